@@ -0,0 +1,951 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2016,
+//  Sony Pictures Imageworks, Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//-*****************************************************************************
+
+// abcbench writes a few synthetic scenes through each of the available
+// backends, reads them back, and prints what it measured as JSON so that
+// the results can be tracked from one build to the next.
+
+#include <Alembic/AbcGeom/All.h>
+#include <Alembic/AbcCoreAbstract/All.h>
+#include <Alembic/AbcCoreFactory/All.h>
+#include <Alembic/AbcCoreOgawa/All.h>
+#include <Alembic/Util/All.h>
+
+#ifdef ALEMBIC_WITH_HDF5
+#include <Alembic/AbcCoreHDF5/All.h>
+#endif
+
+#ifdef ALEMBIC_WITH_MULTIVERSE
+#include <Alembic/AbcCoreGit/All.h>
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#ifndef _WIN32
+#include <ftw.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+//-*****************************************************************************
+using namespace ::Alembic::AbcGeom;
+
+typedef std::chrono::steady_clock Clock;
+
+//-*****************************************************************************
+double secondsSince( const Clock::time_point & iStart )
+{
+    return std::chrono::duration< double >( Clock::now() - iStart ).count();
+}
+
+//-*****************************************************************************
+struct BenchOptions
+{
+    BenchOptions() : scale( 1 ), frames( 24 ), dir( "." ), keep( false ),
+        fork( true ) {}
+
+    size_t scale;
+    size_t frames;
+    std::string dir;
+    std::vector< std::string > scenes;
+    std::vector< std::string > backends;
+    std::string output;
+    bool keep;
+    bool fork;
+};
+
+//-*****************************************************************************
+// what one scene written and read through one backend measured
+struct BenchResult
+{
+    BenchResult() : objects( 0 ), properties( 0 ), samplesWritten( 0 ),
+        exportSeconds( 0.0 ), diskBytes( 0 ), openSeconds( 0.0 ),
+        traversalSeconds( 0.0 ), peakRSSBytes( -1 ) {}
+
+    std::string scene;
+    std::string backend;
+    std::string error;
+    size_t objects;
+    size_t properties;
+    size_t samplesWritten;
+    double exportSeconds;
+    Alembic::Util::uint64_t diskBytes;
+    double openSeconds;
+    double traversalSeconds;
+    std::vector< double > frameSeconds;
+    long long peakRSSBytes;
+};
+
+//-*****************************************************************************
+// FILES
+//-*****************************************************************************
+
+#ifndef _WIN32
+static Alembic::Util::uint64_t g_diskBytes = 0;
+
+int addDiskBytes( const char *, const struct stat * iStat, int iFlag,
+                  struct FTW * )
+{
+    if ( iFlag == FTW_F )
+    {
+        g_diskBytes += iStat->st_size;
+    }
+    return 0;
+}
+
+int removeEntry( const char * iPath, const struct stat *, int, struct FTW * )
+{
+    return remove( iPath );
+}
+#endif
+
+//-*****************************************************************************
+// the size of a file, or of everything under a directory (Git)
+Alembic::Util::uint64_t diskUsage( const std::string & iPath )
+{
+#ifndef _WIN32
+    g_diskBytes = 0;
+    nftw( iPath.c_str(), addDiskBytes, 32, FTW_PHYS );
+    return g_diskBytes;
+#else
+    std::ifstream f( iPath.c_str(), std::ios::binary | std::ios::ate );
+    return f ? ( Alembic::Util::uint64_t ) f.tellg() : 0;
+#endif
+}
+
+//-*****************************************************************************
+void removePath( const std::string & iPath )
+{
+#ifndef _WIN32
+    nftw( iPath.c_str(), removeEntry, 32, FTW_DEPTH | FTW_PHYS );
+#else
+    remove( iPath.c_str() );
+#endif
+}
+
+//-*****************************************************************************
+long long currentPeakRSS()
+{
+#ifndef _WIN32
+    struct rusage usage;
+    if ( getrusage( RUSAGE_SELF, &usage ) != 0 )
+    {
+        return -1;
+    }
+#ifdef __APPLE__
+    return usage.ru_maxrss;
+#else
+    return ( long long ) usage.ru_maxrss * 1024;
+#endif
+#else
+    return -1;
+#endif
+}
+
+//-*****************************************************************************
+// BACKENDS
+//-*****************************************************************************
+
+std::vector< std::string > availableBackends()
+{
+    std::vector< std::string > backends;
+    backends.push_back( "ogawa" );
+#ifdef ALEMBIC_WITH_HDF5
+    backends.push_back( "hdf5" );
+#endif
+#ifdef ALEMBIC_WITH_MULTIVERSE
+    backends.push_back( "git" );
+    backends.push_back( "milliways" );
+#endif
+    return backends;
+}
+
+//-*****************************************************************************
+OArchive createArchive( const std::string & iBackend,
+                        const std::string & iPath )
+{
+#ifdef ALEMBIC_WITH_HDF5
+    if ( iBackend == "hdf5" )
+    {
+        return OArchive( Alembic::AbcCoreHDF5::WriteArchive(), iPath );
+    }
+#endif
+#ifdef ALEMBIC_WITH_MULTIVERSE
+    if ( iBackend == "git" || iBackend == "milliways" )
+    {
+        Alembic::AbcCoreGit::WriteOptions options;
+        options["milliways"] = ( iBackend == "milliways" );
+        return OArchive( Alembic::AbcCoreGit::WriteArchive( options ), iPath );
+    }
+#endif
+    return OArchive( Alembic::AbcCoreOgawa::WriteArchive(), iPath );
+}
+
+//-*****************************************************************************
+IArchive openArchive( const std::string & iBackend,
+                      const std::string & iPath )
+{
+    Alembic::AbcCoreFactory::IFactory factory;
+    Alembic::AbcCoreFactory::IFactory::CoreType coreType;
+#ifdef ALEMBIC_WITH_MULTIVERSE
+    Alembic::AbcCoreFactory::IOptions options;
+    options["milliways"] = ( iBackend == "milliways" );
+    return factory.getArchive( iPath, coreType, options );
+#else
+    return factory.getArchive( iPath, coreType );
+#endif
+}
+
+//-*****************************************************************************
+std::string archivePath( const BenchOptions & iOptions,
+                         const std::string & iScene,
+                         const std::string & iBackend )
+{
+    std::string path = iOptions.dir + "/abcbench_" + iScene + "_" + iBackend;
+    if ( iBackend == "ogawa" || iBackend == "hdf5" )
+    {
+        path += ".abc";
+    }
+    return path;
+}
+
+//-*****************************************************************************
+// SCENES
+//-*****************************************************************************
+
+// many chains of animated transforms, nested 64 deep
+void writeDeep( OObject iTop, Alembic::Util::uint32_t iTsIdx,
+                const BenchOptions & iOptions, BenchResult & oResult )
+{
+    const size_t depth = 64;
+    std::vector< OXformSchema > xforms;
+    for ( size_t c = 0; c < 8 * iOptions.scale; ++c )
+    {
+        OObject parent = iTop;
+        for ( size_t d = 0; d < depth; ++d )
+        {
+            std::ostringstream name;
+            name << "xf_" << c << "_" << d;
+            OXform xform( parent, name.str(), iTsIdx );
+            xforms.push_back( xform.getSchema() );
+            parent = xform;
+        }
+    }
+
+    for ( size_t f = 0; f < iOptions.frames; ++f )
+    {
+        for ( size_t i = 0; i < xforms.size(); ++i )
+        {
+            XformSample sample;
+            sample.setTranslation( V3d( 0.1 * f, 1.0, 0.01 * i ) );
+            sample.setRotation( V3d( 0.0, 1.0, 0.0 ), 0.5 * f );
+            xforms[i].set( sample );
+        }
+        oResult.samplesWritten += xforms.size();
+    }
+    oResult.objects = xforms.size();
+}
+
+//-*****************************************************************************
+// one large grid whose points move every frame
+void writeMesh( OObject iTop, Alembic::Util::uint32_t iTsIdx,
+                const BenchOptions & iOptions, BenchResult & oResult )
+{
+    const size_t width = 256;
+    const size_t height = 256 * iOptions.scale;
+
+    std::vector< Alembic::Util::int32_t > indices;
+    std::vector< Alembic::Util::int32_t > counts;
+    for ( size_t y = 0; y + 1 < height; ++y )
+    {
+        for ( size_t x = 0; x + 1 < width; ++x )
+        {
+            Alembic::Util::int32_t v = y * width + x;
+            indices.push_back( v );
+            indices.push_back( v + 1 );
+            indices.push_back( v + 1 + width );
+            indices.push_back( v + width );
+            counts.push_back( 4 );
+        }
+    }
+
+    OPolyMesh mesh( iTop, "grid", iTsIdx );
+    OPolyMeshSchema & schema = mesh.getSchema();
+    std::vector< V3f > points( width * height );
+    for ( size_t f = 0; f < iOptions.frames; ++f )
+    {
+        for ( size_t i = 0; i < points.size(); ++i )
+        {
+            float x = float( i % width );
+            float y = float( i / width );
+            points[i] = V3f( x, std::sin( 0.1f * x + 0.25f * f ), y );
+        }
+
+        // the topology doesn't change, so it only goes in the first sample
+        if ( f == 0 )
+        {
+            schema.set( OPolyMeshSchema::Sample(
+                P3fArraySample( points ), Int32ArraySample( indices ),
+                Int32ArraySample( counts ) ) );
+        }
+        else
+        {
+            schema.set( OPolyMeshSchema::Sample( P3fArraySample( points ) ) );
+        }
+        ++oResult.samplesWritten;
+    }
+    oResult.objects = 1;
+}
+
+//-*****************************************************************************
+// lots of small static cubes under animated transforms
+void writeProps( OObject iTop, Alembic::Util::uint32_t iTsIdx,
+                 const BenchOptions & iOptions, BenchResult & oResult )
+{
+    static const Alembic::Util::int32_t cubeIndices[] = {
+        0, 1, 3, 2,  2, 3, 5, 4,  4, 5, 7, 6,
+        6, 7, 1, 0,  1, 7, 5, 3,  6, 0, 2, 4 };
+    static const Alembic::Util::int32_t cubeCounts[] = { 4, 4, 4, 4, 4, 4 };
+    static const V3f cubePoints[] = {
+        V3f( -1, -1, 1 ), V3f( 1, -1, 1 ), V3f( -1, 1, 1 ), V3f( 1, 1, 1 ),
+        V3f( -1, 1, -1 ), V3f( 1, 1, -1 ), V3f( -1, -1, -1 ),
+        V3f( 1, -1, -1 ) };
+
+    std::vector< OXformSchema > xforms;
+    for ( size_t i = 0; i < 2000 * iOptions.scale; ++i )
+    {
+        std::ostringstream name;
+        name << "prop_" << i;
+        OXform xform( iTop, name.str(), iTsIdx );
+        xforms.push_back( xform.getSchema() );
+
+        OPolyMesh cube( xform, "cube" );
+        cube.getSchema().set( OPolyMeshSchema::Sample(
+            P3fArraySample( cubePoints, 8 ),
+            Int32ArraySample( cubeIndices, 24 ),
+            Int32ArraySample( cubeCounts, 6 ) ) );
+        ++oResult.samplesWritten;
+    }
+
+    for ( size_t f = 0; f < iOptions.frames; ++f )
+    {
+        for ( size_t i = 0; i < xforms.size(); ++i )
+        {
+            XformSample sample;
+            sample.setTranslation( V3d( i % 100, 0.1 * f, i / 100 ) );
+            xforms[i].set( sample );
+        }
+        oResult.samplesWritten += xforms.size();
+    }
+    oResult.objects = xforms.size() * 2;
+}
+
+//-*****************************************************************************
+// objects carrying lots of metadata and animated string properties
+void writeStrings( OObject iTop, Alembic::Util::uint32_t iTsIdx,
+                   const BenchOptions & iOptions, BenchResult & oResult )
+{
+    std::vector< OStringArrayProperty > tags;
+    std::vector< OStringProperty > labels;
+    for ( size_t i = 0; i < 500 * iOptions.scale; ++i )
+    {
+        MetaData md;
+        for ( size_t k = 0; k < 16; ++k )
+        {
+            std::ostringstream key, value;
+            key << "attr" << k;
+            value << "/show/seq/shot/asset_" << i << "/variant_" << k;
+            md.set( key.str(), value.str() );
+        }
+
+        std::ostringstream name;
+        name << "tagged_" << i;
+        OObject obj( iTop, name.str(), md );
+        tags.push_back( OStringArrayProperty( obj.getProperties(), "tags",
+                                              iTsIdx ) );
+        labels.push_back( OStringProperty( obj.getProperties(), "label",
+                                           iTsIdx ) );
+    }
+
+    std::vector< std::string > values( 32 );
+    for ( size_t f = 0; f < iOptions.frames; ++f )
+    {
+        for ( size_t i = 0; i < tags.size(); ++i )
+        {
+            for ( size_t v = 0; v < values.size(); ++v )
+            {
+                std::ostringstream value;
+                value << "tag_" << v << "_" << ( ( i + f ) % 7 );
+                values[v] = value.str();
+            }
+            tags[i].set( StringArraySample( values ) );
+
+            std::ostringstream label;
+            label << "frame " << f << " of tagged_" << i;
+            labels[i].set( label.str() );
+        }
+        oResult.samplesWritten += tags.size() * 2;
+    }
+    oResult.objects = tags.size();
+}
+
+//-*****************************************************************************
+std::vector< std::string > availableScenes()
+{
+    std::vector< std::string > scenes;
+    scenes.push_back( "deep" );
+    scenes.push_back( "mesh" );
+    scenes.push_back( "props" );
+    scenes.push_back( "strings" );
+    return scenes;
+}
+
+//-*****************************************************************************
+void writeScene( const std::string & iScene, const std::string & iBackend,
+                 const std::string & iPath, const BenchOptions & iOptions,
+                 BenchResult & oResult )
+{
+    Clock::time_point start = Clock::now();
+    {
+        OArchive archive = createArchive( iBackend, iPath );
+        TimeSampling ts( 1.0 / 24.0, 0.0 );
+        Alembic::Util::uint32_t tsIdx = archive.addTimeSampling( ts );
+        OObject top = archive.getTop();
+
+        if ( iScene == "deep" )
+        {
+            writeDeep( top, tsIdx, iOptions, oResult );
+        }
+        else if ( iScene == "mesh" )
+        {
+            writeMesh( top, tsIdx, iOptions, oResult );
+        }
+        else if ( iScene == "props" )
+        {
+            writeProps( top, tsIdx, iOptions, oResult );
+        }
+        else
+        {
+            writeStrings( top, tsIdx, iOptions, oResult );
+        }
+
+        // everything is flushed as the archive goes out of scope
+    }
+    oResult.exportSeconds = secondsSince( start );
+    oResult.diskBytes = diskUsage( iPath );
+}
+
+//-*****************************************************************************
+// READING
+//-*****************************************************************************
+
+struct SampledProperties
+{
+    std::vector< IArrayProperty > arrays;
+    std::vector< IScalarProperty > scalars;
+};
+
+//-*****************************************************************************
+void traverseProperties( ICompoundProperty iParent, BenchResult & ioResult,
+                         SampledProperties & ioProps )
+{
+    for ( size_t i = 0; i < iParent.getNumProperties(); ++i )
+    {
+        const PropertyHeader & header = iParent.getPropertyHeader( i );
+        ++ioResult.properties;
+
+        if ( header.isCompound() )
+        {
+            traverseProperties( ICompoundProperty( iParent,
+                header.getName() ), ioResult, ioProps );
+        }
+        else if ( header.isArray() )
+        {
+            ioProps.arrays.push_back( IArrayProperty( iParent,
+                header.getName() ) );
+        }
+        else
+        {
+            ioProps.scalars.push_back( IScalarProperty( iParent,
+                header.getName() ) );
+        }
+    }
+}
+
+//-*****************************************************************************
+size_t traverseObjects( IObject iObj, BenchResult & ioResult,
+                        SampledProperties & ioProps )
+{
+    size_t numObjects = 1;
+    traverseProperties( iObj.getProperties(), ioResult, ioProps );
+    for ( size_t i = 0; i < iObj.getNumChildren(); ++i )
+    {
+        numObjects += traverseObjects( iObj.getChild( i ), ioResult,
+                                       ioProps );
+    }
+    return numObjects;
+}
+
+//-*****************************************************************************
+index_t clampIndex( size_t iFrame, size_t iNumSamples )
+{
+    return ( index_t ) std::min( iFrame, iNumSamples - 1 );
+}
+
+//-*****************************************************************************
+// reads every sample that is live on iFrame
+void readFrame( size_t iFrame, SampledProperties & iProps )
+{
+    for ( size_t i = 0; i < iProps.arrays.size(); ++i )
+    {
+        IArrayProperty & prop = iProps.arrays[i];
+        if ( prop.getNumSamples() == 0 )
+        {
+            continue;
+        }
+
+        AbcA::ArraySamplePtr samp;
+        prop.get( samp, ISampleSelector(
+            clampIndex( iFrame, prop.getNumSamples() ) ) );
+    }
+
+    for ( size_t i = 0; i < iProps.scalars.size(); ++i )
+    {
+        IScalarProperty & prop = iProps.scalars[i];
+        if ( prop.getNumSamples() == 0 )
+        {
+            continue;
+        }
+
+        const AbcA::DataType & dt = prop.getDataType();
+        Alembic::Util::Dimensions dims( dt.getExtent() );
+        AbcA::ArraySamplePtr samp = AbcA::AllocateArraySample( dt, dims );
+        prop.get( const_cast< void * >( samp->getData() ), ISampleSelector(
+            clampIndex( iFrame, prop.getNumSamples() ) ) );
+    }
+}
+
+//-*****************************************************************************
+void readScene( const std::string & iBackend, const std::string & iPath,
+                const BenchOptions & iOptions, BenchResult & oResult )
+{
+    Clock::time_point start = Clock::now();
+    IArchive archive = openArchive( iBackend, iPath );
+    oResult.openSeconds = secondsSince( start );
+
+    if ( !archive.valid() )
+    {
+        oResult.error = "could not open " + iPath;
+        return;
+    }
+
+    // only count what was read back
+    oResult.properties = 0;
+    SampledProperties props;
+    start = Clock::now();
+    oResult.objects = traverseObjects( archive.getTop(), oResult, props ) - 1;
+    oResult.traversalSeconds = secondsSince( start );
+
+    for ( size_t f = 0; f < iOptions.frames; ++f )
+    {
+        start = Clock::now();
+        readFrame( f, props );
+        oResult.frameSeconds.push_back( secondsSince( start ) );
+    }
+}
+
+//-*****************************************************************************
+// REPORTING
+//-*****************************************************************************
+
+std::string jsonString( const std::string & iStr )
+{
+    std::ostringstream out;
+    out << '"';
+    for ( size_t i = 0; i < iStr.size(); ++i )
+    {
+        char c = iStr[i];
+        if ( c == '"' || c == '\\' )
+        {
+            out << '\\' << c;
+        }
+        else if ( ( unsigned char ) c < 0x20 )
+        {
+            char buf[8];
+            snprintf( buf, sizeof( buf ), "\\u%04x", c );
+            out << buf;
+        }
+        else
+        {
+            out << c;
+        }
+    }
+    out << '"';
+    return out.str();
+}
+
+//-*****************************************************************************
+double percentile( const std::vector< double > & iSorted, double iFraction )
+{
+    if ( iSorted.empty() )
+    {
+        return 0.0;
+    }
+
+    size_t idx = ( size_t ) std::ceil( iFraction * iSorted.size() );
+    return iSorted[ std::min( iSorted.size(), std::max( idx, ( size_t ) 1 ) )
+                    - 1 ];
+}
+
+//-*****************************************************************************
+std::string resultJson( const BenchResult & iResult,
+                        const BenchOptions & iOptions )
+{
+    std::vector< double > frames( iResult.frameSeconds );
+    std::sort( frames.begin(), frames.end() );
+    double total = 0.0;
+    for ( size_t i = 0; i < frames.size(); ++i )
+    {
+        total += frames[i];
+    }
+
+    std::ostringstream out;
+    out.precision( 9 );
+    out << "    {\n"
+        << "      \"scene\": " << jsonString( iResult.scene ) << ",\n"
+        << "      \"backend\": " << jsonString( iResult.backend ) << ",\n";
+
+    if ( !iResult.error.empty() )
+    {
+        out << "      \"error\": " << jsonString( iResult.error ) << ",\n";
+    }
+
+    double exportSeconds = std::max( iResult.exportSeconds, 1e-9 );
+    out << "      \"frames\": " << iOptions.frames << ",\n"
+        << "      \"objects\": " << iResult.objects << ",\n"
+        << "      \"properties\": " << iResult.properties << ",\n"
+        << "      \"samples_written\": " << iResult.samplesWritten << ",\n"
+        << "      \"export_seconds\": " << iResult.exportSeconds << ",\n"
+        << "      \"export_samples_per_second\": "
+        << iResult.samplesWritten / exportSeconds << ",\n"
+        << "      \"export_bytes_per_second\": "
+        << iResult.diskBytes / exportSeconds << ",\n"
+        << "      \"disk_bytes\": " << iResult.diskBytes << ",\n"
+        << "      \"open_seconds\": " << iResult.openSeconds << ",\n"
+        << "      \"traversal_seconds\": " << iResult.traversalSeconds
+        << ",\n"
+        << "      \"frame_read_seconds\": {"
+        << " \"mean\": " << ( frames.empty() ? 0.0 : total / frames.size() )
+        << ", \"p50\": " << percentile( frames, 0.5 )
+        << ", \"p95\": " << percentile( frames, 0.95 )
+        << ", \"max\": " << ( frames.empty() ? 0.0 : frames.back() )
+        << " },\n"
+        << "      \"peak_rss_bytes\": " << iResult.peakRSSBytes << "\n"
+        << "    }";
+    return out.str();
+}
+
+//-*****************************************************************************
+std::string runCase( const std::string & iScene, const std::string & iBackend,
+                     const BenchOptions & iOptions )
+{
+    BenchResult result;
+    result.scene = iScene;
+    result.backend = iBackend;
+
+    std::string path = archivePath( iOptions, iScene, iBackend );
+    removePath( path );
+
+    try
+    {
+        writeScene( iScene, iBackend, path, iOptions, result );
+        readScene( iBackend, path, iOptions, result );
+    }
+    catch ( std::exception & e )
+    {
+        result.error = e.what();
+    }
+
+    result.peakRSSBytes = currentPeakRSS();
+
+    if ( !iOptions.keep )
+    {
+        removePath( path );
+    }
+
+    return resultJson( result, iOptions );
+}
+
+//-*****************************************************************************
+// runs the case in a child process so that its peak RSS is its own
+std::string runCaseIsolated( const std::string & iScene,
+                             const std::string & iBackend,
+                             const BenchOptions & iOptions )
+{
+#ifndef _WIN32
+    if ( iOptions.fork )
+    {
+        int fds[2];
+        if ( pipe( fds ) == 0 )
+        {
+            pid_t pid = fork();
+            if ( pid == 0 )
+            {
+                close( fds[0] );
+                std::string json = runCase( iScene, iBackend, iOptions );
+                size_t written = 0;
+                while ( written < json.size() )
+                {
+                    ssize_t n = write( fds[1], json.data() + written,
+                                       json.size() - written );
+                    if ( n <= 0 )
+                    {
+                        break;
+                    }
+                    written += n;
+                }
+                close( fds[1] );
+                _exit( 0 );
+            }
+
+            close( fds[1] );
+            std::string json;
+            char buf[4096];
+            ssize_t n;
+            while ( pid > 0 && ( n = read( fds[0], buf, sizeof( buf ) ) ) > 0 )
+            {
+                json.append( buf, n );
+            }
+            close( fds[0] );
+
+            if ( pid > 0 )
+            {
+                int status = 0;
+                waitpid( pid, &status, 0 );
+                if ( !json.empty() )
+                {
+                    return json;
+                }
+            }
+        }
+    }
+#endif
+    return runCase( iScene, iBackend, iOptions );
+}
+
+//-*****************************************************************************
+// ARGUMENTS
+//-*****************************************************************************
+
+void usage()
+{
+    std::cerr <<
+        "abcbench [options]\n"
+        "  Writes synthetic scenes through each backend, reads them back\n"
+        "  and prints the timings, sizes and peak memory as JSON.\n\n"
+        "  --scenes a,b,..     scenes to run (deep, mesh, props, strings),\n"
+        "                      all of them by default\n"
+        "  --backends a,b,..   backends to run, all of the ones built in by\n"
+        "                      default:";
+    std::vector< std::string > backends = availableBackends();
+    for ( size_t i = 0; i < backends.size(); ++i )
+    {
+        std::cerr << " " << backends[i];
+    }
+    std::cerr << "\n"
+        "  --scale N           multiplies the size of every scene (1)\n"
+        "  --frames N          number of frames written and read (24)\n"
+        "  --dir DIR           where the archives are written (.)\n"
+        "  --output FILE       write the JSON to FILE instead of stdout\n"
+        "  --keep              keep the written archives\n"
+        "  --no-fork           run every case in this process, the peak\n"
+        "                      RSS then only ever grows\n";
+}
+
+//-*****************************************************************************
+std::vector< std::string > splitList( const std::string & iList )
+{
+    std::vector< std::string > items;
+    std::istringstream in( iList );
+    std::string item;
+    while ( std::getline( in, item, ',' ) )
+    {
+        if ( !item.empty() )
+        {
+            items.push_back( item );
+        }
+    }
+    return items;
+}
+
+//-*****************************************************************************
+bool parseArgs( int argc, char *argv[], BenchOptions & oOptions )
+{
+    for ( int i = 1; i < argc; ++i )
+    {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if ( arg == "--scenes" && hasValue )
+        {
+            oOptions.scenes = splitList( argv[++i] );
+        }
+        else if ( arg == "--backends" && hasValue )
+        {
+            oOptions.backends = splitList( argv[++i] );
+        }
+        else if ( arg == "--scale" && hasValue )
+        {
+            oOptions.scale = std::max( 1, atoi( argv[++i] ) );
+        }
+        else if ( arg == "--frames" && hasValue )
+        {
+            oOptions.frames = std::max( 1, atoi( argv[++i] ) );
+        }
+        else if ( arg == "--dir" && hasValue )
+        {
+            oOptions.dir = argv[++i];
+        }
+        else if ( arg == "--output" && hasValue )
+        {
+            oOptions.output = argv[++i];
+        }
+        else if ( arg == "--keep" )
+        {
+            oOptions.keep = true;
+        }
+        else if ( arg == "--no-fork" )
+        {
+            oOptions.fork = false;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    std::vector< std::string > scenes = availableScenes();
+    if ( oOptions.scenes.empty() )
+    {
+        oOptions.scenes = scenes;
+    }
+
+    for ( size_t i = 0; i < oOptions.scenes.size(); ++i )
+    {
+        if ( std::find( scenes.begin(), scenes.end(), oOptions.scenes[i] ) ==
+             scenes.end() )
+        {
+            std::cerr << "Unknown scene: " << oOptions.scenes[i] << "\n";
+            return false;
+        }
+    }
+
+    std::vector< std::string > backends = availableBackends();
+    if ( oOptions.backends.empty() )
+    {
+        oOptions.backends = backends;
+    }
+
+    for ( size_t i = 0; i < oOptions.backends.size(); ++i )
+    {
+        if ( std::find( backends.begin(), backends.end(),
+                        oOptions.backends[i] ) == backends.end() )
+        {
+            std::cerr << "Backend not available: " << oOptions.backends[i]
+                      << "\n";
+            return false;
+        }
+    }
+
+    return true;
+}
+
+//-*****************************************************************************
+int main( int argc, char *argv[] )
+{
+    BenchOptions options;
+    if ( !parseArgs( argc, argv, options ) )
+    {
+        usage();
+        return 1;
+    }
+
+    std::ostringstream out;
+    out << "{\n"
+        << "  \"alembic_version\": "
+        << jsonString( AbcA::GetLibraryVersionShort() ) << ",\n"
+        << "  \"scale\": " << options.scale << ",\n"
+        << "  \"frames\": " << options.frames << ",\n"
+        << "  \"results\": [\n";
+
+    for ( size_t s = 0; s < options.scenes.size(); ++s )
+    {
+        for ( size_t b = 0; b < options.backends.size(); ++b )
+        {
+            if ( s != 0 || b != 0 )
+            {
+                out << ",\n";
+            }
+            out << runCaseIsolated( options.scenes[s], options.backends[b],
+                                    options );
+        }
+    }
+    out << "\n  ]\n}\n";
+
+    if ( options.output.empty() )
+    {
+        std::cout << out.str();
+    }
+    else
+    {
+        std::ofstream file( options.output.c_str() );
+        file << out.str();
+        if ( !file )
+        {
+            std::cerr << "Could not write " << options.output << "\n";
+            return 1;
+        }
+    }
+
+    return 0;
+}
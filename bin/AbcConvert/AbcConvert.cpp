@@ -64,6 +64,8 @@ public:
         toType = IFactoryNS::kUnknown;
         force = false;
         milliways = false;
+        incremental = false;
+        packProperties = false;
     }
 
     std::vector<std::string>    inFiles;
@@ -72,6 +74,8 @@ public:
     bool                        force;
 
     bool milliways;
+    bool incremental;
+    bool packProperties;
     std::string commitMessage;
     std::string revision;
 };
@@ -180,13 +184,17 @@ void copyObject(Alembic::Abc::IObject & iIn,
 void displayHelp()
 {
     printf ("Usage (single file conversion):\n");
-    printf ("abcconvert [-force] [-r | --revision REVISION] [--milliways ON|OFF] [-m | --message COMMIT-MESSAGE] OPTION inFile outFile\n");
+    printf ("abcconvert [-force] [-r | --revision REVISION] [--milliways ON|OFF] [--incremental] [--pack-properties] [-m | --message COMMIT-MESSAGE] OPTION inFile outFile\n");
     printf ("Usage (convert multiple, layered files to single file):\n");
-    printf ("abcconvert [-r | --revision REVISION] [--milliways ON|OFF] [-m | --message COMMIT-MESSAGE] OPTION -in inFile1 inFile2 ... -out outFile\n");
+    printf ("abcconvert [-r | --revision REVISION] [--milliways ON|OFF] [--incremental] [--pack-properties] [-m | --message COMMIT-MESSAGE] OPTION -in inFile1 inFile2 ... -out outFile\n");
     printf ("Used to convert an Alembic file from one type to another.\n\n");
     printf ("If -force is not provided and inFile happens to be the same\n");
     printf ("type as OPTION no conversion will be done and a message will\n");
     printf ("be printed out.\n");
+    printf ("With --incremental a Git output reuses the trees of its previous\n");
+    printf ("commit for the objects that didn't change.\n");
+    printf ("With --pack-properties a Git output stores the property headers\n");
+    printf ("of each compound in a single blob.\n");
     printf ("OPTION has to be one of these:\n\n");
 #ifdef ALEMBIC_WITH_HDF5
     printf ("  -toHDF   Convert to HDF.\n");
@@ -267,6 +275,14 @@ bool parseArgs( int iArgc, char *iArgv[], ConversionOptions &oOptions, bool &oDo
                     else
                         oOptions.milliways = false;
                 }
+                else if (arg == "--incremental")
+                {
+                    oOptions.incremental = true;
+                }
+                else if (arg == "--pack-properties")
+                {
+                    oOptions.packProperties = true;
+                }
                 else if( (arg == "-help") || (arg == "--help") )
                 {
                     displayHelp();
@@ -431,6 +447,8 @@ int main(int argc, char *argv[])
 
             std::cout << "milliways is " << (options.milliways ? "enabled" : "disabled") << std::endl;
             wOptions["milliways"] = (options.milliways ? true : false);
+            wOptions["incremental"] = (options.incremental ? true : false);
+            wOptions["packProperties"] = (options.packProperties ? true : false);
 
             outArchive = Alembic::Abc::OArchive(
                 Alembic::AbcCoreGit::WriteArchive(wOptions),
@@ -39,6 +39,12 @@
 #include <Alembic/AbcCoreOgawa/All.h>
 #include <Alembic/AbcCoreLayer/Util.h>
 #include <Alembic/AbcGeom/All.h>
+#ifdef ALEMBIC_WITH_MULTIVERSE
+#include <Alembic/AbcCoreGit/All.h>
+#endif
+
+#include <iostream>
+#include <set>
 
 // util which compares the property headers and returns if they are the same
 bool headerCmp(const Alembic::Abc::PropertyHeader * iHeaderA,
@@ -223,36 +229,78 @@ class DiffWalker
 {
 public:
     DiffWalker(const char * iInFileA, const char * iInFileB,
-               const char * iOutFile, bool iVerbose)
+               const char * iOutFile, bool iVerbose,
+               const std::string & iRevisionA = std::string(),
+               const std::string & iRevisionB = std::string())
     {
         m_verbose = iVerbose;
         m_inFileA = iInFileA;
         m_inFileB = iInFileB;
         m_outFile = iOutFile;
+        m_useChanges = false;
+
+        if (!iRevisionA.empty())
+        {
+            m_optionsA["revision"] = iRevisionA;
+        }
+
+        if (!iRevisionB.empty())
+        {
+            m_optionsB["revision"] = iRevisionB;
+        }
     }
 
     int walk()
     {
 
         Alembic::AbcCoreFactory::IFactory factory;
-        Alembic::AbcCoreFactory::IFactory::CoreType coreType;
+        Alembic::AbcCoreFactory::IFactory::CoreType coreTypeA, coreTypeB;
 
-        Alembic::Abc::IArchive arc1 = factory.getArchive(m_inFileA, coreType);
-        if (coreType != Alembic::AbcCoreFactory::IFactory::kOgawa)
+        Alembic::Abc::IArchive arc1 = factory.getArchive(m_inFileA, coreTypeA,
+                                                         m_optionsA);
+        if (!isSupported(coreTypeA))
         {
-            printf("Error: %s is not a valid Alembic Ogawa file.\n",
+            printf("Error: %s is not a valid Alembic Ogawa or Git file.\n",
                    m_inFileA.c_str());
             return 1;
         }
 
-        Alembic::Abc::IArchive arc2 = factory.getArchive(m_inFileB, coreType);
-        if (coreType != Alembic::AbcCoreFactory::IFactory::kOgawa)
+        Alembic::Abc::IArchive arc2 = factory.getArchive(m_inFileB, coreTypeB,
+                                                         m_optionsB);
+        if (!isSupported(coreTypeB))
         {
-            printf("Error: %s is not a valid Alembic Ogawa file.\n",
+            printf("Error: %s is not a valid Alembic Ogawa or Git file.\n",
                    m_inFileB.c_str());
             return 1;
         }
 
+        if (coreTypeA != coreTypeB)
+        {
+            printf("Error: %s and %s do not use the same Alembic backend.\n",
+                   m_inFileA.c_str(), m_inFileB.c_str());
+            return 1;
+        }
+
+#ifdef ALEMBIC_WITH_MULTIVERSE
+        // the Git backend keeps no object or property hashes, but comparing
+        // the trees of both archives tells us where to look
+        if (coreTypeA == Alembic::AbcCoreFactory::IFactory::kGit)
+        {
+            Alembic::AbcCoreGit::ArchiveChanges changes =
+                Alembic::AbcCoreGit::diffArchives(m_inFileA, m_optionsA,
+                                                  m_inFileB, m_optionsB);
+
+            if (changes.empty())
+            {
+                printf("No differences detected, %s was not written.\n",
+                       m_outFile.c_str());
+                return 0;
+            }
+
+            useChanges(changes);
+        }
+#endif
+
         Alembic::Abc::IObject topA = arc1.getTop();
         Alembic::Abc::IObject topB = arc2.getTop();
         walk(topA, topB);
@@ -266,6 +314,77 @@ public:
 
 private:
 
+    bool isSupported(Alembic::AbcCoreFactory::IFactory::CoreType iType)
+    {
+#ifdef ALEMBIC_WITH_MULTIVERSE
+        if (iType == Alembic::AbcCoreFactory::IFactory::kGit)
+        {
+            return true;
+        }
+#endif
+        return iType == Alembic::AbcCoreFactory::IFactory::kOgawa;
+    }
+
+#ifdef ALEMBIC_WITH_MULTIVERSE
+    // objects with changed properties go in m_changedProps, the objects
+    // above any change in m_changedChildren
+    void useChanges(const Alembic::AbcCoreGit::ArchiveChanges & iChanges)
+    {
+        m_useChanges = true;
+
+        Alembic::AbcCoreGit::ArchiveChanges::const_iterator it;
+        for (it = iChanges.begin(); it != iChanges.end(); ++it)
+        {
+            if (m_verbose)
+            {
+                std::cout << *it << std::endl;
+            }
+
+            std::string name = it->object;
+            if (!it->isObject() || it->kind ==
+                Alembic::AbcCoreGit::ArchiveChange::kChanged)
+            {
+                m_changedProps.insert(name);
+            }
+
+            while (name != "/")
+            {
+                size_t pos = name.rfind('/');
+                name = (pos == 0) ? std::string("/") : name.substr(0, pos);
+                m_changedChildren.insert(name);
+            }
+        }
+    }
+#endif
+
+    bool propsDiffer(Alembic::Abc::IObject & iObjA,
+                     Alembic::Abc::IObject & iObjB)
+    {
+        if (m_useChanges)
+        {
+            return m_changedProps.count(iObjA.getFullName()) > 0;
+        }
+
+        Alembic::Util::Digest hashPropA, hashPropB;
+        iObjA.getPropertiesHash(hashPropA);
+        iObjB.getPropertiesHash(hashPropB);
+        return hashPropA != hashPropB;
+    }
+
+    bool childrenDiffer(Alembic::Abc::IObject & iObjA,
+                        Alembic::Abc::IObject & iObjB)
+    {
+        if (m_useChanges)
+        {
+            return m_changedChildren.count(iObjA.getFullName()) > 0;
+        }
+
+        Alembic::Util::Digest hashChildrenA, hashChildrenB;
+        iObjA.getChildrenHash(hashChildrenA);
+        iObjB.getChildrenHash(hashChildrenB);
+        return hashChildrenA != hashChildrenB;
+    }
+
     void walkProps(Alembic::Abc::ICompoundProperty & iPropA,
                    Alembic::Abc::ICompoundProperty & iPropB,
                    Alembic::Abc::OCompoundProperty & oProp)
@@ -480,22 +599,15 @@ private:
     void walk(Alembic::Abc::IObject & iObjA, Alembic::Abc::IObject & iObjB)
     {
 
-        Alembic::Util::Digest hashPropA, hashPropB;
-        iObjA.getPropertiesHash(hashPropA);
-        iObjB.getPropertiesHash(hashPropB);
-
         // lets check our properties
-        if (hashPropA != hashPropB)
+        if (propsDiffer(iObjA, iObjB))
         {
             Alembic::Abc::ICompoundProperty propA = iObjA.getProperties();
             Alembic::Abc::ICompoundProperty propB = iObjB.getProperties();
             walkProps(propA, propB);
         }
 
-        Alembic::Util::Digest hashChildrenA, hashChildrenB;
-        iObjA.getChildrenHash(hashChildrenA);
-        iObjB.getChildrenHash(hashChildrenB);
-        if (hashChildrenA == hashChildrenB)
+        if (!childrenDiffer(iObjA, iObjB))
         {
             if (m_outStack.size() > 1 &&
                 m_outStack.back().getFullName() == iObjA.getFullName())
@@ -609,22 +721,33 @@ private:
     std::string m_inFileA;
     std::string m_inFileB;
     std::string m_outFile;
+    Alembic::AbcCoreFactory::IOptions m_optionsA;
+    Alembic::AbcCoreFactory::IOptions m_optionsB;
     std::vector<Alembic::Abc::OObject> m_outStack;
+
+    // set from the change list of the Git backend instead of using hashes
+    bool m_useChanges;
+    std::set<std::string> m_changedProps;
+    std::set<std::string> m_changedChildren;
 };
 
 void displayHelp()
 {
     printf("Usage:\n");
-    printf("abcdiff [-v] inputFilename1 inputFilename2 outputFilename\n\n");
+    printf("abcdiff [-v] [-r1 REVISION] [-r2 REVISION] inputFilename1 inputFilename2 outputFilename\n\n");
 
     printf("Used to compare two Alembic files and write an Alembic file that contains the differences.\n\n");
     printf("inputFilename1 is the \"base\" file. If there a difference in the object hierarchy of inputFilename2, "
             "that different object will be added to the diff, along with a skeleton of its parent hierarchy. If an "
             "object exists in both inputFilename1 and inputFilename2 but the properties are different, an object will "
             "be added to the diff that contains only the differing properties.\n\n");
+    printf("Git archives are compared tree by tree, only looking into what changed between them. To compare two "
+            "revisions of the same Git archive, give it as both inputs along with -r1 and/or -r2.\n\n");
 
     printf("Parameters:\n");
     printf("-v\t\tOPTIONAL\tVerbose mode prints more detailed information about the diff process\n");
+    printf("-r1 REVISION\tOPTIONAL\tThe revision of inputFilename1 to read, if it is a Git archive (default: HEAD)\n");
+    printf("-r2 REVISION\tOPTIONAL\tThe revision of inputFilename2 to read, if it is a Git archive (default: HEAD)\n");
     printf("inputFilename1\tREQUIRED\tThe first Alembic file to compare\n");
     printf("inputFilename2\tREQUIRED\tThe second Alembic file to compare\n");
     printf("outputFilename\tREQUIRED\tThe filename to write out the Alembic diff file\n");
@@ -633,18 +756,39 @@ void displayHelp()
 int main(int argc, char *argv[])
 {
 
-    if ((argc != 4 && argc != 5)|| (argc == 5 && std::string("-v") != argv[1]))
+    bool verbose = false;
+    std::string revisionA, revisionB;
+
+    // the last 3 arguments are always the filenames
+    int i = 1;
+    for (; i < argc - 3; ++i)
     {
-        displayHelp();
-        return 1;
+        std::string arg = argv[i];
+        if (arg == "-v")
+        {
+            verbose = true;
+        }
+        else if (arg == "-r1" && i + 1 < argc - 3)
+        {
+            revisionA = argv[++i];
+        }
+        else if (arg == "-r2" && i + 1 < argc - 3)
+        {
+            revisionB = argv[++i];
+        }
+        else
+        {
+            break;
+        }
     }
 
-    bool verbose = false;
-    // we've already checked for -v above
-    if (argc == 5)
+    if (argc < 4 || i != argc - 3)
     {
-        verbose = true;
+        displayHelp();
+        return 1;
     }
-    DiffWalker dw(argv[argc-3], argv[argc-2], argv[argc-1], verbose);
-    dw.walk();
+
+    DiffWalker dw(argv[argc-3], argv[argc-2], argv[argc-1], verbose,
+                  revisionA, revisionB);
+    return dw.walk();
 }
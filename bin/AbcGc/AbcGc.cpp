@@ -0,0 +1,96 @@
+/*****************************************************************************/
+/*  multiverse - a next generation storage back-end for Alembic              */
+/*                                                                           */
+/*  Copyright 2015 J CUBE Inc. Tokyo, Japan.                                 */
+/*                                                                           */
+/*  Licensed under the Apache License, Version 2.0 (the "License");          */
+/*  you may not use this file except in compliance with the License.         */
+/*  You may obtain a copy of the License at                                  */
+/*                                                                           */
+/*      http://www.apache.org/licenses/LICENSE-2.0                           */
+/*                                                                           */
+/*  Unless required by applicable law or agreed to in writing, software      */
+/*  distributed under the License is distributed on an "AS IS" BASIS,        */
+/*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. */
+/*  See the License for the specific language governing permissions and      */
+/*  limitations under the License.                                           */
+/*****************************************************************************/
+
+#include <Alembic/AbcCoreGit/All.h>
+
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+
+static void usage()
+{
+    printf ("Usage: abcgc FILE...\n");
+    printf ("Used to reclaim the space taken by unreachable objects in Alembic files.\n\n");
+    printf ("Specified files must be using the Git backend with a Milliways store.\n");
+    printf ("Only the objects reachable from the references of each store are kept,\n");
+    printf ("everything the history rewrites and re-exports left behind is dropped.\n");
+    printf ("The files must not be in use while they are collected.\n");
+
+    exit(EXIT_FAILURE);
+}
+
+static std::string humanSize(Alembic::Util::uint64_t bytes)
+{
+    static const char* units[] = { "B", "KiB", "MiB", "GiB", "TiB" };
+
+    double value = static_cast<double>(bytes);
+    size_t unit = 0;
+    while ((value >= 1024.0) && (unit < 4))
+    {
+        value /= 1024.0;
+        unit++;
+    }
+
+    std::ostringstream ss;
+    ss << std::fixed << std::setprecision(unit ? 1 : 0) << value << " " << units[unit];
+    return ss.str();
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2)
+        usage();
+
+    std::vector<std::string> files;
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg(argv[i]);
+        if (arg.substr(0, 1) == "-")
+            usage();
+        files.push_back(arg);
+    }
+
+    bool all_ok = true;
+
+    std::vector<std::string>::const_iterator it;
+    for (it = files.begin(); it != files.end(); ++it)
+    {
+        const std::string& file = *it;
+
+        Alembic::AbcCoreGit::GarbageStats stats;
+        std::string errorMessage;
+        if (! Alembic::AbcCoreGit::collectGarbage(file, stats, errorMessage))
+        {
+            std::cerr << "ERROR: " << errorMessage << std::endl;
+            all_ok = false;
+            continue;
+        }
+
+        std::cout << file << ": " << stats.liveObjects << " of " << stats.objects <<
+            " objects reachable from " << stats.refs << " references";
+        if (stats.missingObjects)
+            std::cout << " (" << stats.missingObjects << " missing)";
+        std::cout << ", " << humanSize(stats.bytesBefore) << " -> " << humanSize(stats.bytesAfter) <<
+            ", reclaimed " << humanSize(stats.bytesReclaimed()) << std::endl;
+    }
+
+    exit(all_ok ? EXIT_SUCCESS : EXIT_FAILURE);
+}
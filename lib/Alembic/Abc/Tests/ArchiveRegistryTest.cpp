@@ -0,0 +1,267 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2026,
+//  Sony Pictures Imageworks, Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#include <Alembic/AbcCoreOgawa/All.h>
+#include <Alembic/AbcCoreFactory/All.h>
+#include <Alembic/Abc/All.h>
+#include <Alembic/AbcCoreAbstract/Tests/Assert.h>
+
+#include <ctime>
+#include <sstream>
+#include <sys/stat.h>
+
+#ifndef _WIN32
+#include <utime.h>
+#endif
+
+namespace Abc = Alembic::Abc;
+namespace AbcF = Alembic::AbcCoreFactory;
+using namespace Abc;
+
+typedef Alembic::Util::weak_ptr< AbcA::ArchiveReader > ArchiveReaderWeakPtr;
+
+//-*****************************************************************************
+// an archive with iNumChildren empty objects under the top
+void writeArchive( const std::string & iName, std::size_t iNumChildren )
+{
+    OArchive archive( Alembic::AbcCoreOgawa::WriteArchive(), iName );
+    for ( std::size_t i = 0; i < iNumChildren; ++i )
+    {
+        std::ostringstream name;
+        name << "child" << i;
+        OObject child( archive.getTop(), name.str() );
+    }
+}
+
+//-*****************************************************************************
+void sharingTest()
+{
+    writeArchive( "registryShare.abc", 2 );
+
+    AbcF::ArchiveRegistryPtr registry( new AbcF::ArchiveRegistry() );
+    AbcF::IFactory factory;
+    factory.setArchiveRegistry( registry );
+
+    IArchive a = factory.getArchive( "registryShare.abc" );
+    TESTING_ASSERT( a.valid() );
+    TESTING_ASSERT( a.getTop().getNumChildren() == 2 );
+
+    // the same file with the same settings, from any factory
+    IArchive b = factory.getArchive( "registryShare.abc" );
+    TESTING_ASSERT( a.getPtr() == b.getPtr() );
+
+    AbcF::IFactory otherFactory;
+    otherFactory.setArchiveRegistry( registry );
+    AbcF::IFactory::CoreType coreType;
+    IArchive c = otherFactory.getArchive( "registryShare.abc", coreType );
+    TESTING_ASSERT( a.getPtr() == c.getPtr() );
+    TESTING_ASSERT( coreType == AbcF::IFactory::kOgawa );
+    TESTING_ASSERT( registry->getNumArchives() == 1 );
+    TESTING_ASSERT( registry->getNumIdleArchives() == 0 );
+
+    // without a registry every open is a new reader
+    AbcF::IFactory unshared;
+    IArchive d = unshared.getArchive( "registryShare.abc" );
+    TESTING_ASSERT( d.valid() );
+    TESTING_ASSERT( a.getPtr() != d.getPtr() );
+    TESTING_ASSERT( registry->getNumArchives() == 1 );
+
+    // every setting which changes what gets opened gets its own reader
+    AbcF::IFactory mmapFactory;
+    mmapFactory.setArchiveRegistry( registry );
+    mmapFactory.setOgawaUseMMap( true );
+    IArchive mapped = mmapFactory.getArchive( "registryShare.abc" );
+    TESTING_ASSERT( mapped.valid() );
+    TESTING_ASSERT( mapped.getPtr() != a.getPtr() );
+    TESTING_ASSERT( mmapFactory.getArchive( "registryShare.abc" ).getPtr() ==
+                    mapped.getPtr() );
+
+    AbcF::IFactory streamsFactory;
+    streamsFactory.setArchiveRegistry( registry );
+    streamsFactory.setOgawaNumStreams( 4 );
+    IArchive streams = streamsFactory.getArchive( "registryShare.abc" );
+    TESTING_ASSERT( streams.valid() );
+    TESTING_ASSERT( streams.getPtr() != a.getPtr() );
+    TESTING_ASSERT( streams.getPtr() != mapped.getPtr() );
+
+    AbcF::IOptions options;
+    options.set( "ogawaPreloadHeaders", true );
+    IArchive preloaded = factory.getArchive( "registryShare.abc", coreType,
+                                             options );
+    TESTING_ASSERT( preloaded.valid() );
+    TESTING_ASSERT( preloaded.getPtr() != a.getPtr() );
+    TESTING_ASSERT( factory.getArchive( "registryShare.abc", coreType,
+                                        options ).getPtr() ==
+                    preloaded.getPtr() );
+
+    AbcF::IOptions otherOptions;
+    otherOptions.set( "ogawaPreloadHeaders", false );
+    IArchive notPreloaded = factory.getArchive( "registryShare.abc",
+                                                coreType, otherOptions );
+    TESTING_ASSERT( notPreloaded.getPtr() != preloaded.getPtr() );
+
+    TESTING_ASSERT( registry->getNumArchives() == 5 );
+}
+
+//-*****************************************************************************
+void rewriteTest()
+{
+    writeArchive( "registryRewrite.abc", 1 );
+
+    AbcF::ArchiveRegistryPtr registry( new AbcF::ArchiveRegistry() );
+    AbcF::IFactory factory;
+    factory.setArchiveRegistry( registry );
+
+    ArchiveReaderWeakPtr first;
+    {
+        IArchive a = factory.getArchive( "registryRewrite.abc" );
+        TESTING_ASSERT( a.getTop().getNumChildren() == 1 );
+        first = a.getPtr();
+    }
+    TESTING_ASSERT( registry->getNumIdleArchives() == 1 );
+
+    // a new size
+    writeArchive( "registryRewrite.abc", 3 );
+    IArchive a = factory.getArchive( "registryRewrite.abc" );
+    TESTING_ASSERT( a.getPtr() != first.lock() );
+    TESTING_ASSERT( a.getTop().getNumChildren() == 3 );
+
+#ifndef _WIN32
+    // the same size, only the modification time tells them apart
+    struct stat st;
+    TESTING_ASSERT( stat( "registryRewrite.abc", &st ) == 0 );
+    writeArchive( "registryRewrite.abc", 3 );
+
+    struct stat rewritten;
+    TESTING_ASSERT( stat( "registryRewrite.abc", &rewritten ) == 0 );
+    TESTING_ASSERT( rewritten.st_size == st.st_size );
+
+    struct utimbuf times;
+    times.actime = st.st_atime;
+    times.modtime = st.st_mtime + 10;
+    TESTING_ASSERT( utime( "registryRewrite.abc", &times ) == 0 );
+
+    IArchive b = factory.getArchive( "registryRewrite.abc" );
+    TESTING_ASSERT( b.getPtr() != a.getPtr() );
+    TESTING_ASSERT( b.getTop().getNumChildren() == 3 );
+#endif
+}
+
+//-*****************************************************************************
+void evictionByCountTest()
+{
+    const std::size_t numFiles = 4;
+    std::vector< std::string > names;
+    for ( std::size_t i = 0; i < numFiles; ++i )
+    {
+        std::ostringstream name;
+        name << "registryCount" << i << ".abc";
+        names.push_back( name.str() );
+        writeArchive( names.back(), i );
+    }
+
+    AbcF::ArchiveRegistryPtr registry( new AbcF::ArchiveRegistry( 1000.0, 2 ) );
+    AbcF::IFactory factory;
+    factory.setArchiveRegistry( registry );
+
+    // used one after the other, so the first one is the least recently used
+    std::vector< ArchiveReaderWeakPtr > readers;
+    for ( std::size_t i = 0; i < numFiles - 1; ++i )
+    {
+        readers.push_back( factory.getArchive( names[i] ).getPtr() );
+    }
+    registry->purge();
+    TESTING_ASSERT( registry->getNumArchives() == 2 );
+    TESTING_ASSERT( readers[0].expired() );
+    TESTING_ASSERT( !readers[1].expired() );
+    TESTING_ASSERT( !readers[2].expired() );
+
+    // using 1 again makes 2 the least recently used one
+    TESTING_ASSERT( factory.getArchive( names[1] ).getPtr() ==
+                    readers[1].lock() );
+    readers.push_back( factory.getArchive( names[3] ).getPtr() );
+    registry->purge();
+    TESTING_ASSERT( readers[2].expired() );
+    TESTING_ASSERT( !readers[1].expired() );
+    TESTING_ASSERT( !readers[3].expired() );
+
+    // archives which are in use are never dropped
+    IArchive held = factory.getArchive( names[0] );
+    registry->setMaxIdleArchives( 0 );
+    TESTING_ASSERT( registry->getNumArchives() == 1 );
+    TESTING_ASSERT( registry->getNumIdleArchives() == 0 );
+    TESTING_ASSERT( factory.getArchive( names[0] ).getPtr() ==
+                    held.getPtr() );
+
+    held.reset();
+    registry->purge();
+    TESTING_ASSERT( registry->getNumArchives() == 0 );
+}
+
+//-*****************************************************************************
+void evictionByAgeTest()
+{
+    writeArchive( "registryAge.abc", 1 );
+
+    AbcF::ArchiveRegistryPtr registry( new AbcF::ArchiveRegistry( 1.0, 16 ) );
+    AbcF::IFactory factory;
+    factory.setArchiveRegistry( registry );
+
+    ArchiveReaderWeakPtr reader =
+        factory.getArchive( "registryAge.abc" ).getPtr();
+    registry->purge();
+    TESTING_ASSERT( registry->getNumIdleArchives() == 1 );
+    TESTING_ASSERT( !reader.expired() );
+
+    // idle for more than a second
+    std::time_t start = std::time( NULL );
+    while ( std::difftime( std::time( NULL ), start ) < 2.0 )
+    {
+    }
+
+    registry->purge();
+    TESTING_ASSERT( registry->getNumArchives() == 0 );
+    TESTING_ASSERT( reader.expired() );
+}
+
+int main( int argc, char *argv[] )
+{
+    sharingTest();
+    rewriteTest();
+    evictionByCountTest();
+    evictionByAgeTest();
+    return 0;
+}
@@ -0,0 +1,232 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2013,
+//  Sony Pictures Imageworks, Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#include <Alembic/AbcCoreAbstract/LRUReadArraySampleCache.h>
+
+namespace Alembic {
+namespace AbcCoreAbstract {
+namespace ALEMBIC_VERSION_NS {
+
+//-*****************************************************************************
+class LRUReadArraySampleCache::Shard
+{
+public:
+    typedef std::list< ArraySample::Key > KeyList;
+
+    struct Entry
+    {
+        ArraySamplePtr sample;
+        std::size_t numBytes;
+
+        // position in m_recent
+        KeyList::iterator recent;
+    };
+
+    typedef UnorderedMapUtil< Entry >::umap_type EntryMap;
+
+    Shard( std::size_t iMaxBytes ) : m_maxBytes( iMaxBytes ), m_numBytes( 0 )
+    {}
+
+    ReadArraySampleID find( const ArraySample::Key &iKey )
+    {
+        Alembic::Util::scoped_lock l( m_lock );
+
+        EntryMap::iterator found = m_entries.find( iKey );
+        if ( found == m_entries.end() )
+        {
+            ++m_stats.misses;
+            return ReadArraySampleID();
+        }
+
+        ++m_stats.hits;
+        m_recent.splice( m_recent.begin(), m_recent, found->second.recent );
+        return ReadArraySampleID( found->first, found->second.sample );
+    }
+
+    ReadArraySampleID store( const ArraySample::Key &iKey,
+                             ArraySamplePtr iSamp )
+    {
+        Alembic::Util::scoped_lock l( m_lock );
+
+        EntryMap::iterator found = m_entries.find( iKey );
+        if ( found != m_entries.end() )
+        {
+            m_recent.splice( m_recent.begin(), m_recent,
+                             found->second.recent );
+            return ReadArraySampleID( found->first, found->second.sample );
+        }
+
+        Entry entry;
+        entry.sample = iSamp;
+        entry.numBytes = iKey.numBytes;
+        m_recent.push_front( iKey );
+        entry.recent = m_recent.begin();
+        m_entries.insert( EntryMap::value_type( iKey, entry ) );
+
+        m_numBytes += entry.numBytes;
+        ++m_stats.stores;
+
+        // iSamp is still held by the caller so it is safe from this
+        evict( m_maxBytes );
+
+        return ReadArraySampleID( iKey, iSamp );
+    }
+
+    void clear()
+    {
+        Alembic::Util::scoped_lock l( m_lock );
+        evict( 0 );
+    }
+
+    void addStats( Stats & ioStats )
+    {
+        Alembic::Util::scoped_lock l( m_lock );
+        ioStats.hits += m_stats.hits;
+        ioStats.misses += m_stats.misses;
+        ioStats.stores += m_stats.stores;
+        ioStats.evictions += m_stats.evictions;
+        ioStats.numSamples += m_entries.size();
+        ioStats.numBytes += m_numBytes;
+    }
+
+private:
+
+    // walk from the least recently used entry, dropping the ones nobody
+    // else references until we are within iMaxBytes, assumes m_lock is held
+    void evict( std::size_t iMaxBytes )
+    {
+        KeyList::iterator it = m_recent.end();
+        while ( m_numBytes > iMaxBytes && it != m_recent.begin() )
+        {
+            --it;
+            EntryMap::iterator found = m_entries.find( *it );
+            if ( found->second.sample.use_count() > 1 )
+            {
+                continue;
+            }
+
+            m_numBytes -= found->second.numBytes;
+            ++m_stats.evictions;
+            m_entries.erase( found );
+            it = m_recent.erase( it );
+        }
+    }
+
+    Alembic::Util::mutex m_lock;
+    EntryMap m_entries;
+
+    // most recently used at the front
+    KeyList m_recent;
+
+    std::size_t m_maxBytes;
+    std::size_t m_numBytes;
+    Stats m_stats;
+};
+
+//-*****************************************************************************
+LRUReadArraySampleCache::LRUReadArraySampleCache( std::size_t iMaxBytes,
+                                                  std::size_t iNumShards )
+  : m_maxBytes( iMaxBytes )
+{
+    if ( iNumShards == 0 )
+    {
+        iNumShards = 1;
+    }
+
+    m_shards.resize( iNumShards );
+    for ( std::size_t i = 0; i < iNumShards; ++i )
+    {
+        m_shards[i].reset( new Shard( iMaxBytes / iNumShards ) );
+    }
+}
+
+//-*****************************************************************************
+LRUReadArraySampleCache::~LRUReadArraySampleCache()
+{
+    // Nothing!
+}
+
+//-*****************************************************************************
+LRUReadArraySampleCache::Shard &
+LRUReadArraySampleCache::getShard( const ArraySample::Key &iKey ) const
+{
+    // the digest is already well mixed
+    return *m_shards[ iKey.digest.words[0] % m_shards.size() ];
+}
+
+//-*****************************************************************************
+ReadArraySampleID
+LRUReadArraySampleCache::find( const ArraySample::Key &iKey )
+{
+    return getShard( iKey ).find( iKey );
+}
+
+//-*****************************************************************************
+ReadArraySampleID
+LRUReadArraySampleCache::store( const ArraySample::Key &iKey,
+                                ArraySamplePtr iSamp )
+{
+    if ( !iSamp )
+    {
+        return ReadArraySampleID();
+    }
+
+    return getShard( iKey ).store( iKey, iSamp );
+}
+
+//-*****************************************************************************
+void LRUReadArraySampleCache::clear()
+{
+    for ( std::size_t i = 0; i < m_shards.size(); ++i )
+    {
+        m_shards[i]->clear();
+    }
+}
+
+//-*****************************************************************************
+LRUReadArraySampleCache::Stats LRUReadArraySampleCache::getStats() const
+{
+    Stats stats;
+    for ( std::size_t i = 0; i < m_shards.size(); ++i )
+    {
+        m_shards[i]->addStats( stats );
+    }
+    return stats;
+}
+
+} // End namespace ALEMBIC_VERSION_NS
+} // End namespace AbcCoreAbstract
+} // End namespace Alembic
@@ -0,0 +1,120 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2013,
+//  Sony Pictures Imageworks, Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#ifndef _Alembic_AbcCoreAbstract_LRUReadArraySampleCache_h_
+#define _Alembic_AbcCoreAbstract_LRUReadArraySampleCache_h_
+
+#include <Alembic/Util/Export.h>
+#include <Alembic/AbcCoreAbstract/Foundation.h>
+#include <Alembic/AbcCoreAbstract/ReadArraySampleCache.h>
+
+namespace Alembic {
+namespace AbcCoreAbstract {
+namespace ALEMBIC_VERSION_NS {
+
+//-*****************************************************************************
+//! A thread safe ReadArraySampleCache which keeps the samples it holds
+//! within a budget of bytes, evicting the least recently used ones first.
+//! A sample which is still referenced outside of the cache is never
+//! evicted (dropping it would not free anything and the same data would
+//! just be read again), so while everything is in use the cache can go
+//! over its budget.
+//! The entries are split over independently locked shards so that
+//! concurrent readers rarely wait on each other.
+//! Since the keys only depend on the content of the samples, one cache can
+//! be shared by any number of archives, see
+//! ArchiveReader::setReadArraySampleCachePtr.
+class ALEMBIC_EXPORT LRUReadArraySampleCache : public ReadArraySampleCache
+{
+public:
+    //! Counters accumulated since the cache was created, and the current
+    //! number of samples and bytes held.
+    struct Stats
+    {
+        Stats()
+          : hits( 0 ), misses( 0 ), stores( 0 ), evictions( 0 )
+          , numSamples( 0 ), numBytes( 0 ) {}
+
+        Util::uint64_t hits;
+        Util::uint64_t misses;
+        Util::uint64_t stores;
+        Util::uint64_t evictions;
+        Util::uint64_t numSamples;
+        Util::uint64_t numBytes;
+    };
+
+    //! iMaxBytes is split evenly over iNumShards shards
+    //! ...
+    LRUReadArraySampleCache( std::size_t iMaxBytes,
+                             std::size_t iNumShards = 16 );
+
+    virtual ~LRUReadArraySampleCache();
+
+    virtual ReadArraySampleID find( const ArraySample::Key &iKey );
+
+    //! If a sample is already stored under iKey, that one is returned
+    //! and iSamp is not kept.
+    virtual ReadArraySampleID store( const ArraySample::Key &iKey,
+                                     ArraySamplePtr iSamp );
+
+    std::size_t getMaxBytes() const { return m_maxBytes; }
+
+    //! Drops every sample which isn't referenced outside of the cache.
+    //! ...
+    void clear();
+
+    Stats getStats() const;
+
+private:
+    class Shard;
+    Shard & getShard( const ArraySample::Key &iKey ) const;
+
+    std::size_t m_maxBytes;
+    std::vector< Alembic::Util::shared_ptr< Shard > > m_shards;
+};
+
+//-*****************************************************************************
+typedef Alembic::Util::shared_ptr<LRUReadArraySampleCache>
+LRUReadArraySampleCachePtr;
+
+} // End namespace ALEMBIC_VERSION_NS
+
+using namespace ALEMBIC_VERSION_NS;
+
+} // End namespace AbcCoreAbstract
+} // End namespace Alembic
+
+#endif
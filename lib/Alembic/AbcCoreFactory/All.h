@@ -39,5 +39,6 @@
 
 #include <Alembic/Util/Export.h>
 #include <Alembic/AbcCoreFactory/IFactory.h>
+#include <Alembic/AbcCoreFactory/ArchiveRegistry.h>
 
 #endif
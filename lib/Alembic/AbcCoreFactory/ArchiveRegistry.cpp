@@ -0,0 +1,246 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2013-2016,
+//  Sony Pictures Imageworks, Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#include <Alembic/AbcCoreFactory/ArchiveRegistry.h>
+
+#include <algorithm>
+#include <sstream>
+#include <vector>
+#include <sys/stat.h>
+
+namespace Alembic {
+namespace AbcCoreFactory {
+namespace ALEMBIC_VERSION_NS {
+
+namespace {
+
+// appends the size and modification time of iPath, returns false if it
+// doesn't exist
+bool AppendFileStamp( const std::string & iPath, std::ostream & oStream )
+{
+    struct stat st;
+    if ( stat( iPath.c_str(), &st ) != 0 )
+    {
+        return false;
+    }
+
+    oStream << '\0' << st.st_size << '\0' << st.st_mtime;
+
+    // a rewrite within the same second only shows in the sub second part
+#if defined(__APPLE__)
+    oStream << '.' << st.st_mtimespec.tv_nsec;
+#elif defined(__linux__)
+    oStream << '.' << st.st_mtim.tv_nsec;
+#endif
+
+    // and a file renamed over the old one is another inode
+    oStream << '\0' << st.st_dev << '\0' << st.st_ino;
+    return true;
+}
+
+typedef std::pair< Alembic::Util::uint64_t, std::string > IdleKey;
+
+} // End anonymous namespace
+
+ArchiveRegistry::ArchiveRegistry( double iMaxIdleSeconds,
+                                  std::size_t iMaxIdleArchives )
+    : m_maxIdleSeconds( iMaxIdleSeconds )
+    , m_maxIdleArchives( iMaxIdleArchives )
+    , m_lastUse( 0 )
+{
+}
+
+ArchiveRegistry::~ArchiveRegistry()
+{
+}
+
+ArchiveRegistryPtr ArchiveRegistry::getProcessRegistry()
+{
+    static ArchiveRegistryPtr registry( new ArchiveRegistry() );
+    return registry;
+}
+
+bool ArchiveRegistry::makeKey( const std::string & iFileName,
+                               const std::string & iSettings,
+                               std::string & oKey )
+{
+    std::ostringstream key;
+    key << iFileName;
+    if ( !AppendFileStamp( iFileName, key ) )
+    {
+        return false;
+    }
+
+    // a git repository is updated in place, its reflog is appended to
+    // whenever HEAD moves
+    AppendFileStamp( iFileName + "/.git/logs/HEAD", key );
+
+    key << '\0' << iSettings;
+    oKey = key.str();
+    return true;
+}
+
+Alembic::AbcCoreAbstract::ArchiveReaderPtr
+ArchiveRegistry::find( const std::string & iKey, IFactory::CoreType & oType )
+{
+    Alembic::Util::scoped_lock l( m_mutex );
+    purgeLocked();
+
+    EntryMap::iterator it = m_entries.find( iKey );
+    if ( it == m_entries.end() )
+    {
+        return Alembic::AbcCoreAbstract::ArchiveReaderPtr();
+    }
+
+    it->second.lastUsed = std::time( NULL );
+    it->second.lastUse = ++m_lastUse;
+    oType = it->second.type;
+    return it->second.archive;
+}
+
+Alembic::AbcCoreAbstract::ArchiveReaderPtr
+ArchiveRegistry::store( const std::string & iKey,
+                        Alembic::AbcCoreAbstract::ArchiveReaderPtr iArchive,
+                        IFactory::CoreType iType )
+{
+    Alembic::Util::scoped_lock l( m_mutex );
+
+    Entry & entry = m_entries[iKey];
+    if ( !entry.archive )
+    {
+        entry.archive = iArchive;
+        entry.type = iType;
+    }
+    entry.lastUsed = std::time( NULL );
+    entry.lastUse = ++m_lastUse;
+
+    Alembic::AbcCoreAbstract::ArchiveReaderPtr archive = entry.archive;
+    purgeLocked();
+    return archive;
+}
+
+void ArchiveRegistry::setMaxIdleSeconds( double iMaxIdleSeconds )
+{
+    Alembic::Util::scoped_lock l( m_mutex );
+    m_maxIdleSeconds = iMaxIdleSeconds;
+    purgeLocked();
+}
+
+void ArchiveRegistry::setMaxIdleArchives( std::size_t iMaxIdleArchives )
+{
+    Alembic::Util::scoped_lock l( m_mutex );
+    m_maxIdleArchives = iMaxIdleArchives;
+    purgeLocked();
+}
+
+void ArchiveRegistry::purge()
+{
+    Alembic::Util::scoped_lock l( m_mutex );
+    purgeLocked();
+}
+
+void ArchiveRegistry::clear()
+{
+    Alembic::Util::scoped_lock l( m_mutex );
+    m_entries.clear();
+}
+
+std::size_t ArchiveRegistry::getNumArchives()
+{
+    Alembic::Util::scoped_lock l( m_mutex );
+    return m_entries.size();
+}
+
+std::size_t ArchiveRegistry::getNumIdleArchives()
+{
+    Alembic::Util::scoped_lock l( m_mutex );
+
+    std::size_t numIdle = 0;
+    EntryMap::iterator it = m_entries.begin();
+    for ( ; it != m_entries.end(); ++it )
+    {
+        if ( it->second.archive.use_count() == 1 )
+        {
+            ++numIdle;
+        }
+    }
+    return numIdle;
+}
+
+void ArchiveRegistry::purgeLocked()
+{
+    std::time_t now = std::time( NULL );
+    std::vector< IdleKey > idle;
+
+    EntryMap::iterator it = m_entries.begin();
+    while ( it != m_entries.end() )
+    {
+        // still referenced outside of the registry, so it counts as used
+        if ( it->second.archive.use_count() > 1 )
+        {
+            it->second.lastUsed = now;
+            it->second.lastUse = ++m_lastUse;
+            ++it;
+        }
+        else if ( std::difftime( now, it->second.lastUsed ) >
+                  m_maxIdleSeconds )
+        {
+            m_entries.erase( it++ );
+        }
+        else
+        {
+            idle.push_back( IdleKey( it->second.lastUse, it->first ) );
+            ++it;
+        }
+    }
+
+    if ( idle.size() <= m_maxIdleArchives )
+    {
+        return;
+    }
+
+    // too many idle archives, drop the least recently used ones
+    std::size_t numDrop = idle.size() - m_maxIdleArchives;
+    std::partial_sort( idle.begin(), idle.begin() + numDrop, idle.end() );
+    for ( std::size_t i = 0; i < numDrop; ++i )
+    {
+        m_entries.erase( idle[i].second );
+    }
+}
+
+} // End namespace ALEMBIC_VERSION_NS
+} // End namespace AbcCoreFactory
+} // End namespace Alembic
@@ -0,0 +1,138 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2013-2016,
+//  Sony Pictures Imageworks, Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#ifndef _Alembic_AbcCoreFactory_ArchiveRegistry_h_
+#define _Alembic_AbcCoreFactory_ArchiveRegistry_h_
+
+#include <Alembic/AbcCoreFactory/IFactory.h>
+#include <Alembic/Util/Export.h>
+
+#include <ctime>
+#include <map>
+
+namespace Alembic {
+namespace AbcCoreFactory {
+namespace ALEMBIC_VERSION_NS {
+
+//! Keeps opened archive readers around so that opening the same file with
+//! the same settings again hands back the reader which is already open,
+//! instead of reading the file from scratch.
+//! An archive is idle once nothing but the registry references it, idle
+//! archives are dropped after they haven't been used for a while, or when
+//! there are too many of them (least recently used first).  Archives which
+//! are still in use are never dropped.
+//! All of the methods are thread safe.
+//! See IFactory::setArchiveRegistry
+class ALEMBIC_EXPORT ArchiveRegistry
+{
+public:
+    //! Idle archives are kept for at most iMaxIdleSeconds, and at most
+    //! iMaxIdleArchives of them are kept
+    ArchiveRegistry( double iMaxIdleSeconds = 60.0,
+                     std::size_t iMaxIdleArchives = 16 );
+    ~ArchiveRegistry();
+
+    //! The registry shared by the whole process
+    static ArchiveRegistryPtr getProcessRegistry();
+
+    //! Builds the key under which iFileName opened with iSettings is kept,
+    //! out of its path, size and modification time, so that a file which
+    //! was rewritten gets a new key.  Returns false if the file can't be
+    //! found.
+    static bool makeKey( const std::string & iFileName,
+                         const std::string & iSettings,
+                         std::string & oKey );
+
+    //! Returns the archive kept under iKey and its type, or an empty
+    //! pointer
+    Alembic::AbcCoreAbstract::ArchiveReaderPtr
+    find( const std::string & iKey, IFactory::CoreType & oType );
+
+    //! Keeps iArchive under iKey and returns it, if another archive was
+    //! stored under iKey in the meantime that one is returned instead
+    Alembic::AbcCoreAbstract::ArchiveReaderPtr
+    store( const std::string & iKey,
+           Alembic::AbcCoreAbstract::ArchiveReaderPtr iArchive,
+           IFactory::CoreType iType );
+
+    double getMaxIdleSeconds() const { return m_maxIdleSeconds; }
+    void setMaxIdleSeconds( double iMaxIdleSeconds );
+
+    std::size_t getMaxIdleArchives() const { return m_maxIdleArchives; }
+    void setMaxIdleArchives( std::size_t iMaxIdleArchives );
+
+    //! Drops the idle archives which are past the eviction policy, this
+    //! also happens on every find and store
+    void purge();
+
+    //! Drops every archive, the ones still in use stay open for their users
+    void clear();
+
+    //! The number of archives kept, and how many of them are idle
+    std::size_t getNumArchives();
+    std::size_t getNumIdleArchives();
+
+private:
+    void purgeLocked();
+
+    struct Entry
+    {
+        Alembic::AbcCoreAbstract::ArchiveReaderPtr archive;
+        IFactory::CoreType type;
+        std::time_t lastUsed;
+
+        // orders the idle archives by when they were last used, lastUsed
+        // alone can't tell apart the ones used within the same second
+        Alembic::Util::uint64_t lastUse;
+    };
+
+    typedef std::map< std::string, Entry > EntryMap;
+
+    Alembic::Util::mutex m_mutex;
+    EntryMap m_entries;
+    double m_maxIdleSeconds;
+    std::size_t m_maxIdleArchives;
+    Alembic::Util::uint64_t m_lastUse;
+};
+
+} // End namespace ALEMBIC_VERSION_NS
+
+using namespace ALEMBIC_VERSION_NS;
+
+} // End namespace AbcCoreFactory
+} // End namespace Alembic
+
+#endif
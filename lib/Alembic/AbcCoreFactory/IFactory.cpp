@@ -35,23 +35,95 @@
 //-*****************************************************************************
 
 #include <fstream>
+#include <sstream>
 #include <Alembic/AbcCoreOgawa/All.h>
 #include <Alembic/AbcCoreGit/All.h>
 #include <Alembic/AbcCoreLayer/Read.h>
 #include <Alembic/AbcCoreFactory/IFactory.h>
+#include <Alembic/AbcCoreFactory/ArchiveRegistry.h>
 
 #ifdef ALEMBIC_WITH_HDF5
 #include <Alembic/AbcCoreHDF5/All.h>
 #endif
 
+#if !defined(ALEMBIC_LIB_USES_TR1) && __cplusplus >= 201103L
+#include <atomic>
+#include <exception>
+#include <thread>
+#endif
+
 namespace Alembic {
 namespace AbcCoreFactory {
 namespace ALEMBIC_VERSION_NS {
 
+namespace {
+
+// writes out the option values that can take part in a registry key,
+// returns false for any other type
+bool AppendOption( const boost::any & iValue, std::ostream & oStream )
+{
+    if ( const bool * b = boost::any_cast< bool >( &iValue ) )
+    {
+        oStream << *b;
+    }
+    else if ( const std::string * s = boost::any_cast< std::string >( &iValue ) )
+    {
+        oStream << *s;
+    }
+    else if ( const char * const * c = boost::any_cast< const char * >( &iValue ) )
+    {
+        oStream << *c;
+    }
+    else if ( const int * i = boost::any_cast< int >( &iValue ) )
+    {
+        oStream << *i;
+    }
+    else if ( const size_t * n = boost::any_cast< size_t >( &iValue ) )
+    {
+        oStream << *n;
+    }
+    else if ( const double * d = boost::any_cast< double >( &iValue ) )
+    {
+        oStream << *d;
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
+
+#if !defined(ALEMBIC_LIB_USES_TR1) && __cplusplus >= 201103L
+// opens the files handed out by ioNext until there are none left, the
+// errors are kept to be rethrown on the calling thread
+void OpenArchives( IFactory & iFactory,
+                   const std::vector< std::string > & iFileNames,
+                   std::vector< Alembic::Abc::IArchive > & oArchives,
+                   std::vector< std::exception_ptr > & oErrors,
+                   std::atomic< std::size_t > & ioNext )
+{
+    for ( std::size_t i = ioNext++; i < iFileNames.size(); i = ioNext++ )
+    {
+        try
+        {
+            oArchives[i] = iFactory.getArchive( iFileNames[i] );
+        }
+        catch ( ... )
+        {
+            oErrors[i] = std::current_exception();
+        }
+    }
+}
+#endif
+
+} // End anonymous namespace
+
 IFactory::IFactory()
 {
     m_cacheHierarchy = true;
     m_numStreams = 1;
+    m_useMMap = false;
+    m_flattenHierarchy = false;
     m_policy = Alembic::Abc::ErrorHandler::kThrowPolicy;
 }
 
@@ -59,12 +131,86 @@ IFactory::~IFactory()
 {
 }
 
+std::string IFactory::makeRegistryKey( const std::string & iFileName,
+                                       const IOptions * iOptions ) const
+{
+    if ( !m_registry )
+    {
+        return std::string();
+    }
+
+    // everything that changes what gets opened has to be part of the key
+    std::ostringstream settings;
+    settings << m_numStreams << ' ' << m_useMMap << ' ' << m_cacheHierarchy
+             << ' ' << m_cachePtr.get();
+
+    if ( iOptions )
+    {
+        IOptions options( *iOptions );
+        std::vector< std::string > keys;
+        options.getKeys( keys );
+        for ( size_t i = 0; i < keys.size(); ++i )
+        {
+            settings << ' ' << keys[i] << '=';
+            if ( !AppendOption( options.get( keys[i] ), settings ) )
+            {
+                return std::string();
+            }
+        }
+    }
+
+    std::string key;
+    ArchiveRegistry::makeKey( iFileName, settings.str(), key );
+    return key;
+}
+
+bool IFactory::findShared( const std::string & iKey, CoreType & oType,
+                           Alembic::Abc::IArchive & oArchive )
+{
+    if ( iKey.empty() || !m_registry )
+    {
+        return false;
+    }
+
+    Alembic::AbcCoreAbstract::ArchiveReaderPtr ptr =
+        m_registry->find( iKey, oType );
+    if ( !ptr )
+    {
+        return false;
+    }
+
+    oArchive = Alembic::Abc::IArchive( ptr, Alembic::Abc::kWrapExisting,
+                                       m_policy );
+    return true;
+}
+
+Alembic::Abc::IArchive IFactory::share( const std::string & iKey,
+                                        Alembic::Abc::IArchive iArchive,
+                                        CoreType iType )
+{
+    if ( iKey.empty() || !m_registry )
+    {
+        return iArchive;
+    }
+
+    Alembic::AbcCoreAbstract::ArchiveReaderPtr ptr =
+        m_registry->store( iKey, iArchive.getPtr(), iType );
+    return Alembic::Abc::IArchive( ptr, Alembic::Abc::kWrapExisting,
+                                   m_policy );
+}
+
 Alembic::Abc::IArchive IFactory::getArchive( const std::string & iFileName,
                                             CoreType & oType )
 {
+    std::string registryKey = makeRegistryKey( iFileName, NULL );
+    Alembic::Abc::IArchive shared;
+    if ( findShared( registryKey, oType, shared ) )
+    {
+        return shared;
+    }
 
     // try Ogawa first, use kQuietNoop at first in case we fail
-    Alembic::AbcCoreOgawa::ReadArchive ogawa( m_numStreams );
+    Alembic::AbcCoreOgawa::ReadArchive ogawa( m_numStreams, m_useMMap );
     Alembic::Abc::IArchive archive( ogawa, iFileName,
         Alembic::Abc::ErrorHandler::kQuietNoopPolicy, m_cachePtr );
 
@@ -72,7 +218,7 @@ Alembic::Abc::IArchive IFactory::getArchive( const std::string & iFileName,
     {
         oType = kOgawa;
         archive.getErrorHandler().setPolicy( m_policy );
-        return archive;
+        return share( registryKey, archive, oType );
     }
 
 #ifdef ALEMBIC_WITH_HDF5
@@ -83,7 +229,7 @@ Alembic::Abc::IArchive IFactory::getArchive( const std::string & iFileName,
     {
         oType = kHDF5;
         archive.getErrorHandler().setPolicy( m_policy );
-        return archive;
+        return share( registryKey, archive, oType );
     }
 #else
     // check the first 8 bytes to see if this is an HDF5 file according to
@@ -115,7 +261,7 @@ Alembic::Abc::IArchive IFactory::getArchive( const std::string & iFileName,
     {
         oType = kGit;
         archive.getErrorHandler().setPolicy( m_policy );
-        return archive;
+        return share( registryKey, archive, oType );
     }
 
     oType = kUnknown;
@@ -126,9 +272,24 @@ Alembic::Abc::IArchive IFactory::getArchive( const std::string & iFileName,
                                              CoreType & oType,
                                              const IOptions& iOptions )
 {
+    std::string registryKey = makeRegistryKey( iFileName, &iOptions );
+    Alembic::Abc::IArchive shared;
+    if ( findShared( registryKey, oType, shared ) )
+    {
+        return shared;
+    }
+
+    bool preloadHeaders = false;
+    if ( iOptions.has( "ogawaPreloadHeaders" ) )
+    {
+        IOptions options( iOptions );
+        preloadHeaders = boost::any_cast< bool >(
+            options.get( "ogawaPreloadHeaders" ) );
+    }
 
     // try Ogawa first, use kQuietNoop at first in case we fail
-    Alembic::AbcCoreOgawa::ReadArchive ogawa( m_numStreams );
+    Alembic::AbcCoreOgawa::ReadArchive ogawa( m_numStreams, m_useMMap,
+                                              preloadHeaders );
     Alembic::Abc::IArchive archive( ogawa, iFileName,
         Alembic::Abc::ErrorHandler::kQuietNoopPolicy, m_cachePtr );
 
@@ -136,7 +297,7 @@ Alembic::Abc::IArchive IFactory::getArchive( const std::string & iFileName,
     {
         oType = kOgawa;
         archive.getErrorHandler().setPolicy( m_policy );
-        return archive;
+        return share( registryKey, archive, oType );
     }
 
 #ifdef ALEMBIC_WITH_HDF5
@@ -147,7 +308,7 @@ Alembic::Abc::IArchive IFactory::getArchive( const std::string & iFileName,
     {
         oType = kHDF5;
         archive.getErrorHandler().setPolicy( m_policy );
-        return archive;
+        return share( registryKey, archive, oType );
     }
 #endif
 
@@ -159,7 +320,7 @@ Alembic::Abc::IArchive IFactory::getArchive( const std::string & iFileName,
     {
         oType = kGit;
         archive.getErrorHandler().setPolicy( m_policy );
-        return archive;
+        return share( registryKey, archive, oType );
     }
 #endif
 
@@ -183,18 +344,72 @@ Alembic::Abc::IArchive IFactory::getArchive(
 Alembic::Abc::IArchive IFactory::getArchive(
     const std::vector< std::string > & iFileNames, CoreType & oType )
 {
-    Alembic::AbcCoreLayer::ReadArchive layer;
+    // a layered archive is shared under the keys of all of its files
+    std::string registryKey;
+    if ( m_registry )
+    {
+        std::ostringstream key;
+        key << "layer " << m_flattenHierarchy;
+        std::vector< std::string >::const_iterator it = iFileNames.begin();
+        for ( ; it != iFileNames.end(); ++it )
+        {
+            key << '\0' << makeRegistryKey( *it, NULL );
+        }
+        registryKey = key.str();
+    }
+
+    Alembic::Abc::IArchive shared;
+    if ( findShared( registryKey, oType, shared ) )
+    {
+        return shared;
+    }
+
+    Alembic::AbcCoreLayer::ReadArchive layer( m_flattenHierarchy );
 
     Alembic::AbcCoreLayer::ArchiveReaderPtrs archives;
 
-    // first read our archives, skipping over bad ones
-    std::vector< std::string >::const_iterator it = iFileNames.begin();
-    for ( ; it != iFileNames.end(); ++it )
+    // first read our archives, each on its own thread so that this takes
+    // about as long as the slowest one, the layers keep the order of
+    // iFileNames
+    std::vector< Alembic::Abc::IArchive > opened( iFileNames.size() );
+#if !defined(ALEMBIC_LIB_USES_TR1) && __cplusplus >= 201103L
+    std::vector< std::exception_ptr > errors( iFileNames.size() );
+    std::atomic< std::size_t > next( 0 );
+    std::vector< std::thread > threads;
+    for ( std::size_t i = 1; i < iFileNames.size(); ++i )
+    {
+        threads.push_back( std::thread( OpenArchives, std::ref( *this ),
+                                        std::cref( iFileNames ),
+                                        std::ref( opened ),
+                                        std::ref( errors ),
+                                        std::ref( next ) ) );
+    }
+    OpenArchives( *this, iFileNames, opened, errors, next );
+    for ( std::size_t i = 0; i < threads.size(); ++i )
     {
-        Alembic::Abc::IArchive archive = getArchive( *it );
-        if ( archive.getPtr() )
+        threads[i].join();
+    }
+
+    for ( std::size_t i = 0; i < errors.size(); ++i )
+    {
+        if ( errors[i] )
         {
-            archives.push_back( archive.getPtr() );
+            std::rethrow_exception( errors[i] );
+        }
+    }
+#else
+    for ( std::size_t i = 0; i < iFileNames.size(); ++i )
+    {
+        opened[i] = getArchive( iFileNames[i] );
+    }
+#endif
+
+    // skipping over bad ones
+    for ( std::size_t i = 0; i < opened.size(); ++i )
+    {
+        if ( opened[i].getPtr() )
+        {
+            archives.push_back( opened[i].getPtr() );
         }
     }
 
@@ -203,8 +418,10 @@ Alembic::Abc::IArchive IFactory::getArchive(
     {
         Alembic::AbcCoreAbstract::ArchiveReaderPtr arPtr = layer( archives );
         oType = kLayer;
-        return Alembic::Abc::IArchive( arPtr, Alembic::Abc::kWrapExisting,
-                                       m_policy );
+        return share( registryKey,
+                      Alembic::Abc::IArchive( arPtr,
+                                              Alembic::Abc::kWrapExisting,
+                                              m_policy ), oType );
     }
 
     // no valid archives pushed, so invalid
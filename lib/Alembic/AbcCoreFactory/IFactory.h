@@ -42,6 +42,7 @@
 #include <Alembic/Util/Export.h>
 
 #include <map>
+#include <vector>
 #include <boost/any.hpp>
 #include <boost/optional.hpp>
 
@@ -79,10 +80,19 @@ public:
 
     OptProxy operator[] (const std::string& key) { return OptProxy(key, m_generic); }
 
+    void getKeys(std::vector< std::string >& oKeys) const
+    {
+        std::map< std::string, boost::any >::const_iterator it = m_generic.begin();
+        for ( ; it != m_generic.end(); ++it ) { oKeys.push_back(it->first); }
+    }
+
 private:
     std::map< std::string, boost::any > m_generic;
 };
 
+class ArchiveRegistry;
+typedef Alembic::Util::shared_ptr< ArchiveRegistry > ArchiveRegistryPtr;
+
 class ALEMBIC_EXPORT IFactory
 {
 public:
@@ -101,6 +111,9 @@ public:
 
     //! Try to open a file and set oType to the one that yields a successful
     //! oType, or kUnknown if the IArchive isn't valid
+    //! With the "ogawaPreloadHeaders" option set to true, an Ogawa file has
+    //! all of its object and property headers read by several threads when
+    //! it is opened, instead of as it is walked
     Alembic::Abc::IArchive getArchive( const std::string & iFileName,
                                        CoreType & oType );
     Alembic::Abc::IArchive getArchive( const std::string & iFileName,
@@ -165,6 +178,45 @@ public:
         m_numStreams = iNumStreams;
     }
 
+    //! Gets whether Ogawa files will be memory mapped
+    bool getOgawaUseMMap() const { return m_useMMap; }
+
+    //! Sets whether Ogawa files will be memory mapped instead of opened
+    //! getOgawaNumStreams() times, so that any number of threads can read
+    //! from them without locking, the default is false
+    //! Only map files that nothing rewrites while they are open (a new
+    //! WriteArchive on the same path included), reading a truncated
+    //! mapping raises SIGBUS instead of throwing
+    void setOgawaUseMMap( bool iUseMMap )
+    {
+        m_useMMap = iUseMMap;
+    }
+
+    //! Gets whether layered archives flatten their hierarchy when opened
+    bool getLayerFlattenHierarchy() const { return m_flattenHierarchy; }
+
+    //! Sets whether layered archives merge their whole hierarchy once when
+    //! they are opened, instead of every time an object is read, the default
+    //! is false
+    void setLayerFlattenHierarchy( bool iFlattenHierarchy )
+    {
+        m_flattenHierarchy = iFlattenHierarchy;
+    }
+
+    //! Gets the registry that opened archives are shared through
+    ArchiveRegistryPtr getArchiveRegistry() const { return m_registry; }
+
+    //! Sets the registry that archives opened by file name are shared
+    //! through, opening a file again with the same settings then hands back
+    //! the archive which is already open.  Use
+    //! ArchiveRegistry::getProcessRegistry() to share the archives with every
+    //! IFactory in the process.  The default is no registry, every
+    //! getArchive call opens the file from scratch.
+    void setArchiveRegistry( ArchiveRegistryPtr iRegistry )
+    {
+        m_registry = iRegistry;
+    }
+
     //! Gets the error handler policy
     Alembic::Abc::ErrorHandler::Policy getPolicy() { return m_policy; }
 
@@ -175,9 +227,27 @@ public:
     }
 
 private:
+    // the key iFileName opened with the current settings and iOptions is
+    // shared under, empty if there is no registry or it can't be shared
+    std::string makeRegistryKey( const std::string & iFileName,
+                                 const IOptions * iOptions ) const;
+
+    // looks iKey up in the registry
+    bool findShared( const std::string & iKey, CoreType & oType,
+                     Alembic::Abc::IArchive & oArchive );
+
+    // keeps the valid iArchive in the registry under iKey, returns the
+    // archive to hand back
+    Alembic::Abc::IArchive share( const std::string & iKey,
+                                  Alembic::Abc::IArchive iArchive,
+                                  CoreType iType );
+
     bool m_cacheHierarchy;
     size_t m_numStreams;
+    bool m_useMMap;
+    bool m_flattenHierarchy;
     Alembic::AbcCoreAbstract::ReadArraySampleCachePtr m_cachePtr;
+    ArchiveRegistryPtr m_registry;
     Alembic::Abc::ErrorHandler::Policy m_policy;
 
 };
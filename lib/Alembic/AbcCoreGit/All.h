@@ -20,6 +20,7 @@
 #define _Alembic_AbcCoreGit_All_h_
 
 #include <Alembic/AbcCoreGit/ReadWrite.h>
+#include <Alembic/AbcCoreGit/Diff.h>
 
 namespace Alembic {
 namespace AbcCoreGit {
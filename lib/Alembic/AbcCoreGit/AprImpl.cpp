@@ -23,6 +23,7 @@
 #include <Alembic/AbcCoreGit/SampleStore.h>
 #include <Alembic/AbcCoreGit/Git.h>
 #include <Alembic/AbcCoreGit/Utils.h>
+#include <Alembic/Util/ConvertPOD.h>
 
 #include <iostream>
 #include <fstream>
@@ -223,7 +224,7 @@ static void Convert(void *toBuffer, void *fromBuffer, size_t fromSize, const Abc
         char * buf = new char[ fromSize ];
         memcpy(buf, fromBuffer, fromSize);
 
-        ConvertData( fromPod, toPod, buf, toBuffer, fromSize );
+        Util::ConvertData( fromPod, toPod, buf, toBuffer, fromSize );
 
         delete [] buf;
 
@@ -233,7 +234,7 @@ static void Convert(void *toBuffer, void *fromBuffer, size_t fromSize, const Abc
         char * buf = new char[ fromSize ];
         memcpy(buf, fromBuffer, fromSize);
 
-        ConvertData( fromPod, toPod, buf, toBuffer, fromSize );
+        Util::ConvertData( fromPod, toPod, buf, toBuffer, fromSize );
 
         delete [] buf;
     } else
@@ -356,20 +357,20 @@ bool AprImpl::readFromDisk()
     jsonBuffer << jsonFile.rdbuf();
     jsonFile.close();
 
-    std::string jsonContents = jsonBuffer.str();
+    JSONParser json(jsonPathname, jsonBuffer.str());
 #else
     GitGroupPtr parentGroup = m_group;
-    boost::optional<std::string> optJsonContents = parentGroup->tree()->getChildFile(name() + ".json");
-    if (! optJsonContents)
+    boost::optional<GitBlobPtr> optJsonBlob = parentGroup->getFile(name() + ".json");
+    if (! optJsonBlob)
     {
         ABCA_THROW( "can't read git blob '" << jsonPathname << "'" );
         return false;
     }
-    std::string jsonContents = *optJsonContents;
+    JSONParser json(jsonPathname, (*optJsonBlob)->data(), (*optJsonBlob)->size());
 
 #if MSGPACK_SAMPLES
-    boost::optional<std::string> optBinContents = parentGroup->tree()->getChildFile(name() + ".bin");
-    if (! optBinContents)
+    boost::optional<GitBlobPtr> optBinBlob = parentGroup->getFile(name() + ".bin");
+    if (! optBinBlob)
     {
         ABCA_THROW( "can't read git blob '" << absPathname() + ".bin" << "'" );
         return false;
@@ -377,7 +378,6 @@ bool AprImpl::readFromDisk()
 #endif /* MSGPACK_SAMPLES */
 #endif
 
-    JSONParser json(jsonPathname, jsonContents);
     rapidjson::Document& document = json.document;
 
     // TRACE( "AprImpl::readFromDisk - read JSON:" << jsonBuffer.str() );
@@ -401,7 +401,7 @@ bool AprImpl::readFromDisk()
     // size_t v_num_samples = JsonGetSizeT(document, "num_samples").get_value_or(0);
 
 #if MSGPACK_SAMPLES
-    m_store->unpack( *optBinContents );
+    m_store->unpack( (*optBinBlob)->data(), (*optBinBlob)->size() );
 #else
     m_store->fromJson( root["data"] );
 #endif
@@ -79,6 +79,10 @@ ApwImpl::~ApwImpl()
     hash.Init(0, 0);
     HashPropertyHeader( m_header->header, hash );
 
+    // the index is written along with the samples, an incremental write
+    // can only reuse them if it's the same
+    hash.Update( &m_header->timeSamplingIndex, sizeof( m_header->timeSamplingIndex ) );
+
     // mix in the accumulated hash if we have samples
     if ( numSamples != 0 )
     {
@@ -117,10 +121,10 @@ void ApwImpl::setFromPreviousSample()
 
     m_store->setFromPreviousSample();
 
-    // Util::Digest digest = m_previousWrittenSampleID->getKey().digest;
-    // HashDimensions( m_dims, digest );
-    // Util::SpookyHash::ShortEnd(m_hash.words[0], m_hash.words[1],
-    //                           digest.words[0], digest.words[1]);
+    Util::Digest digest = m_previousWrittenSampleID->getKey().digest;
+    HashDimensions( m_dims, digest );
+    Util::SpookyHash::ShortEnd(m_hash.words[0], m_hash.words[1],
+                               digest.words[0], digest.words[1]);
     m_header->nextSampleIndex ++;
 }
 
@@ -237,7 +241,6 @@ void ApwImpl::setSample( const AbcA::ArraySample & iSamp )
         m_header->lastChangedIndex = m_header->nextSampleIndex;
     }
 
-#if 0
     Util::Digest digest = m_previousWrittenSampleID->getKey().digest;
     HashDimensions( m_dims, digest );
     if ( m_header->nextSampleIndex == 0 )
@@ -249,7 +252,6 @@ void ApwImpl::setSample( const AbcA::ArraySample & iSamp )
         Util::SpookyHash::ShortEnd(m_hash.words[0], m_hash.words[1],
                                    digest.words[0], digest.words[1]);
     }
-#endif /* 0 */
 
     // m_header->lastChangedIndex = m_header->nextSampleIndex;
     m_header->nextSampleIndex ++;
@@ -454,7 +456,7 @@ void ApwImpl::writeToDisk()
         Profile::add_git(t_end - t_start);
 #else
         t_start = time_us();
-        m_group->add_file_from_memory(name() + ".json", output);
+        m_group->add_property_file(name() + ".json", output);
         t_end = time_us();
         Profile::add_git(t_end - t_start);
 
@@ -464,7 +466,7 @@ void ApwImpl::writeToDisk()
         t_end = time_us();
         TRACE("ApwImpl::writeToDisk() samples-to-msgpack: " << (t_end - t_start) << "us");
         t_start = time_us();
-        m_group->add_file_from_memory(name() + ".bin", packedSamples);
+        m_group->add_property_file(name() + ".bin", std::move(packedSamples));
         t_end = time_us();
         Profile::add_git(t_end - t_start);
 #endif /* MSGPACK_SAMPLES */
@@ -237,18 +237,17 @@ bool ArImpl::readFromDisk()
     jsonBuffer << jsonFile.rdbuf();
     jsonFile.close();
 
-    std::string jsonContents = jsonBuffer.str();
+    JSONParser json(jsonPathname, jsonBuffer.str());
 #else
-    boost::optional<std::string> optJsonContents = topGroupPtr->tree()->getChildFile("archive.json.abc");
-    if (! optJsonContents)
+    boost::optional<GitBlobPtr> optJsonBlob = topGroupPtr->tree()->getChildBlob("archive.json.abc");
+    if (! optJsonBlob)
     {
         ABCA_THROW( "can't read git blob '" << jsonPathname << "'" );
         return false;
     }
-    std::string jsonContents = *optJsonContents;
+    JSONParser json(jsonPathname, (*optJsonBlob)->data(), (*optJsonBlob)->size());
 #endif
 
-    JSONParser json(jsonPathname, jsonContents);
     rapidjson::Document& document = json.document;
 
     std::string v_kind = JsonGetString(document, "kind").get_value_or("UNKNOWN");
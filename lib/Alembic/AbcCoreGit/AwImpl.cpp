@@ -48,6 +48,15 @@ AwImpl::AwImpl( const std::string &iFileName,
     // since the GitRepo could have normalized/altered the actual path used, use that
     m_fileName = m_repo_ptr->pathname();
 
+    // must happen before any KeyStore is created
+    if (incrementalEnabled())
+        m_repo_ptr->enableIncremental();
+    m_repo_ptr->setBundleSamplesBelow(bundleSamplesBelow());
+    m_repo_ptr->setBundleFlushBytes(bundleFlushBytes());
+    m_repo_ptr->setPackProperties(packPropertiesEnabled());
+    m_repo_ptr->setHashThreads(hashThreads());
+    m_repo_ptr->setWriteBatchBytes(writeBatchBytes());
+
     // add default time sampling
     AbcA::TimeSamplingPtr ts( new AbcA::TimeSampling() );
     m_timeSamples.push_back(ts);
@@ -220,6 +229,48 @@ bool AwImpl::milliwaysEnabled()
     return GitRepo::DEFAULT_MILLIWAYS_ENABLED;
 }
 
+bool AwImpl::incrementalEnabled()
+{
+    if (m_options.has("incremental"))
+        return boost::any_cast<bool>(m_options["incremental"]);
+    return GitRepo::DEFAULT_INCREMENTAL_ENABLED;
+}
+
+bool AwImpl::packPropertiesEnabled()
+{
+    if (m_options.has("packProperties"))
+        return boost::any_cast<bool>(m_options["packProperties"]);
+    return GitRepo::DEFAULT_PACK_PROPERTIES;
+}
+
+size_t AwImpl::bundleSamplesBelow()
+{
+    if (m_options.has("bundleSamplesBelow"))
+        return static_cast<size_t>(boost::any_cast<int>(m_options["bundleSamplesBelow"]));
+    return GitRepo::DEFAULT_BUNDLE_SAMPLES_BELOW;
+}
+
+size_t AwImpl::bundleFlushBytes()
+{
+    if (m_options.has("bundleFlushBytes"))
+        return static_cast<size_t>(boost::any_cast<int>(m_options["bundleFlushBytes"]));
+    return GitRepo::DEFAULT_BUNDLE_FLUSH_BYTES;
+}
+
+size_t AwImpl::hashThreads()
+{
+    if (m_options.has("hashThreads"))
+        return static_cast<size_t>(boost::any_cast<int>(m_options["hashThreads"]));
+    return GitRepo::DEFAULT_HASH_THREADS;
+}
+
+size_t AwImpl::writeBatchBytes()
+{
+    if (m_options.has("writeBatchBytes"))
+        return static_cast<size_t>(boost::any_cast<int>(m_options["writeBatchBytes"]));
+    return GitRepo::DEFAULT_WRITE_BATCH_BYTES;
+}
+
 std::string AwImpl::relPathname() const
 {
     return m_repo_ptr->rootGroup()->relPathname();
@@ -310,6 +361,8 @@ void AwImpl::writeToDisk()
         ksm().writeToDisk();
 
         m_repo_ptr->rootGroup()->add_file_from_memory("archive.json.abc", output);
+        if (m_repo_ptr->incrementalEnabled())
+            m_repo_ptr->rootGroup()->add_file_from_memory("object_hashes.json", m_repo_ptr->packObjectHashes());
         m_repo_ptr->rootGroup()->treebuilder()->write();
 
         TRACE("committing...");
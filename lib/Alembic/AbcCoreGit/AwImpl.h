@@ -90,6 +90,12 @@ public:
     GitGroupPtr group()         { return repo()->rootGroup(); }
 
     bool milliwaysEnabled();
+    bool incrementalEnabled();
+    bool packPropertiesEnabled();
+    size_t bundleSamplesBelow();
+    size_t bundleFlushBytes();
+    size_t hashThreads();
+    size_t writeBatchBytes();
 
     std::string relPathname() const;
     std::string absPathname() const;
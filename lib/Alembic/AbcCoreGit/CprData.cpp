@@ -308,11 +308,11 @@ bool CprData::readFromDisk()
     jsonBuffer << jsonFile.rdbuf();
     jsonFile.close();
 
-    std::string jsonContents = jsonBuffer.str();
+    JSONParser json(jsonPathname, jsonBuffer.str());
 #else
     GitGroupPtr parentGroup = m_group->parent();
-    boost::optional<std::string> optJsonContents = parentGroup->tree()->getChildFile(name() + ".json");
-    if (! optJsonContents)
+    boost::optional<GitBlobPtr> optJsonBlob = parentGroup->getFile(name() + ".json");
+    if (! optJsonBlob)
     {
         TRACE("[CprData " << *this << "] can't read git blob '" << jsonPathname << "' (Ignoring...)");
         m_read = true;
@@ -321,10 +321,9 @@ bool CprData::readFromDisk()
         // ABCA_THROW( "can't read git blob '" << jsonPathname << "'" );
         // return false;
     }
-    std::string jsonContents = *optJsonContents;
+    JSONParser json(jsonPathname, (*optJsonBlob)->data(), (*optJsonBlob)->size());
 #endif
 
-    JSONParser json(jsonPathname, jsonContents);
     rapidjson::Document& document = json.document;
 
     std::string v_kind = JsonGetString(document, "kind").get_value_or("UNKNOWN");
@@ -400,20 +399,19 @@ bool CprData::readFromDiskSubHeader(size_t i)
     jsonBuffer << jsonFile.rdbuf();
     jsonFile.close();
 
-    std::string jsonContents = jsonBuffer.str();
+    JSONParser json(jsonPathname, jsonBuffer.str());
 #else
     GitGroupPtr parentGroup = m_group;
-    boost::optional<std::string> optJsonContents = parentGroup->tree()->getChildFile(subName + ".json");
-    if (! optJsonContents)
+    boost::optional<GitBlobPtr> optJsonBlob = parentGroup->getFile(subName + ".json");
+    if (! optJsonBlob)
     {
         TRACE("[CprData " << *this << "] readFromDiskSubHeader(" << i << ") can't read git blob '" << jsonPathname << "'");
         ABCA_THROW( "can't read git blob '" << jsonPathname << "'" );
         return false;
     }
-    std::string jsonContents = *optJsonContents;
+    JSONParser json(jsonPathname, (*optJsonBlob)->data(), (*optJsonBlob)->size());
 #endif
 
-    JSONParser json(jsonPathname, jsonContents);
     rapidjson::Document& document = json.document;
 
     std::string v_name = JsonGetString(document, "name").get_value_or("UNKNOWN");
@@ -353,7 +353,7 @@ void CpwImpl::writeToDisk()
 #else
         t_start = time_us();
         GitGroupPtr parentGroup = m_data->getGroup()->parent();
-        parentGroup->add_file_from_memory(name() + ".json", output);
+        parentGroup->add_property_file(name() + ".json", output);
         t_end = time_us();
         Profile::add_git(t_end - t_start);
 #endif
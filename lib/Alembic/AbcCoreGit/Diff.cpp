@@ -0,0 +1,765 @@
+/*****************************************************************************/
+/*  multiverse - a next generation storage back-end for Alembic              */
+/*                                                                           */
+/*  Copyright 2015 J CUBE Inc. Tokyo, Japan.                                 */
+/*                                                                           */
+/*  Licensed under the Apache License, Version 2.0 (the "License");          */
+/*  you may not use this file except in compliance with the License.         */
+/*  You may obtain a copy of the License at                                  */
+/*                                                                           */
+/*      http://www.apache.org/licenses/LICENSE-2.0                           */
+/*                                                                           */
+/*  Unless required by applicable law or agreed to in writing, software      */
+/*  distributed under the License is distributed on an "AS IS" BASIS,        */
+/*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. */
+/*  See the License for the specific language governing permissions and      */
+/*  limitations under the License.                                           */
+/*****************************************************************************/
+
+#include <Alembic/AbcCoreGit/Diff.h>
+#include <Alembic/AbcCoreGit/Git.h>
+#include <Alembic/AbcCoreGit/KeyStore.h>
+#include <Alembic/AbcCoreGit/Utils.h>
+
+#include <Alembic/AbcCoreGit/JSON.h>
+#include <Alembic/AbcCoreGit/msgpack_support.h>
+
+#include <msgpack.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <set>
+#include <sstream>
+
+#include <git2.h>
+
+#ifndef GIT_SUCCESS
+#define GIT_SUCCESS 0
+#endif /* GIT_SUCCESS */
+
+namespace Alembic {
+namespace AbcCoreGit {
+namespace ALEMBIC_VERSION_NS {
+
+/*
+ * Layout of the trees compared here (see OwData, CpwImpl, ApwImpl, SpwImpl
+ * and KeyStore for the writing side):
+ *
+ *   /archive.json.abc                  archive metadata and time samplings
+ *   /keystore_<type>_header.bin        kid -> sample key, per POD type
+ *   /ABC.json, /ABC                    header and tree of the top object
+ *   <object>/<child>.json, <child>     header and tree of a child object
+ *   <object>/.prop                     tree of the top compound property
+ *   <compound>/<prop>.json, <prop>     header and tree of a compound
+ *   <compound>/<prop>.json, <prop>.bin header and samples (index -> kid)
+ *                                      of a scalar or array property
+ *   <compound>/.pack                   all of the above .json and .bin
+ *                                      files of a compound, when written
+ *                                      with "packProperties"
+ *
+ * Equal object ids mean equal contents, but the .bin files only refer to
+ * samples by kid: equal .bin files (and so equal trees) only mean equal
+ * samples if both keystores agree on what the kids they share stand for,
+ * as is the case for incremental writes. Otherwise every property is
+ * compared by sample digest.
+ */
+
+namespace {
+
+typedef Alembic::Util::shared_ptr<git_tree> TreeHandle;
+typedef std::map<size_t, std::string> KidDigests;
+
+//-*****************************************************************************
+struct SampleIndex
+{
+    SampleIndex() : numSamples(0) {}
+
+    std::string typeName;
+    size_t numSamples;
+    std::map<size_t, size_t> indexToKid;
+};
+
+//-*****************************************************************************
+// a .json or .bin file of a tree, either a blob of its own or a slice of
+// the GitPack of the tree
+struct FileRef
+{
+    FileRef() : entry(NULL) {}
+
+    const git_tree_entry* entry;
+    GitBlobPtr packed;
+
+    bool exists() const { return (entry != NULL) || packed; }
+};
+
+//-*****************************************************************************
+bool endsWith(const std::string& str, const std::string& suffix)
+{
+    return (str.size() >= suffix.size()) &&
+        (str.compare(str.size() - suffix.size(), suffix.size(), suffix) == 0);
+}
+
+std::string propJoin(const std::string& parent, const std::string& name)
+{
+    return parent.empty() ? name : (parent + "/" + name);
+}
+
+std::string objectJoin(const std::string& parent, const std::string& name)
+{
+    return (parent == "/") ? (parent + name) : (parent + "/" + name);
+}
+
+std::string keyStoreTypeName(Alembic::Util::PlainOldDataType pod)
+{
+    switch (pod)
+    {
+    case Alembic::Util::kBooleanPOD: return GetTypeStr<Util::bool_t>();
+    case Alembic::Util::kUint8POD: return GetTypeStr<Util::uint8_t>();
+    case Alembic::Util::kInt8POD: return GetTypeStr<Util::int8_t>();
+    case Alembic::Util::kUint16POD: return GetTypeStr<Util::uint16_t>();
+    case Alembic::Util::kInt16POD: return GetTypeStr<Util::int16_t>();
+    case Alembic::Util::kUint32POD: return GetTypeStr<Util::uint32_t>();
+    case Alembic::Util::kInt32POD: return GetTypeStr<Util::int32_t>();
+    case Alembic::Util::kUint64POD: return GetTypeStr<Util::uint64_t>();
+    case Alembic::Util::kInt64POD: return GetTypeStr<Util::int64_t>();
+    case Alembic::Util::kFloat16POD: return GetTypeStr<Util::float16_t>();
+    case Alembic::Util::kFloat32POD: return GetTypeStr<Util::float32_t>();
+    case Alembic::Util::kFloat64POD: return GetTypeStr<Util::float64_t>();
+    case Alembic::Util::kStringPOD: return GetTypeStr<Util::string>();
+    case Alembic::Util::kWstringPOD: return GetTypeStr<Util::wstring>();
+    default:
+        break;
+    }
+    return std::string();
+}
+
+// same layout as KeyStore<T>::unpackHeader(), only keeping the digests
+void unpackDigests(const GitBlob& packed, KidDigests& oDigests)
+{
+    MsgPackBufferUnpacker pac(packed.data(), packed.size());
+
+    msgpack::unpacked msg;
+
+    size_t v_n_kid = 0;
+    size_t v_next_kid = 0;
+
+    pac.next(&msg);
+    msgpack::object pko = msg.get();
+    mp_unpack(pko, v_n_kid);
+
+    pac.next(&msg);
+    pko = msg.get();
+    mp_unpack(pko, v_next_kid);
+
+    for (size_t i = 0; i < v_n_kid; ++i)
+    {
+        msgpack::type::tuple< size_t, size_t, std::string, std::string, std::string > tuple;
+
+        pac.next(&msg);
+        pko = msg.get();
+        mp_unpack(pko, tuple);
+
+        oDigests[tuple.get<0>()] = tuple.get<4>();
+    }
+}
+
+// same layout as TypedSampleStore<T>::unpack(), stopping after the
+// index -> kid map
+void unpackSampleIndex(const GitBlob& packed, SampleIndex& oIndex)
+{
+    MsgPackBufferUnpacker pac(packed.data(), packed.size());
+
+    msgpack::unpacked msg;
+
+    std::string v_type;
+    AbcA::DataType dataType;
+
+    pac.next(&msg);
+    msgpack::object pko = msg.get();
+    mp_unpack(pko, v_type);
+
+    pac.next(&msg);
+    pko = msg.get();
+    mp_unpack(pko, dataType);
+
+    pac.next(&msg);
+    pko = msg.get();
+    mp_unpack(pko, oIndex.numSamples);
+
+    // dimensions
+    pac.next(&msg);
+
+    oIndex.typeName = keyStoreTypeName(dataType.getPod());
+
+    size_t v_n_index = 0;
+    pac.next(&msg);
+    pko = msg.get();
+    mp_unpack(pko, v_n_index);
+    for (size_t i = 0; i < v_n_index; ++i)
+    {
+        msgpack::type::tuple< size_t, size_t > tuple;
+
+        pac.next(&msg);
+        pko = msg.get();
+        mp_unpack(pko, tuple);
+
+        oIndex.indexToKid[tuple.get<0>()] = tuple.get<1>();
+    }
+}
+
+// the parts of an object or property header which aren't derived from the
+// samples (unlike numSamples, firstChangedIndex, ...)
+std::string headerSignature(const std::string& name, const GitBlob& contents)
+{
+    JSONParser json(name, contents.data(), contents.size());
+    rapidjson::Document& document = json.document;
+
+    ABCA_ASSERT( json.ok && document.IsObject(), "Could not parse '" << name << "'" );
+
+    std::ostringstream ss;
+    ss << JsonGetString(document, "kind").get_value_or("") << '\n';
+    ss << JsonGetString(document, "type").get_value_or("") << '\n';
+    ss << JsonGetString(document, "metadata").get_value_or("") << '\n';
+
+    rapidjson::Value::ConstMemberIterator itr = document.FindMember("info");
+    if (itr != document.MemberEnd() && itr->value.IsObject())
+    {
+        const rapidjson::Value& info = itr->value;
+        ss << JsonGetUint(info, "timeSamplingIndex").get_value_or(0) << '\n';
+        ss << JsonGetBool(info, "isScalarLike").get_value_or(false) << '\n';
+        ss << JsonGetString(info, "metadata").get_value_or("") << '\n';
+    }
+
+    return ss.str();
+}
+
+//-*****************************************************************************
+class DiffSide
+{
+public:
+    DiffSide(const std::string& pathname, const Alembic::AbcCoreFactory::IOptions& options) :
+        m_repo(new GitRepo(pathname, options, GitMode::Read))
+    {
+        ABCA_ASSERT( m_repo->isValid(),
+                     "Could not open as Git repository: " << pathname );
+
+        GitTreePtr tree = m_repo->rootGroup()->tree();
+        ABCA_ASSERT( tree && tree->g_ptr(),
+                     "Could not get the tree of: " << pathname );
+
+        m_root = lookupTree(tree->oid());
+    }
+
+    TreeHandle root() const { return m_root; }
+
+    TreeHandle subtree(const git_tree_entry* entry) const
+    {
+        if ((! entry) || (git_tree_entry_type(entry) != GIT_OBJ_TREE))
+            return TreeHandle();
+
+        return lookupTree(*git_tree_entry_id(entry));
+    }
+
+    GitBlobPtr blob(const git_tree_entry* entry) const
+    {
+        git_blob *blob = NULL;
+        int rc = git_blob_lookup(&blob, m_repo->g_ptr(), git_tree_entry_id(entry));
+        ABCA_ASSERT( rc == GIT_SUCCESS,
+                     "Could not read '" << git_tree_entry_name(entry) << "' in " << m_repo->pathname() );
+
+        return GitBlobPtr(new GitBlob(blob));
+    }
+
+    FileRef file(const TreeHandle& tree, const std::string& name)
+    {
+        FileRef ref;
+        if (! tree)
+            return ref;
+
+        ref.entry = git_tree_entry_byname(tree.get(), name.c_str());
+        if (! ref.entry)
+        {
+            const GitPack::Files& files = pack(tree);
+            GitPack::Files::const_iterator it = files.find(name);
+            if (it != files.end())
+                ref.packed = it->second;
+        }
+        return ref;
+    }
+
+    GitBlobPtr contents(const FileRef& ref) const
+    {
+        return ref.packed ? ref.packed : blob(ref.entry);
+    }
+
+    // the files in the GitPack of a tree (if any), read on first use
+    const GitPack::Files& pack(const TreeHandle& tree)
+    {
+        std::string key(reinterpret_cast<const char*>(git_tree_id(tree.get())->id), GIT_OID_RAWSZ);
+
+        std::map<std::string, GitPack::Files>::iterator it = m_packs.find(key);
+        if (it != m_packs.end())
+            return it->second;
+
+        GitPack::Files& files = m_packs[key];
+
+        const git_tree_entry *entry = git_tree_entry_byname(tree.get(), GitPack::FILENAME);
+        if (entry && (git_tree_entry_type(entry) == GIT_OBJ_BLOB))
+            GitPack::unpack(blob(entry), files);
+
+        return files;
+    }
+
+    // kid -> digest for the keystore of the given type, read on first use
+    const KidDigests& digests(const std::string& typeName)
+    {
+        std::map<std::string, KidDigests>::iterator it = m_digests.find(typeName);
+        if (it != m_digests.end())
+            return it->second;
+
+        KidDigests& digests = m_digests[typeName];
+
+        std::string name = "keystore_" + typeName + "_header.bin";
+        const git_tree_entry *entry = git_tree_entry_byname(m_root.get(), name.c_str());
+        if (entry)
+            unpackDigests(*blob(entry), digests);
+
+        return digests;
+    }
+
+private:
+    TreeHandle lookupTree(const git_oid& oid) const
+    {
+        git_tree *tree = NULL;
+        int rc = git_tree_lookup(&tree, m_repo->g_ptr(), &oid);
+        ABCA_ASSERT( rc == GIT_SUCCESS,
+                     "Could not look up tree in " << m_repo->pathname() );
+
+        return TreeHandle(tree, git_tree_free);
+    }
+
+    GitRepoPtr m_repo;
+    TreeHandle m_root;
+    std::map<std::string, KidDigests> m_digests;
+    std::map<std::string, GitPack::Files> m_packs;
+};
+
+//-*****************************************************************************
+class TreeDiff
+{
+public:
+    TreeDiff(DiffSide& a, DiffSide& b) :
+        m_a(a), m_b(b), m_trustOids(false)
+    {
+    }
+
+    ArchiveChanges run()
+    {
+        TreeHandle rootA = m_a.root();
+        TreeHandle rootB = m_b.root();
+
+        m_trustOids = keyStoresAgree();
+        TRACE("TreeDiff::run() keystores " << (m_trustOids ? "agree" : "disagree"));
+
+        if (m_trustOids && sameTree(rootA, rootB))
+            return m_changes;
+
+        // time samplings and archive metadata count as the top object's
+        bool archiveChanged = ! sameBlob(entry(rootA, "archive.json.abc"),
+                                         entry(rootB, "archive.json.abc"));
+
+        diffChild(rootA, rootB, "ABC", "/", archiveChanged);
+
+        return m_changes;
+    }
+
+private:
+    static const git_tree_entry* entry(const TreeHandle& tree, const std::string& name)
+    {
+        if (! tree)
+            return NULL;
+
+        return git_tree_entry_byname(tree.get(), name.c_str());
+    }
+
+    static const git_tree_entry* treeEntry(const TreeHandle& tree, const std::string& name)
+    {
+        const git_tree_entry *e = entry(tree, name);
+        return (e && (git_tree_entry_type(e) == GIT_OBJ_TREE)) ? e : NULL;
+    }
+
+    static bool sameBlob(const git_tree_entry* a, const git_tree_entry* b)
+    {
+        if ((! a) || (! b))
+            return (a == b);
+
+        return (git_oid_cmp(git_tree_entry_id(a), git_tree_entry_id(b)) == 0);
+    }
+
+    // packed files have no object id, they are compared by contents
+    bool sameFile(const FileRef& a, const FileRef& b)
+    {
+        if ((! a.exists()) || (! b.exists()))
+            return (a.exists() == b.exists());
+
+        if (a.entry && b.entry)
+            return sameBlob(a.entry, b.entry);
+
+        GitBlobPtr contentsA = m_a.contents(a);
+        GitBlobPtr contentsB = m_b.contents(b);
+        return (contentsA->size() == contentsB->size()) &&
+            (memcmp(contentsA->data(), contentsB->data(), contentsA->size()) == 0);
+    }
+
+    static bool sameTree(const TreeHandle& a, const TreeHandle& b)
+    {
+        return (git_oid_cmp(git_tree_id(a.get()), git_tree_id(b.get())) == 0);
+    }
+
+    // every kid both keystores of a type know about stands for the same key
+    bool keyStoresAgree()
+    {
+        TreeHandle rootA = m_a.root();
+        TreeHandle rootB = m_b.root();
+
+        const std::string prefix = "keystore_";
+        const std::string suffix = "_header.bin";
+
+        size_t n_entries = git_tree_entrycount(rootA.get());
+        for (size_t i = 0; i < n_entries; ++i)
+        {
+            const git_tree_entry *entryA = git_tree_entry_byindex(rootA.get(), i);
+            std::string name = git_tree_entry_name(entryA);
+
+            if ((name.compare(0, prefix.size(), prefix) != 0) || (! endsWith(name, suffix)))
+                continue;
+
+            const git_tree_entry *entryB = entry(rootB, name);
+            if ((! entryB) || sameBlob(entryA, entryB))
+                continue;
+
+            std::string typeName = name.substr(prefix.size(), name.size() - prefix.size() - suffix.size());
+            const KidDigests& digestsA = m_a.digests(typeName);
+            const KidDigests& digestsB = m_b.digests(typeName);
+
+            KidDigests::const_iterator it;
+            for (it = digestsA.begin(); it != digestsA.end(); ++it)
+            {
+                KidDigests::const_iterator other = digestsB.find(it->first);
+                if ((other != digestsB.end()) && (other->second != it->second))
+                    return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool headerChanged(const TreeHandle& parentA, const TreeHandle& parentB, const std::string& jsonName)
+    {
+        FileRef jsonA = m_a.file(parentA, jsonName);
+        FileRef jsonB = m_b.file(parentB, jsonName);
+
+        if (sameFile(jsonA, jsonB))
+            return false;
+        if ((! jsonA.exists()) || (! jsonB.exists()))
+            return true;
+
+        return (headerSignature(jsonName, *m_a.contents(jsonA)) !=
+                headerSignature(jsonName, *m_b.contents(jsonB)));
+    }
+
+    void add(ArchiveChange::Kind kind, const std::string& object,
+             const std::string& property = std::string(), bool header = false)
+    {
+        ArchiveChange change;
+        change.kind = kind;
+        change.object = object;
+        change.property = property;
+        change.headerChanged = header;
+        m_changes.push_back(change);
+    }
+
+    // names of the subtrees of either tree
+    static void treeNames(const TreeHandle& tree, std::set<std::string>& oNames)
+    {
+        if (! tree)
+            return;
+
+        size_t n_entries = git_tree_entrycount(tree.get());
+        for (size_t i = 0; i < n_entries; ++i)
+        {
+            const git_tree_entry *e = git_tree_entry_byindex(tree.get(), i);
+            if (git_tree_entry_type(e) == GIT_OBJ_TREE)
+                oNames.insert(git_tree_entry_name(e));
+        }
+    }
+
+    void diffChild(const TreeHandle& parentA, const TreeHandle& parentB,
+                   const std::string& name, const std::string& fullName,
+                   bool forceHeaderChanged = false)
+    {
+        const git_tree_entry *entryA = treeEntry(parentA, name);
+        const git_tree_entry *entryB = treeEntry(parentB, name);
+
+        if ((! entryA) && (! entryB))
+            return;
+
+        if (! entryA)
+        {
+            add(ArchiveChange::kAdded, fullName);
+            return;
+        }
+
+        if (! entryB)
+        {
+            add(ArchiveChange::kRemoved, fullName);
+            return;
+        }
+
+        if (forceHeaderChanged || headerChanged(parentA, parentB, name + ".json"))
+            add(ArchiveChange::kChanged, fullName, std::string(), true);
+
+        if (m_trustOids && sameBlob(entryA, entryB))
+            return;
+
+        TreeHandle treeA = m_a.subtree(entryA);
+        TreeHandle treeB = m_b.subtree(entryB);
+
+        std::set<std::string> names;
+        treeNames(treeA, names);
+        treeNames(treeB, names);
+
+        std::set<std::string>::const_iterator it;
+        for (it = names.begin(); it != names.end(); ++it)
+        {
+            if (*it == ".prop")
+                diffCompound(treeA, treeB, *it, fullName, std::string());
+            else
+                diffChild(treeA, treeB, *it, objectJoin(fullName, *it));
+        }
+    }
+
+    void diffCompound(const TreeHandle& parentA, const TreeHandle& parentB,
+                      const std::string& name, const std::string& object,
+                      const std::string& property)
+    {
+        const git_tree_entry *entryA = treeEntry(parentA, name);
+        const git_tree_entry *entryB = treeEntry(parentB, name);
+
+        if ((! entryA) && (! entryB))
+            return;
+
+        // the top compound always exists along with its object
+        if (! entryA)
+        {
+            add(ArchiveChange::kAdded, object, property);
+            return;
+        }
+
+        if (! entryB)
+        {
+            add(ArchiveChange::kRemoved, object, property);
+            return;
+        }
+
+        // the top compound shares its metadata with the object
+        if ((! property.empty()) && headerChanged(parentA, parentB, name + ".json"))
+            add(ArchiveChange::kChanged, object, property, true);
+
+        if (m_trustOids && sameBlob(entryA, entryB))
+            return;
+
+        TreeHandle treeA = m_a.subtree(entryA);
+        TreeHandle treeB = m_b.subtree(entryB);
+
+        std::set<std::string> compounds;
+        treeNames(treeA, compounds);
+        treeNames(treeB, compounds);
+
+        // any other header is a scalar or array property
+        std::set<std::string> headers;
+        const TreeHandle* trees[2] = { &treeA, &treeB };
+        DiffSide* sides[2] = { &m_a, &m_b };
+        for (size_t t = 0; t < 2; ++t)
+        {
+            size_t n_entries = git_tree_entrycount(trees[t]->get());
+            for (size_t i = 0; i < n_entries; ++i)
+            {
+                const git_tree_entry *e = git_tree_entry_byindex(trees[t]->get(), i);
+                if (git_tree_entry_type(e) == GIT_OBJ_BLOB)
+                    headers.insert(git_tree_entry_name(e));
+            }
+
+            const GitPack::Files& packed = sides[t]->pack(*trees[t]);
+            GitPack::Files::const_iterator p_it;
+            for (p_it = packed.begin(); p_it != packed.end(); ++p_it)
+                headers.insert(p_it->first);
+        }
+
+        std::set<std::string> properties;
+        std::set<std::string>::const_iterator h_it;
+        for (h_it = headers.begin(); h_it != headers.end(); ++h_it)
+        {
+            if (! endsWith(*h_it, ".json"))
+                continue;
+
+            std::string propName = h_it->substr(0, h_it->size() - 5);
+            if (! compounds.count(propName))
+                properties.insert(propName);
+        }
+
+        std::set<std::string>::const_iterator it;
+        for (it = compounds.begin(); it != compounds.end(); ++it)
+            diffCompound(treeA, treeB, *it, object, propJoin(property, *it));
+
+        for (it = properties.begin(); it != properties.end(); ++it)
+            diffProperty(treeA, treeB, *it, object, propJoin(property, *it));
+    }
+
+    void diffProperty(const TreeHandle& parentA, const TreeHandle& parentB,
+                      const std::string& name, const std::string& object,
+                      const std::string& property)
+    {
+        FileRef jsonA = m_a.file(parentA, name + ".json");
+        FileRef jsonB = m_b.file(parentB, name + ".json");
+
+        if (! jsonA.exists())
+        {
+            add(ArchiveChange::kAdded, object, property);
+            return;
+        }
+
+        if (! jsonB.exists())
+        {
+            add(ArchiveChange::kRemoved, object, property);
+            return;
+        }
+
+        FileRef binA = m_a.file(parentA, name + ".bin");
+        FileRef binB = m_b.file(parentB, name + ".bin");
+
+        bool samplesSame = m_trustOids && sameFile(binA, binB);
+        if (samplesSame && sameFile(jsonA, jsonB))
+            return;
+
+        ArchiveChange change;
+        change.kind = ArchiveChange::kChanged;
+        change.object = object;
+        change.property = property;
+        change.headerChanged = headerChanged(parentA, parentB, name + ".json");
+
+        if (! samplesSame)
+            diffSamples(binA, binB, change.samples);
+
+        if (change.headerChanged || (! change.samples.empty()))
+            m_changes.push_back(change);
+    }
+
+    void diffSamples(const FileRef& binA, const FileRef& binB,
+                     std::vector<ArchiveChange::SampleRange>& oRanges)
+    {
+        SampleIndex indexA, indexB;
+        if (binA.exists())
+            unpackSampleIndex(*m_a.contents(binA), indexA);
+        if (binB.exists())
+            unpackSampleIndex(*m_b.contents(binB), indexB);
+
+        static const KidDigests noDigests;
+        const KidDigests& digestsA = indexA.typeName.empty() ? noDigests : m_a.digests(indexA.typeName);
+        const KidDigests& digestsB = indexB.typeName.empty() ? noDigests : m_b.digests(indexB.typeName);
+
+        size_t numSamples = std::max(indexA.numSamples, indexB.numSamples);
+        for (size_t i = 0; i < numSamples; ++i)
+        {
+            bool changed = (i >= indexA.numSamples) || (i >= indexB.numSamples) ||
+                (indexA.typeName != indexB.typeName) ||
+                (digest(indexA, digestsA, i) != digest(indexB, digestsB, i));
+
+            if (! changed)
+                continue;
+
+            if ((! oRanges.empty()) && (oRanges.back().second + 1 == i))
+                oRanges.back().second = i;
+            else
+                oRanges.push_back(ArchiveChange::SampleRange(i, i));
+        }
+    }
+
+    static std::string digest(const SampleIndex& index, const KidDigests& digests, size_t i)
+    {
+        std::map<size_t, size_t>::const_iterator k_it = index.indexToKid.find(i);
+        if (k_it == index.indexToKid.end())
+            return std::string();
+
+        KidDigests::const_iterator d_it = digests.find(k_it->second);
+        return (d_it != digests.end()) ? d_it->second : std::string();
+    }
+
+    DiffSide& m_a;
+    DiffSide& m_b;
+    bool m_trustOids;
+    ArchiveChanges m_changes;
+};
+
+} // End anonymous namespace
+
+//-*****************************************************************************
+std::ostream& operator<< (std::ostream& out, const ArchiveChange& value)
+{
+    switch (value.kind)
+    {
+    case ArchiveChange::kAdded:   out << "added   "; break;
+    case ArchiveChange::kRemoved: out << "removed "; break;
+    case ArchiveChange::kChanged: out << "changed "; break;
+    }
+
+    out << value.object;
+    if (! value.isObject())
+        out << " property " << value.property;
+
+    if (value.headerChanged)
+        out << " (header)";
+
+    for (size_t i = 0; i < value.samples.size(); ++i)
+    {
+        out << ((i == 0) ? " samples " : ",") << value.samples[i].first;
+        if (value.samples[i].second != value.samples[i].first)
+            out << "-" << value.samples[i].second;
+    }
+
+    return out;
+}
+
+//-*****************************************************************************
+ArchiveChanges diffArchives(const std::string& archivePathnameA,
+                            const Alembic::AbcCoreFactory::IOptions& iOptionsA,
+                            const std::string& archivePathnameB,
+                            const Alembic::AbcCoreFactory::IOptions& iOptionsB)
+{
+    TRACE("diffArchives('" << archivePathnameA << "', '" << archivePathnameB << "')");
+
+    DiffSide a(archivePathnameA, iOptionsA);
+    DiffSide b(archivePathnameB, iOptionsB);
+
+    return TreeDiff(a, b).run();
+}
+
+ArchiveChanges diffRevisions(const std::string& archivePathname,
+                             const std::string& revisionA,
+                             const std::string& revisionB)
+{
+    Alembic::AbcCoreFactory::IOptions optionsA;
+    Alembic::AbcCoreFactory::IOptions optionsB;
+
+    if (! revisionA.empty())
+        optionsA["revision"] = revisionA;
+    if (! revisionB.empty())
+        optionsB["revision"] = revisionB;
+
+    return diffArchives(archivePathname, optionsA, archivePathname, optionsB);
+}
+
+} // End namespace ALEMBIC_VERSION_NS
+} // End namespace AbcCoreGit
+} // End namespace Alembic
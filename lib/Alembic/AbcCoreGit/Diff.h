@@ -0,0 +1,99 @@
+/*****************************************************************************/
+/*  multiverse - a next generation storage back-end for Alembic              */
+/*                                                                           */
+/*  Copyright 2015 J CUBE Inc. Tokyo, Japan.                                 */
+/*                                                                           */
+/*  Licensed under the Apache License, Version 2.0 (the "License");          */
+/*  you may not use this file except in compliance with the License.         */
+/*  You may obtain a copy of the License at                                  */
+/*                                                                           */
+/*      http://www.apache.org/licenses/LICENSE-2.0                           */
+/*                                                                           */
+/*  Unless required by applicable law or agreed to in writing, software      */
+/*  distributed under the License is distributed on an "AS IS" BASIS,        */
+/*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. */
+/*  See the License for the specific language governing permissions and      */
+/*  limitations under the License.                                           */
+/*****************************************************************************/
+
+#ifndef _Alembic_AbcCoreGit_Diff_h_
+#define _Alembic_AbcCoreGit_Diff_h_
+
+#include <Alembic/AbcCoreAbstract/All.h>
+
+#include <Alembic/AbcCoreFactory/IFactory.h>
+
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Alembic {
+namespace AbcCoreGit {
+namespace ALEMBIC_VERSION_NS {
+
+//-*****************************************************************************
+//! One entry of the change list between two Git archives (or two revisions
+//! of the same one), going from the first archive to the second.
+struct ALEMBIC_EXPORT ArchiveChange
+{
+    enum Kind
+    {
+        kAdded,
+        kRemoved,
+        kChanged
+    };
+
+    typedef std::pair< Alembic::Util::uint64_t, Alembic::Util::uint64_t > SampleRange;
+
+    ArchiveChange() : kind(kChanged), headerChanged(false) {}
+
+    Kind kind;
+
+    // full name of the object, "/" being the top object
+    std::string object;
+
+    // path of the property below the top compound of the object
+    // (e.g. ".geom/P"), empty when the change is about the object itself
+    std::string property;
+
+    // for a changed object or property: its metadata, data type or time
+    // sampling differ
+    bool headerChanged;
+
+    // for a changed property: inclusive ranges of the sample indices whose
+    // data differ, samples only present in one of the archives included
+    std::vector< SampleRange > samples;
+
+    bool isObject() const { return property.empty(); }
+};
+
+typedef std::vector<ArchiveChange> ArchiveChanges;
+
+ALEMBIC_EXPORT std::ostream& operator<< (std::ostream& out, const ArchiveChange& value);
+
+/* Diff API */
+
+// Compares the trees of the two archives (a "revision" in the options
+// selects the commit, HEAD otherwise), only descending into the subtrees
+// whose object id differs, so the time taken depends on the size of the
+// difference rather than on the size of the archives.
+ALEMBIC_EXPORT ArchiveChanges diffArchives(
+    const std::string& archivePathnameA,
+    const Alembic::AbcCoreFactory::IOptions& iOptionsA,
+    const std::string& archivePathnameB,
+    const Alembic::AbcCoreFactory::IOptions& iOptionsB );
+
+ALEMBIC_EXPORT ArchiveChanges diffRevisions(
+    const std::string& archivePathname,
+    const std::string& revisionA,
+    const std::string& revisionB );
+
+} // End namespace ALEMBIC_VERSION_NS
+
+using namespace ALEMBIC_VERSION_NS;
+
+} // End namespace AbcCoreGit
+} // End namespace Alembic
+
+#endif
@@ -25,6 +25,10 @@
 #include <sstream>
 #include <cstdlib>
 #include <cassert>
+#include <cstring>
+#include <algorithm>
+#include <atomic>
+#include <thread>
 
 #include <sys/stat.h>
 #include <sys/types.h>
@@ -152,6 +156,23 @@ static void get_system_user_info(std::string & username,
         mail = username + "@localhost";
 }
 
+#ifdef MILLIWAYS_ENABLED
+// the refdb of a new milliways store is empty: point its HEAD to master
+// like the HEAD file of a plain repository, or the commits would go to a
+// detached HEAD and leave no branch behind
+static bool milliways_init_head(git_repository* repo)
+{
+    git_reference* head = NULL;
+    int rc = git_reference_lookup(&head, repo, "HEAD");
+    if (rc == GIT_ENOTFOUND)
+        rc = git_reference_symbolic_create(&head, repo, "HEAD", "refs/heads/master",
+            /* force */ 0, "initial HEAD");
+    if (head)
+        git_reference_free(head);
+    return git_check_ok(rc, "setting milliways HEAD");
+}
+#endif /* MILLIWAYS_ENABLED */
+
 static bool git_check_error(int error_code, const std::string& action)
 {
     if (error_code == GIT_SUCCESS)
@@ -376,6 +397,10 @@ GitRepo::GitRepo(const std::string& pathname_, const Alembic::AbcCoreFactory::IO
     m_index_dirty(false),
     m_options(options), m_ignore_wrong_rev(DEFAULT_IGNORE_WRONG_REV),
     m_milliways_enabled(milliwaysEnable), m_support_repo(),
+    m_incremental(DEFAULT_INCREMENTAL_ENABLED), m_head_tree(NULL),
+    m_bundle_below(DEFAULT_BUNDLE_SAMPLES_BELOW), m_bundle_flush(DEFAULT_BUNDLE_FLUSH_BYTES),
+    m_pack_properties(DEFAULT_PACK_PROPERTIES), m_hash_threads(DEFAULT_HASH_THREADS),
+    m_write_batch(DEFAULT_WRITE_BATCH_BYTES),
     m_cleaned_up(false)
 {
     TRACE("GitRepo::GitRepo(pathname:'" << pathname_ << "' mode:" << mode_ << ")");
@@ -597,7 +622,7 @@ GitRepo::GitRepo(const std::string& pathname_, const Alembic::AbcCoreFactory::IO
         assert(m_odb);
 
         TRACE("call git_odb_backend_milliways()");
-        rc = git_odb_backend_milliways(&m_git_backend, milliwaysPathname.c_str());
+        rc = git_odb_backend_milliways(&m_git_backend, milliwaysPathname.c_str(), (m_mode == GitMode::Read) ? 1 : 0);
         ok = ok && git_check_ok(rc, "connecting to milliways ODB backend");
         if (!ok) goto ret;
 
@@ -620,7 +645,7 @@ GitRepo::GitRepo(const std::string& pathname_, const Alembic::AbcCoreFactory::IO
         git_refdb_backend *milliways_refdb_backend = NULL;
 
         TRACE("call git_refdb_backend_milliways()");
-        rc = git_refdb_backend_milliways(&milliways_refdb_backend, milliwaysPathname.c_str());
+        rc = git_refdb_backend_milliways(&milliways_refdb_backend, milliwaysPathname.c_str(), (m_mode == GitMode::Read) ? 1 : 0);
         ok = ok && git_check_ok(rc, "connecting to milliways refdb backend");
         if (!ok) goto ret;
 
@@ -633,6 +658,12 @@ GitRepo::GitRepo(const std::string& pathname_, const Alembic::AbcCoreFactory::IO
 
         TRACE("call git_repository_set_refdb()");
         git_repository_set_refdb(m_repo, m_refdb);
+
+        if (m_mode != GitMode::Read)
+        {
+            ok = ok && milliways_init_head(m_repo);
+            if (!ok) goto ret;
+        }
     }
 #endif
 
@@ -655,7 +686,7 @@ GitRepo::GitRepo(const std::string& pathname_, const Alembic::AbcCoreFactory::IO
 #endif
 
 #ifdef USE_MILLIWAYS_BACKEND
-    rc = git_odb_backend_milliways(&m_git_backend, milliwaysPathname.c_str());
+    rc = git_odb_backend_milliways(&m_git_backend, milliwaysPathname.c_str(), (m_mode == GitMode::Read) ? 1 : 0);
     ok = ok && git_check_ok(rc, "connecting to milliways backend");
 #endif
 
@@ -744,6 +775,10 @@ GitRepo::GitRepo(const std::string& pathname_, GitMode mode_, bool milliwaysEnab
     m_odb(NULL), m_refdb(NULL), m_index(NULL), m_error(false),
     m_index_dirty(false), m_ignore_wrong_rev(DEFAULT_IGNORE_WRONG_REV),
     m_milliways_enabled(milliwaysEnable), m_support_repo(),
+    m_incremental(DEFAULT_INCREMENTAL_ENABLED), m_head_tree(NULL),
+    m_bundle_below(DEFAULT_BUNDLE_SAMPLES_BELOW), m_bundle_flush(DEFAULT_BUNDLE_FLUSH_BYTES),
+    m_pack_properties(DEFAULT_PACK_PROPERTIES), m_hash_threads(DEFAULT_HASH_THREADS),
+    m_write_batch(DEFAULT_WRITE_BATCH_BYTES),
     m_cleaned_up(false)
 {
     TRACE("GitRepo::GitRepo(pathname:'" << pathname_ << "' mode:" << mode_ << ")");
@@ -912,7 +947,7 @@ GitRepo::GitRepo(const std::string& pathname_, GitMode mode_, bool milliwaysEnab
         assert(m_odb);
 
         TRACE("call git_odb_backend_milliways()");
-        rc = git_odb_backend_milliways(&m_git_backend, milliwaysPathname.c_str());
+        rc = git_odb_backend_milliways(&m_git_backend, milliwaysPathname.c_str(), (m_mode == GitMode::Read) ? 1 : 0);
         ok = ok && git_check_ok(rc, "connecting to milliways backend");
         if (!ok) goto ret;
 
@@ -935,7 +970,7 @@ GitRepo::GitRepo(const std::string& pathname_, GitMode mode_, bool milliwaysEnab
         git_refdb_backend *milliways_refdb_backend = NULL;
 
         TRACE("call git_refdb_backend_milliways()");
-        rc = git_refdb_backend_milliways(&milliways_refdb_backend, milliwaysPathname.c_str());
+        rc = git_refdb_backend_milliways(&milliways_refdb_backend, milliwaysPathname.c_str(), (m_mode == GitMode::Read) ? 1 : 0);
         ok = ok && git_check_ok(rc, "connecting to milliways refdb backend");
         if (!ok) goto ret;
 
@@ -948,6 +983,12 @@ GitRepo::GitRepo(const std::string& pathname_, GitMode mode_, bool milliwaysEnab
 
         TRACE("call git_repository_set_refdb()");
         git_repository_set_refdb(m_repo, m_refdb);
+
+        if (m_mode != GitMode::Read)
+        {
+            ok = ok && milliways_init_head(m_repo);
+            if (!ok) goto ret;
+        }
     }
 #endif
 
@@ -970,7 +1011,7 @@ GitRepo::GitRepo(const std::string& pathname_, GitMode mode_, bool milliwaysEnab
 #endif
 
 #ifdef USE_MILLIWAYS_BACKEND
-    rc = git_odb_backend_milliways(&m_git_backend, milliwaysPathname.c_str());
+    rc = git_odb_backend_milliways(&m_git_backend, milliwaysPathname.c_str(), (m_mode == GitMode::Read) ? 1 : 0);
     ok = ok && git_check_ok(rc, "connecting to milliways backend");
 #endif
 
@@ -1070,6 +1111,10 @@ void GitRepo::cleanup()
 
     TRACE("GitRepo::cleanup()");
 
+    if (m_head_tree)
+        git_tree_free(m_head_tree);
+    m_head_tree = NULL;
+
     if (m_index)
         git_index_free(m_index);
     m_index = NULL;
@@ -1378,6 +1423,228 @@ std::string GitRepo::relpath(const std::string& pathname_) const
     return relative_path(real_path(pathname_), real_path(pathname()));
 }
 
+/* incremental writes */
+
+bool GitRepo::enableIncremental()
+{
+    git_oid head_oid;
+    git_commit *head_commit = NULL;
+    int rc;
+
+    ABCA_ASSERT( m_repo, "libgit2 repository must be open" );
+
+    m_incremental = true;
+
+    if (m_head_tree)
+        return true;
+
+    if (git_reference_name_to_id(&head_oid, m_repo, "HEAD") < 0)
+    {
+        TRACE("HEAD not found (no previous commits), nothing to reuse");
+        return false;
+    }
+
+    rc = git_commit_lookup(&head_commit, m_repo, &head_oid);
+    if (! git_check_ok(rc, "looking up HEAD commit"))
+        return false;
+
+    rc = git_commit_tree(&m_head_tree, head_commit);
+    git_commit_free(head_commit);
+    if (! git_check_ok(rc, "looking up HEAD commit tree"))
+    {
+        m_head_tree = NULL;
+        return false;
+    }
+
+    m_head_object_hashes.clear();
+
+    boost::optional<std::string> optHashes = headFile("object_hashes.json");
+    if (optHashes)
+    {
+        JSONParser json("object_hashes.json", *optHashes);
+        rapidjson::Document& document = json.document;
+
+        if (json.ok && document.HasMember("hashes") && document["hashes"].IsObject())
+        {
+            const rapidjson::Value& v_hashes = document["hashes"];
+            for (rapidjson::Value::ConstMemberIterator it = v_hashes.MemberBegin(); it != v_hashes.MemberEnd(); ++it)
+            {
+                boost::optional<std::string> o_hash = JsonGetString(it->value);
+                if (o_hash)
+                    m_head_object_hashes[it->name.GetString()] = *o_hash;
+            }
+        }
+    }
+
+    TRACE("incremental writes: " << m_head_object_hashes.size() << " object hashes in HEAD");
+    return true;
+}
+
+bool GitRepo::headEntry(const std::string& path, git_oid& oid, git_otype type) const
+{
+    if (! m_head_tree)
+        return false;
+
+    size_t start = path.find_first_not_of('/');
+    if (start == std::string::npos)
+        return false;
+
+    git_tree_entry *entry = NULL;
+    if (git_tree_entry_bypath(&entry, m_head_tree, path.c_str() + start) < 0)
+    {
+        giterr_clear();
+        return false;
+    }
+
+    bool found = (git_tree_entry_type(entry) == type);
+    if (found)
+        git_oid_cpy(&oid, git_tree_entry_id(entry));
+
+    git_tree_entry_free(entry);
+    return found;
+}
+
+boost::optional<std::string> GitRepo::headFile(const std::string& path) const
+{
+    git_oid oid;
+    if (! headEntry(path, oid, GIT_OBJ_BLOB))
+        return boost::none;
+
+    git_blob *blob = NULL;
+    int rc = git_blob_lookup(&blob, m_repo, &oid);
+    if (! git_check_ok(rc, "looking up HEAD blob"))
+        return boost::none;
+
+    std::string blob_str(static_cast<const char *>(git_blob_rawcontent(blob)), git_blob_rawsize(blob));
+    git_blob_free(blob);
+
+    return blob_str;
+}
+
+boost::optional<std::string> GitRepo::headObjectHash(const std::string& fullName) const
+{
+    std::map<std::string, std::string>::const_iterator it = m_head_object_hashes.find(fullName);
+    if (it == m_head_object_hashes.end())
+        return boost::none;
+    return it->second;
+}
+
+void GitRepo::setObjectHash(const std::string& fullName, const std::string& hash)
+{
+    m_object_hashes[fullName] = hash;
+}
+
+std::string GitRepo::packObjectHashes() const
+{
+    rapidjson::Document document;
+    document.SetObject();
+    rapidjson::Document::AllocatorType& allocator = document.GetAllocator();
+
+    JsonSet(document, "kind", "ObjectHashes");
+
+    rapidjson::Value jsonHashes( rapidjson::kObjectType );
+    std::map<std::string, std::string>::const_iterator it;
+    for (it = m_object_hashes.begin(); it != m_object_hashes.end(); ++it)
+    {
+        rapidjson::Value k(it->first.c_str(), it->first.length(), allocator);
+        rapidjson::Value v(it->second.c_str(), it->second.length(), allocator);
+        jsonHashes.AddMember(k, v, allocator);
+    }
+    JsonSet(document, "hashes", jsonHashes);
+
+    return JsonWrite(document);
+}
+
+// below this many bytes in a batch, starting the threads costs more than
+// hashing on the calling one
+static const size_t PARALLEL_HASH_MIN_BYTES = 1024 * 1024;
+
+// hashing only reads the contents, the workers pick the next blob to hash
+// from the shared counter so that a few large blobs don't stall the others
+static void hash_blobs(const std::vector<const std::string*>& contents,
+    std::vector<git_oid>& oids, std::vector<int>& rcs, std::atomic<size_t>& next)
+{
+    size_t i;
+    while ((i = next++) < contents.size())
+    {
+        const std::string& blob = *contents[i];
+        rcs[i] = git_odb_hash(&oids[i], blob.data(), blob.length(), GIT_OBJ_BLOB);
+    }
+}
+
+// git_odb_write() would hash the data once more, go to the backends
+// directly with the oid we already have
+static int odb_write_hashed(git_odb* odb, const git_oid& oid, const std::string& blob)
+{
+    int rc = -1;
+    bool tried = false;
+
+    size_t n_backends = git_odb_num_backends(odb);
+    for (size_t i = 0; (i < n_backends) && (rc < 0); ++i)
+    {
+        git_odb_backend* backend = NULL;
+        if ((git_odb_get_backend(&backend, odb, i) < 0) || !backend || !backend->write)
+            continue;
+
+        tried = true;
+        rc = backend->write(backend, &oid, blob.data(), blob.length(), GIT_OBJ_BLOB);
+    }
+
+    if (! tried)
+    {
+        git_oid written;
+        rc = git_odb_write(&written, odb, blob.data(), blob.length(), GIT_OBJ_BLOB);
+    }
+    return rc;
+}
+
+bool GitRepo::writeBlobs(const std::vector<const std::string*>& contents, std::vector<git_oid>& oids)
+{
+    size_t n_blobs = contents.size();
+    oids.resize(n_blobs);
+    if (n_blobs == 0)
+        return true;
+
+    size_t total = 0;
+    std::vector<const std::string*>::const_iterator it;
+    for (it = contents.begin(); it != contents.end(); ++it)
+        total += (*it)->length();
+
+    size_t n_threads = m_hash_threads ? m_hash_threads : std::thread::hardware_concurrency();
+    if (total < PARALLEL_HASH_MIN_BYTES)
+        n_threads = 1;
+    n_threads = std::max<size_t>(1, std::min(n_threads, n_blobs));
+
+    std::vector<int> rcs(n_blobs, 0);
+    std::atomic<size_t> next(0);
+
+    std::vector<std::thread> workers;
+    for (size_t t = 1; t < n_threads; ++t)
+        workers.push_back(std::thread(hash_blobs, std::cref(contents),
+            std::ref(oids), std::ref(rcs), std::ref(next)));
+    hash_blobs(contents, oids, rcs, next);
+
+    std::vector<std::thread>::iterator w_it;
+    for (w_it = workers.begin(); w_it != workers.end(); ++w_it)
+        w_it->join();
+
+    bool ok = true;
+    for (size_t i = 0; ok && (i < n_blobs); ++i)
+        ok = git_check_ok(rcs[i], "hashing blob");
+
+    // the backends are not thread-safe, the writes stay on this thread
+    for (size_t i = 0; ok && (i < n_blobs); ++i)
+    {
+        if (git_odb_exists(m_odb, &oids[i]))
+            continue;
+
+        ok = git_check_ok(odb_write_hashed(m_odb, oids[i], *contents[i]), "writing blob");
+    }
+
+    m_error = m_error || (!ok);
+    return ok;
+}
+
 /* groups */
 
 // create a group and add it as a child to this group
@@ -1402,13 +1669,6 @@ GitGroupPtr GitRepo::rootGroup()
 
 /* trash history */
 
-#define LOGMESSAGE( TEXT )                                       \
-do {                                                             \
-    std::ostringstream ss;                                       \
-    ss << TEXT;                                                  \
-    log_message = ss.str();                                      \
-} while( 0 )
-
 bool GitRepo::trashHistory(std::string& errorMessage, const std::string& branchName)
 {
     git_repository* repo = g_ptr();
@@ -1465,109 +1725,23 @@ bool GitRepo::trashHistory(std::string& errorMessage, const std::string& branchN
         return false;
     }
 
-    git_commit* fresh_commit = NULL;
-    git_commit_lookup(&fresh_commit, repo, &oid_fresh_commit);
-    assert(fresh_commit);
-
     git_oid_tostr(oid_str, 40, &oid_fresh_commit);
     TRACE("[TRASH HISTORY] fresh commit " << oid_str);
 
-    std::string oldBranchName = "old_" + branchName;
-    std::string freshBranchName = "fresh";
-    std::string log_message;
-
-    /* create a new branch, using the newly created commit */
-    git_reference *fresh_branch = NULL;
-    LOGMESSAGE("creating new trashed history branch '" << freshBranchName << "'");
-    rc = git_branch_create(&fresh_branch, repo,
-        /* branch name */ freshBranchName.c_str() /* "fresh" */, /* target */ fresh_commit, /* force */ 0);
-    ok = ok && git_check_rc(rc, log_message, errorMessage);
-    if (! ok)
-    {
-        if (fresh_branch) git_reference_free(fresh_branch);
-        git_tree_free(tree);
-        git_commit_free(commit);
-        return false;
-    }
-    assert(fresh_branch);
-
-    /* Make HEAD point to this branch */
-    assert(! head);
-    rc = git_reference_symbolic_create(&head, repo,
-        /* name */ "HEAD", /* target */ git_reference_name(fresh_branch),
-        /* force */ 1,
-        /* log_message */ "change HEAD when trashing history");
-    ok = ok && git_check_rc(rc, "setting HEAD", errorMessage);
-    if (! ok)
-    {
-        if (head) git_reference_free(head);
-        git_reference_free(fresh_branch);
-        git_tree_free(tree);
-        git_commit_free(commit);
-        return false;
-    }
-    assert(head);
-    git_reference_free(head);
-    head = NULL;
-
-    /* rename master -> old_master */
-    git_reference *master_branch = NULL;
-    git_branch_lookup(&master_branch, repo, branchName.c_str() /* "master" */, GIT_BRANCH_LOCAL);
-    assert(master_branch);
-    git_reference *old_master_branch = NULL;
-    LOGMESSAGE("renaming original '" << branchName << "' to '" << oldBranchName << "'");
-    rc = git_branch_move(&old_master_branch,
-        /* branch */ master_branch, /* new name */ oldBranchName.c_str() /* "old_master" */, /* force */ 0);
-    ok = ok && git_check_rc(rc, log_message, errorMessage);
-    if (! ok)
-    {
-        if (old_master_branch) git_reference_free(old_master_branch);
-        git_reference_free(master_branch);
-        git_reference_free(fresh_branch);
-        git_tree_free(tree);
-        git_commit_free(commit);
-        return false;
-    }
-    assert(old_master_branch);
-    git_reference_free(master_branch); master_branch = NULL;
-
-    /* rename fresh -> master */
-    git_reference *new_master_branch = NULL;
-    assert(fresh_branch);
-    LOGMESSAGE("renaming new '" << freshBranchName << "' to '" << branchName << "'");
-    rc = git_branch_move(&new_master_branch,
-        /* branch */ fresh_branch, /* new name */ branchName.c_str() /* "master" */, /* force */ 0);
-    ok = ok && git_check_rc(rc, log_message, errorMessage);
-    if (! ok)
-    {
-        if (new_master_branch) git_reference_free(new_master_branch);
-        git_reference_free(old_master_branch);
-        git_reference_free(fresh_branch);
-        git_tree_free(tree);
-        git_commit_free(commit);
-        return false;
-    }
-    assert(new_master_branch);
-    git_reference_free(new_master_branch); new_master_branch = NULL;
-    git_reference_free(fresh_branch); fresh_branch = NULL;
-
-    /* delete old_master */
-    assert(old_master_branch);
-    LOGMESSAGE("deleting original branch (now '" << oldBranchName << "')");
-    rc = git_branch_delete(old_master_branch);
-    ok = ok && git_check_rc(rc, log_message, errorMessage);
-    if (! ok)
-    {
-        git_reference_free(old_master_branch);
-        git_tree_free(tree);
-        git_commit_free(commit);
-        return false;
-    }
-    git_reference_free(old_master_branch); old_master_branch = NULL;
+    /* move the branch to the new commit, HEAD keeps pointing to it. The
+     * branch isn't renamed, libgit2 would follow a rename in the HEAD file
+     * but not in the HEAD of a milliways refdb */
+    std::string refName = "refs/heads/" + branchName;
+    git_reference *branch = NULL;
+    rc = git_reference_create(&branch, repo, refName.c_str(), &oid_fresh_commit,
+        /* force */ 1, "trash history");
+    ok = ok && git_check_rc(rc, "moving '" + branchName + "' to the new root commit", errorMessage);
+    if (branch)
+        git_reference_free(branch);
 
     git_tree_free(tree);
     git_commit_free(commit);
-    return true;
+    return ok;
 }
 
 /* fetch history */
@@ -1673,6 +1847,146 @@ std::ostream& operator<< (std::ostream& out, const GitRepo& repo)
 }
 
 
+/* --- GitBlob -------------------------------------------------------- */
+
+GitBlob::~GitBlob()
+{
+    if (m_blob)
+    {
+        git_blob_free(m_blob);
+        m_blob = NULL;
+    }
+}
+
+const char* GitBlob::data() const
+{
+    if (m_whole)
+        return m_whole->data() + m_offset;
+    return m_blob ? static_cast<const char *>(git_blob_rawcontent(m_blob)) : NULL;
+}
+
+size_t GitBlob::size() const
+{
+    if (m_whole)
+        return m_size;
+    return m_blob ? static_cast<size_t>(git_blob_rawsize(m_blob)) : 0;
+}
+
+
+/* --- GitPack -------------------------------------------------------- */
+
+const char* GitPack::FILENAME = ".pack";
+
+static const char GITPACK_MAGIC[4] = { '\xc1', 'P', 'C', 'K' };
+
+static uint64_t gitpack_get(const char* p, size_t nbytes)
+{
+    const unsigned char* u = reinterpret_cast<const unsigned char*>(p);
+    uint64_t value = 0;
+    for (size_t i = nbytes; i > 0; --i)
+        value = (value << 8) | u[i - 1];
+    return value;
+}
+
+static void gitpack_put(std::string& out, uint64_t value, size_t nbytes)
+{
+    for (size_t i = 0; i < nbytes; ++i)
+    {
+        out.push_back(static_cast<char>(value & 0xff));
+        value >>= 8;
+    }
+}
+
+static bool gitpack_is_header(const std::string& filename)
+{
+    return (filename.size() >= 5) && (filename.compare(filename.size() - 5, 5, ".json") == 0);
+}
+
+std::string GitPack::pack(const Contents& contents)
+{
+    // headers first, then the sample index tables
+    std::vector<Contents::const_iterator> order;
+    Contents::const_iterator it;
+    for (int pass = 0; pass < 2; ++pass)
+    {
+        for (it = contents.begin(); it != contents.end(); ++it)
+        {
+            if (gitpack_is_header(it->first) == (pass == 0))
+                order.push_back(it);
+        }
+    }
+
+    std::string out;
+    out.append(GITPACK_MAGIC, sizeof(GITPACK_MAGIC));
+    gitpack_put(out, VERSION, 4);
+    gitpack_put(out, order.size(), 4);
+
+    size_t offset = 0;
+    for (size_t i = 0; i < order.size(); ++i)
+    {
+        const std::string& name = order[i]->first;
+        gitpack_put(out, name.size(), 4);
+        out.append(name);
+        gitpack_put(out, offset, 8);
+        gitpack_put(out, order[i]->second.size(), 8);
+        offset += order[i]->second.size();
+    }
+
+    out.reserve(out.size() + offset);
+    for (size_t i = 0; i < order.size(); ++i)
+        out.append(order[i]->second);
+
+    return out;
+}
+
+bool GitPack::unpack(GitBlobPtr blob, Files& files)
+{
+    const char* data = blob->data();
+    size_t size = blob->size();
+
+    if ((size < 12) || (memcmp(data, GITPACK_MAGIC, sizeof(GITPACK_MAGIC)) != 0))
+        return false;
+
+    uint32_t version = static_cast<uint32_t>(gitpack_get(data + 4, 4));
+    ABCA_ASSERT( version == VERSION, "unsupported property pack version " << version );
+
+    size_t count = static_cast<size_t>(gitpack_get(data + 8, 4));
+
+    std::vector< std::pair<std::string, std::pair<size_t, size_t> > > directory;
+    directory.reserve(count);
+
+    size_t pos = 12;
+    for (size_t i = 0; i < count; ++i)
+    {
+        ABCA_ASSERT( pos + 4 <= size, "truncated property pack" );
+        size_t name_size = static_cast<size_t>(gitpack_get(data + pos, 4));
+        pos += 4;
+
+        ABCA_ASSERT( pos + name_size + 16 <= size, "truncated property pack" );
+        std::string name(data + pos, name_size);
+        pos += name_size;
+
+        size_t f_offset = static_cast<size_t>(gitpack_get(data + pos, 8));
+        size_t f_size   = static_cast<size_t>(gitpack_get(data + pos + 8, 8));
+        pos += 16;
+
+        directory.push_back(std::make_pair(name, std::make_pair(f_offset, f_size)));
+    }
+
+    for (size_t i = 0; i < directory.size(); ++i)
+    {
+        size_t f_offset = directory[i].second.first;
+        size_t f_size   = directory[i].second.second;
+        ABCA_ASSERT( (f_offset <= size - pos) && (f_size <= size - pos - f_offset),
+                     "corrupt property pack entry '" << directory[i].first << "'" );
+
+        files[directory[i].first] = GitBlobPtr(new GitBlob(blob, pos + f_offset, f_size));
+    }
+
+    return true;
+}
+
+
 /* --- GitTree -------------------------------------------------------- */
 
 GitTree::GitTree(GitRepoPtr repo) :
@@ -1836,6 +2150,15 @@ boost::optional<GitTreePtr> GitTree::getChildTree(const std::string& filename)
 }
 
 boost::optional<std::string> GitTree::getChildFile(const std::string& filename)
+{
+    boost::optional<GitBlobPtr> optBlob = getChildBlob(filename);
+    if (! optBlob)
+        return boost::none;
+
+    return (*optBlob)->str();
+}
+
+boost::optional<GitBlobPtr> GitTree::getChildBlob(const std::string& filename)
 {
     if (! m_tree)
         return boost::none;
@@ -1851,14 +2174,11 @@ boost::optional<std::string> GitTree::getChildFile(const std::string& filename)
     {
         git_blob *blob = NULL;
         int rc = git_blob_lookup(&blob, repo()->g_ptr(), git_tree_entry_id(entry));
-        m_error = m_error || git_check_error(rc, "getting child blob");
-
-        std::string blob_str(static_cast<const char *>(git_blob_rawcontent(blob)), git_blob_rawsize(blob));
+        // only written on failure, the tree is shared by the readers
+        if (git_check_error(rc, "getting child blob"))
+            m_error = true;
 
-        git_blob_free(blob);
-        blob = NULL;
-
-        return blob_str;
+        return GitBlobPtr(new GitBlob(blob));
     }
 
     return boost::none;
@@ -1912,7 +2232,8 @@ std::ostream& operator<< (std::ostream& out, const GitTree& tree)
 /* --- GitTreebuilder ------------------------------------------------- */
 
 GitTreebuilder::GitTreebuilder(GitRepoPtr repo) :
-    m_repo(repo), m_tree_bld(NULL), m_tree(NULL), m_written(false), m_dirty(false), m_error(false)
+    m_repo(repo), m_tree_bld(NULL), m_tree(NULL), m_written(false), m_dirty(false), m_error(false),
+    m_reused(false), m_pending_bytes(0)
 {
     int rc = git_treebuilder_new(&m_tree_bld, m_repo->g_ptr(), /* source */ NULL);
     m_error = m_error || git_check_error(rc, "creating treebuilder");
@@ -1990,6 +2311,9 @@ GitTreebuilderPtr GitTreebuilder::getChild(const std::string& filename)
 
 bool GitTreebuilder::dirty() const
 {
+    if (m_reused)
+        return false;
+
     if (m_dirty)
         return true;
 
@@ -2010,9 +2334,20 @@ bool GitTreebuilder::write()
     bool op_ok, ok = true;
     int rc;
 
+    if (m_reused)
+        return true;
+
     if (m_written && !dirty())
         return true;
 
+    // only our own blobs, the children write theirs below; the packed
+    // files are kept, a later write must still find every one of them
+    std::string pack;
+    if (! m_packed.empty())
+        pack = GitPack::pack(m_packed);
+    if (! _write_pending(m_packed.empty() ? NULL : &pack))
+        return false;
+
     std::vector<GitTreebuilderPtr>::iterator it;
     for (it = m_children.begin(); it != m_children.end(); ++it)
     {
@@ -2029,9 +2364,14 @@ bool GitTreebuilder::write()
     ok = ok && git_check_ok(rc, "writing treebuilder to the db");
     if (! ok) goto ret;
 
-    rc = git_tree_lookup(&m_tree, m_repo->g_ptr(), &m_tree_oid);
-    ok = ok && git_check_ok(rc, "looking up tree from tree oid");
-    if (! ok) goto ret;
+    // subtrees are only inserted into their parent by oid, just the root
+    // tree object is needed (to commit it)
+    if (isRoot())
+    {
+        rc = git_tree_lookup(&m_tree, m_repo->g_ptr(), &m_tree_oid);
+        ok = ok && git_check_ok(rc, "looking up tree from tree oid");
+        if (! ok) goto ret;
+    }
 
 ret:
     m_error = m_error || (!ok);
@@ -2040,31 +2380,86 @@ ret:
     return m_written;
 }
 
-bool GitTreebuilder::add_file_from_memory(const std::string& filename, const std::string& contents)
+bool GitTreebuilder::add_file_from_memory(const std::string& filename, std::string contents)
+{
+    if (m_reused)
+        return true;
+
+    m_pending_bytes += contents.length();
+    m_pending.push_back( std::make_pair(filename, std::string()) );
+    m_pending.back().second.swap(contents);
+    m_dirty = true;
+
+    // defer hashing and compressing the blob until we know whether
+    // the subtree has changed at all
+    if (m_repo->incrementalEnabled() && !isRoot())
+        return true;
+
+    // otherwise only until there is a batch worth hashing in parallel
+    if (m_pending_bytes < m_repo->writeBatchBytes())
+        return true;
+    return _write_pending(NULL);
+}
+
+bool GitTreebuilder::add_packed_file(const std::string& filename, std::string contents)
+{
+    if (m_reused)
+        return true;
+
+    m_packed[filename].swap(contents);
+    m_dirty = true;
+    return true;
+}
+
+bool GitTreebuilder::_write_pending(const std::string* pack)
 {
-    git_oid oid_blob;                       /* the SHA1 for our blob in the tree */
-    git_blob *blob = NULL;                  /* our blob in the tree */
+    std::vector< std::pair<std::string, std::string> > pending;
+    pending.swap(m_pending);
+    m_pending_bytes = 0;
+
+    std::vector<std::string> filenames;
+    std::vector<const std::string*> contents;
+
+    std::vector< std::pair<std::string, std::string> >::const_iterator p_it;
+    for (p_it = pending.begin(); p_it != pending.end(); ++p_it)
+    {
+        filenames.push_back(p_it->first);
+        contents.push_back(&p_it->second);
+    }
+
+    if (pack)
+    {
+        filenames.push_back(GitPack::FILENAME);
+        contents.push_back(pack);
+    }
+
+    if (contents.empty())
+        return true;
+    return _write_blobs_and_insert(filenames, contents);
+}
+
+bool GitTreebuilder::_write_blobs_and_insert(const std::vector<std::string>& filenames, const std::vector<const std::string*>& contents)
+{
+    std::vector<git_oid> oids;              /* the SHA1s for our blobs in the tree */
     int rc;
 
-    rc = git_blob_create_frombuffer(&oid_blob, m_repo->g_ptr(),
-        contents.c_str(), contents.length());
-    m_error = m_error || git_check_error(rc, "creating blob");
-    if (m_error) goto ret;
+    assert(filenames.size() == contents.size());
 
-    rc = git_blob_lookup(&blob, m_repo->g_ptr(), &oid_blob);
-    m_error = m_error || git_check_error(rc, "looking up blob oid");
+    // the oids are computed before writing, no need to read the blobs back
+    m_error = m_error || !m_repo->writeBlobs(contents, oids);
     if (m_error) goto ret;
 
-    rc = git_treebuilder_insert(NULL, m_tree_bld,
-        filename.c_str(), &oid_blob, GIT_FILEMODE_BLOB);
-    m_error = m_error || git_check_error(rc, "adding blob to treebuilder");
-    if (m_error) goto ret;
+    for (size_t i = 0; i < filenames.size(); ++i)
+    {
+        rc = git_treebuilder_insert(NULL, m_tree_bld,
+            filenames[i].c_str(), &oids[i], GIT_FILEMODE_BLOB);
+        m_error = m_error || git_check_error(rc, "adding blob to treebuilder");
+        if (m_error) goto ret;
+    }
 
     m_dirty = m_dirty || !m_error;
 
 ret:
-    if (blob)
-        git_blob_free(blob);
     return !m_error;
 }
 
@@ -2078,6 +2473,54 @@ GitTreebuilderPtr GitTreebuilder::add_tree(const std::string& filename)
     return GitTreebuilderPtr();
 }
 
+bool GitTreebuilder::insert(const std::string& filename, const git_oid& oid, git_filemode_t filemode)
+{
+    if (m_reused)
+        return true;
+
+    int rc = git_treebuilder_insert(NULL, m_tree_bld,
+        filename.c_str(), &oid, filemode);
+    m_error = m_error || git_check_error(rc, "adding existing object to treebuilder");
+
+    m_dirty = m_dirty || !m_error;
+
+    return !m_error;
+}
+
+bool GitTreebuilder::flush()
+{
+    if (m_reused)
+        return true;
+
+    bool ok = _write_pending(NULL);
+
+    std::vector<GitTreebuilderPtr>::iterator it;
+    for (it = m_children.begin(); it != m_children.end(); ++it)
+    {
+        ok = (*it)->flush() && ok;
+    }
+
+    return ok;
+}
+
+bool GitTreebuilder::reuse(const git_oid& oid)
+{
+    // whatever was staged for this subtree is identical to the existing
+    // tree, drop it without writing it
+    m_pending.clear();
+    m_pending_bytes = 0;
+    m_packed.clear();
+    m_children.clear();
+    m_children_set.clear();
+
+    git_oid_cpy(&m_tree_oid, &oid);
+    m_reused = true;
+    m_written = true;
+    m_dirty = false;
+
+    return true;
+}
+
 bool GitTreebuilder::_add_subtree(GitTreebuilderPtr subtreePtr)
 {
     if (m_children_set.count(subtreePtr) != 0)
@@ -2157,7 +2600,8 @@ GitObject::~GitObject()
 /* --- GitGroup ------------------------------------------------------- */
 
 GitGroup::GitGroup( GitRepoPtr repo, const std::string& name ) :
-    m_repo_ptr(repo), m_name(name), m_written(false), m_read(false)
+    m_repo_ptr(repo), m_name(name), m_written(false), m_read(false),
+    m_pack_read(false)
 {
     // top-level group
     TRACE("GitGroup::GitGroup(repo) created:" << repr());
@@ -2169,7 +2613,7 @@ GitGroup::GitGroup( GitRepoPtr repo, const std::string& name ) :
 
 GitGroup::GitGroup( GitGroupPtr parent, const std::string& name ) :
     m_repo_ptr(parent->repo()), m_parent_ptr(parent), m_name(name),
-    m_written(false), m_read(false)
+    m_written(false), m_read(false), m_pack_read(false)
 {
     // child group
     TRACE("GitGroup::GitGroup(parent) created:" << repr());
@@ -2214,6 +2658,9 @@ GitGroupPtr GitGroup::addGroup( const std::string& name )
 
 GitTreePtr GitGroup::tree()
 {
+    // looked up on first use, possibly by several property readers at once
+    Alembic::Util::scoped_lock l( m_tree_lock );
+
     if (! m_tree_ptr)
     {
         if (isTopLevel())
@@ -2275,9 +2722,45 @@ GitTreebuilderPtr GitGroup::treebuilder()
     return m_treebld_ptr;
 };
 
-bool GitGroup::add_file_from_memory(const std::string& filename, const std::string& contents)
+bool GitGroup::add_file_from_memory(const std::string& filename, std::string contents)
+{
+    return treebuilder()->add_file_from_memory(filename, std::move(contents));
+}
+
+bool GitGroup::add_property_file(const std::string& filename, std::string contents)
 {
-    return treebuilder()->add_file_from_memory(filename, contents);
+    if (repo()->packProperties())
+        return treebuilder()->add_packed_file(filename, std::move(contents));
+    return treebuilder()->add_file_from_memory(filename, std::move(contents));
+}
+
+boost::optional<GitBlobPtr> GitGroup::getFile(const std::string& filename)
+{
+    GitTreePtr tree_ = tree();
+
+    {
+        // the properties of a compound can be opened from several threads,
+        // the first one in unpacks for all of them
+        Alembic::Util::scoped_lock l( m_pack_lock );
+
+        if (! m_pack_read)
+        {
+            // one read for the files of all the properties of a compound
+            boost::optional<GitBlobPtr> optPack = tree_->getChildBlob(GitPack::FILENAME);
+            if (optPack)
+            {
+                ABCA_ASSERT( GitPack::unpack(*optPack, m_packed),
+                             "invalid property pack in '" << absPathname() << "'" );
+            }
+            m_pack_read = true;
+        }
+    }
+
+    GitPack::Files::const_iterator it = m_packed.find(filename);
+    if (it != m_packed.end())
+        return it->second;
+
+    return tree_->getChildBlob(filename);
 }
 
 GitDataPtr GitGroup::addData(Alembic::Util::uint64_t iSize, const void * iData)
@@ -27,7 +27,9 @@
 #include <iostream>
 #include <sstream>
 
+#include <map>
 #include <set>
+#include <utility>
 #include <vector>
 
 #include <boost/operators.hpp>
@@ -58,6 +60,7 @@ struct GitMode;
 class GitRepo;
 class GitTreebuilder;
 class GitTree;
+class GitBlob;
 
 class GitGroup;
 class GitData;
@@ -66,6 +69,7 @@ typedef Alembic::Util::shared_ptr<GitRepo> GitRepoPtr;
 typedef Alembic::Util::shared_ptr<const GitRepo> GitRepoConstPtr;
 typedef Alembic::Util::shared_ptr<GitTreebuilder> GitTreebuilderPtr;
 typedef Alembic::Util::shared_ptr<GitTree> GitTreePtr;
+typedef Alembic::Util::shared_ptr<GitBlob> GitBlobPtr;
 
 typedef Alembic::Util::shared_ptr<GitGroup> GitGroupPtr;
 typedef Alembic::Util::shared_ptr<const GitGroup> GitGroupConstPtr;
@@ -160,6 +164,12 @@ class GitRepo : public Alembic::Util::enable_shared_from_this<GitRepo>
 public:
     static const bool DEFAULT_IGNORE_WRONG_REV = false;
     static const bool DEFAULT_MILLIWAYS_ENABLED = false;
+    static const bool DEFAULT_INCREMENTAL_ENABLED = false;
+    static const size_t DEFAULT_BUNDLE_SAMPLES_BELOW = 200;
+    static const size_t DEFAULT_BUNDLE_FLUSH_BYTES = 16 * 1024 * 1024;
+    static const bool DEFAULT_PACK_PROPERTIES = false;
+    static const size_t DEFAULT_HASH_THREADS = 0;
+    static const size_t DEFAULT_WRITE_BATCH_BYTES = 8 * 1024 * 1024;
 
     GitRepo(const std::string& pathname, GitMode mode = GitMode::ReadWrite, bool milliwaysEnable = DEFAULT_MILLIWAYS_ENABLED);
     GitRepo(const std::string& pathname, const Alembic::AbcCoreFactory::IOptions& options, GitMode mode = GitMode::Read, bool milliwaysEnable = DEFAULT_MILLIWAYS_ENABLED);
@@ -212,6 +222,53 @@ public:
 
     std::string relpath(const std::string& pathname_) const;
 
+    /* incremental writes */
+
+    // look up the tree of the HEAD commit (if any) and the object hashes
+    // recorded with it, so that the writer can reuse the subtrees of the
+    // objects whose content didn't change
+    bool enableIncremental();
+    bool incrementalEnabled() const { return m_incremental; }
+    bool hasHeadTree() const        { return (m_head_tree != NULL); }
+
+    // samples smaller than this (in bytes) are written together in the
+    // bundle of their KeyStore instead of getting a blob of their own
+    void setBundleSamplesBelow(size_t nbytes) { m_bundle_below = nbytes; }
+    size_t bundleSamplesBelow() const         { return m_bundle_below; }
+
+    // the pending bundled samples are written as a segment of their own
+    // once they add up to this size (in bytes), 0 keeps them until the end
+    void setBundleFlushBytes(size_t nbytes)   { m_bundle_flush = nbytes; }
+    size_t bundleFlushBytes() const           { return m_bundle_flush; }
+
+    // write the property files of each compound as a GitPack
+    void setPackProperties(bool value)        { m_pack_properties = value; }
+    bool packProperties() const               { return m_pack_properties; }
+
+    // number of threads hashing the blobs of a batch, 0 uses one per core
+    void setHashThreads(size_t nthreads)      { m_hash_threads = nthreads; }
+    size_t hashThreads() const                { return m_hash_threads; }
+
+    // blobs are hashed and written in batches of about this size (in
+    // bytes), 0 writes each one as it is added
+    void setWriteBatchBytes(size_t nbytes)    { m_write_batch = nbytes; }
+    size_t writeBatchBytes() const            { return m_write_batch; }
+
+    // hash the blobs (in parallel for a large enough batch) and hand the
+    // resulting oids to the odb backend, skipping the blobs already stored
+    bool writeBlobs(const std::vector<const std::string*>& contents, std::vector<git_oid>& oids);
+
+    // look up the entry at the given path (relative to the root) in the
+    // HEAD commit tree
+    bool headEntry(const std::string& path, git_oid& oid, git_otype type) const;
+    boost::optional<std::string> headFile(const std::string& path) const;
+
+    // content hashes of the objects, by full name, as recorded in the HEAD
+    // commit and as written by this session
+    boost::optional<std::string> headObjectHash(const std::string& fullName) const;
+    void setObjectHash(const std::string& fullName, const std::string& hash);
+    std::string packObjectHashes() const;
+
     /* groups */
 
     // create a top-level group from this repo
@@ -273,6 +330,17 @@ private:
     bool m_milliways_enabled;
     std::string m_support_repo;
 
+    bool m_incremental;
+    git_tree *m_head_tree;
+    std::map<std::string, std::string> m_head_object_hashes;
+    std::map<std::string, std::string> m_object_hashes;
+
+    size_t m_bundle_below;
+    size_t m_bundle_flush;
+    bool m_pack_properties;
+    size_t m_hash_threads;
+    size_t m_write_batch;
+
     bool m_cleaned_up;
 };
 
@@ -280,6 +348,66 @@ std::ostream& operator<< (std::ostream& out, const GitRepo& repo);
 inline std::ostream& operator<< (std::ostream& out, const GitRepoPtr& repoPtr) { out << *repoPtr; return out; }
 
 
+/* --- GitBlob -------------------------------------------------------- */
+
+// Keeps a looked up blob alive, so its content can be parsed in place
+// instead of being copied out of the libgit2 object cache.
+// The memory returned by data() is read-only and is only valid while
+// the GitBlob exists.
+class GitBlob : private Alembic::Util::noncopyable
+{
+public:
+    explicit GitBlob(git_blob* blob) : m_blob(blob), m_offset(0), m_size(0) {}
+    // a slice of another blob, which is kept alive along with it
+    GitBlob(GitBlobPtr whole, size_t offset, size_t size) :
+        m_blob(NULL), m_whole(whole), m_offset(offset), m_size(size) {}
+    ~GitBlob();
+
+    const char* data() const;
+    size_t size() const;
+
+    std::string str() const                 { return std::string(data(), size()); }
+
+    // NULL for a slice
+    git_blob* g_ptr()                       { return m_blob; }
+    const git_blob* g_ptr() const           { return m_blob; }
+
+private:
+    git_blob* m_blob;
+    GitBlobPtr m_whole;
+    size_t m_offset;
+    size_t m_size;
+};
+
+
+/* --- GitPack -------------------------------------------------------- */
+
+// The headers and sample index tables of the properties of a compound,
+// written as a single blob instead of a .json and a .bin blob each.
+//
+// Layout (integers are little endian):
+//
+//   magic      4 bytes, "\xc1PCK"
+//   version    uint32
+//   count      uint32, number of files
+//   directory  count x (uint32 name size, name, uint64 offset, uint64 size)
+//   data       the .json headers first, then the other files
+class GitPack
+{
+public:
+    static const char* FILENAME;
+    static const uint32_t VERSION = 1;
+
+    typedef std::map<std::string, std::string> Contents;
+    typedef std::map<std::string, GitBlobPtr> Files;
+
+    static std::string pack(const Contents& contents);
+
+    // the files returned are slices of the pack blob
+    static bool unpack(GitBlobPtr blob, Files& files);
+};
+
+
 /* --- GitTree -------------------------------------------------------- */
 
 class GitTree : public Alembic::Util::enable_shared_from_this<GitTree>, private boost::totally_ordered<GitTree>
@@ -309,6 +437,9 @@ public:
 
     boost::optional<std::string> getChildFile(const std::string& filename);
 
+    // same as getChildFile(), without copying the content
+    boost::optional<GitBlobPtr> getChildBlob(const std::string& filename);
+
     bool hasChild(const std::string& filename);
     bool hasFileChild(const std::string& filename);
     bool hasTreeChild(const std::string& filename);
@@ -407,17 +538,34 @@ public:
     git_repository* g_repo_ptr() const      { return m_repo->g_ptr(); }
 
     const git_oid& oid() const              { return m_tree_oid; }
+    // only looked up for the root, once written
     git_tree* tree()                        { return m_tree; }
     git_tree* tree() const                  { return m_tree; }
 
     virtual bool write();
-    virtual bool add_file_from_memory(const std::string& filename, const std::string& contents);
+    // the contents are swapped into the pending batch, not copied: pass
+    // them with std::move() when the caller is done with them
+    virtual bool add_file_from_memory(const std::string& filename, std::string contents);
+
+    // written along with the tree, all together as a GitPack
+    virtual bool add_packed_file(const std::string& filename, std::string contents);
 
     // WARNING: be sure to have an existing shared_ptr to this treebuilder
     // before calling the following method!
     // (Because it uses shared_from_this()...)
     virtual GitTreebuilderPtr add_tree(const std::string& filename);
 
+    // add an entry for an object already in the db
+    virtual bool insert(const std::string& filename, const git_oid& oid, git_filemode_t filemode);
+
+    // with incremental writes the blobs below the root are kept in memory
+    // until flush() writes them, or reuse() replaces the whole subtree with
+    // an existing tree; otherwise they are written in batches of about
+    // GitRepo::writeBatchBytes(), hashed together
+    virtual bool flush();
+    virtual bool reuse(const git_oid& oid);
+    bool reused() const                     { return m_reused; }
+
     virtual bool dirty() const;
 
     static bool cmp(const GitTreebuilder& a, const GitTreebuilder& b)
@@ -445,6 +593,8 @@ private:
 
     bool _add_subtree(GitTreebuilderPtr subtreePtr);
     bool _write_subtree_and_insert(GitTreebuilderPtr child);
+    bool _write_pending(const std::string* pack);
+    bool _write_blobs_and_insert(const std::vector<std::string>& filenames, const std::vector<const std::string*>& contents);
 
     void _set_parent(GitTreebuilderPtr parent);
     void _set_filename(const std::string& filename);
@@ -458,6 +608,11 @@ private:
     bool m_written;
     bool m_dirty;
     bool m_error;
+    bool m_reused;
+
+    std::vector< std::pair<std::string, std::string> > m_pending;     /* blobs not written yet */
+    size_t m_pending_bytes;                                           /* their total size */
+    GitPack::Contents m_packed;                                       /* files of our GitPack */
 
     std::set<GitTreebuilderPtr> m_children_set;
     std::vector<GitTreebuilderPtr> m_children;
@@ -538,7 +693,14 @@ public:
 
     GitTreebuilderPtr treebuilder();
 
-    bool add_file_from_memory(const std::string& filename, const std::string& contents);
+    bool add_file_from_memory(const std::string& filename, std::string contents);
+
+    // a header or sample index table of a property, packed if the
+    // repository is set to pack properties
+    bool add_property_file(const std::string& filename, std::string contents);
+
+    // look up a file of this group, in its GitPack first if it has one
+    boost::optional<GitBlobPtr> getFile(const std::string& filename);
 
     // write the data stream and add it as a child to this group
     GitDataPtr addData(Alembic::Util::uint64_t iSize, const void * iData);
@@ -598,6 +760,11 @@ private:
 
     bool            m_written;
     bool            m_read;
+
+    Alembic::Util::mutex m_tree_lock;                 /* guards the lazy lookup of m_tree_ptr */
+    Alembic::Util::mutex m_pack_lock;                 /* guards the lazy read of m_packed */
+    bool            m_pack_read;
+    GitPack::Files  m_packed;
 };
 
 std::ostream& operator<< (std::ostream& out, const GitGroup& group);
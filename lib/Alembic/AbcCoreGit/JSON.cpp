@@ -33,6 +33,12 @@ JSONParser::JSONParser(const std::string& jsonPathname, const std::string& jsonC
     parseString(jsonPathname, jsonContents);
 }
 
+JSONParser::JSONParser(const std::string& jsonPathname, const char* jsonData, size_t jsonSize) :
+    ok(false)
+{
+    parseBuffer(jsonPathname, jsonData, jsonSize);
+}
+
 JSONParser::JSONParser(const std::string& jsonPathname) :
     ok(false)
 {
@@ -76,28 +82,27 @@ bool JSONParser::parseFile(const std::string& jsonPathname)
 
 bool JSONParser::parseString(const std::string& jsonPathname, const std::string& jsonContents)
 {
-    std::stringstream jsonBuffer;
-
-    jsonBuffer.str(jsonContents);
-
-    size_t jsonSize = jsonContents.length();
-
-    jsonBuffer.seekg(0, std::ios::beg);
+    return parseBuffer(jsonPathname, jsonContents.data(), jsonContents.size());
+}
 
+bool JSONParser::parseBuffer(const std::string& jsonPathname, const char* jsonData, size_t jsonSize)
+{
+#ifdef JSON_IN_SITU_PARSING
+    // In-situ parsing needs a mutable, NUL-terminated copy of the source.
     m_jsonCharBufferPtr.reset( new char[jsonSize + 1] );
-    jsonBuffer.read( m_jsonCharBufferPtr.get(), jsonSize );
+    memcpy( m_jsonCharBufferPtr.get(), jsonData, jsonSize );
     m_jsonCharBufferPtr.get()[jsonSize] = '\0';
 
-#ifdef JSON_IN_SITU_PARSING
-    // In-situ parsing, decode strings directly in the source string. Source must be string.
     if (document.ParseInsitu(m_jsonCharBufferPtr.get()).HasParseError())
     {
         ABCA_THROW( "format error while parsing '" << jsonPathname << "': " << GetParseError_En(document.GetParseError()) );
         ok = false;
     }
 #else
-    // "normal" parsing, decode strings to new buffers. Can use other input stream via ParseStream().
-    if (document.Parse(jsonContents.c_str()).HasParseError())
+    // "normal" parsing straight from the caller's buffer (e.g. a git blob),
+    // strings are decoded to new buffers so nothing is copied up front.
+    rapidjson::MemoryStream jsonStream(jsonData, jsonSize);
+    if (document.ParseStream(jsonStream).HasParseError())
     {
         ABCA_THROW( "format error while parsing '" << jsonPathname << "': " << GetParseError_En(document.GetParseError()) );
         ok = false;
@@ -28,6 +28,7 @@
 #include <boost/utility/in_place_factory.hpp>
 #include <rapidjson/document.h>     // rapidjson's DOM-style API
 #include <rapidjson/error/en.h>     // english error messages
+#include <rapidjson/memorystream.h> // for parsing from read-only buffers
 #include <rapidjson/stringbuffer.h> // for I/O to/from strings
 #include <rapidjson/writer.h>       // for output writer
 
@@ -756,6 +757,7 @@ class JSONParser
 public:
     JSONParser();
     JSONParser(const std::string& jsonPathname, const std::string& jsonContents);
+    JSONParser(const std::string& jsonPathname, const char* jsonData, size_t jsonSize);
     JSONParser(const std::string& jsonPathname);
     virtual ~JSONParser() {}
 
@@ -765,20 +767,41 @@ public:
     bool parseFile(const std::string& jsonPathname);
     bool parseString(const std::string& jsonPathname, const std::string& jsonContents);
 
+    // parses jsonSize bytes at jsonData, which don't need to be
+    // NUL-terminated nor to outlive the call
+    bool parseBuffer(const std::string& jsonPathname, const char* jsonData, size_t jsonSize);
+
 private:
     Util::shared_ptr<char> m_jsonCharBufferPtr;
 };
 
+// rapidjson output stream writing straight into a std::string, saving the
+// copy out of a rapidjson::StringBuffer
+class JsonStringStream
+{
+public:
+    typedef char Ch;
+
+    explicit JsonStringStream(std::string& str) : m_str(str) {}
+
+    void Put(Ch c) { m_str.push_back(c); }
+    void Flush() {}
+
+private:
+    std::string& m_str;
+};
+
 inline std::string JsonWrite(const rapidjson::Document& document)
 {
-    rapidjson::StringBuffer buffer;
-    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+    std::string output;
+    JsonStringStream stream(output);
+    rapidjson::Writer<JsonStringStream> writer(stream);
     document.Accept(writer);
     // rapidjson::StringStream ss;
     // PrettyWriter<StringStream> writer(ss);
     // document.Accept(writer);
 
-    return buffer.GetString();
+    return output;
 }
 
 } // End namespace ALEMBIC_VERSION_NS
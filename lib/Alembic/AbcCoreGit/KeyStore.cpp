@@ -21,6 +21,7 @@
 #include <iomanip>
 #include <sstream>
 #include <cassert>
+#include <cstring>
 
 #include <Alembic/AbcCoreGit/KeyStore.h>
 #include <Alembic/AbcCoreGit/Utils.h>
@@ -117,6 +118,186 @@ static size_t hex2bin(uint8_t *dst, const char* src)
     return (dst - dst_orig);
 }
 
+/* --------------------------------------------------------------------
+ *
+ *   BundleIndex
+ *
+ * -------------------------------------------------------------------- */
+
+static const char BUNDLE_MAGIC[4] = { '\xc1', 'K', 'S', 'B' };
+static const size_t BUNDLE_HEADER_SIZE = 16;
+
+static uint64_t get_le(const char* p, size_t nbytes)
+{
+    const unsigned char* u = reinterpret_cast<const unsigned char*>(p);
+    uint64_t value = 0;
+    for (size_t i = nbytes; i > 0; --i)
+        value = (value << 8) | u[i - 1];
+    return value;
+}
+
+static void put_le(std::string& out, uint64_t value, size_t nbytes)
+{
+    for (size_t i = 0; i < nbytes; ++i)
+    {
+        out.push_back(static_cast<char>(value & 0xff));
+        value >>= 8;
+    }
+}
+
+BundleIndex::BundleIndex() :
+    m_count(0), m_record_size(0),
+    m_kids(NULL), m_offsets(NULL), m_records(NULL), m_records_size(0)
+{
+}
+
+void BundleIndex::close()
+{
+    m_blob.reset();
+    m_count = m_record_size = m_records_size = 0;
+    m_kids = m_offsets = m_records = NULL;
+}
+
+bool BundleIndex::open(GitBlobPtr blob)
+{
+    close();
+
+    const char* data = blob->data();
+    size_t size = blob->size();
+
+    if ((size < BUNDLE_HEADER_SIZE) || (memcmp(data, BUNDLE_MAGIC, sizeof(BUNDLE_MAGIC)) != 0))
+        return false;
+
+    uint32_t version = static_cast<uint32_t>(get_le(data + 4, 4));
+    ABCA_ASSERT( version == VERSION, "unsupported KeyStore bundle version " << version );
+
+    size_t count       = static_cast<size_t>(get_le(data + 8, 4));
+    size_t record_size = static_cast<size_t>(get_le(data + 12, 4));
+
+    size_t index_size = count * 8;
+    if (record_size == 0)
+        index_size += (count + 1) * 8;
+    ABCA_ASSERT( size >= BUNDLE_HEADER_SIZE + index_size, "truncated KeyStore bundle" );
+
+    m_count        = count;
+    m_record_size  = record_size;
+    m_kids         = data + BUNDLE_HEADER_SIZE;
+    m_offsets      = (record_size == 0) ? (m_kids + count * 8) : NULL;
+    m_records      = data + BUNDLE_HEADER_SIZE + index_size;
+    m_records_size = size - BUNDLE_HEADER_SIZE - index_size;
+
+    if (record_size != 0)
+        ABCA_ASSERT( m_records_size >= count * record_size, "truncated KeyStore bundle" );
+    else
+        ABCA_ASSERT( m_records_size >= get_le(m_offsets + count * 8, 8), "truncated KeyStore bundle" );
+
+    m_blob = blob;
+    return true;
+}
+
+size_t BundleIndex::kidAt(size_t i) const
+{
+    assert(i < m_count);
+    return static_cast<size_t>(get_le(m_kids + i * 8, 8));
+}
+
+bool BundleIndex::find(size_t kid, size_t& i) const
+{
+    if (m_count == 0)
+        return false;
+
+    size_t first = kidAt(0);
+    if ((kid >= first) && (kid - first < m_count) && (kidAt(kid - first) == kid))
+    {
+        i = kid - first;
+        return true;
+    }
+
+    size_t lo = 0, hi = m_count;
+    while (lo < hi)
+    {
+        size_t mid = lo + (hi - lo) / 2;
+        size_t mid_kid = kidAt(mid);
+        if (mid_kid == kid)
+        {
+            i = mid;
+            return true;
+        }
+        if (mid_kid < kid)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return false;
+}
+
+void BundleIndex::record(size_t i, const char*& data, size_t& size) const
+{
+    assert(isOpen() && (i < m_count));
+
+    size_t begin, end;
+    if (m_record_size != 0)
+    {
+        begin = i * m_record_size;
+        end   = begin + m_record_size;
+    } else
+    {
+        begin = static_cast<size_t>(get_le(m_offsets + i * 8, 8));
+        end   = static_cast<size_t>(get_le(m_offsets + (i + 1) * 8, 8));
+    }
+    ABCA_ASSERT( (begin <= end) && (end <= m_records_size), "corrupt KeyStore bundle index" );
+
+    data = m_records + begin;
+    size = end - begin;
+}
+
+void BundleIndex::pack(std::string& out, const std::vector<size_t>& kids,
+                       const std::vector<std::string>& records)
+{
+    assert(kids.size() == records.size());
+
+    size_t count = kids.size();
+
+    // scalar properties usually pack to records of the same size, which
+    // spares the offsets
+    size_t record_size = (count > 0) ? records[0].size() : 0;
+    size_t records_size = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (records[i].size() != record_size)
+            record_size = 0;
+        records_size += records[i].size();
+    }
+
+    out.clear();
+    out.reserve(BUNDLE_HEADER_SIZE + count * 16 + 8 + records_size);
+
+    out.append(BUNDLE_MAGIC, sizeof(BUNDLE_MAGIC));
+    put_le(out, VERSION, 4);
+    put_le(out, count, 4);
+    put_le(out, record_size, 4);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        assert((i == 0) || (kids[i - 1] < kids[i]));
+        put_le(out, kids[i], 8);
+    }
+
+    if (record_size == 0)
+    {
+        size_t offset = 0;
+        for (size_t i = 0; i < count; ++i)
+        {
+            put_le(out, offset, 8);
+            offset += records[i].size();
+        }
+        put_le(out, offset, 8);
+    }
+
+    for (size_t i = 0; i < count; ++i)
+        out.append(records[i]);
+}
+
 /* --------------------------------------------------------------------
  *
  *   KeyStoreMap
@@ -181,7 +362,10 @@ KeyStoreBase::~KeyStoreBase()
 
 template <typename T>
 KeyStore<T>::KeyStore(GitGroupPtr groupPtr, RWMode rwmode) :
-    m_group(groupPtr), m_rwmode(rwmode), m_next_kid(0), m_saved(false), m_loaded(false),
+    m_group(groupPtr), m_rwmode(rwmode), m_next_kid(0), m_seeded(false), m_saved(false), m_loaded(false),
+    m_bundle_below(groupPtr->repo()->bundleSamplesBelow()),
+    m_bundle_flush(groupPtr->repo()->bundleFlushBytes()),
+    m_bundled_bytes(0), m_bundle_segments(0),
     m_samples_unbundled(0), m_samples_bundled(0),
     m_write_info(false), m_write_packed(0)
 {
@@ -192,6 +376,9 @@ KeyStore<T>::KeyStore(GitGroupPtr groupPtr, RWMode rwmode) :
         {
             readFromDisk();
         }
+    } else if (m_group->repo()->hasHeadTree())
+    {
+        seedFromHead();
     }
 }
 
@@ -232,35 +419,92 @@ bool KeyStore<T>::writeToDiskSampleData(size_t kid, const AbcA::ArraySample::Key
 
     size_t estimated_size = data.size() * sizeof(T);
 
-    if (estimated_size >= BUNDLE_SAMPLES_BELOW)
+    if (estimated_size >= m_bundle_below)
     {
-        TRACE("KeyStore::writeToDiskSampleData() estimated_size:" << estimated_size << " >= " << BUNDLE_SAMPLES_BELOW);
-        std::stringstream buffer;
-        msgpack::packer<std::stringstream> pk(&buffer);
+        TRACE("KeyStore::writeToDiskSampleData() estimated_size:" << estimated_size << " >= " << m_bundle_below);
+        std::string packedSample;
+        MsgPackStringBuffer buffer(packedSample);
+        msgpack::packer<MsgPackStringBuffer> pk(&buffer);
 
         mp_pack(pk, data);
 
-        std::string packedSample = buffer.str();
-
         std::ostringstream ss;
         ss << "_" << key.digest.str();
         std::string suffix = ss.str();
 
         std::string name = m_basename + suffix + ".bin";
 
-        m_group->add_file_from_memory(name, packedSample);
-
         m_write_packed += packedSample.length();
+        m_group->add_file_from_memory(name, std::move(packedSample));
+
         m_samples_unbundled++;
     } else
     {
         // write later, in bundled form
         m_bundled_data[kid] = data;
+        m_bundled_bytes += estimated_size;
+
+        // the root tree builder holds on to one batch of blobs at most, so
+        // flushing a segment lets go of its samples
+        if (m_bundle_flush && (m_bundled_bytes >= m_bundle_flush))
+            flushBundle();
     }
 
     return true;
 }
 
+template <typename T>
+bool KeyStore<T>::writeBundle(const std::string& name_bundle)
+{
+    assert(m_rwmode == WRITE);
+
+    std::vector<size_t> kids;
+    std::vector<std::string> records;
+    kids.reserve(m_bundled_data.size());
+    records.reserve(m_bundled_data.size());
+
+    typename std::map< size_t, std::vector<T> >::const_iterator b_it;
+    for (b_it = m_bundled_data.begin(); b_it != m_bundled_data.end(); ++b_it)
+    {
+        size_t kid                 = (*b_it).first;
+        const std::vector<T>& data = (*b_it).second;
+
+        kids.push_back(kid);
+        records.push_back(std::string());
+
+        MsgPackStringBuffer buffer(records.back());
+        msgpack::packer<MsgPackStringBuffer> pk(&buffer);
+        mp_pack(pk, data);
+
+        m_samples_bundled++;
+    }
+
+    std::string packedBundle;
+    BundleIndex::pack(packedBundle, kids, records);
+
+    size_t npacked = packedBundle.length();
+    bool ok = m_group->add_file_from_memory(name_bundle, std::move(packedBundle));
+
+    m_write_packed += npacked;
+    TRACE("bundle '" << name_bundle << "' packed to " << npacked << " bytes for # " << kids.size() << " (different) bundled samples of type " << GetTypeStr<T>());
+
+    m_bundled_data.clear();
+    m_bundled_bytes = 0;
+
+    return ok;
+}
+
+template <typename T>
+bool KeyStore<T>::flushBundle()
+{
+    ensureWriteInfo();
+
+    std::ostringstream ss;
+    ss << m_basename << "_bundle_" << m_bundle_segments++ << ".bin";
+
+    return writeBundle(ss.str());
+}
+
 template <typename T>
 bool KeyStore<T>::writeToDisk()
 {
@@ -287,10 +531,16 @@ bool KeyStore<T>::writeToDisk()
 
     std::string name_header = basename + "_header" + ".bin";
 
-    std::stringstream buffer;
-    msgpack::packer<std::stringstream> pk(&buffer);
+    std::string packedHeader;
+    MsgPackStringBuffer buffer(packedHeader);
+    msgpack::packer<MsgPackStringBuffer> pk(&buffer);
 
-    mp_pack(pk, static_cast<size_t>(m_kid_to_key.size()));
+    // keys seeded from HEAD but not used anymore have no data, leave them out
+    size_t n_kid = m_kid_to_key.size();
+    if (m_seeded)
+        n_kid = m_has_kid_data.size();
+
+    mp_pack(pk, static_cast<size_t>(n_kid));
     mp_pack(pk, static_cast<size_t>(m_next_kid));
 
     size_t n_samples = 0;
@@ -301,6 +551,9 @@ bool KeyStore<T>::writeToDisk()
             size_t kid                        = (*p_it).first;
             const AbcA::ArraySample::Key& key = (*p_it).second;
 
+            if (m_seeded && !m_has_kid_data.count(kid))
+                continue;
+
             msgpack::type::tuple< size_t, size_t, std::string, std::string, std::string >
                 tuple(kid, key.numBytes, pod2str(key.origPOD), pod2str(key.readPOD), key.digest.str());
 
@@ -309,42 +562,14 @@ bool KeyStore<T>::writeToDisk()
         }
     }
 
-    std::string packedHeader = buffer.str();
-    m_group->add_file_from_memory(name_header, packedHeader);
-
     size_t npacked = packedHeader.length();
+    m_group->add_file_from_memory(name_header, std::move(packedHeader));
+
     m_write_packed += npacked;
     TRACE("header packed to " << npacked << " bytes for # " << n_samples << " (different) samples of type " << GetTypeStr<T>());
 
-    // pack & write bundled samples
-    {
-        std::string name_bundle = basename + "_bundle" + ".bin";
-
-        std::stringstream buffer;
-        msgpack::packer<std::stringstream> pk(&buffer);
-
-        mp_pack(pk, static_cast<size_t>(m_bundled_data.size()));
-
-        m_samples_bundled = 0;
-        typename std::map< size_t, std::vector<T> >::const_iterator b_it;
-        for (b_it = m_bundled_data.begin(); b_it != m_bundled_data.end(); ++b_it)
-        {
-            size_t kid                 = (*b_it).first;
-            const std::vector<T>& data = (*b_it).second;
-
-            mp_pack(pk, kid);
-            mp_pack(pk, data);
-
-            m_samples_bundled++;
-        }
-
-        std::string packedBundle = buffer.str();
-        m_group->add_file_from_memory(name_bundle, packedBundle);
-
-        size_t npacked = packedBundle.length();
-        m_write_packed += npacked;
-        TRACE("bundle packed to " << npacked << " bytes for # " << m_samples_bundled << " (different) bundled samples of type " << GetTypeStr<T>());
-    }
+    // pack & write the bundled samples not flushed yet
+    writeBundle(basename + "_bundle" + ".bin");
 
 #if 0
     // pack & write samples
@@ -373,6 +598,80 @@ bool KeyStore<T>::writeToDisk()
     return true;
 }
 
+template <typename T>
+size_t KeyStore<T>::unpackHeader(const char* packedData, size_t packedSize)
+{
+    MsgPackBufferUnpacker pac(packedData, packedSize);
+
+    // deserialize it.
+    msgpack::unpacked msg;
+
+    size_t v_n_kid = 0;
+    size_t v_next_kid = 0;
+
+    m_key_to_kid.clear();
+    m_kid_to_key.clear();
+    m_next_kid = 0;
+
+    pac.next(&msg);
+    msgpack::object pko = msg.get();
+    mp_unpack(pko, v_n_kid);
+
+    pac.next(&msg);
+    pko = msg.get();
+    mp_unpack(pko, v_next_kid);
+
+    for (size_t i = 0; i < v_n_kid; ++i)
+    {
+        msgpack::type::tuple< size_t, size_t, std::string, std::string, std::string > tuple;
+
+        pac.next(&msg);
+        msgpack::object pko = msg.get();
+        mp_unpack(pko, tuple);
+
+        size_t      k_kid       = tuple.get<0>();
+        size_t      k_num_bytes = tuple.get<1>();
+        std::string k_orig_pod  = tuple.get<2>();
+        std::string k_read_pod  = tuple.get<3>();
+        std::string k_digest    = tuple.get<4>();
+
+        AbcA::ArraySample::Key key;
+
+        key.numBytes = k_num_bytes;
+        key.origPOD = Alembic::Util::PODFromName( k_orig_pod );
+        key.readPOD = Alembic::Util::PODFromName( k_read_pod );
+        hex2bin(key.digest.d, k_digest.c_str());
+
+        m_kid_to_key[k_kid] = key;
+        m_key_to_kid[key]   = k_kid;
+    }
+
+    // set m_next_kid
+    m_next_kid = v_next_kid;
+    assert(static_cast<size_t>(m_kid_to_key.size()) == v_n_kid);
+
+    return v_n_kid;
+}
+
+template <typename T>
+bool KeyStore<T>::seedFromHead()
+{
+    assert(m_rwmode == WRITE);
+
+    std::string name_header = "keystore_" + GetTypeStr<T>() + "_header" + ".bin";
+
+    boost::optional<std::string> optBinHeaderContents =
+        m_group->repo()->headFile(v_pathjoin(m_group->treebuilder()->pathname(), name_header, '/'));
+    if (! optBinHeaderContents)
+        return false;
+
+    unpackHeader(optBinHeaderContents->data(), optBinHeaderContents->size());
+    m_seeded = true;
+
+    TRACE("KeyStore::seedFromHead() seeded " << m_kid_to_key.size() << " keys of type " << GetTypeStr<T>());
+    return true;
+}
+
 template <typename T>
 bool KeyStore<T>::readFromDisk()
 {
@@ -402,9 +701,9 @@ bool KeyStore<T>::readFromDisk()
     // read & unpack header
 
     std::string name_header = basename + "_header" + ".bin";
-    boost::optional<std::string> optBinHeaderContents = gitTree->getChildFile(name_header);
+    boost::optional<GitBlobPtr> optBinHeaderBlob = gitTree->getChildBlob(name_header);
 #if 0
-    if (! optBinHeaderContents)
+    if (! optBinHeaderBlob)
     {
         ABCA_THROW( "can't read git blob '" << pathjoin(m_group->absPathname(), name_header) << "'" );
         return false;
@@ -412,68 +711,14 @@ bool KeyStore<T>::readFromDisk()
 #endif
 
     size_t v_n_kid = 0;
-    size_t v_next_kid = 0;
 
-    if (optBinHeaderContents)
+    if (optBinHeaderBlob)
     {
-        std::string packedHeader = *optBinHeaderContents;
-
-        {
-            msgpack::unpacker pac;
-
-            // copy the buffer data to the unpacker object
-            pac.reserve_buffer(packedHeader.size());
-            memcpy(pac.buffer(), packedHeader.data(), packedHeader.size());
-            pac.buffer_consumed(packedHeader.size());
-
-            // deserialize it.
-            msgpack::unpacked msg;
-
-            m_key_to_kid.clear();
-            m_kid_to_key.clear();
-            m_next_kid = 0;
-
-            pac.next(&msg);
-            msgpack::object pko = msg.get();
-            mp_unpack(pko, v_n_kid);
-
-            pac.next(&msg);
-            pko = msg.get();
-            mp_unpack(pko, v_next_kid);
-
-            for (size_t i = 0; i < v_n_kid; ++i)
-            {
-                msgpack::type::tuple< size_t, size_t, std::string, std::string, std::string > tuple;
-
-                pac.next(&msg);
-                msgpack::object pko = msg.get();
-                mp_unpack(pko, tuple);
-
-                size_t      k_kid       = tuple.get<0>();
-                size_t      k_num_bytes = tuple.get<1>();
-                std::string k_orig_pod  = tuple.get<2>();
-                std::string k_read_pod  = tuple.get<3>();
-                std::string k_digest    = tuple.get<4>();
-
-                AbcA::ArraySample::Key key;
+        GitBlobPtr packedHeader = *optBinHeaderBlob;
 
-                key.numBytes = k_num_bytes;
-                key.origPOD = Alembic::Util::PODFromName( k_orig_pod );
-                key.readPOD = Alembic::Util::PODFromName( k_read_pod );
-                hex2bin(key.digest.d, k_digest.c_str());
+        v_n_kid = unpackHeader(packedHeader->data(), packedHeader->size());
 
-                //std::string key_str = j_key.asString();
-
-                m_kid_to_key[k_kid] = key;
-                m_key_to_kid[key]   = k_kid;
-            }
-
-            // set m_next_kid
-            m_next_kid = v_next_kid;
-            assert(static_cast<size_t>(m_kid_to_key.size()) == v_n_kid);
-        }
-
-        all_unpacked += packedHeader.length();
+        all_unpacked += packedHeader->size();
     } else
     {
         std::cerr << "WARNING: can't read git blob '" << pathjoin(m_group->absPathname(), name_header) << "'" << std::endl;
@@ -483,51 +728,25 @@ bool KeyStore<T>::readFromDisk()
 
     bool all_ok = true;
 
-    // read & unpack bundled samples
+    // read & index bundled samples, the last bundle then the segments
+    // flushed while writing, if any
 
     {
         std::string name_bundle = basename + "_bundle" + ".bin";
-        boost::optional<std::string> optBinBundleContents = gitTree->getChildFile(name_bundle);
-        if (optBinBundleContents)
+        for (size_t segment = 0; ; ++segment)
         {
-            std::string packedBundle = *optBinBundleContents;
+            boost::optional<GitBlobPtr> optBinBundleBlob = gitTree->getChildBlob(name_bundle);
+            if (! optBinBundleBlob)
+                break;
 
-            msgpack::unpacker pac;
+            GitBlobPtr packedBundle = *optBinBundleBlob;
 
-            // copy the buffer data to the unpacker object
-            pac.reserve_buffer(packedBundle.size());
-            memcpy(pac.buffer(), packedBundle.data(), packedBundle.size());
-            pac.buffer_consumed(packedBundle.size());
+            readBundle(packedBundle);
+            all_unpacked += packedBundle->size();
 
-            size_t n_bundled = 0;
-
-            // deserialize it.
-            msgpack::unpacked msg;
-
-            pac.next(&msg);
-            msgpack::object pko = msg.get();
-            mp_unpack(pko, n_bundled);
-
-            for (size_t i = 0; i < n_bundled; ++i)
-            {
-                size_t kid;
-                std::vector<T> data;
-
-                pac.next(&msg);
-                pko = msg.get();
-                mp_unpack(pko, kid);
-
-                pac.next(&msg);
-                pko = msg.get();
-                mp_unpack(pko, data);
-
-                m_kid_to_data[kid] = data;
-                m_has_kid_data[kid] = true;
-            }
-
-            all_unpacked += packedBundle.length();
-
-            TRACE("unpacked " << packedBundle.length() << " bytes for # " << n_bundled << " (different) bundled samples of type " << GetTypeStr<T>());
+            std::ostringstream ss;
+            ss << basename << "_bundle_" << segment << ".bin";
+            name_bundle = ss.str();
         }
     }
 
@@ -538,12 +757,14 @@ bool KeyStore<T>::readFromDisk()
 
         size_t n_unbundled = 0;
         size_t unbundled_unpacked = 0;
-        for (size_t i = 0; i < v_n_kid; ++i)
+        // key ids are sparse after incremental writes
+        std::map< size_t, AbcA::ArraySample::Key >::const_iterator p_it;
+        for (p_it = m_kid_to_key.begin(); p_it != m_kid_to_key.end(); ++p_it)
         {
-            size_t kid = i;
+            size_t kid = (*p_it).first;
             if ((! m_has_kid_data.count(kid)) || (! m_has_kid_data[kid]))
             {
-                ok = readFromDiskSample(gitTree, basename, i, unpacked);
+                ok = readFromDiskSample(gitTree, basename, kid, unpacked);
                 all_ok = all_ok && ok;
                 if (! ok)
                     break;
@@ -564,6 +785,85 @@ bool KeyStore<T>::readFromDisk()
     return all_ok;
 }
 
+template <typename T>
+bool KeyStore<T>::readBundle(GitBlobPtr packedBundle)
+{
+    BundleIndex bundle;
+    if (! bundle.open(packedBundle))
+        return readFromLegacyBundle(packedBundle);
+
+    // only the index is read here, see readFromBundle()
+    size_t segment = m_bundles.size();
+    for (size_t i = 0; i < bundle.size(); ++i)
+    {
+        size_t kid = bundle.kidAt(i);
+        m_has_kid_data[kid] = true;
+        m_kid_bundle[kid] = segment;
+    }
+    m_bundles.push_back(bundle);
+
+    TRACE("indexed " << packedBundle->size() << " bytes for # " << bundle.size() << " (different) bundled samples of type " << GetTypeStr<T>());
+    return true;
+}
+
+template <typename T>
+bool KeyStore<T>::readFromBundle(size_t kid)
+{
+    assert(m_rwmode == READ);
+
+    std::map< size_t, size_t >::const_iterator b_it = m_kid_bundle.find(kid);
+    ABCA_ASSERT( b_it != m_kid_bundle.end(),
+                 "no data for sample kid:" << kid << " of type " << GetTypeStr<T>() );
+
+    const BundleIndex& bundle = m_bundles[(*b_it).second];
+
+    size_t i = 0;
+    ABCA_ASSERT( bundle.find(kid, i), "corrupt KeyStore bundle index" );
+
+    const char* packedData = NULL;
+    size_t packedSize = 0;
+    bundle.record(i, packedData, packedSize);
+
+    return unpackSample(packedData, packedSize, kid);
+}
+
+// bundles written before the index: a msgpack stream of the number of
+// samples followed by (kid, data) pairs, unpacked all at once
+template <typename T>
+bool KeyStore<T>::readFromLegacyBundle(GitBlobPtr packedBundle)
+{
+    MsgPackBufferUnpacker pac(packedBundle->data(), packedBundle->size());
+
+    size_t n_bundled = 0;
+
+    // deserialize it.
+    msgpack::unpacked msg;
+
+    pac.next(&msg);
+    msgpack::object pko = msg.get();
+    mp_unpack(pko, n_bundled);
+
+    for (size_t i = 0; i < n_bundled; ++i)
+    {
+        size_t kid;
+        std::vector<T> data;
+
+        pac.next(&msg);
+        pko = msg.get();
+        mp_unpack(pko, kid);
+
+        pac.next(&msg);
+        pko = msg.get();
+        mp_unpack(pko, data);
+
+        m_kid_to_data[kid] = data;
+        m_has_kid_data[kid] = true;
+    }
+
+    TRACE("unpacked " << packedBundle->size() << " bytes for # " << n_bundled << " (different) bundled samples of type " << GetTypeStr<T>());
+    return true;
+}
+
 #if 0
 template <typename T>
 bool KeyStore<T>::writeToDiskSample(const std::string& basename, std::map< size_t, AbcA::ArraySample::Key >::const_iterator& p_it, size_t& npacked)
@@ -584,9 +884,8 @@ bool KeyStore<T>::writeToDiskSample(const std::string& basename, std::map< size_
     std::string name = basename + suffix + ".bin";
 
     std::string packedSample = packSample(kid, key);
-    m_group->add_file_from_memory(name, packedSample);
-
     npacked = packedSample.length();
+    m_group->add_file_from_memory(name, std::move(packedSample));
 
     // TRACE("packed " << packedSample.length() << " bytes for sample kid:" << kid << " type " << GetTypeStr<T>());
 
@@ -610,19 +909,19 @@ bool KeyStore<T>::readFromDiskSample(GitTreePtr gitTree, const std::string& base
     // basename: "keystore_" + GetTypeStr<T>();
     std::string name_sample = basename + suffix + ".bin";
 
-    boost::optional<std::string> optBinSampleContents = gitTree->getChildFile(name_sample);
-    if (! optBinSampleContents)
+    boost::optional<GitBlobPtr> optBinSampleBlob = gitTree->getChildBlob(name_sample);
+    if (! optBinSampleBlob)
     {
         ABCA_THROW( "can't read git blob '" << name_sample << "'" );
         return false;
     }
 
-    std::string packedSample = *optBinSampleContents;
+    GitBlobPtr packedSample = *optBinSampleBlob;
 
-    bool ok = unpackSample(*optBinSampleContents, kid);
+    bool ok = unpackSample(packedSample->data(), packedSample->size(), kid);
 
     if (ok)
-        unpacked = packedSample.length();
+        unpacked = packedSample->size();
 
     return ok;
 }
@@ -651,16 +950,11 @@ std::string KeyStore<T>::packSample(size_t kid, const AbcA::ArraySample::Key& ke
 #endif
 
 template <typename T>
-bool KeyStore<T>::unpackSample(const std::string& packedSample, size_t kid)
+bool KeyStore<T>::unpackSample(const char* packedData, size_t packedSize, size_t kid)
 {
     // TRACE("KeyStore::unpackSample(type:" << GetTypeStr<T>() << ", kid:" << kid << ")");
 
-    msgpack::unpacker pac;
-
-    // copy the buffer data to the unpacker object
-    pac.reserve_buffer(packedSample.size());
-    memcpy(pac.buffer(), packedSample.data(), packedSample.size());
-    pac.buffer_consumed(packedSample.size());
+    MsgPackBufferUnpacker pac(packedData, packedSize);
 
     // deserialize it.
     msgpack::unpacked msg;
@@ -814,9 +1108,9 @@ bool KeyStore<T>::writeToDisk()
         TRACE("KeyStore::writeToDisk() path:'" << pathname << "' (WRITING)");
 
         std::string packed = pack();
-        m_group->add_file_from_memory(name + ".bin", packed);
-
         TRACE("packed " << packed.length() << " bytes for type " << GetTypeStr<T>());
+        m_group->add_file_from_memory(name + ".bin", std::move(packed));
+
         saved(true);
     } else
     {
@@ -23,7 +23,9 @@
 #include <Alembic/AbcCoreGit/Utils.h>
 #include <Alembic/AbcCoreGit/Git.h>
 
+#include <string>
 #include <typeinfo>
+#include <vector>
 
 namespace Alembic {
 namespace AbcCoreGit {
@@ -31,7 +33,55 @@ namespace ALEMBIC_VERSION_NS {
 
 enum RWMode { READ = 0, WRITE = 1 };
 
-const size_t BUNDLE_SAMPLES_BELOW = 200;        // bundle samples together if below this size (in bytes)
+// Random access to the samples packed in a KeyStore bundle blob.
+//
+// Layout (integers are little endian):
+//
+//   magic        4 bytes, "\xc1KSB"
+//   version      uint32
+//   count        uint32, number of samples
+//   record_size  uint32, size of every record, 0 if they differ
+//   kids         count x uint64, ascending
+//   offsets      (count + 1) x uint64, only if record_size is 0
+//   records      the msgpack packed data of each sample
+//
+// 0xc1 is never used by msgpack, so bundles written before the index
+// (a plain msgpack stream starting with the number of samples) are told
+// apart by their first byte.
+class BundleIndex
+{
+public:
+    static const uint32_t VERSION = 2;
+
+    BundleIndex();
+
+    // false if the blob isn't an indexed bundle
+    bool open(GitBlobPtr blob);
+    bool isOpen() const         { return (m_blob.get() != NULL); }
+    void close();
+
+    size_t size() const         { return m_count; }
+    size_t kidAt(size_t i) const;
+
+    // position of the sample with the given kid, O(1) when kids are
+    // contiguous (the common case), binary search otherwise
+    bool find(size_t kid, size_t& i) const;
+
+    // packed data of the sample at position i
+    void record(size_t i, const char*& data, size_t& size) const;
+
+    static void pack(std::string& out, const std::vector<size_t>& kids,
+                     const std::vector<std::string>& records);
+
+private:
+    GitBlobPtr m_blob;
+    size_t m_count;
+    size_t m_record_size;
+    const char* m_kids;
+    const char* m_offsets;
+    const char* m_records;
+    size_t m_records_size;
+};
 
 struct KeyStoreBase
 {
@@ -101,17 +151,21 @@ struct KeyStore : public KeyStoreBase
 
     const std::vector<T>& data(size_t kid)
     {
+        // the readers of all the properties of this type share the store,
+        // a bundled sample is unpacked by whichever asks for it first.
+        // Its data is never moved once inserted, the reference outlives the lock
+        Alembic::Util::scoped_lock l( m_data_lock );
+
         assert(m_has_kid_data.count(kid));
+        if (! m_kid_to_data.count(kid))
+            readFromBundle(kid);
         assert(m_kid_to_data.count(kid));
         return m_kid_to_data[kid];
     }
 
     const std::vector<T>& data(const AbcA::ArraySample::Key& key)
     {
-        size_t kid = KeyToKid(key);
-        assert(m_has_kid_data.count(kid));
-        assert(m_kid_to_data.count(kid));
-        return m_kid_to_data[kid];
+        return data(KeyToKid(key));
     }
 
     virtual bool saved() const     { return m_saved; }
@@ -120,6 +174,10 @@ struct KeyStore : public KeyStoreBase
     virtual bool loaded() const     { return m_loaded; }
     virtual void loaded(bool value) { m_loaded = value; }
 
+    // bundled samples held until the next segment is flushed
+    size_t bundledBytes() const     { return m_bundled_bytes; }
+    size_t bundleSegments() const   { return m_bundle_segments; }
+
     // std::string pack();
     // bool unpack(const std::string& packed);
 
@@ -129,24 +187,48 @@ struct KeyStore : public KeyStoreBase
     bool writeToDiskSample(const std::string& basename, std::map< size_t, AbcA::ArraySample::Key >::const_iterator& p_it, size_t& npacked);
     bool readFromDiskSample(GitTreePtr gitTree, const std::string& basename, size_t kid, size_t& unpacked);
 
+    // bundled samples are only unpacked when asked for
+    bool readBundle(GitBlobPtr packedBundle);
+    bool readFromBundle(size_t kid);
+    bool readFromLegacyBundle(GitBlobPtr packedBundle);
+
     // std::string packSample(size_t kid, const AbcA::ArraySample::Key& key);
-    bool unpackSample(const std::string& packedSample, size_t kid);
+    bool unpackSample(const char* packedData, size_t packedSize, size_t kid);
+
+    // unpack a header written by writeToDisk(), returns the number of keys
+    size_t unpackHeader(const char* packedData, size_t packedSize);
+
+    // for incremental writes, keep the key ids of the HEAD commit so that
+    // the samples of the objects reused from it stay valid
+    bool seedFromHead();
 
     void ensureWriteInfo()   { if (! m_write_info) _ensureWriteInfo(); }
     void _ensureWriteInfo();
     bool writeToDiskSampleData(size_t kid, const AbcA::ArraySample::Key& key, const std::vector<T>& data);
 
+    // write the pending bundled samples and let go of them
+    bool writeBundle(const std::string& name_bundle);
+    bool flushBundle();
+
     GitGroupPtr m_group;
     RWMode m_rwmode;
 
     std::map< AbcA::ArraySample::Key, size_t > m_key_to_kid;                   // key to progressive key id
     std::map< size_t, AbcA::ArraySample::Key > m_kid_to_key;                   // progressive key id to key
     std::map< size_t, std::vector<T> > m_kid_to_data;                          // kid to sample data
+    Alembic::Util::mutex m_data_lock;                                          // guards the lazy unpacking into m_kid_to_data
     std::map< size_t, bool > m_has_kid_data;                                   // has kid AND its data
     std::map< size_t, std::vector<T> > m_bundled_data;                         // sample data to write lazily in bundled form
+    std::vector<BundleIndex> m_bundles;                                        // bundle segments, to read lazily
+    std::map< size_t, size_t > m_kid_bundle;                                   // kid to its bundle segment
     size_t m_next_kid;                                                         // next key id
+    bool m_seeded;                                                             // key ids seeded from HEAD
     bool m_saved;
     bool m_loaded;
+    size_t m_bundle_below;                                                     // bundle samples below this size (in bytes)
+    size_t m_bundle_flush;                                                     // flush a bundle segment above this size (in bytes), 0 for never
+    size_t m_bundled_bytes;                                                    // estimated size of m_bundled_data
+    size_t m_bundle_segments;                                                  // bundle segments flushed so far
 
     size_t m_samples_unbundled;
     size_t m_samples_bundled;
@@ -203,22 +285,28 @@ public:
 
     void add(KeyStoreBase* keyStoreP)
     {
+        Alembic::Util::scoped_lock l( m_lock );
         m_map[TypeInfoWrapper(typeid(*keyStoreP))] = keyStoreP;
     }
 
     KeyStoreBase* get(const std::type_info& typeinfo)
     {
+        Alembic::Util::scoped_lock l( m_lock );
         return m_map[TypeInfoWrapper(typeinfo)];
     }
 
     template <class T> KeyStore<T>* get()
     {
+        Alembic::Util::scoped_lock l( m_lock );
         KeyStoreBase* ksbptr = m_map[TypeInfoWrapper(typeid(T))];
         return dynamic_cast< KeyStore<T>* >( ksbptr );
     }
 
+    // the property readers of an archive share the stores, and may be
+    // opened from several threads
     template <class T> KeyStore<T>* getOrCreate()
     {
+        Alembic::Util::scoped_lock l( m_lock );
         TypeInfoWrapper tiw = TypeInfoWrapper(typeid(T));
         if (m_map.count(tiw))
         {
@@ -235,6 +323,7 @@ private:
     GitGroupPtr m_group;
     RWMode m_rwmode;
 
+    Alembic::Util::mutex m_lock;
     std::map <TypeInfoWrapper, KeyStoreBase*> m_map;
 };
 
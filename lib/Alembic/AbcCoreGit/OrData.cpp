@@ -211,20 +211,19 @@ bool OrData::readFromDisk()
     jsonBuffer << jsonFile.rdbuf();
     jsonFile.close();
 
-    std::string jsonContents = jsonBuffer.str();
+    JSONParser json(jsonPathname, jsonBuffer.str());
 #else
     GitGroupPtr parentGroup = m_group->parent();
-    boost::optional<std::string> optJsonContents = parentGroup->tree()->getChildFile(name() + ".json");
-    if (! optJsonContents)
+    boost::optional<GitBlobPtr> optJsonBlob = parentGroup->tree()->getChildBlob(name() + ".json");
+    if (! optJsonBlob)
     {
         TRACE("[OrData " << *this << "] can't read git blob '" << jsonPathname << "'");
         ABCA_THROW( "can't read git blob '" << jsonPathname << "'" );
         return false;
     }
-    std::string jsonContents = *optJsonContents;
+    JSONParser json(jsonPathname, (*optJsonBlob)->data(), (*optJsonBlob)->size());
 #endif
 
-    JSONParser json(jsonPathname, jsonContents);
     rapidjson::Document& document = json.document;
 
     std::string v_kind = JsonGetString(document, "kind").get_value_or("UNKNOWN");
@@ -314,20 +313,19 @@ bool OrData::readFromDiskChildHeader(size_t i)
     jsonBuffer << jsonFile.rdbuf();
     jsonFile.close();
 
-    std::string jsonContents = jsonBuffer.str();
+    JSONParser json(jsonPathname, jsonBuffer.str());
 #else
     GitGroupPtr parentGroup = m_group;
-    boost::optional<std::string> optJsonContents = parentGroup->tree()->getChildFile(childName + ".json");
-    if (! optJsonContents)
+    boost::optional<GitBlobPtr> optJsonBlob = parentGroup->tree()->getChildBlob(childName + ".json");
+    if (! optJsonBlob)
     {
         TRACE("[OrData " << *this << "] readFromDiskChildHeader(" << i << ") can't read git blob '" << jsonPathname << "'");
         ABCA_THROW( "can't read git blob '" << jsonPathname << "'" );
         return false;
     }
-    std::string jsonContents = *optJsonContents;
+    JSONParser json(jsonPathname, (*optJsonBlob)->data(), (*optJsonBlob)->size());
 #endif
 
-    JSONParser json(jsonPathname, jsonContents);
     rapidjson::Document& document = json.document;
 
     std::string v_name = JsonGetString(document, "name").get_value_or("UNKNOWN");
@@ -24,7 +24,9 @@
 #include <Alembic/AbcCoreGit/ReadWriteUtil.h>
 #include <Alembic/AbcCoreGit/Utils.h>
 #include <iostream>
+#include <iomanip>
 #include <fstream>
+#include <sstream>
 #include <string>
 
 #include <Alembic/AbcCoreGit/JSON.h>
@@ -254,6 +256,40 @@ void OwData::fillHash( std::size_t iIndex, Util::uint64_t iHash0,
     m_hashes[ iIndex * 2 + 1 ] = iHash1;
 }
 
+void OwData::setContentHash( Util::uint64_t iHash0, Util::uint64_t iHash1 )
+{
+    std::ostringstream ss;
+    ss << std::hex << std::setfill('0') << std::setw(16) << iHash0 <<
+        std::setw(16) << iHash1;
+    m_contentHash = ss.str();
+}
+
+// an unchanged object gets the tree (and json) of the HEAD commit, without
+// writing any of the blobs staged for it
+bool OwData::reuseHeadTree()
+{
+    GitRepoPtr repo_ptr = m_group->repo();
+    if (! repo_ptr->hasHeadTree())
+        return false;
+
+    boost::optional<std::string> o_hash = repo_ptr->headObjectHash( m_header->getFullName() );
+    if ( (! o_hash) || (*o_hash != m_contentHash) )
+        return false;
+
+    GitTreebuilderPtr treebld = m_group->treebuilder();
+    GitTreebuilderPtr parentTreebld = m_group->parent()->treebuilder();
+    std::string jsonName = name() + ".json";
+
+    git_oid tree_oid, json_oid;
+    if ( (! repo_ptr->headEntry(treebld->pathname(), tree_oid, GIT_OBJ_TREE)) ||
+         (! repo_ptr->headEntry(v_pathjoin(parentTreebld->pathname(), jsonName, '/'), json_oid, GIT_OBJ_BLOB)) )
+        return false;
+
+    TRACE("OwData::reuseHeadTree() path:'" << absPathname() << "' unchanged, reusing HEAD tree");
+    treebld->reuse(tree_oid);
+    return parentTreebld->insert(jsonName, json_oid, GIT_FILEMODE_BLOB);
+}
+
 void OwData::writeToDisk()
 {
     TRACE("OwData::writeToDisk() path:'" << absPathname() << "'");
@@ -264,6 +300,21 @@ void OwData::writeToDisk()
     {
         TRACE("OwData::writeToDisk() path:'" << absPathname() << "' (WRITING)");
 
+        GitRepoPtr repo = m_group->repo();
+        if (repo->incrementalEnabled() && !m_contentHash.empty())
+        {
+            repo->setObjectHash(m_header->getFullName(), m_contentHash);
+
+            if (reuseHeadTree())
+            {
+                m_written = true;
+                return;
+            }
+
+            // changed, write what was staged for it so far
+            m_group->treebuilder()->flush();
+        }
+
         TRACE("create '" << absPathname() << ".json'");
 
         double t_end, t_start = time_us();
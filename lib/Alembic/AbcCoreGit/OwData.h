@@ -66,6 +66,10 @@ public:
     void fillHash( std::size_t iIndex, Util::uint64_t iHash0,
                    Util::uint64_t iHash1 );
 
+    // the hash of the whole object (children included), used by
+    // incremental writes to find the unchanged subtrees
+    void setContentHash( Util::uint64_t iHash0, Util::uint64_t iHash1 );
+
     const std::string& name() const               { ABCA_ASSERT(m_group, "invalid group"); return m_group->name(); }
     std::string relPathname() const               { ABCA_ASSERT(m_group, "invalid group"); return m_group->relPathname(); }
     std::string absPathname() const               { ABCA_ASSERT(m_group, "invalid group"); return m_group->absPathname(); }
@@ -75,6 +79,8 @@ public:
     Alembic::Util::shared_ptr< AwImpl > getArchiveImpl() const;
 
 private:
+    bool reuseHeadTree();
+
     // The group corresponding to the object
     GitGroupPtr m_group;
 
@@ -96,6 +102,9 @@ private:
     // child hashes
     std::vector< Util::uint64_t > m_hashes;
 
+    // hex content hash, empty for the top object
+    std::string m_contentHash;
+
     bool m_written;
 };
 
@@ -89,6 +89,7 @@ OwImpl::~OwImpl()
         hash.Update( &( m_header->getName()[0] ), m_header->getName().size() );
         Util::uint64_t hash0, hash1;
         hash.Final( &hash0, &hash1 );
+        m_data->setContentHash( hash0, hash1 );
 
         Util::shared_ptr< OwImpl > parent =
             Alembic::Util::dynamic_pointer_cast< OwImpl,
@@ -22,6 +22,7 @@
 #include <Alembic/AbcCoreGit/ArImpl.h>
 
 #include <Alembic/AbcCoreGit/Git.h>
+#include <Alembic/AbcCoreGit/git-milliways.h>
 
 namespace Alembic {
 namespace AbcCoreGit {
@@ -164,7 +165,8 @@ bool trashHistory(const std::string& archivePathname, std::string& errorMessage,
 {
     Alembic::AbcCoreFactory::IOptions rOptions;
 
-    GitRepoPtr repo_ptr( new GitRepo(archivePathname, rOptions, GitMode::Read) );
+    // rewriting the history updates the references: needs the writer
+    GitRepoPtr repo_ptr( new GitRepo(archivePathname, rOptions, GitMode::ReadWrite) );
     return repo_ptr->trashHistory(errorMessage, branchName);
 }
 
@@ -182,6 +184,49 @@ std::string getHistoryJSON(const std::string& archivePathname, bool& error)
     return repo_ptr->getHistoryJSON(error);
 }
 
+/* Garbage collection API */
+
+bool collectGarbage(const std::string& archivePathname, GarbageStats& stats, std::string& errorMessage)
+{
+    LibGit::Initialize();
+
+    errorMessage = "";
+    stats = GarbageStats();
+
+    // same layout as GitRepo: a single file archive is the store itself,
+    // otherwise the store lives in the repository directory
+    std::string storePathname = archivePathname;
+    if (! isfile(storePathname))
+        storePathname = pathjoin(storePathname, "store.mwdb");
+
+    if (! isfile(storePathname))
+    {
+        errorMessage = "no milliways store for '" + archivePathname + "'";
+        return false;
+    }
+
+    milliways_gc_stats st;
+    int rc = milliways_gc(storePathname.c_str(), &st);
+    if (rc != 0)
+    {
+        const git_error *error = giterr_last();
+
+        std::ostringstream ss;
+        ss << "can't collect garbage in '" << storePathname << "' - " <<
+            ((error && error->message) ? error->message : "(UNKNOWN)");
+        errorMessage = ss.str();
+        return false;
+    }
+
+    stats.refs           = st.refs;
+    stats.objects        = st.objects;
+    stats.liveObjects    = st.live_objects;
+    stats.missingObjects = st.missing_objects;
+    stats.bytesBefore    = st.size_before;
+    stats.bytesAfter     = st.size_after;
+    return true;
+}
+
 } // End namespace ALEMBIC_VERSION_NS
 } // End namespace AbcCoreGit
 } // End namespace Alembic
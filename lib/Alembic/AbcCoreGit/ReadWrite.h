@@ -129,6 +129,33 @@ ALEMBIC_EXPORT bool trashHistory(const std::string& archivePathname, std::string
 ALEMBIC_EXPORT std::string getHistoryJSON(Alembic::Abc::IArchive& archive, bool& error);
 ALEMBIC_EXPORT std::string getHistoryJSON(const std::string& archivePathname, bool& error);
 
+/* Garbage collection API */
+
+//! What collectGarbage() found in, and reclaimed from, a Milliways store.
+struct ALEMBIC_EXPORT GarbageStats
+{
+    GarbageStats() :
+        refs(0), objects(0), liveObjects(0), missingObjects(0),
+        bytesBefore(0), bytesAfter(0) {}
+
+    size_t refs;
+    size_t objects;
+    size_t liveObjects;
+    size_t missingObjects;
+
+    Alembic::Util::uint64_t bytesBefore;
+    Alembic::Util::uint64_t bytesAfter;
+
+    Alembic::Util::uint64_t bytesReclaimed() const
+    { return (bytesBefore > bytesAfter) ? (bytesBefore - bytesAfter) : 0; }
+};
+
+// Rewrites the Milliways store of the archive keeping only the objects
+// reachable from its references, dropping what trashHistory() and
+// re-exports left behind. The archive must not be open (for reading or
+// writing) while this runs.
+ALEMBIC_EXPORT bool collectGarbage(const std::string& archivePathname, GarbageStats& stats, std::string& errorMessage);
+
 } // End namespace ALEMBIC_VERSION_NS
 
 using namespace ALEMBIC_VERSION_NS;
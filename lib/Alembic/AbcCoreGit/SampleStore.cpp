@@ -440,10 +440,8 @@ size_t TypedSampleStore<T>::addSample( const T* iSamp, AbcA::ArraySample::Key& k
 
     size_t at = m_next_index++;
     size_t kid = addKey(key);
-    if (! m_kid_indexes.count(kid))
-        m_kid_indexes[kid] = std::vector<size_t>();
-    m_kid_indexes[kid].push_back( at );
-    m_index_to_kid[at] = kid;
+    assert(at == m_index_to_kid.size());
+    m_index_to_kid.push_back(kid);
     // TRACE("set index_to_kid[" << at << "] := " << kid);
 
     if (! hasDimensions(kid))
@@ -541,8 +539,8 @@ size_t TypedSampleStore<T>::setFromPreviousSample()                           //
     size_t kid = sampleIndexToKid(previousSampleIndex);
     size_t at = m_next_index++;
 
-    m_kid_indexes[kid].push_back( at );
-    m_index_to_kid[at] = kid;
+    assert(at == m_index_to_kid.size());
+    m_index_to_kid.push_back(kid);
     // TRACE("set index_to_kid[" << at << "] := " << kid);
 
     return at;
@@ -626,8 +624,9 @@ std::string TypedSampleStore<T>::pack()
         v_type = ss.str();
     }
 
-    std::stringstream buffer;
-    msgpack::packer<std::stringstream> pk(&buffer);
+    std::string packed;
+    MsgPackStringBuffer buffer(packed);
+    msgpack::packer<MsgPackStringBuffer> pk(&buffer);
 
     // mp_pack(pk, v_typename);
     mp_pack(pk, v_type);        // not necessary actually (redundant, given m_dataType)
@@ -642,11 +641,9 @@ std::string TypedSampleStore<T>::pack()
     // save index->kid map
     {
         mp_pack(pk, static_cast<size_t>(m_index_to_kid.size()));
-        std::map< size_t, size_t >::const_iterator p_it;
-        for (p_it = m_index_to_kid.begin(); p_it != m_index_to_kid.end(); ++p_it)
+        for (size_t index = 0; index < m_index_to_kid.size(); ++index)
         {
-            size_t index = (*p_it).first;
-            size_t kid   = (*p_it).second;
+            size_t kid   = m_index_to_kid[index];
 
             msgpack::type::tuple< size_t, size_t >
                 tuple(index, kid);
@@ -673,20 +670,15 @@ std::string TypedSampleStore<T>::pack()
         }
     }
 
-    return buffer.str();
+    return packed;
 }
 
 template <typename T>
-void TypedSampleStore<T>::unpack(const std::string& packed)
+void TypedSampleStore<T>::unpack(const char* packedData, size_t packedSize)
 {
     TRACE("TypedSampleStore<T>::unpack() T:" << GetTypeStr<T>());
 
-    msgpack::unpacker pac;
-
-    // copy the buffer data to the unpacker object
-    pac.reserve_buffer(packed.size());
-    memcpy(pac.buffer(), packed.data(), packed.size());
-    pac.buffer_consumed(packed.size());
+    MsgPackBufferUnpacker pac(packedData, packedSize);
 
     // deserialize it.
     msgpack::unpacked msg;
@@ -740,12 +732,12 @@ void TypedSampleStore<T>::unpack(const std::string& packed)
 
     // deserialize index->kid map
     m_index_to_kid.clear();
-    m_kid_indexes.clear();
     m_next_index = 0;
     size_t v_n_index = 0;
     pac.next(&msg);
     pko = msg.get();
     mp_unpack(pko, v_n_index);
+    m_index_to_kid.resize(v_n_index);
     for (size_t i = 0; i < v_n_index; ++i)
     {
         msgpack::type::tuple< size_t, size_t > tuple;
@@ -757,10 +749,8 @@ void TypedSampleStore<T>::unpack(const std::string& packed)
         size_t k_index = tuple.get<0>();
         size_t k_kid   = tuple.get<1>();
 
+        ABCA_ASSERT( k_index < v_n_index, "sample index " << k_index << " out of range" );
         m_index_to_kid[k_index] = k_kid;
-        if (! m_kid_indexes.count(k_kid))
-            m_kid_indexes[k_kid] = std::vector<size_t>();
-        m_kid_indexes[k_kid].push_back( k_index );
         // TRACE("deserialized index_to_kid[" << k_index << "] := " << k_kid);
     }
     pac.next(&msg);
@@ -76,7 +76,7 @@ public:
 
     // binary serialization
     virtual std::string pack() = 0;
-    virtual void unpack(const std::string& packed) = 0;
+    virtual void unpack(const char* packedData, size_t packedSize) = 0;
 
     friend std::ostream& operator<< ( std::ostream& out, const AbstractTypedSampleStore& value );
 };
@@ -151,7 +151,7 @@ public:
 
     // binary serialization
     virtual std::string pack();
-    virtual void unpack(const std::string& packed);
+    virtual void unpack(const char* packedData, size_t packedSize);
 
 protected:
 #if 0
@@ -191,9 +191,9 @@ protected:
     const std::vector<T>& data(size_t kid)                       { return ks()->data(kid); }
     const std::vector<T>& data(const AbcA::ArraySample::Key& key) { return ks()->data(key); }
 
-    bool hasIndex(size_t sampleIndex) const           { return (m_index_to_kid.count(sampleIndex) != 0); }
-    size_t sampleIndexToKid(size_t sampleIndex) const { return m_index_to_kid.find(sampleIndex)->second; }
-    size_t sampleIndexToKid(size_t sampleIndex)       { return m_index_to_kid.find(sampleIndex)->second; }
+    bool hasIndex(size_t sampleIndex) const           { return (sampleIndex < m_index_to_kid.size()); }
+    size_t sampleIndexToKid(size_t sampleIndex) const { return m_index_to_kid[sampleIndex]; }
+    size_t sampleIndexToKid(size_t sampleIndex)       { return m_index_to_kid[sampleIndex]; }
 
     bool hasDimensions(size_t kid) const                          { return (m_kid_dims.count(kid) != 0); }
     const AbcA::Dimensions& getDimensions(size_t kid) const       { return m_kid_dims.find(kid)->second; }
@@ -223,8 +223,7 @@ private:
     AbcA::DataType m_dataType;
     AbcA::Dimensions m_dimensions;
 
-    std::map< size_t, size_t > m_index_to_kid;                                   // sample index to kid
-    std::map< size_t, std::vector<size_t> > m_kid_indexes;                     // kid to array of sample indexes
+    std::vector< size_t > m_index_to_kid;                                      // sample index to kid (indexes are contiguous)
     // std::map< size_t, std::vector<T> > m_kid_to_data;                          // kid to sample data
     std::map< size_t, AbcA::Dimensions > m_kid_dims;                           // kid to dimensions
     size_t m_next_index;                                                       // next sample index
@@ -198,20 +198,20 @@ bool SprImpl::readFromDisk()
     jsonBuffer << jsonFile.rdbuf();
     jsonFile.close();
 
-    std::string jsonContents = jsonBuffer.str();
+    JSONParser json(jsonPathname, jsonBuffer.str());
 #else
     GitGroupPtr parentGroup = m_group;
-    boost::optional<std::string> optJsonContents = parentGroup->tree()->getChildFile(name() + ".json");
-    if (! optJsonContents)
+    boost::optional<GitBlobPtr> optJsonBlob = parentGroup->getFile(name() + ".json");
+    if (! optJsonBlob)
     {
         ABCA_THROW( "can't read git blob '" << jsonPathname << "'" );
         return false;
     }
-    std::string jsonContents = *optJsonContents;
+    JSONParser json(jsonPathname, (*optJsonBlob)->data(), (*optJsonBlob)->size());
 
 #if MSGPACK_SAMPLES
-    boost::optional<std::string> optBinContents = parentGroup->tree()->getChildFile(name() + ".bin");
-    if (! optBinContents)
+    boost::optional<GitBlobPtr> optBinBlob = parentGroup->getFile(name() + ".bin");
+    if (! optBinBlob)
     {
         ABCA_THROW( "can't read git blob '" << absPathname() + ".bin" << "'" );
         return false;
@@ -219,7 +219,6 @@ bool SprImpl::readFromDisk()
 #endif /* MSGPACK_SAMPLES */
 #endif
 
-    JSONParser json(jsonPathname, jsonContents);
 #if !MSGPACK_SAMPLES
     rapidjson::Document& document = json.document;
 #endif
@@ -228,7 +227,7 @@ bool SprImpl::readFromDisk()
     TODO("add SprImpl core read functionality");
 
 #if MSGPACK_SAMPLES
-    m_store->unpack( *optBinContents );
+    m_store->unpack( (*optBinBlob)->data(), (*optBinBlob)->size() );
 #else
     m_store->fromJson( document["data"] );
 #endif
@@ -82,6 +82,9 @@ SpwImpl::~SpwImpl()
     hash.Init(0, 0);
     HashPropertyHeader( m_header->header, hash );
 
+    // as in ApwImpl, the stored time sampling index has to match too
+    hash.Update( &m_header->timeSamplingIndex, sizeof( m_header->timeSamplingIndex ) );
+
     // mix in the accumulated hash if we have samples
     if ( numSamples != 0 )
     {
@@ -119,9 +122,9 @@ void SpwImpl::setFromPreviousSample()
 
     m_store->setFromPreviousSample();
 
-    // Util::Digest digest = m_previousWrittenSampleID->getKey().digest;
-    // Util::SpookyHash::ShortEnd(m_hash.words[0], m_hash.words[1],
-    //                            digest.words[0], digest.words[1]);
+    Util::Digest digest = m_previousWrittenSampleID->getKey().digest;
+    Util::SpookyHash::ShortEnd(m_hash.words[0], m_hash.words[1],
+                               digest.words[0], digest.words[1]);
     m_header->nextSampleIndex ++;
 }
 
@@ -393,7 +396,7 @@ void SpwImpl::writeToDisk()
         Profile::add_git(t_end - t_start);
 #else
         t_start = time_us();
-        m_group->add_file_from_memory(name() + ".json", output);
+        m_group->add_property_file(name() + ".json", output);
         t_end = time_us();
         Profile::add_git(t_end - t_start);
 
@@ -403,7 +406,7 @@ void SpwImpl::writeToDisk()
         t_end = time_us();
         TRACE("SpwImpl::writeToDisk() samples-to-msgpack: " << (t_end - t_start) << "us");
         t_start = time_us();
-        m_group->add_file_from_memory(name() + ".bin", packedSamples);
+        m_group->add_property_file(name() + ".bin", std::move(packedSamples));
         t_end = time_us();
         Profile::add_git(t_end - t_start);
 #endif /* MSGPACK_SAMPLES */
@@ -36,12 +36,19 @@
 
 #include <Alembic/AbcCoreAbstract/All.h>
 #include <Alembic/AbcCoreGit/All.h>
+#include <Alembic/AbcCoreGit/AwImpl.h>
+#include <Alembic/AbcCoreGit/Git.h>
+#include <Alembic/AbcCoreGit/git-milliways.h>
 #include <Alembic/Util/All.h>
 
 #include <Alembic/AbcCoreAbstract/Tests/Assert.h>
 
+#include <algorithm>
+#include <cstring>
 #include <iostream>
+#include <map>
 #include <sstream>
+#include <thread>
 #include <vector>
 
 //-*****************************************************************************
@@ -371,6 +378,781 @@ void readVeryEmptyArchive( const std::string & iName )
     TESTING_ASSERT(a->getTop()->getNumChildren() == 0);
 }
 
+void writeIncrementalArchive( const std::string & iName,
+                              Alembic::Util::int32_t iValue,
+                              bool iMilliways = false )
+{
+    ABCA::MetaData m;
+    AO::WriteOptions options;
+    options["incremental"] = true;
+    if (iMilliways)
+        options["milliways"] = true;
+    AO::WriteArchive w( options );
+    ABCA::ArchiveWriterPtr a = w( iName, m );
+    ABCA::ObjectWriterPtr root = a->getTop();
+
+    ABCA::DataType i32d(Alembic::Util::kInt32POD, 1);
+
+    // "same" never changes, "changed" gets iValue
+    for (int i = 0; i < 2; ++i)
+    {
+        Alembic::Util::int32_t val = (i == 0) ? 7 : iValue;
+        ABCA::ObjectWriterPtr obj = root->createChild(
+            ABCA::ObjectHeader( (i == 0) ? "same" : "changed", m ) );
+        ABCA::CompoundPropertyWriterPtr top = obj->getProperties();
+
+        // one sample big enough to get its own blob, one bundled
+        std::vector <Alembic::Util::int32_t> big(300, val);
+        std::vector <Alembic::Util::int32_t> small(3, val);
+        top->createArrayProperty("big", m, i32d, 0)->setSample(
+            ABCA::ArraySample(&(big.front()), i32d, Dimensions(big.size())));
+        top->createArrayProperty("small", m, i32d, 0)->setSample(
+            ABCA::ArraySample(&(small.front()), i32d, Dimensions(small.size())));
+    }
+}
+
+void checkIncrementalArchive( ABCA::ArchiveReaderPtr a,
+                              Alembic::Util::int32_t iValue )
+{
+    ABCA::ObjectReaderPtr root = a->getTop();
+    TESTING_ASSERT( root->getNumChildren() == 2 );
+
+    for (int i = 0; i < 2; ++i)
+    {
+        Alembic::Util::int32_t val = (i == 0) ? 7 : iValue;
+        ABCA::ObjectReaderPtr obj = root->getChild( (i == 0) ? "same" : "changed" );
+        TESTING_ASSERT( obj );
+
+        const char * names[2] = { "big", "small" };
+        for (int j = 0; j < 2; ++j)
+        {
+            ABCA::ArrayPropertyReaderPtr apr =
+                obj->getProperties()->getArrayProperty( names[j] );
+            TESTING_ASSERT( apr->getNumSamples() == 1 );
+
+            ABCA::ArraySamplePtr samp;
+            apr->getSample( 0, samp );
+            TESTING_ASSERT( samp->getDimensions().numPoints() ==
+                            ( (j == 0) ? 300 : 3 ) );
+
+            const Alembic::Util::int32_t * data =
+                (const Alembic::Util::int32_t *) samp->getData();
+            for (std::size_t k = 0; k < samp->size(); ++k)
+            {
+                TESTING_ASSERT( data[k] == val );
+            }
+        }
+    }
+}
+
+void readIncrementalArchive( const std::string & iName,
+                             Alembic::Util::int32_t iValue )
+{
+    Alembic::AbcCoreGit::ReadArchive r;
+    checkIncrementalArchive( r( iName ), iValue );
+}
+
+git_oid treeOid( const std::string & iName, const std::string & iSpec )
+{
+    git_repository * repo = NULL;
+    TESTING_ASSERT( git_repository_open( &repo, iName.c_str() ) == 0 );
+
+    git_object * tree = NULL;
+    TESTING_ASSERT( git_revparse_single( &tree, repo, iSpec.c_str() ) == 0 );
+    git_oid oid = *git_object_id( tree );
+
+    git_object_free( tree );
+    git_repository_free( repo );
+    return oid;
+}
+
+// the oid of the tree of an object at the given revision
+git_oid objectTreeOid( const std::string & iName, const std::string & iRev,
+                       const std::string & iObject )
+{
+    return treeOid( iName, iRev + ":ABC/" + iObject );
+}
+
+void testIncrementalArchive()
+{
+    std::string archiveName = "incrementalArchive.abc";
+
+    writeIncrementalArchive( archiveName, 1 );
+    readIncrementalArchive( archiveName, 1 );
+
+    // "same" is reused from the previous commit
+    writeIncrementalArchive( archiveName, 2 );
+    readIncrementalArchive( archiveName, 2 );
+
+    git_oid same1 = objectTreeOid( archiveName, "HEAD~1", "same" );
+    git_oid same2 = objectTreeOid( archiveName, "HEAD", "same" );
+    TESTING_ASSERT( git_oid_equal( &same1, &same2 ) );
+
+    git_oid changed1 = objectTreeOid( archiveName, "HEAD~1", "changed" );
+    git_oid changed2 = objectTreeOid( archiveName, "HEAD", "changed" );
+    TESTING_ASSERT( !git_oid_equal( &changed1, &changed2 ) );
+
+    // and back, "changed" matches a commit older than HEAD
+    writeIncrementalArchive( archiveName, 1 );
+    readIncrementalArchive( archiveName, 1 );
+
+    git_oid same3 = objectTreeOid( archiveName, "HEAD", "same" );
+    TESTING_ASSERT( git_oid_equal( &same1, &same3 ) );
+
+    git_oid changed3 = objectTreeOid( archiveName, "HEAD", "changed" );
+    TESTING_ASSERT( !git_oid_equal( &changed2, &changed3 ) );
+}
+
+void testSnapshotReader()
+{
+    std::string archiveName = "snapshotArchive.abc";
+    writeIncrementalArchive( archiveName, 1, /* milliways */ true );
+
+    Alembic::AbcCoreFactory::IOptions options;
+    options["milliways"] = true;
+
+    // the reader keeps the commit it was opened on...
+    Alembic::AbcCoreGit::ReadArchive r( options );
+    ABCA::ArchiveReaderPtr before = r( archiveName );
+
+    // ...while a writer on the same store commits a new one
+    writeIncrementalArchive( archiveName, 2, /* milliways */ true );
+
+    checkIncrementalArchive( before, 1 );
+    checkIncrementalArchive( r( archiveName ), 2 );
+    checkIncrementalArchive( before, 1 );
+}
+
+void testDiffRevisions()
+{
+    // the three commits written by testIncrementalArchive
+    std::string archiveName = "incrementalArchive.abc";
+
+    Alembic::AbcCoreGit::ArchiveChanges changes =
+        Alembic::AbcCoreGit::diffRevisions( archiveName, "HEAD", "HEAD" );
+    TESTING_ASSERT( changes.empty() );
+
+    changes = Alembic::AbcCoreGit::diffRevisions( archiveName, "HEAD~2", "HEAD" );
+    TESTING_ASSERT( changes.empty() );
+
+    // only the properties of "changed" differ, in their only sample
+    changes = Alembic::AbcCoreGit::diffRevisions( archiveName, "HEAD~1", "HEAD" );
+    TESTING_ASSERT( changes.size() == 2 );
+    for (std::size_t i = 0; i < changes.size(); ++i)
+    {
+        TESTING_ASSERT( changes[i].kind == Alembic::AbcCoreGit::ArchiveChange::kChanged );
+        TESTING_ASSERT( changes[i].object == "/changed" );
+        TESTING_ASSERT( changes[i].property == "big" ||
+                        changes[i].property == "small" );
+        TESTING_ASSERT( !changes[i].headerChanged );
+        TESTING_ASSERT( changes[i].samples.size() == 1 );
+        TESTING_ASSERT( changes[i].samples[0].first == 0 &&
+                        changes[i].samples[0].second == 0 );
+    }
+
+    // another archive, its kids are numbered independently
+    std::string otherName = "incrementalArchiveOther.abc";
+    writeIncrementalArchive( otherName, 2 );
+
+    Alembic::AbcCoreFactory::IOptions options;
+    changes = Alembic::AbcCoreGit::diffArchives( archiveName, options,
+                                                 otherName, options );
+    TESTING_ASSERT( changes.size() == 2 );
+}
+
+void writeBundledArchive( const std::string & iName, int iBundleBelow,
+                          int iFlushBytes = 0 )
+{
+    ABCA::MetaData m;
+    AO::WriteOptions options;
+    options["bundleSamplesBelow"] = iBundleBelow;
+    options["bundleFlushBytes"] = iFlushBytes;
+    AO::WriteArchive w( options );
+    ABCA::ArchiveWriterPtr a = w( iName, m );
+    ABCA::CompoundPropertyWriterPtr top = a->getTop()->getProperties();
+
+    // every sample differs, the int32 ones pack to records of different sizes
+    ABCA::DataType i32d(Alembic::Util::kInt32POD, 1);
+    ABCA::DataType f32d(Alembic::Util::kFloat32POD, 3);
+    ABCA::ScalarPropertyWriterPtr ints =
+        top->createScalarProperty("ints", m, i32d, 0);
+    ABCA::ScalarPropertyWriterPtr floats =
+        top->createScalarProperty("floats", m, f32d, 0);
+    for (int i = 0; i < 2000; ++i)
+    {
+        Alembic::Util::int32_t val = i * i;
+        ints->setSample(&val);
+
+        float32_t vec[3] = { float32_t(i), 0.5f, -float32_t(i) };
+        floats->setSample(vec);
+    }
+}
+
+void readBundledArchive( const std::string & iName )
+{
+    Alembic::AbcCoreGit::ReadArchive r;
+    ABCA::ArchiveReaderPtr a = r( iName );
+    ABCA::CompoundPropertyReaderPtr top = a->getTop()->getProperties();
+
+    ABCA::ScalarPropertyReaderPtr ints = top->getScalarProperty("ints");
+    ABCA::ScalarPropertyReaderPtr floats = top->getScalarProperty("floats");
+    TESTING_ASSERT( ints->getNumSamples() == 2000 );
+    TESTING_ASSERT( floats->getNumSamples() == 2000 );
+
+    // out of order, a few samples only
+    for (int i = 1999; i >= 0; i -= 97)
+    {
+        Alembic::Util::int32_t val = 0;
+        ints->getSample( i, &val );
+        TESTING_ASSERT( val == i * i );
+
+        float32_t vec[3];
+        floats->getSample( i, vec );
+        TESTING_ASSERT( vec[0] == float32_t(i) && vec[1] == 0.5f &&
+                        vec[2] == -float32_t(i) );
+    }
+}
+
+// every thread reads all the samples, starting from a different one, so
+// that the first reads of the bundled samples overlap
+void readBundledSamples( ABCA::ScalarPropertyReaderPtr iInts,
+                         ABCA::ScalarPropertyReaderPtr iFloats,
+                         int iStart, bool * oOk )
+{
+    *oOk = true;
+    for (int n = 0; n < 2000; ++n)
+    {
+        int i = (iStart + n * 7) % 2000;
+
+        Alembic::Util::int32_t val = 0;
+        iInts->getSample( i, &val );
+
+        float32_t vec[3];
+        iFloats->getSample( i, vec );
+
+        if ( val != i * i || vec[0] != float32_t(i) || vec[2] != -float32_t(i) )
+        {
+            *oOk = false;
+        }
+    }
+}
+
+void readBundledArchiveConcurrently( const std::string & iName )
+{
+    Alembic::AbcCoreGit::ReadArchive r;
+    ABCA::ArchiveReaderPtr a = r( iName );
+    ABCA::CompoundPropertyReaderPtr top = a->getTop()->getProperties();
+    ABCA::ScalarPropertyReaderPtr ints = top->getScalarProperty("ints");
+    ABCA::ScalarPropertyReaderPtr floats = top->getScalarProperty("floats");
+
+    const int numThreads = 8;
+    bool ok[numThreads];
+    std::vector<std::thread> readers;
+    for (int t = 0; t < numThreads; ++t)
+    {
+        readers.push_back( std::thread( readBundledSamples, ints, floats,
+                                        t * 250, &ok[t] ) );
+    }
+    for (int t = 0; t < numThreads; ++t)
+    {
+        readers[t].join();
+        TESTING_ASSERT( ok[t] );
+    }
+}
+
+void testBundledSamples()
+{
+    std::string archiveName = "bundledArchive.abc";
+    writeBundledArchive( archiveName, 200 );
+    readBundledArchive( archiveName );
+
+    // nothing bundled
+    std::string unbundledName = "unbundledArchive.abc";
+    writeBundledArchive( unbundledName, 0 );
+    readBundledArchive( unbundledName );
+
+    // bundle segments flushed every few hundred samples while writing
+    std::string streamedName = "streamedArchive.abc";
+    writeBundledArchive( streamedName, 200, 4096 );
+    readBundledArchive( streamedName );
+
+    // the bundled samples are unpacked on first use, from any thread
+    readBundledArchiveConcurrently( archiveName );
+    readBundledArchiveConcurrently( streamedName );
+}
+
+bool hasTreeEntry( const std::string & iName, const std::string & iPath )
+{
+    git_repository * repo = NULL;
+    TESTING_ASSERT( git_repository_open( &repo, iName.c_str() ) == 0 );
+
+    git_object * obj = NULL;
+    std::string spec = "HEAD:" + iPath;
+    bool found = ( git_revparse_single( &obj, repo, spec.c_str() ) == 0 );
+
+    git_object_free( obj );
+    git_repository_free( repo );
+    return found;
+}
+
+void testBundleSegments()
+{
+    std::string archiveName = "segmentedArchive.abc";
+    const int flushBytes = 1024;
+    {
+        ABCA::MetaData m;
+        AO::WriteOptions options;
+        options["bundleSamplesBelow"] = 200;
+        options["bundleFlushBytes"] = flushBytes;
+        AO::WriteArchive w( options );
+        ABCA::ArchiveWriterPtr a = w( archiveName, m );
+        AO::AwImplPtr aw = Alembic::Util::dynamic_pointer_cast<AO::AwImpl>( a );
+        TESTING_ASSERT( aw );
+
+        ABCA::DataType i32d(Alembic::Util::kInt32POD, 1);
+        ABCA::ScalarPropertyWriterPtr ints = a->getTop()->getProperties()->
+            createScalarProperty("ints", m, i32d, 0);
+
+        AO::KeyStore<Alembic::Util::int32_t> * ks = NULL;
+        for (int i = 0; i < 2000; ++i)
+        {
+            Alembic::Util::int32_t val = i * i;
+            ints->setSample(&val);
+
+            // the samples of a segment are let go of once it is flushed
+            ks = aw->ksm().get<Alembic::Util::int32_t>();
+            TESTING_ASSERT( ks );
+            TESTING_ASSERT( ks->bundledBytes() < (size_t) flushBytes );
+        }
+
+        // 4 bytes a sample: one segment every 256 samples, the rest is
+        // written with the header
+        TESTING_ASSERT( ks->bundleSegments() == 2000 / 256 );
+        TESTING_ASSERT( ks->bundledBytes() == ( 2000 % 256 ) * 4 );
+    }
+
+    for (int s = 0; s < 2000 / 256; ++s)
+    {
+        std::ostringstream ss;
+        ss << "keystore_int32_bundle_" << s << ".bin";
+        TESTING_ASSERT( hasTreeEntry( archiveName, ss.str() ) );
+    }
+    TESTING_ASSERT( !hasTreeEntry( archiveName, "keystore_int32_bundle_7.bin" ) );
+    TESTING_ASSERT( hasTreeEntry( archiveName, "keystore_int32_bundle.bin" ) );
+
+    // every segment reads back
+    Alembic::AbcCoreGit::ReadArchive r;
+    ABCA::ArchiveReaderPtr a = r( archiveName );
+    ABCA::ScalarPropertyReaderPtr ints =
+        a->getTop()->getProperties()->getScalarProperty("ints");
+    TESTING_ASSERT( ints->getNumSamples() == 2000 );
+    for (int i = 0; i < 2000; ++i)
+    {
+        Alembic::Util::int32_t val = 0;
+        ints->getSample( i, &val );
+        TESTING_ASSERT( val == i * i );
+    }
+}
+
+void writePackedArchive( const std::string & iName, bool iPack )
+{
+    ABCA::MetaData m;
+    AO::WriteOptions options;
+    options["packProperties"] = iPack;
+    AO::WriteArchive w( options );
+    ABCA::ArchiveWriterPtr a = w( iName, m );
+    ABCA::ObjectWriterPtr obj = a->getTop()->createChild(
+        ABCA::ObjectHeader( "mesh", m ) );
+    ABCA::CompoundPropertyWriterPtr top = obj->getProperties();
+    ABCA::CompoundPropertyWriterPtr geom =
+        top->createCompoundProperty( ".geom", m );
+
+    ABCA::DataType i32d(Alembic::Util::kInt32POD, 1);
+    std::vector <Alembic::Util::int32_t> vals(10, 4);
+    geom->createArrayProperty("faces", m, i32d, 0)->setSample(
+        ABCA::ArraySample(&(vals.front()), i32d, Dimensions(vals.size())));
+
+    Alembic::Util::int32_t val = 3;
+    geom->createScalarProperty("count", m, i32d, 0)->setSample(&val);
+    top->createScalarProperty("visible", m, i32d, 0)->setSample(&val);
+}
+
+void readPackedArchive( const std::string & iName )
+{
+    Alembic::AbcCoreGit::ReadArchive r;
+    ABCA::ArchiveReaderPtr a = r( iName );
+    ABCA::ObjectReaderPtr obj = a->getTop()->getChild( "mesh" );
+    TESTING_ASSERT( obj );
+
+    ABCA::CompoundPropertyReaderPtr top = obj->getProperties();
+    TESTING_ASSERT( top->getNumProperties() == 2 );
+
+    Alembic::Util::int32_t val = 0;
+    top->getScalarProperty( "visible" )->getSample( 0, &val );
+    TESTING_ASSERT( val == 3 );
+
+    ABCA::CompoundPropertyReaderPtr geom = top->getCompoundProperty( ".geom" );
+    TESTING_ASSERT( geom && geom->getNumProperties() == 2 );
+
+    val = 0;
+    geom->getScalarProperty( "count" )->getSample( 0, &val );
+    TESTING_ASSERT( val == 3 );
+
+    ABCA::ArraySamplePtr samp;
+    geom->getArrayProperty( "faces" )->getSample( 0, samp );
+    TESTING_ASSERT( samp->getDimensions().numPoints() == 10 );
+    const Alembic::Util::int32_t * data =
+        (const Alembic::Util::int32_t *) samp->getData();
+    TESTING_ASSERT( data[0] == 4 && data[9] == 4 );
+}
+
+void readPackedProperty( ABCA::CompoundPropertyReaderPtr iGeom,
+                         bool iArray, bool * oOk )
+{
+    if ( iArray )
+    {
+        ABCA::ArraySamplePtr samp;
+        iGeom->getArrayProperty( "faces" )->getSample( 0, samp );
+        *oOk = ( samp->getDimensions().numPoints() == 10 &&
+                 ((const Alembic::Util::int32_t *) samp->getData())[9] == 4 );
+    }
+    else
+    {
+        Alembic::Util::int32_t val = 0;
+        iGeom->getScalarProperty( "count" )->getSample( 0, &val );
+        *oOk = ( val == 3 );
+    }
+}
+
+// the first property opened unpacks the files of all of them, whichever
+// thread it is opened from
+void readPackedArchiveConcurrently( const std::string & iName )
+{
+    for (int n = 0; n < 20; ++n)
+    {
+        Alembic::AbcCoreGit::ReadArchive r;
+        ABCA::ArchiveReaderPtr a = r( iName );
+        ABCA::CompoundPropertyReaderPtr geom = a->getTop()->getChild(
+            "mesh" )->getProperties()->getCompoundProperty( ".geom" );
+
+        bool arrayOk = false;
+        bool scalarOk = false;
+        std::thread arrayReader( readPackedProperty, geom, true, &arrayOk );
+        std::thread scalarReader( readPackedProperty, geom, false, &scalarOk );
+        arrayReader.join();
+        scalarReader.join();
+        TESTING_ASSERT( arrayOk && scalarOk );
+    }
+}
+
+void testPackedProperties()
+{
+    std::string packedName = "packedArchive.abc";
+    writePackedArchive( packedName, true );
+    readPackedArchive( packedName );
+    readPackedArchiveConcurrently( packedName );
+
+    std::string plainName = "unpackedArchive.abc";
+    writePackedArchive( plainName, false );
+    readPackedArchive( plainName );
+
+    // same contents, whatever the layout
+    Alembic::AbcCoreFactory::IOptions options;
+    Alembic::AbcCoreGit::ArchiveChanges changes =
+        Alembic::AbcCoreGit::diffArchives( packedName, options,
+                                           plainName, options );
+    TESTING_ASSERT( changes.empty() );
+}
+
+void writeHashedArchive( const std::string & iName, int iHashThreads,
+                         int iWriteBatchBytes = -1 )
+{
+    ABCA::MetaData m;
+    AO::WriteOptions options;
+    options["hashThreads"] = iHashThreads;
+    if (iWriteBatchBytes >= 0)
+        options["writeBatchBytes"] = iWriteBatchBytes;
+    AO::WriteArchive w( options );
+    ABCA::ArchiveWriterPtr a = w( iName, m );
+    ABCA::CompoundPropertyWriterPtr top = a->getTop()->getProperties();
+
+    // large enough to span several write batches
+    ABCA::DataType f32d(Alembic::Util::kFloat32POD, 1);
+    ABCA::ArrayPropertyWriterPtr prop =
+        top->createArrayProperty("weights", m, f32d, 0);
+    std::vector<float32_t> vals(64 * 1024);
+    for (int i = 0; i < 48; ++i)
+    {
+        std::fill(vals.begin(), vals.end(), float32_t(i));
+        prop->setSample(ABCA::ArraySample(&(vals.front()), f32d,
+                                          Dimensions(vals.size())));
+    }
+}
+
+// every blob of the tree is stored under the oid libgit2 gives its contents
+int checkBlobOid( const char * iRoot, const git_tree_entry * iEntry,
+                  void * iPayload )
+{
+    if ( git_tree_entry_type( iEntry ) != GIT_OBJ_BLOB )
+    {
+        return 0;
+    }
+
+    std::pair< git_repository *, int > * walk =
+        static_cast< std::pair< git_repository *, int > * >( iPayload );
+
+    git_blob * blob = NULL;
+    TESTING_ASSERT( git_blob_lookup( &blob, walk->first,
+                                     git_tree_entry_id( iEntry ) ) == 0 );
+
+    git_oid oid;
+    TESTING_ASSERT( git_blob_create_frombuffer( &oid, walk->first,
+        git_blob_rawcontent( blob ), git_blob_rawsize( blob ) ) == 0 );
+    TESTING_ASSERT( git_oid_equal( &oid, git_tree_entry_id( iEntry ) ) );
+
+    git_blob_free( blob );
+    walk->second++;
+    return 0;
+}
+
+void checkBlobOids( const std::string & iName )
+{
+    git_repository * repo = NULL;
+    TESTING_ASSERT( git_repository_open( &repo, iName.c_str() ) == 0 );
+
+    git_object * tree = NULL;
+    TESTING_ASSERT( git_revparse_single( &tree, repo, "HEAD^{tree}" ) == 0 );
+
+    std::pair< git_repository *, int > walk( repo, 0 );
+    TESTING_ASSERT( git_tree_walk( ( git_tree * ) tree, GIT_TREEWALK_PRE,
+                                   checkBlobOid, &walk ) == 0 );
+    TESTING_ASSERT( walk.second > 0 );
+
+    git_object_free( tree );
+    git_repository_free( repo );
+}
+
+void testParallelHashing()
+{
+    std::string serialName = "serialHashArchive.abc";
+    writeHashedArchive( serialName, 1 );
+
+    std::string parallelName = "parallelHashArchive.abc";
+    writeHashedArchive( parallelName, 4 );
+
+    Alembic::AbcCoreGit::ReadArchive r;
+    ABCA::ArchiveReaderPtr a = r( parallelName );
+    ABCA::ArrayPropertyReaderPtr prop =
+        a->getTop()->getProperties()->getArrayProperty( "weights" );
+    TESTING_ASSERT( prop->getNumSamples() == 48 );
+
+    ABCA::ArraySamplePtr samp;
+    prop->getSample( 47, samp );
+    TESTING_ASSERT( samp->getDimensions().numPoints() == 64 * 1024 );
+    TESTING_ASSERT( ((const float32_t *) samp->getData())[100] == 47.0f );
+
+    checkBlobOids( serialName );
+    checkBlobOids( parallelName );
+
+    // the oids don't depend on the threads hashing them
+    Alembic::AbcCoreFactory::IOptions options;
+    Alembic::AbcCoreGit::ArchiveChanges changes =
+        Alembic::AbcCoreGit::diffArchives( serialName, options,
+                                           parallelName, options );
+    TESTING_ASSERT( changes.empty() );
+
+    // nor on the blobs being written in batches or one by one
+    std::string unbatchedName = "unbatchedHashArchive.abc";
+    writeHashedArchive( unbatchedName, 4, /* writeBatchBytes */ 0 );
+    checkBlobOids( unbatchedName );
+
+    git_oid batchedTree = treeOid( parallelName, "HEAD^{tree}" );
+    git_oid unbatchedTree = treeOid( unbatchedName, "HEAD^{tree}" );
+    TESTING_ASSERT( git_oid_equal( &batchedTree, &unbatchedTree ) );
+}
+
+// an odb backend keeping the blobs in memory and counting the calls the
+// odb makes to it
+struct CountingBackend
+{
+    git_odb_backend parent;
+    std::map<std::string, std::string> blobs;
+    size_t writes;
+    size_t freshens;
+    size_t rehashed;
+};
+
+static std::string oidKey( const git_oid * oid )
+{
+    return std::string( ( const char * ) oid->id, GIT_OID_RAWSZ );
+}
+
+static int countingExists( git_odb_backend * backend, const git_oid * oid )
+{
+    CountingBackend * b = ( CountingBackend * ) backend;
+    return b->blobs.count( oidKey( oid ) ) ? 1 : 0;
+}
+
+static int countingWrite( git_odb_backend * backend, const git_oid * oid,
+                          const void * data, size_t len, git_otype type )
+{
+    CountingBackend * b = ( CountingBackend * ) backend;
+    b->writes++;
+
+    git_oid expected;
+    git_odb_hash( &expected, data, len, type );
+    if ( !git_oid_equal( &expected, oid ) )
+    {
+        b->rehashed++;
+    }
+
+    b->blobs[oidKey( oid )] = std::string( ( const char * ) data, len );
+    return 0;
+}
+
+static int countingFreshen( git_odb_backend * backend, const git_oid * oid )
+{
+    CountingBackend * b = ( CountingBackend * ) backend;
+    b->freshens++;
+    return countingExists( backend, oid ) ? 0 : GIT_ENOTFOUND;
+}
+
+static void countingFree( git_odb_backend * )
+{
+}
+
+void testHashOnce()
+{
+    CountingBackend counting;
+    memset( &counting.parent, 0, sizeof( counting.parent ) );
+    counting.parent.version = GIT_ODB_BACKEND_VERSION;
+    counting.parent.exists = countingExists;
+    counting.parent.write = countingWrite;
+    counting.parent.freshen = countingFreshen;
+    counting.parent.free = countingFree;
+    counting.writes = 0;
+    counting.freshens = 0;
+    counting.rehashed = 0;
+
+    std::string first( 1000, 'a' );
+    std::string second( 2000, 'b' );
+    std::vector<const std::string *> contents;
+    contents.push_back( &first );
+    contents.push_back( &second );
+    contents.push_back( &first );
+
+    {
+        AO::GitRepoPtr repo( new AO::GitRepo( "hashOnceArchive.abc" ) );
+        TESTING_ASSERT( git_odb_add_backend( repo->g_odb(),
+                                             &counting.parent, 1000 ) == 0 );
+
+        std::vector<git_oid> oids;
+        TESTING_ASSERT( repo->writeBlobs( contents, oids ) );
+        TESTING_ASSERT( oids.size() == 3 );
+        TESTING_ASSERT( git_oid_equal( &oids[0], &oids[2] ) );
+
+        // each new blob reaches the backend once, under the oid computed
+        // by the batch: git_odb_write() would have hashed it again and
+        // freshened it first
+        TESTING_ASSERT( counting.writes == 2 );
+        TESTING_ASSERT( counting.rehashed == 0 );
+        TESTING_ASSERT( counting.freshens == 0 );
+        TESTING_ASSERT( counting.blobs[oidKey( &oids[1] )] == second );
+
+        // the blobs already stored are skipped
+        TESTING_ASSERT( repo->writeBlobs( contents, oids ) );
+        TESTING_ASSERT( counting.writes == 2 );
+    }
+
+    // milliways stores the blob under the oid it is given, it doesn't
+    // hash the payload itself
+    std::string storeName = "hashOnce.mwdb";
+    git_odb_backend * odb = NULL;
+    TESTING_ASSERT( git_odb_backend_milliways( &odb, storeName.c_str(),
+                                               0 ) == 0 );
+    git_oid given, hashed;
+    TESTING_ASSERT( git_odb_hash( &given, "other", 5, GIT_OBJ_BLOB ) == 0 );
+    TESTING_ASSERT( git_odb_hash( &hashed, "blob", 4, GIT_OBJ_BLOB ) == 0 );
+    TESTING_ASSERT( odb->write( odb, &given, "blob", 4, GIT_OBJ_BLOB ) == 0 );
+    TESTING_ASSERT( odb->exists( odb, &given ) == 1 );
+    TESTING_ASSERT( odb->exists( odb, &hashed ) == 0 );
+    odb->free( odb );
+}
+
+void readMilliwaysArchive( const std::string & iName,
+                           Alembic::Util::int32_t iValue )
+{
+    Alembic::AbcCoreFactory::IOptions options;
+    options["milliways"] = true;
+    Alembic::AbcCoreGit::ReadArchive r( options );
+    checkIncrementalArchive( r( iName ), iValue );
+}
+
+void testGarbageCollection()
+{
+    std::string archiveName = "gcArchive.abc";
+    writeIncrementalArchive( archiveName, 1, /* milliways */ true );
+    writeIncrementalArchive( archiveName, 2, /* milliways */ true );
+    writeIncrementalArchive( archiveName, 3, /* milliways */ true );
+
+    // only the last commit stays reachable
+    std::string errorMessage;
+    TESTING_ASSERT( AO::trashHistory( archiveName, errorMessage ) );
+
+    AO::GarbageStats stats;
+    TESTING_ASSERT( AO::collectGarbage( archiveName, stats, errorMessage ) );
+    TESTING_ASSERT( stats.refs == 1 );
+    TESTING_ASSERT( stats.missingObjects == 0 );
+    TESTING_ASSERT( stats.liveObjects < stats.objects );
+    readMilliwaysArchive( archiveName, 3 );
+
+    // nothing left to collect
+    AO::GarbageStats again;
+    TESTING_ASSERT( AO::collectGarbage( archiveName, again, errorMessage ) );
+    TESTING_ASSERT( again.objects == stats.liveObjects );
+    TESTING_ASSERT( again.liveObjects == again.objects );
+    readMilliwaysArchive( archiveName, 3 );
+
+    // refused while the archive is open, whatever the path it is given by
+    {
+        Alembic::AbcCoreFactory::IOptions options;
+        options["milliways"] = true;
+        Alembic::AbcCoreGit::ReadArchive r( options );
+        ABCA::ArchiveReaderPtr a = r( archiveName );
+
+        TESTING_ASSERT( !AO::collectGarbage( "./" + archiveName, stats,
+                                             errorMessage ) );
+        TESTING_ASSERT( errorMessage.find( "in use" ) != std::string::npos );
+    }
+    TESTING_ASSERT( AO::collectGarbage( "./" + archiveName, stats,
+                                        errorMessage ) );
+
+    // a store without references would lose everything, it is left alone
+    std::string bareName = "gcBare.mwdb";
+    git_oid oid;
+    {
+        git_odb_backend * odb = NULL;
+        TESTING_ASSERT( git_odb_backend_milliways( &odb, bareName.c_str(),
+                                                   0 ) == 0 );
+        TESTING_ASSERT( git_odb_hash( &oid, "blob", 4, GIT_OBJ_BLOB ) == 0 );
+        TESTING_ASSERT( odb->write( odb, &oid, "blob", 4,
+                                    GIT_OBJ_BLOB ) == 0 );
+        odb->free( odb );
+    }
+
+    TESTING_ASSERT( !AO::collectGarbage( bareName, stats, errorMessage ) );
+    TESTING_ASSERT( errorMessage.find( "no references" ) !=
+                    std::string::npos );
+    TESTING_ASSERT( stats.liveObjects == 0 );
+    {
+        git_odb_backend * odb = NULL;
+        TESTING_ASSERT( git_odb_backend_milliways( &odb, bareName.c_str(),
+                                                   1 ) == 0 );
+        TESTING_ASSERT( odb->exists( odb, &oid ) == 1 );
+        odb->free( odb );
+    }
+}
+
 int main ( int argc, char *argv[] )
 {
     testReadWriteEmptyArchive();
@@ -384,5 +1166,16 @@ int main ( int argc, char *argv[] )
 
     testReadWriteMaxNumSamplesArchive();
 
+    testIncrementalArchive();
+    testDiffRevisions();
+    testSnapshotReader();
+
+    testBundledSamples();
+    testBundleSegments();
+    testPackedProperties();
+    testParallelHashing();
+    testHashOnce();
+    testGarbageCollection();
+
     return 0;
 }
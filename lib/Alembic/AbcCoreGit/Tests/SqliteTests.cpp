@@ -0,0 +1,199 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2026,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#include <Alembic/AbcCoreGit/git-sqlite.h>
+#include <Alembic/Util/All.h>
+
+#include <Alembic/AbcCoreAbstract/Tests/Assert.h>
+
+#include <sqlite3.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// the tests cross batch boundaries, so they are built with a small batch
+#ifndef SQLITE_TRANSACTION_BYTES
+#error "build the tests and git-sqlite.c with a common SQLITE_TRANSACTION_BYTES"
+#endif
+
+//-*****************************************************************************
+void removeDatabase( const std::string & iName )
+{
+    std::remove( iName.c_str() );
+    std::remove( ( iName + "-wal" ).c_str() );
+    std::remove( ( iName + "-shm" ).c_str() );
+}
+
+// the rows another connection sees, those of committed transactions
+int committedRows( const std::string & iName )
+{
+    sqlite3 * db = NULL;
+    TESTING_ASSERT( sqlite3_open( iName.c_str(), &db ) == SQLITE_OK );
+
+    sqlite3_stmt * st = NULL;
+    TESTING_ASSERT( sqlite3_prepare_v2( db, "SELECT count(*) FROM git2_odb",
+                                        -1, &st, NULL ) == SQLITE_OK );
+    TESTING_ASSERT( sqlite3_step( st ) == SQLITE_ROW );
+    int rows = sqlite3_column_int( st, 0 );
+
+    sqlite3_finalize( st );
+    sqlite3_close( db );
+    return rows;
+}
+
+// about a kilobyte, every blob differs
+std::string blobContents( int i )
+{
+    std::string contents( 1000 + i % 7, 'a' + i % 26 );
+    std::sprintf( &contents[0], "blob %d", i );
+    return contents;
+}
+
+void writeBlobs( git_odb_backend * iBackend, int iFirst, int iLast,
+                 std::vector< git_oid > & oOids )
+{
+    for ( int i = iFirst; i < iLast; ++i )
+    {
+        std::string contents = blobContents( i );
+
+        git_oid oid;
+        TESTING_ASSERT( git_odb_hash( &oid, contents.data(), contents.size(),
+                                      GIT_OBJ_BLOB ) == 0 );
+        TESTING_ASSERT( iBackend->write( iBackend, &oid, contents.data(),
+            contents.size(), GIT_OBJ_BLOB ) == 0 );
+        oOids.push_back( oid );
+    }
+}
+
+void checkBlobs( git_odb_backend * iBackend,
+                 const std::vector< git_oid > & iOids )
+{
+    for ( std::size_t i = 0; i < iOids.size(); ++i )
+    {
+        std::string contents = blobContents( ( int ) i );
+
+        void * data = NULL;
+        size_t len = 0;
+        git_otype type = GIT_OBJ_BAD;
+        TESTING_ASSERT( iBackend->read( &data, &len, &type, iBackend,
+                                        &iOids[i] ) == 0 );
+        TESTING_ASSERT( type == GIT_OBJ_BLOB );
+        TESTING_ASSERT( len == contents.size() );
+        TESTING_ASSERT( memcmp( data, contents.data(), len ) == 0 );
+        free( data );
+
+        len = 0;
+        TESTING_ASSERT( iBackend->read_header( &len, &type, iBackend,
+                                               &iOids[i] ) == 0 );
+        TESTING_ASSERT( len == contents.size() );
+        TESTING_ASSERT( iBackend->exists( iBackend, &iOids[i] ) );
+
+        // long enough to be unique among a few hundred objects
+        git_oid found;
+        TESTING_ASSERT( iBackend->read_prefix( &found, &data, &len, &type,
+                                               iBackend, &iOids[i], 16 ) == 0 );
+        TESTING_ASSERT( memcmp( found.id, iOids[i].id, GIT_OID_RAWSZ ) == 0 );
+        free( data );
+    }
+}
+
+//-*****************************************************************************
+void testBatchedWrites()
+{
+    std::string dbName = "sqliteBatches.db";
+    removeDatabase( dbName );
+
+    // three batches, built with a small SQLITE_TRANSACTION_BYTES
+    const int numBlobs = 3 * SQLITE_TRANSACTION_BYTES / 1000;
+    std::vector< git_oid > oids;
+
+    git_odb_backend * backend = NULL;
+    TESTING_ASSERT( git_odb_backend_sqlite( &backend, dbName.c_str() ) == 0 );
+    writeBlobs( backend, 0, numBlobs, oids );
+
+    // the full batches are committed, the last one is still pending but
+    // this connection reads it
+    int rows = committedRows( dbName );
+    TESTING_ASSERT( rows >= 2 * SQLITE_TRANSACTION_BYTES / 1006 );
+    TESTING_ASSERT( rows < numBlobs );
+    checkBlobs( backend, oids );
+
+    // a commit object closes the batch
+    std::string commit = "tree 4b825dc642cb6eb9a060e54bf8d69288fbee4904\n";
+    git_oid commitOid;
+    TESTING_ASSERT( git_odb_hash( &commitOid, commit.data(), commit.size(),
+                                  GIT_OBJ_COMMIT ) == 0 );
+    TESTING_ASSERT( backend->write( backend, &commitOid, commit.data(),
+        commit.size(), GIT_OBJ_COMMIT ) == 0 );
+    TESTING_ASSERT( committedRows( dbName ) == numBlobs + 1 );
+
+    // and closing the backend commits what follows it
+    writeBlobs( backend, numBlobs, numBlobs + 10, oids );
+    TESTING_ASSERT( committedRows( dbName ) == numBlobs + 1 );
+    backend->free( backend );
+    TESTING_ASSERT( committedRows( dbName ) == numBlobs + 11 );
+
+    // everything reads back once reopened
+    backend = NULL;
+    TESTING_ASSERT( git_odb_backend_sqlite( &backend, dbName.c_str() ) == 0 );
+    checkBlobs( backend, oids );
+    TESTING_ASSERT( backend->exists( backend, &commitOid ) );
+
+    // an empty object too
+    git_oid emptyOid;
+    TESTING_ASSERT( git_odb_hash( &emptyOid, "", 0, GIT_OBJ_BLOB ) == 0 );
+    TESTING_ASSERT( backend->write( backend, &emptyOid, "", 0,
+                                    GIT_OBJ_BLOB ) == 0 );
+    void * data = NULL;
+    size_t len = 1;
+    git_otype type = GIT_OBJ_BAD;
+    TESTING_ASSERT( backend->read( &data, &len, &type, backend,
+                                   &emptyOid ) == 0 );
+    TESTING_ASSERT( len == 0 && type == GIT_OBJ_BLOB );
+    free( data );
+
+    backend->free( backend );
+}
+
+//-*****************************************************************************
+int main( int argc, char *argv[] )
+{
+    testBatchedWrites();
+    return 0;
+}
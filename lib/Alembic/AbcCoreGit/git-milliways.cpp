@@ -27,6 +27,10 @@
 #include <stdint.h>
 #include <string.h>
 #include <errno.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #include <git2.h>
 #include <git2/errors.h>
@@ -43,7 +47,10 @@
 
 #include "milliways/Utils.h"
 #include "Utils.h"
+#include <Alembic/Util/Murmur3.h>
 #include <algorithm>
+#include <set>
+#include <vector>
 
 #ifndef GIT_SUCCESS
 #define GIT_SUCCESS 0
@@ -185,8 +192,6 @@ typedef XTYPENAME kv_store_t::Search kv_search_t;
 typedef XTYPENAME kv_store_t::iterator kv_iterator_t;
 typedef XTYPENAME kv_store_t::glob_iterator kv_glob_iterator_t;
 
-static cache_el cached;
-
 struct milliways_backend
 {
 public:
@@ -197,11 +202,14 @@ public:
 	bool init;
 	bool cleaned;
 	bool is_open;
+	bool odb_taken;
+	bool refdb_taken;
 	std::string m_pathname;
 	int m_refcnt;
+	cache_el cached;					/* per instance: readers must not see objects outside their snapshot */
 
 	milliways_backend() :
-		bs(NULL), kv(NULL), init(false), cleaned(false), is_open(false), m_pathname(), m_refcnt(0) { memset(&parent, 0, sizeof(git_odb_backend)); memset(&parent_refdb, 0, sizeof(git_refdb_backend)); }
+		bs(NULL), kv(NULL), init(false), cleaned(false), is_open(false), odb_taken(false), refdb_taken(false), m_pathname(), m_refcnt(0), cached() { memset(&parent, 0, sizeof(git_odb_backend)); memset(&parent_refdb, 0, sizeof(git_refdb_backend)); }
 	~milliways_backend();
 
 	int refcnt() const { return m_refcnt; }
@@ -212,24 +220,28 @@ public:
 
 	const std::string& pathname() const { return m_pathname; }
 
-	bool open(const std::string& pathname_);
+	bool open(const std::string& pathname_, bool readonly_ = false);
 	bool isOpen() const { return is_open; }
 	void cleanup();
 
 	git_odb_backend   *odb_backend() { return &parent; }
 	git_refdb_backend *refdb_backend() { return &parent_refdb; }
 
-	static struct milliways_backend* GetInstance(const std::string& pathname);
+	typedef std::pair< std::string, bool > instance_key_t;			/* (canonical pathname, readonly) */
+	typedef std::multimap< instance_key_t, struct milliways_backend* > instances_map_t;
+
+	static struct milliways_backend* GetInstance(const std::string& pathname, bool readonly, bool for_refdb);
 	static struct milliways_backend* FromOdb(git_odb_backend* ptr);
 	static struct milliways_backend* FromRefdb(const git_refdb_backend* ptr);
-	static std::map< std::string, struct milliways_backend* > s_instances;
+	static bool IsInUse(const std::string& pathname);
+	static instances_map_t s_instances;
 	static std::map< const git_refdb_backend*, struct milliways_backend* > s_refdb_to_master;
 };
 
 struct milliways_refdb_iterator
 {
-	milliways_refdb_iterator(kv_glob_iterator_t& it, milliways_backend* backend_) :
-		parent(), iterator(NULL), backend(backend_)
+	milliways_refdb_iterator(kv_glob_iterator_t& it, milliways_backend* backend_, const std::string& glob_) :
+		parent(), iterator(NULL), backend(backend_), glob(glob_)
 	{
 		iterator = new kv_glob_iterator_t(it);
 		parent.next = &milliways_refdb_backend__iterator_next;
@@ -244,18 +256,47 @@ struct milliways_refdb_iterator
 	git_odb_backend   *odb_backend() { return backend->odb_backend(); }
 	git_refdb_backend *refdb_backend() { return backend->refdb_backend(); }
 
+	/* the name of the next reference matching glob */
+	bool next_name(std::string& ref_name);
+
 	/* members */
 	git_reference_iterator parent;
 
 	kv_glob_iterator_t* iterator;
 
 	milliways_backend* backend;
+
+	std::string glob;
 };
 
 
-std::map< std::string, struct milliways_backend* > milliways_backend::s_instances;
+milliways_backend::instances_map_t milliways_backend::s_instances;
 std::map< const git_refdb_backend*, struct milliways_backend* > milliways_backend::s_refdb_to_master;
 
+/* the same store can be reached through different names (relative, symlinks, ...) */
+static std::string milliways_canonical_path(const std::string& pathname)
+{
+	char resolved[PATH_MAX];
+	if (realpath(pathname.c_str(), resolved))
+		return std::string(resolved);
+
+	/* the store doesn't exist yet: resolve its directory */
+	std::string dirname(".");
+	std::string basename(pathname);
+	std::string::size_type slash = pathname.rfind('/');
+	if (slash != std::string::npos) {
+		dirname  = (slash == 0) ? std::string("/") : pathname.substr(0, slash);
+		basename = pathname.substr(slash + 1);
+	}
+	if (realpath(dirname.c_str(), resolved)) {
+		std::string canonical(resolved);
+		if (canonical.empty() || (canonical[canonical.size() - 1] != '/'))
+			canonical += "/";
+		return canonical + basename;
+	}
+	return pathname;
+}
+
 milliways_backend::~milliways_backend()
 {
 	if (init) cleanup();
@@ -264,35 +305,70 @@ milliways_backend::~milliways_backend()
 
 	typedef std::map< const git_refdb_backend*, struct milliways_backend* > r2m_map_t;
 	typedef r2m_map_t::iterator r2m_it_t;
-	for (r2m_it_t it = s_refdb_to_master.begin(); it != s_refdb_to_master.end(); ++it) {
-		milliways_backend*& b_ptr = it->second;
-		if (b_ptr == this)
-			s_refdb_to_master.erase(it);
+	for (r2m_it_t it = s_refdb_to_master.begin(); it != s_refdb_to_master.end(); ) {
+		if (it->second == this)
+			s_refdb_to_master.erase(it++);
+		else
+			++it;
+	}
+	for (instances_map_t::iterator it = s_instances.begin(); it != s_instances.end(); ) {
+		if (it->second == this)
+			s_instances.erase(it++);
+		else
+			++it;
 	}
-	// if (milliways_backend::s_refdb_to_master.count(this) != 0)
-	// 	milliways_backend::s_refdb_to_master.erase(this);
-	if (milliways_backend::s_instances.count(pathname()) != 0)
-		milliways_backend::s_instances.erase(pathname());
 }
 
-struct milliways_backend* milliways_backend::GetInstance(const std::string& pathname)
+/*
+ * The odb and the refdb of a repository share one instance, asked for
+ * one after the other.  Writers share a single instance per store (the
+ * store lock allows only one anyway), while every reader gets its own,
+ * so that it keeps the snapshot committed when it was opened.
+ */
+struct milliways_backend* milliways_backend::GetInstance(const std::string& pathname, bool readonly, bool for_refdb)
 {
-	if (s_instances.count(pathname) != 0)
-		return s_instances[pathname];
+	instance_key_t key(milliways_canonical_path(pathname), readonly);
+
+	std::pair<instances_map_t::iterator, instances_map_t::iterator> range = s_instances.equal_range(key);
+	for (instances_map_t::iterator it = range.first; it != range.second; ++it) {
+		milliways_backend* candidate = it->second;
+		bool taken = for_refdb ? candidate->refdb_taken : candidate->odb_taken;
+		if ((! readonly) || (! taken)) {
+			if (for_refdb)
+				candidate->refdb_taken = true;
+			else
+				candidate->odb_taken = true;
+			return candidate;
+		}
+	}
 
 	milliways_backend* backend = new milliways_backend();
 	if (! backend)
 		return NULL;
-	if (! backend->open(pathname))
+	if (! backend->open(pathname, readonly)) {
+		delete backend;
 		return NULL;
+	}
 	assert(backend->isOpen());
 
-	s_instances[pathname] = backend;
+	if (for_refdb)
+		backend->refdb_taken = true;
+	else
+		backend->odb_taken = true;
+
+	s_instances.insert(instances_map_t::value_type(key, backend));
 	s_refdb_to_master[backend->refdb_backend()] = backend;
 
 	return backend;
 }
 
+bool milliways_backend::IsInUse(const std::string& pathname)
+{
+	std::string canonical = milliways_canonical_path(pathname);
+	return (s_instances.count(instance_key_t(canonical, false)) != 0) ||
+		(s_instances.count(instance_key_t(canonical, true)) != 0);
+}
+
 struct milliways_backend* milliways_backend::FromOdb(git_odb_backend* ptr)
 {
 	return reinterpret_cast<milliways_backend*>(ptr);
@@ -305,7 +381,7 @@ struct milliways_backend* milliways_backend::FromRefdb(const git_refdb_backend*
 	return NULL;
 }
 
-bool milliways_backend::open(const std::string& pathname_)
+bool milliways_backend::open(const std::string& pathname_, bool readonly_)
 {
 	TRACE("milliways_backend::open()") ;
 
@@ -315,17 +391,22 @@ bool milliways_backend::open(const std::string& pathname_)
 	assert(! init);
 	init = true;
 
-	bs = new kv_blockstorage_t(pathname_);
+	/* read-only backends see the snapshot committed when they are opened */
+	bs = new kv_blockstorage_t(pathname_, readonly_);
 	if (! bs)
 		goto do_cleanup;
 	assert(bs);
+	/* writers log changes sequentially and sync them once per ref update */
+	if (! readonly_)
+		bs->wal(true);
 
 	kv = new kv_store_t(bs);
 	if (kv == NULL)
 		goto do_cleanup;
 	assert(kv);
 
-	kv->open();
+	if (! kv->open())
+		goto do_cleanup;
 
 	parent.version = 1;
 	parent.read = &milliways_backend__read;
@@ -334,6 +415,7 @@ bool milliways_backend::open(const std::string& pathname_)
 	parent.exists = &milliways_backend__exists;
 	parent.free = &milliways_backend__free;
 
+	parent_refdb.version = 1;
 	parent_refdb.exists = &milliways_refdb_backend__exists;
 	parent_refdb.lookup = &milliways_refdb_backend__lookup;
 	parent_refdb.iterator = &milliways_refdb_backend__iterator;
@@ -397,9 +479,9 @@ static int milliways_backend__read_header(size_t *len_p, git_otype *type_p, git_
 	milliways_backend *backend = reinterpret_cast<milliways_backend*>(backend_);
 	assert(backend);
 
-	if (cached.matches(oid)) {
-		*type_p = cached.type;
-		*len_p = cached.len;
+	if (backend->cached.matches(oid)) {
+		*type_p = backend->cached.type;
+		*len_p = backend->cached.len;
 		return GIT_SUCCESS;
 	}
 
@@ -468,18 +550,18 @@ static int milliways_backend__read(void **data_p, size_t *len_p, git_otype *type
 	milliways_backend *backend = reinterpret_cast<milliways_backend*>(backend_);
 	assert(backend);
 
-	if (cached.matches(oid)) {
-		*type_p = cached.type;
-		*len_p = cached.len;
+	if (backend->cached.matches(oid)) {
+		*type_p = backend->cached.type;
+		*len_p = backend->cached.len;
 		if (data_p) {
-			if (! cached.data)
+			if (! backend->cached.data)
 				return GIT_ENOMEM;
-			char* databuf = (char *)malloc(cached.len + 1);
+			char* databuf = (char *)malloc(backend->cached.len + 1);
 			if (! databuf)
 				return GIT_ENOMEM;
-			assert(cached.data);
-			memcpy(databuf, cached.data, cached.len);
-			databuf[cached.len] = '\0';
+			assert(backend->cached.data);
+			memcpy(databuf, backend->cached.data, backend->cached.len);
+			databuf[backend->cached.len] = '\0';
 			*data_p = databuf;
 		}
 		return GIT_SUCCESS;
@@ -572,7 +654,7 @@ static int milliways_backend__read(void **data_p, size_t *len_p, git_otype *type
 	double t_elapsed = Alembic::AbcCoreGit::time_ms() - t_start;
 	std::cerr << "MW::GET " << milliways::hexify(s_oid) << " <- OK (" << t_elapsed << " ms) " << v_type << " " << v_size << " " << milliways::hexify(s_data) << std::endl;
 #endif /* TRACE_MW */
-	cached.set(oid, *type_p, *len_p, databuf);
+	backend->cached.set(oid, *type_p, *len_p, databuf);
 
 	return GIT_SUCCESS;
 }
@@ -584,11 +666,11 @@ static int milliways_backend__exists(git_odb_backend *backend_, const git_oid *o
 #endif /* TRACE_MW */
 	assert(backend_ && oid);
 
-	if (cached.matches(oid)) {
-		return cached.present ? 1 : 0;
-	}
-
 	milliways_backend *backend = reinterpret_cast<milliways_backend*>(backend_);
+
+	if (backend->cached.matches(oid)) {
+		return backend->cached.present ? 1 : 0;
+	}
 	assert(backend);
 
 	std::string s_oid(reinterpret_cast<const char*>(oid->id), 20);
@@ -610,6 +692,7 @@ static int milliways_backend__write(git_odb_backend *backend_, const git_oid *oi
 	git_oid oid_data, *oid = NULL;
 	if (oid_)
 	{
+		/* the caller already hashed the payload, trust its oid */
 		oid = (git_oid *)oid_;
 	} else
 	{
@@ -656,7 +739,7 @@ static int milliways_backend__write(git_odb_backend *backend_, const git_oid *oi
 	double t_elapsed = Alembic::AbcCoreGit::time_ms() - t_start;
 	std::cerr << "MW::PUT " << milliways::hexify(s_oid) << " <- OK (" << t_elapsed << " ms) " << v_type << " " << v_size << " " << milliways::hexify(whole) << std::endl;
 #endif /* TRACE_MW */
-	cached.set(oid, type, len, data);
+	backend->cached.set(oid, type, len, data);
 
 	return GIT_SUCCESS;
 }
@@ -695,6 +778,81 @@ void milliways_backend__free(git_odb_backend *backend_)
 	}
 }
 
+	/* refdb backend - keys */
+
+/*
+ * references are stored under "refdb:<name>", but keys are capped at
+ * KEY_MAX_SIZE bytes: longer names (like "refs/heads/master") are stored
+ * under "refdb#<digest of the name>" instead. Either way the value is
+ * [type][target][name], stores written before the name was added lack it.
+ */
+static std::string milliways_refdb__key(const char *ref_name)
+{
+	std::string key("refdb:");
+	key += ref_name;
+	if (key.size() <= kv_store_t::KEY_MAX_SIZE)
+		return key;
+
+	uint64_t digest[2];
+	Alembic::Util::MurmurHash3_x64_128(ref_name, strlen(ref_name), 1, digest);
+
+	/* byte by byte, so that the key doesn't depend on the endianness */
+	key = "refdb#";
+	for (size_t i = 0; key.size() < kv_store_t::KEY_MAX_SIZE; i++)
+		key.push_back(static_cast<char>(digest[i / 8] >> (8 * (i % 8))));
+	return key;
+}
+
+static bool milliways_refdb__is_ref(const std::string& key)
+{
+	return (key.compare(0, 6, "refdb:") == 0) || (key.compare(0, 6, "refdb#") == 0);
+}
+
+static bool milliways_refdb__unpack(const std::string& blob, uint32_t& ref_type, std::string& target, std::string& name)
+{
+	const char *blob_ptr   = blob.data();
+	size_t      blob_avail = blob.size();
+
+	ref_type = (uint32_t)-1;
+	target.clear();
+	name.clear();
+	if ((seriously::Traits<uint32_t>::deserialize(blob_ptr, blob_avail, ref_type) < 0) ||
+		(seriously::Traits<std::string>::deserialize(blob_ptr, blob_avail, target) < 0))
+		return false;
+	if ((blob_avail > 0) && (seriously::Traits<std::string>::deserialize(blob_ptr, blob_avail, name) < 0))
+		return false;
+	return true;
+}
+
+/* the name of the reference stored under key, empty if it can't be told */
+static std::string milliways_refdb__name(kv_store_t *kv, const std::string& key)
+{
+	if (key.compare(0, 6, "refdb:") == 0)
+		return key.substr(6);
+
+	std::string blob, target, name;
+	uint32_t ref_type;
+	if ((! kv->get(key, blob)) || (! milliways_refdb__unpack(blob, ref_type, target, name)))
+		return std::string();
+	return name;
+}
+
+bool milliways_refdb_iterator::next_name(std::string& ref_name)
+{
+	for (; ! iterator->end(); ++(*iterator)) {
+		std::string key = iterator->key();
+		if (! milliways_refdb__is_ref(key))
+			continue;
+
+		ref_name = milliways_refdb__name(backend->kv, key);
+		if ((! ref_name.empty()) && milliways::glob(glob, ref_name)) {
+			++(*iterator);
+			return true;
+		}
+	}
+	return false;
+}
+
 	/* refdb backend */
 static int milliways_refdb_backend__exists(int *exists, git_refdb_backend *backend_, const char *ref_name)
 {
@@ -706,8 +864,7 @@ static int milliways_refdb_backend__exists(int *exists, git_refdb_backend *backe
 	milliways_backend *backend = milliways_backend::FromRefdb(backend_);
 	assert(backend);
 
-	std::string key("refdb:");
-	key += ref_name;
+	std::string key = milliways_refdb__key(ref_name);
 
 	// std::cerr << "milliways_refdb_backend__exists('" << key << "')" << std::endl;
 	kv_search_t search;
@@ -716,7 +873,8 @@ static int milliways_refdb_backend__exists(int *exists, git_refdb_backend *backe
 	double t_elapsed = Alembic::AbcCoreGit::time_ms() - t_start;
 	std::cerr << "MW::HAS " << key << " <- (" << t_elapsed << " ms) " << (r ? "TRUE" : "FALSE") << std::endl;
 #endif /* TRACE_MW */
-	return r;
+	*exists = r;
+	return GIT_SUCCESS;
 }
 
 static int milliways_refdb_backend__lookup(git_reference **out, git_refdb_backend *backend_, const char *ref_name)
@@ -730,8 +888,7 @@ static int milliways_refdb_backend__lookup(git_reference **out, git_refdb_backen
 	milliways_backend *backend = milliways_backend::FromRefdb(backend_);
 	assert(backend);
 
-	std::string key("refdb:");
-	key += ref_name;
+	std::string key = milliways_refdb__key(ref_name);
 
 	// std::cerr << "milliways_refdb_backend__lookup('" << key << "')" << std::endl;
 	kv_search_t search;
@@ -765,16 +922,18 @@ static int milliways_refdb_backend__lookup(git_reference **out, git_refdb_backen
 		return error;
 	}
 
-	const char *blob_ptr   = blob.data();
-	size_t      blob_avail = blob.size();
-
 	uint32_t v_ref_type = (uint32_t)-1;
-	std::string v_ref;
+	std::string v_ref, v_name;
 
-	seriously::Traits<uint32_t>::deserialize(blob_ptr, blob_avail, v_ref_type);
-	seriously::Traits<std::string>::deserialize(blob_ptr, blob_avail, v_ref);
+	milliways_refdb__unpack(blob, v_ref_type, v_ref, v_name);
 	// std::cerr << "  ref_type:" << v_ref_type << " ref:" << v_ref << std::endl;
 
+	/* a different name with the same digest */
+	if ((key[5] == '#') && (v_name != ref_name)) {
+		giterr_set_str(GITERR_REFERENCE, "milliways refdb couldn't find ref");
+		return GIT_ENOTFOUND;
+	}
+
 	git_ref_t ref_type = static_cast<git_ref_t>(v_ref_type);
 	git_oid oid;
 
@@ -823,13 +982,13 @@ static int milliways_refdb_backend__iterator(git_reference_iterator **iter_, str
 	milliways_backend *backend = milliways_backend::FromRefdb(backend_);
 	assert(backend);
 
-	std::string pattern("refdb:");
-	pattern += ((glob != NULL) ? glob : "refs/*");
+	/* every reference, whatever its key, the names are matched while iterating */
+	std::string pattern("refdb*");
 
 	kv_glob_iterator_t it = backend->kv->glob(pattern);
 
 	// milliways_refdb_iterator *iterator = (milliways_refdb_iterator*) calloc(1, sizeof(milliways_refdb_iterator));
-	milliways_refdb_iterator* iterator = new milliways_refdb_iterator(it, backend);
+	milliways_refdb_iterator* iterator = new milliways_refdb_iterator(it, backend, (glob != NULL) ? glob : "refs/*");
 
 	// iterator->backend = backend;
 	// iterator->iterator = new kv_glob_iterator_t(it);
@@ -857,16 +1016,11 @@ static int milliways_refdb_backend__iterator_next(git_reference **ref, git_refer
 
 	assert(iterator->iterator);
 
-	if (iterator->iterator->end())
+	std::string ref_name;
+	if (! iterator->next_name(ref_name))
 		return GIT_ITEROVER;
 
-	std::string key = iterator->iterator->lookupKey();
-	std::string ref_name = key.substr(6);
-	int error = milliways_refdb_backend__lookup(ref, iterator->refdb_backend(), ref_name.c_str());
-
-	++iterator->iterator;
-
-	return error;
+	return milliways_refdb_backend__lookup(ref, iterator->refdb_backend(), ref_name.c_str());
 }
 
 static int milliways_refdb_backend__iterator_next_name(const char **ref_name, git_reference_iterator *iter_)
@@ -878,15 +1032,12 @@ static int milliways_refdb_backend__iterator_next_name(const char **ref_name, gi
 
 	assert(iterator->iterator);
 
-	if (iterator->iterator->end())
+	std::string ref_name_;
+	if (! iterator->next_name(ref_name_))
 		return GIT_ITEROVER;
 
-	std::string key = iterator->iterator->lookupKey();
-	std::string ref_name_ = key.substr(6);
 	*ref_name = strdup(ref_name_.c_str());
 
-	++iterator->iterator;
-
 	return GIT_OK;
 }
 
@@ -923,8 +1074,7 @@ static int milliways_refdb_backend__write(git_refdb_backend *backend_, const git
 	target = git_reference_target(ref);
 	symbolic_target = git_reference_symbolic_target(ref);
 
-	std::string key("refdb:");
-	key += name;
+	std::string key = milliways_refdb__key(name);
 
 	/* FIXME handle force correctly */
 
@@ -942,10 +1092,11 @@ static int milliways_refdb_backend__write(git_refdb_backend *backend_, const git
 	}
 
 	seriously::Packer<BUFFER_SIZE> packer;
-	packer << v_type << v_target;
+	packer << v_type << v_target << std::string(name);
 	std::string whole(packer.data(), packer.size());
 
-	ok = backend->kv->put(key, whole);
+	/* a ref update completes a set of objects: commit it for snapshot readers */
+	ok = backend->kv->put(key, whole) && backend->kv->flush();
 #if TRACE_MW
 	double t_elapsed = Alembic::AbcCoreGit::time_ms() - t_start;
 	std::cerr << "MW::PUT " << key << " <- " << (ok ? "OK" : "NO") << " (" << t_elapsed << " ms) " << v_type << " " << v_target << std::endl;
@@ -968,10 +1119,44 @@ static int milliways_refdb_backend__rename(git_reference **out, git_refdb_backen
 	milliways_backend *backend = milliways_backend::FromRefdb(backend_);
 	assert(backend);
 
-	int error = GIT_ERROR;
-	giterr_set_str(GITERR_REFERENCE, "milliways refdb storage error - rename UNIMPLEMENTED (yet)");
+	std::string old_key = milliways_refdb__key(old_name);
+	std::string new_key = milliways_refdb__key(new_name);
 
-	return error;
+	if (! backend->kv->has(old_key)) {
+		giterr_set_str(GITERR_REFERENCE, "milliways refdb couldn't find ref");
+		return GIT_ENOTFOUND;
+	}
+
+	if (backend->kv->has(new_key)) {
+		if (! force) {
+			giterr_set_str(GITERR_REFERENCE, "milliways refdb - a reference with that name already exists");
+			return GIT_EEXISTS;
+		}
+		if (! backend->kv->remove(new_key)) {
+			giterr_set_str(GITERR_REFERENCE, "milliways refdb storage error");
+			return GIT_ERROR;
+		}
+	}
+
+	/* the name is part of the value, so it is moved by hand */
+	std::string blob, v_target, v_name;
+	uint32_t v_type;
+	bool ok = backend->kv->get(old_key, blob) && milliways_refdb__unpack(blob, v_type, v_target, v_name);
+	if (ok) {
+		seriously::Packer<BUFFER_SIZE> packer;
+		packer << v_type << v_target << std::string(new_name);
+		std::string whole(packer.data(), packer.size());
+
+		ok = backend->kv->put(new_key, whole) && backend->kv->remove(old_key) && backend->kv->flush();
+	}
+	if (! ok) {
+		giterr_set_str(GITERR_REFERENCE, "milliways refdb storage error");
+		return GIT_ERROR;
+	}
+
+	if (out)
+		return milliways_refdb_backend__lookup(out, backend_, new_name);
+	return GIT_SUCCESS;
 }
 
 static int milliways_refdb_backend__del(git_refdb_backend *backend_, const char *ref_name, const git_oid *old, const char *old_target)
@@ -982,10 +1167,23 @@ static int milliways_refdb_backend__del(git_refdb_backend *backend_, const char
 	milliways_backend *backend = milliways_backend::FromRefdb(backend_);
 	assert(backend);
 
-	int error = GIT_ERROR;
-	giterr_set_str(GITERR_REFERENCE, "milliways refdb storage error - delete UNIMPLEMENTED (yet)");
+	std::string key = milliways_refdb__key(ref_name);
 
-	return error;
+	/* FIXME check old / old_target */
+
+	if (! backend->kv->has(key)) {
+		giterr_set_str(GITERR_REFERENCE, "milliways refdb couldn't find ref");
+		return GIT_ENOTFOUND;
+	}
+
+	/* the objects it was keeping alive stay in the store until milliways_gc() */
+	bool ok = backend->kv->remove(key) && backend->kv->flush();
+	if (! ok) {
+		giterr_set_str(GITERR_REFERENCE, "milliways refdb storage error");
+		return GIT_ERROR;
+	}
+
+	return GIT_SUCCESS;
 }
 
 static void milliways_refdb_backend__free(git_refdb_backend *backend_)
@@ -1051,7 +1249,292 @@ static int milliways_refdb_backend__reflog_delete(git_refdb_backend *backend_, c
 }
 
 
-int git_odb_backend_milliways(git_odb_backend **backend_out, const char *pathname)
+	/* garbage collection */
+
+/* a store opened directly, without the odb/refdb plumbing nor WAL mode */
+struct milliways_gc_store
+{
+	kv_blockstorage_t* bs;
+	kv_store_t* kv;
+
+	milliways_gc_store() : bs(NULL), kv(NULL) {}
+	~milliways_gc_store() { close(); }
+
+	bool open(const std::string& pathname_, bool readonly_) {
+		assert(! bs && ! kv);
+		bs = new kv_blockstorage_t(pathname_, readonly_);
+		kv = new kv_store_t(bs);
+		return kv->open();
+	}
+
+	bool close() {
+		bool ok = true;
+		if (kv) {
+			if (kv->isOpen())
+				ok = kv->close();
+			delete kv;
+			kv = NULL;
+		}
+		if (bs) {
+			delete bs;
+			bs = NULL;
+		}
+		return ok;
+	}
+};
+
+static uint64_t milliways_gc__file_size(const std::string& pathname)
+{
+	struct stat st;
+	if (stat(pathname.c_str(), &st) != 0)
+		return 0;
+	return static_cast<uint64_t>(st.st_size);
+}
+
+static void milliways_gc__unlink(const std::string& pathname)
+{
+	if (Alembic::AbcCoreGit::file_exists(pathname))
+		unlink(pathname.c_str());
+}
+
+/* the directory holding pathname, whose entry a rename changes */
+static std::string milliways_gc__parent_dir(const std::string& pathname)
+{
+	std::string::size_type slash = pathname.find_last_of('/');
+	if (slash == std::string::npos)
+		return ".";
+	if (slash == 0)
+		return "/";
+	return pathname.substr(0, slash);
+}
+
+/* objects are keyed by their raw id, references by "refdb:<name>" */
+static bool milliways_gc__is_object(const std::string& key)
+{
+	return (key.size() == GIT_OID_RAWSZ) && (! milliways_refdb__is_ref(key));
+}
+
+/* splits a stored object ([type][size][data], see milliways_backend__write()) */
+static bool milliways_gc__unpack(const std::string& whole, git_otype& type, const char*& data, size_t& len)
+{
+	const char *ptr = whole.data();
+	size_t avail = whole.size();
+
+	if (avail < (2 * sizeof(uint32_t)))
+		return false;
+
+	uint32_t v_type = (uint32_t)-1, v_size = (uint32_t)-1;
+	seriously::Traits<uint32_t>::deserialize(ptr, avail, v_type);
+	seriously::Traits<uint32_t>::deserialize(ptr, avail, v_size);
+	if ((size_t)v_size > avail)
+		return false;
+
+	type = static_cast<git_otype>(v_type);
+	data = ptr;
+	len = static_cast<size_t>(v_size);
+	return true;
+}
+
+/* appends the (raw) ids of the objects referenced by a commit, tag or tree */
+static void milliways_gc__references(git_otype type, const char *data, size_t len, std::vector<std::string>& refs)
+{
+	const char *p = data;
+	const char *end = data + len;
+	git_oid oid;
+
+	switch (type)
+	{
+	case GIT_OBJ_COMMIT:
+	case GIT_OBJ_TAG:
+		/* header lines ("tree <hex>", "parent <hex>", "object <hex>", ...) up to the first empty one */
+		while ((p < end) && (*p != '\n')) {
+			const char *eol = static_cast<const char *>(memchr(p, '\n', end - p));
+			if (! eol)
+				eol = end;
+			const char *sp = static_cast<const char *>(memchr(p, ' ', eol - p));
+			if (sp && ((eol - (sp + 1)) >= GIT_OID_HEXSZ)) {
+				std::string field(p, sp - p);
+				if (((field == "tree") || (field == "parent") || (field == "object")) &&
+					(git_oid_fromstrn(&oid, sp + 1, GIT_OID_HEXSZ) == GIT_SUCCESS))
+					refs.push_back(std::string(reinterpret_cast<const char*>(oid.id), GIT_OID_RAWSZ));
+			}
+			p = eol + 1;
+		}
+		break;
+	case GIT_OBJ_TREE:
+		/* entries: "<octal mode> <name>\0<raw id>", submodules (gitlinks) live elsewhere */
+		while (p < end) {
+			const char *sp = static_cast<const char *>(memchr(p, ' ', end - p));
+			if (! sp)
+				break;
+			bool gitlink = ((sp - p) == 6) && (memcmp(p, "160000", 6) == 0);
+			const char *nul = static_cast<const char *>(memchr(sp, '\0', end - sp));
+			if ((! nul) || ((end - (nul + 1)) < GIT_OID_RAWSZ))
+				break;
+			if (! gitlink)
+				refs.push_back(std::string(nul + 1, GIT_OID_RAWSZ));
+			p = nul + 1 + GIT_OID_RAWSZ;
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+int milliways_gc(const char *pathname, milliways_gc_stats *stats)
+{
+	assert(pathname);
+
+	std::string s_pathname(pathname);
+	std::string gc_pathname = s_pathname + ".gc";
+
+	milliways_gc_stats st;
+	memset(&st, 0, sizeof(st));
+	if (stats)
+		*stats = st;
+
+	if (milliways_backend::IsInUse(s_pathname)) {
+		giterr_set_str(GITERR_ODB, "milliways gc: the store is in use by this process");
+		return GIT_ERROR;
+	}
+	if (! Alembic::AbcCoreGit::isfile(s_pathname)) {
+		giterr_set_str(GITERR_ODB, "milliways gc: no such store");
+		return GIT_ENOTFOUND;
+	}
+
+	st.size_before = milliways_gc__file_size(s_pathname) + milliways_gc__file_size(s_pathname + ".wal");
+
+	/* make sure it is a store before opening it for writing */
+	{
+		milliways_gc_store probe;
+		bool valid = probe.open(s_pathname, /* readonly */ true);
+		probe.close();
+		if (! valid) {
+			giterr_set_str(GITERR_ODB, "milliways gc: can't open the store");
+			return GIT_ERROR;
+		}
+	}
+
+	/* being the writer keeps others from adding objects while we collect */
+	milliways_gc_store src;
+	if (! src.open(s_pathname, /* readonly */ false)) {
+		giterr_set_str(GITERR_ODB, "milliways gc: the store is locked by another writer");
+		return GIT_ERROR;
+	}
+
+	/* roots: the targets of the direct references (symbolic ones resolve to those) */
+	std::vector<std::string> pending;
+	for (kv_iterator_t it = src.kv->begin(); it; ++it) {
+		const std::string& key = it.key();
+		if (milliways_gc__is_object(key)) {
+			st.objects++;
+			continue;
+		}
+		if (! milliways_refdb__is_ref(key))
+			continue;
+
+		std::string blob;
+		if (! src.kv->get(it, blob))
+			continue;
+
+		uint32_t v_ref_type;
+		std::string v_ref, v_name;
+		if (! milliways_refdb__unpack(blob, v_ref_type, v_ref, v_name))
+			continue;
+
+		git_oid oid;
+		if ((static_cast<git_ref_t>(v_ref_type) == GIT_REF_OID) &&
+			(git_oid_fromstr(&oid, v_ref.c_str()) == GIT_SUCCESS)) {
+			pending.push_back(std::string(reinterpret_cast<const char*>(oid.id), GIT_OID_RAWSZ));
+			st.refs++;
+		}
+	}
+
+	/* without any reference everything would go: most likely not what was meant */
+	if (st.refs == 0) {
+		src.close();
+		giterr_set_str(GITERR_ODB, "milliways gc: no references in the store, nothing collected");
+		return GIT_ERROR;
+	}
+
+	/* mark */
+	std::set<std::string> live;
+	while (! pending.empty()) {
+		std::string s_oid = pending.back();
+		pending.pop_back();
+		if (! live.insert(s_oid).second)
+			continue;
+
+		std::string whole;
+		git_otype type;
+		const char *data;
+		size_t len;
+		if ((! src.kv->get(s_oid, whole)) || (! milliways_gc__unpack(whole, type, data, len))) {
+			st.missing_objects++;
+			continue;
+		}
+		milliways_gc__references(type, data, len, pending);
+	}
+
+	/* sweep: copy the references and the live objects into a fresh store */
+	milliways_gc__unlink(gc_pathname);
+	milliways_gc__unlink(gc_pathname + ".wal");
+
+	bool ok = true;
+	{
+		milliways_gc_store dst;
+		ok = dst.open(gc_pathname, /* readonly */ false);
+		for (kv_iterator_t it = src.kv->begin(); ok && it; ++it) {
+			const std::string& key = it.key();
+			bool is_object = milliways_gc__is_object(key);
+			if (is_object && (live.count(key) == 0))
+				continue;
+
+			std::string value;
+			ok = src.kv->get(it, value) && dst.kv->put(key, value);
+			if (ok && is_object)
+				st.live_objects++;
+		}
+		ok = dst.close() && ok;
+	}
+
+	/* replace the store while still holding its writer lock, the collected
+	 * store must be on disk before it takes the old one's name */
+	if (ok)
+		ok = milliways::sync_pathname(gc_pathname);
+	if (ok)
+		ok = (rename(gc_pathname.c_str(), s_pathname.c_str()) == 0);
+	if (! ok) {
+		src.close();
+		milliways_gc__unlink(gc_pathname);
+		milliways_gc__unlink(gc_pathname + ".lock");
+		giterr_set_str(GITERR_ODB, "milliways gc: can't write the collected store");
+		return GIT_ERROR;
+	}
+
+	/* and the rename must be on disk before the old log is dropped */
+	bool synced = milliways::sync_pathname(milliways_gc__parent_dir(s_pathname));
+
+	/* the old store (and its log) are now unlinked / obsolete, the log must
+	 * go even if the sync failed, it would be replayed over the new store */
+	src.close();
+	milliways_gc__unlink(s_pathname + ".wal");
+	milliways_gc__unlink(gc_pathname + ".lock");
+
+	if (! synced) {
+		giterr_set_str(GITERR_ODB, "milliways gc: can't sync the directory of the collected store");
+		return GIT_ERROR;
+	}
+
+	st.size_after = milliways_gc__file_size(s_pathname);
+	if (stats)
+		*stats = st;
+
+	return GIT_SUCCESS;
+}
+
+
+int git_odb_backend_milliways(git_odb_backend **backend_out, const char *pathname, int readonly)
 {
 	// std::cerr << "START MILLIWAYS BACKEND\n";
 
@@ -1067,9 +1550,9 @@ int git_odb_backend_milliways(git_odb_backend **backend_out, const char *pathnam
 	*backend_out = (git_odb_backend *) backend;
 #endif
 	// use a singleton mapping on 'pathname'
-	milliways_backend* backend = milliways_backend::GetInstance(pathname);
+	milliways_backend* backend = milliways_backend::GetInstance(pathname, readonly ? true : false, /* for_refdb */ false);
 	if (! backend)
-		return GIT_ENOMEM;
+		return GIT_ERROR;
 	assert(backend);
 	if (! backend->isOpen())
 		return GIT_ERROR;
@@ -1081,14 +1564,14 @@ int git_odb_backend_milliways(git_odb_backend **backend_out, const char *pathnam
 	return GIT_SUCCESS;
 }
 
-int git_refdb_backend_milliways(git_refdb_backend **backend_out, const char *pathname)
+int git_refdb_backend_milliways(git_refdb_backend **backend_out, const char *pathname, int readonly)
 {
 	// std::cerr << "START MILLIWAYS BACKEND\n";
 
 	// use a singleton mapping on 'pathname'
-	milliways_backend* backend = milliways_backend::GetInstance(pathname);
+	milliways_backend* backend = milliways_backend::GetInstance(pathname, readonly ? true : false, /* for_refdb */ true);
 	if (! backend)
-		return GIT_ENOMEM;
+		return GIT_ERROR;
 	assert(backend);
 	if (! backend->isOpen())
 		return GIT_ERROR;
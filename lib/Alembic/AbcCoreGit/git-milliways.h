@@ -19,14 +19,33 @@
 #ifndef _ALEMBIC_GIT_MILLIWAYS_H_
 #define _ALEMBIC_GIT_MILLIWAYS_H_
 
+#include <stdint.h>
+#include <stddef.h>
+
 #include <git2.h>
 
 extern "C" {
 
 int milliways_backend__cleanedup(git_odb_backend *backend_);
 void milliways_backend__free(git_odb_backend *backend_);
-int git_odb_backend_milliways(git_odb_backend **backend_out, const char *pathname);
-int git_refdb_backend_milliways(git_refdb_backend **backend_out, const char *pathname);
+int git_odb_backend_milliways(git_odb_backend **backend_out, const char *pathname, int readonly);
+int git_refdb_backend_milliways(git_refdb_backend **backend_out, const char *pathname, int readonly);
+
+typedef struct milliways_gc_stats {
+	size_t refs;				/* direct references, the roots of the collection */
+	size_t objects;				/* objects in the store before collecting */
+	size_t live_objects;		/* objects reachable from the references (kept) */
+	size_t missing_objects;		/* reachable but not in the store */
+	uint64_t size_before;		/* bytes on disk (store + log) */
+	uint64_t size_after;
+} milliways_gc_stats;
+
+/*
+ * Rewrites the store at 'pathname' keeping only its references and the
+ * objects reachable from them, then replaces it atomically.
+ * Fails if the store is open in this process or by another writer.
+ */
+int milliways_gc(const char *pathname, milliways_gc_stats *stats);
 
 } /* extern "C" */
 
@@ -24,6 +24,8 @@
  */
 
 #include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <git2.h>
 #include <git2/odb_backend.h>
@@ -49,6 +51,25 @@
 #endif
 
 #define GIT2_TABLE_NAME "git2_odb"
+#define GIT2_HEADER_INDEX_NAME "git2_odb_header"
+
+/* set before the table gets created, larger pages suit the blobs, all of
+   these can be overridden at build time */
+#ifndef SQLITE_PAGE_SIZE
+#define SQLITE_PAGE_SIZE 16384
+#endif
+#ifndef SQLITE_MMAP_SIZE
+#define SQLITE_MMAP_SIZE (256 * 1024 * 1024)
+#endif
+#ifndef SQLITE_CACHE_KIB
+#define SQLITE_CACHE_KIB (64 * 1024)
+#endif
+
+/* writes are grouped in one transaction until a commit object is written,
+   or until this much data is pending */
+#ifndef SQLITE_TRANSACTION_BYTES
+#define SQLITE_TRANSACTION_BYTES (64 * 1024 * 1024)
+#endif
 
 typedef struct {
 	git_odb_backend parent;
@@ -56,8 +77,37 @@ typedef struct {
 	sqlite3_stmt *st_read;
 	sqlite3_stmt *st_write;
 	sqlite3_stmt *st_read_header;
+	sqlite3_stmt *st_read_prefix;
+	int in_transaction;
+	size_t pending_bytes;
 } sqlite_backend;
 
+static int sqlite_backend__begin(sqlite_backend *backend)
+{
+	if (backend->in_transaction)
+		return GIT_SUCCESS;
+
+	if (sqlite3_exec(backend->db, "BEGIN;", NULL, NULL, NULL) != SQLITE_OK)
+		return GIT_ERROR;
+
+	backend->in_transaction = 1;
+	backend->pending_bytes = 0;
+	return GIT_SUCCESS;
+}
+
+static int sqlite_backend__commit(sqlite_backend *backend)
+{
+	if (! backend->in_transaction)
+		return GIT_SUCCESS;
+
+	if (sqlite3_exec(backend->db, "COMMIT;", NULL, NULL, NULL) != SQLITE_OK)
+		return GIT_ERROR;
+
+	backend->in_transaction = 0;
+	backend->pending_bytes = 0;
+	return GIT_SUCCESS;
+}
+
 int sqlite_backend__read_header(size_t *len_p, git_otype *type_p, git_odb_backend *_backend, const git_oid *oid)
 {
 	sqlite_backend *backend;
@@ -71,7 +121,7 @@ int sqlite_backend__read_header(size_t *len_p, git_otype *type_p, git_odb_backen
 	if (sqlite3_bind_text(backend->st_read_header, 1, (char *)oid->id, 20, SQLITE_TRANSIENT) == SQLITE_OK) {
 		if (sqlite3_step(backend->st_read_header) == SQLITE_ROW) {
 			*type_p = (git_otype)sqlite3_column_int(backend->st_read_header, 0);
-			*len_p = (size_t)sqlite3_column_int(backend->st_read_header, 1);
+			*len_p = (size_t)sqlite3_column_int64(backend->st_read_header, 1);
 			assert(sqlite3_step(backend->st_read_header) == SQLITE_DONE);
 			error = GIT_SUCCESS;
 		} else {
@@ -96,13 +146,14 @@ int sqlite_backend__read(void **data_p, size_t *len_p, git_otype *type_p, git_od
 	if (sqlite3_bind_text(backend->st_read, 1, (char *)oid->id, 20, SQLITE_TRANSIENT) == SQLITE_OK) {
 		if (sqlite3_step(backend->st_read) == SQLITE_ROW) {
 			*type_p = (git_otype)sqlite3_column_int(backend->st_read, 0);
-			*len_p = (size_t)sqlite3_column_int(backend->st_read, 1);
-			*data_p = malloc(*len_p);
+			*len_p = (size_t)sqlite3_column_int64(backend->st_read, 1);
+			*data_p = malloc(*len_p ? *len_p : 1);
 
 			if (*data_p == NULL) {
 				error = GIT_ENOMEM;
 			} else {
-				memcpy(*data_p, sqlite3_column_blob(backend->st_read, 2), *len_p);
+				if (*len_p)
+					memcpy(*data_p, sqlite3_column_blob(backend->st_read, 2), *len_p);
 				error = GIT_SUCCESS;
 			}
 
@@ -119,18 +170,59 @@ int sqlite_backend__read(void **data_p, size_t *len_p, git_otype *type_p, git_od
 int sqlite_backend__read_prefix(git_oid *out_oid, void **data_p, size_t *len_p, git_otype *type_p, git_odb_backend *_backend,
 					const git_oid *short_oid, size_t len)
 {
+	sqlite_backend *backend;
+	unsigned char lower[GIT_OID_RAWSZ];
+	git_oid found, candidate;
+	size_t nbytes;
+	int nfound, error;
+
+	assert(out_oid && data_p && len_p && type_p && _backend && short_oid);
+
 	if (len >= GIT_OID_HEXSZ) {
 		/* Just match the full identifier */
-		int error = sqlite_backend__read(data_p, len_p, type_p, _backend, short_oid);
+		error = sqlite_backend__read(data_p, len_p, type_p, _backend, short_oid);
 		if (error == GIT_SUCCESS)
 			git_oid_cpy(out_oid, short_oid);
 
 		return error;
-	} else if (len < GIT_OID_HEXSZ) {
-		return GIT_ENOTIMPLEMENTED;
 	}
 
-	return GIT_ERROR;
+	backend = (sqlite_backend *)_backend;
+
+	/* the oids starting with the prefix sort right after its bytes, an odd
+	   last digit padded with 0; two of them are enough to be ambiguous */
+	nbytes = (len + 1) / 2;
+	memcpy(lower, short_oid->id, nbytes);
+	if (len % 2)
+		lower[nbytes - 1] &= 0xf0;
+
+	nfound = 0;
+	if (sqlite3_bind_text(backend->st_read_prefix, 1, (char *)lower, (int)nbytes, SQLITE_TRANSIENT) == SQLITE_OK) {
+		while (sqlite3_step(backend->st_read_prefix) == SQLITE_ROW) {
+			if (sqlite3_column_bytes(backend->st_read_prefix, 0) != GIT_OID_RAWSZ)
+				break;
+
+			git_oid_fromraw(&candidate, (const unsigned char *)sqlite3_column_blob(backend->st_read_prefix, 0));
+			if (git_oid_ncmp(&candidate, short_oid, len) != 0)
+				break;
+
+			if (nfound++ == 0)
+				git_oid_cpy(&found, &candidate);
+		}
+	}
+
+	sqlite3_reset(backend->st_read_prefix);
+
+	if (nfound == 0)
+		return GIT_ENOTFOUND;
+	if (nfound > 1)
+		return GIT_EAMBIGUOUS;
+
+	error = sqlite_backend__read(data_p, len_p, type_p, _backend, &found);
+	if (error == GIT_SUCCESS)
+		git_oid_cpy(out_oid, &found);
+
+	return error;
 }
 
 int sqlite_backend__exists(git_odb_backend *_backend, const git_oid *oid)
@@ -175,15 +267,31 @@ int sqlite_backend__write(git_odb_backend *_backend, const git_oid *oid_, const
 
 	backend = (sqlite_backend *)_backend;
 
+	if (sqlite_backend__begin(backend) < 0)
+		return GIT_ERROR;
+
+	/* the statement only runs before the data is released, no copy needed */
 	if (sqlite3_bind_text(backend->st_write, 1, (char *)oid->id, 20, SQLITE_TRANSIENT) == SQLITE_OK &&
 		sqlite3_bind_int(backend->st_write, 2, (int)type) == SQLITE_OK &&
-		sqlite3_bind_int(backend->st_write, 3, len) == SQLITE_OK &&
-		sqlite3_bind_blob(backend->st_write, 4, data, len, SQLITE_TRANSIENT) == SQLITE_OK) {
+		sqlite3_bind_int64(backend->st_write, 3, (sqlite3_int64)len) == SQLITE_OK &&
+		sqlite3_bind_blob64(backend->st_write, 4, data, (sqlite3_uint64)len, SQLITE_STATIC) == SQLITE_OK) {
 		error = sqlite3_step(backend->st_write);
 	}
 
 	sqlite3_reset(backend->st_write);
-	return (error == SQLITE_DONE) ? GIT_SUCCESS : GIT_ERROR;
+	sqlite3_clear_bindings(backend->st_write);
+
+	if (error != SQLITE_DONE)
+		return GIT_ERROR;
+
+	backend->pending_bytes += len;
+
+	/* the reference to a commit is updated right after it is written, so
+	   everything it points to must be stored for good by then */
+	if ((type == GIT_OBJ_COMMIT) || (backend->pending_bytes >= SQLITE_TRANSACTION_BYTES))
+		return sqlite_backend__commit(backend);
+
+	return GIT_SUCCESS;
 }
 
 
@@ -193,8 +301,11 @@ void sqlite_backend__free(git_odb_backend *_backend)
 	assert(_backend);
 	backend = (sqlite_backend *)_backend;
 
+	sqlite_backend__commit(backend);
+
 	sqlite3_finalize(backend->st_read);
 	sqlite3_finalize(backend->st_read_header);
+	sqlite3_finalize(backend->st_read_prefix);
 	sqlite3_finalize(backend->st_write);
 	sqlite3_close(backend->db);
 
@@ -216,6 +327,38 @@ static int create_table(sqlite3 *db)
 	return GIT_SUCCESS;
 }
 
+/* covers the headers, read_header and exists never touch the blob pages;
+   older stores get it the first time they are opened */
+static int create_header_index(sqlite3 *db)
+{
+	static const char *sql_index =
+		"CREATE INDEX IF NOT EXISTS '" GIT2_HEADER_INDEX_NAME "' "
+		"ON '" GIT2_TABLE_NAME "' (oid, type, size);";
+
+	if (sqlite3_exec(db, sql_index, NULL, NULL, NULL) != SQLITE_OK)
+		return GIT_ERROR;
+
+	return GIT_SUCCESS;
+}
+
+static int tune_db(sqlite3 *db)
+{
+	char sql_tune[256];
+
+	/* page_size only applies to a new database, it must come first */
+	snprintf(sql_tune, sizeof(sql_tune),
+		"PRAGMA page_size = %d;"
+		"PRAGMA journal_mode = WAL;"
+		"PRAGMA mmap_size = %d;"
+		"PRAGMA cache_size = -%d;",
+		SQLITE_PAGE_SIZE, SQLITE_MMAP_SIZE, SQLITE_CACHE_KIB);
+
+	if (sqlite3_exec(db, sql_tune, NULL, NULL, NULL) != SQLITE_OK)
+		return GIT_ERROR;
+
+	return GIT_SUCCESS;
+}
+
 static int init_db(sqlite3 *db)
 {
 	static const char *sql_check =
@@ -244,6 +387,10 @@ static int init_db(sqlite3 *db)
 	}
 
 	sqlite3_finalize(st_check);
+
+	if (error == GIT_SUCCESS)
+		error = create_header_index(db);
+
 	return error;
 }
 
@@ -253,7 +400,11 @@ static int init_statements(sqlite_backend *backend)
 		"SELECT type, size, data FROM '" GIT2_TABLE_NAME "' WHERE oid = ?;";
 
 	static const char *sql_read_header =
-		"SELECT type, size FROM '" GIT2_TABLE_NAME "' WHERE oid = ?;";
+		"SELECT type, size FROM '" GIT2_TABLE_NAME "' INDEXED BY '" GIT2_HEADER_INDEX_NAME "' WHERE oid = ?;";
+
+	static const char *sql_read_prefix =
+		"SELECT oid FROM '" GIT2_TABLE_NAME "' INDEXED BY '" GIT2_HEADER_INDEX_NAME "' "
+		"WHERE oid >= ? ORDER BY oid LIMIT 2;";
 
 	static const char *sql_write =
 		"INSERT OR IGNORE INTO '" GIT2_TABLE_NAME "' VALUES (?, ?, ?, ?);";
@@ -264,6 +415,9 @@ static int init_statements(sqlite_backend *backend)
 	if (sqlite3_prepare_v2(backend->db, sql_read_header, -1, &backend->st_read_header, NULL) != SQLITE_OK)
 		return GIT_ERROR;
 
+	if (sqlite3_prepare_v2(backend->db, sql_read_prefix, -1, &backend->st_read_prefix, NULL) != SQLITE_OK)
+		return GIT_ERROR;
+
 	if (sqlite3_prepare_v2(backend->db, sql_write, -1, &backend->st_write, NULL) != SQLITE_OK)
 		return GIT_ERROR;
 
@@ -279,9 +433,14 @@ int git_odb_backend_sqlite(git_odb_backend **backend_out, const char *sqlite_db)
 	if (backend == NULL)
 		return GIT_ENOMEM;
 
+	error = GIT_ERROR;
 	if (sqlite3_open(sqlite_db, &backend->db) != SQLITE_OK)
 		goto cleanup;
 
+	error = tune_db(backend->db);
+	if (error < 0)
+		goto cleanup;
+
 	error = init_db(backend->db);
 	if (error < 0)
 		goto cleanup;
@@ -28,6 +28,7 @@
 #include <iostream>
 #include <fstream>
 #include <string>
+#include <vector>
 #include <functional>
 
 #include <stdint.h>
@@ -132,6 +133,7 @@ public:
 	void node_dispose(MW_SHPTR<node_type>& node_) { assert(m_io); return m_io->node_dispose(node_); }
 	MW_SHPTR<node_type> node_read(node_id_t node_id) { assert(m_io); return m_io->node_read(node_id); }
 	MW_SHPTR<node_type> node_read(MW_SHPTR<node_type>& node_) { assert(m_io); return m_io->node_read(node_); }
+	void node_prefetch(const std::vector<node_id_t>& node_ids) { assert(m_io); m_io->node_prefetch(node_ids); }
 	MW_SHPTR<node_type> node_write(MW_SHPTR<node_type>& node_) { assert(m_io); return m_io->node_write(node_); }
 
 	/* -- Output --------------------------------------------------- */
@@ -181,6 +183,7 @@ public:
 		MW_SHPTR<node_type> down(const MW_SHPTR<node_type>& node, bool right = false);
 		bool next();
 		bool prev();
+		void read_ahead(const MW_SHPTR<node_type>& leaf);
 
 		tree_type* tree() const { return m_tree; }
 		MW_SHPTR<node_type> root() const { return m_root; }
@@ -392,6 +395,8 @@ public:
 		return MW_SHPTR<node_type>();
 	}
 	virtual MW_SHPTR<node_type> node_write(MW_SHPTR<node_type>& node_) = 0;
+	/* hint: these nodes are going to be read soon */
+	virtual void node_prefetch(const std::vector<node_id_t>& /* node_ids */) {}
 
 	/* -- Header I/O ----------------------------------------------- */
 
@@ -111,6 +111,7 @@ MW_SHPTR<typename BTree<B_, KeyTraits, TTraits, Compare>::node_type> BTree<B_, K
 	MW_SHPTR<node_type> node_( where.node() );
 	assert(node_);
 	node_->value(where.pos()) = value_;
+	node_write(node_);
 
 	return node_;
 }
@@ -194,6 +195,7 @@ typename BTree<B_, KeyTraits, TTraits, Compare>::iterator& BTree<B_, KeyTraits,
 		m_end = false;
 		m_first_node = down(m_root, /* right */ (m_forward ? false : true));
 		m_current.node(m_first_node).pos(m_forward ? 0 : (m_first_node->n() - 1));
+		read_ahead(m_first_node);
 
 		assert(! m_end);
 	}
@@ -230,15 +232,21 @@ bool BTree<B_, KeyTraits, TTraits, Compare>::iterator::next()
 	{
 		if (++pos >= node->n())
 		{
+			node_id_t parent_id = node->parentId();
 			node = node->right();
 			pos = 0;
+			if (node && (node->parentId() != parent_id))
+				read_ahead(node);
 		}
 	} else
 	{
 		if (--pos < 0)
 		{
+			node_id_t parent_id = node->parentId();
 			node = node->left();
 			pos = node ? (node->n() - 1) : 0;
+			if (node && (node->parentId() != parent_id))
+				read_ahead(node);
 		}
 	}
 	m_current.pos(pos).node(node);
@@ -247,6 +255,27 @@ bool BTree<B_, KeyTraits, TTraits, Compare>::iterator::next()
 	return true;
 }
 
+template < int B_, typename KeyTraits, typename TTraits, class Compare >
+void BTree<B_, KeyTraits, TTraits, Compare>::iterator::read_ahead(const MW_SHPTR<node_type>& leaf)
+{
+	/* entering the leaves of another parent: ask for all of them at once */
+	if ((! m_tree) || (! leaf) || (! leaf->hasParent()))
+		return;
+	MW_SHPTR<node_type> parent( leaf->parent() );
+	if (! parent)
+		return;
+
+	std::vector<node_id_t> node_ids;
+	for (int i = 0; i <= parent->n(); i++)
+	{
+		node_id_t child_id = parent->child(i);
+		if (node_id_valid(child_id) && (child_id != leaf->id()))
+			node_ids.push_back(child_id);
+	}
+	if (! node_ids.empty())
+		m_tree->node_prefetch(node_ids);
+}
+
 template < int B_, typename KeyTraits, typename TTraits, class Compare >
 bool BTree<B_, KeyTraits, TTraits, Compare>::iterator::prev()
 {
@@ -263,15 +292,21 @@ bool BTree<B_, KeyTraits, TTraits, Compare>::iterator::prev()
 	{
 		if (--pos < 0)
 		{
+			node_id_t parent_id = node->parentId();
 			node = node->left();
 			pos = node ? (node->n() - 1) : 0;
+			if (node && (node->parentId() != parent_id))
+				read_ahead(node);
 		}
 	} else
 	{
 		if (++pos >= node->n())
 		{
+			node_id_t parent_id = node->parentId();
 			node = node->right();
 			pos = 0;
+			if (node && (node->parentId() != parent_id))
+				read_ahead(node);
 		}
 	}
 	m_current.pos(pos).node(node);
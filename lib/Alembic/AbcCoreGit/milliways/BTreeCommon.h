@@ -55,6 +55,10 @@
 #define MILLIWAYS_DEFAULT_NODE_CACHE_SIZE 1024
 #endif /* MILLIWAYS_DEFAULT_NODE_CACHE_SIZE */
 
+#ifndef MILLIWAYS_DEFAULT_SMALL_VALUE_SIZE
+#define MILLIWAYS_DEFAULT_SMALL_VALUE_SIZE 512
+#endif /* MILLIWAYS_DEFAULT_SMALL_VALUE_SIZE */
+
 
 /* ----------------------------------------------------------------- */
 
@@ -30,6 +30,7 @@
 #include <iostream>
 #include <fstream>
 #include <string>
+#include <set>
 #include <functional>
 #if defined(USE_STD_ARRAY)
 #include <array>
@@ -48,6 +49,12 @@
 
 namespace milliways {
 
+/*
+ * Nodes handed back with node_write() (or freshly allocated) are tracked
+ * as modified, and only those are serialized back to their blocks when
+ * evicted: unmodified nodes are simply dropped, so that the block storage
+ * only ever sees blocks that actually changed.
+ */
 template < size_t CACHESIZE, size_t BLOCKSIZE, int B_, typename KeyTraits, typename TTraits, class Compare = std::less<typename KeyTraits::type> >
 class LRUNodeCache : public LRUCache< CACHESIZE, node_id_t, MW_SHPTR< BTreeNode<B_, KeyTraits, TTraits, Compare> > >
 {
@@ -67,9 +74,12 @@ public:
 	static const node_id_t InvalidCacheKey = NODE_ID_INVALID;
 
 	LRUNodeCache(storage_ptr_type storage) :
-			base_type(LRUNodeCache::InvalidCacheKey), m_storage(storage) {}
+			base_type(LRUNodeCache::InvalidCacheKey), m_storage(storage), m_modified() {}
 	~LRUNodeCache() { this->evict_all(); }
 
+	void modified(node_id_t node_id) { m_modified.insert(node_id); }
+	void forget(node_id_t node_id) { m_modified.erase(node_id); }
+
 	bool on_miss(typename base_type::op_type op, const key_type& key, mapped_type& value)
 	{
 		// std::cerr << "node MISS id:" << key << " op:" << (int)op << "\n";
@@ -121,10 +131,11 @@ public:
 		return true;
 	}
 	//bool on_delete(const key_type& key);
-	bool on_eviction(const key_type& /* key */, mapped_type& value)
+	bool on_eviction(const key_type& key, mapped_type& value)
 	{
-		/* write back block */
-		/* node_id_t node_id = key; */
+		/* write back modified nodes only, the others are already in storage */
+		if (m_modified.erase(key) == 0)
+			return true;
 		if (value) {
 			node_type* node = value.get();
 			if (node)
@@ -150,6 +161,7 @@ private:
 	LRUNodeCache& operator= (const LRUNodeCache&) {}
 
 	storage_ptr_type m_storage;
+	std::set<node_id_t> m_modified;
 };
 
 template <size_t BLOCKSIZE, size_t MAX_SERIALIZED_KEYSIZE, typename TTraits>
@@ -210,11 +222,13 @@ public:
 	bool isOpen() const { assert(m_block_storage); return m_block_storage->isOpen(); }
 	bool open() { return base_type::open(); }
 	bool close() { return base_type::close(); }
-	bool flush() { assert(m_block_storage); return m_block_storage->flush(); }
+	bool flush();
 
 	bool openHelper(bool& created_) { assert(m_block_storage); bool r = m_block_storage->open(); created_ = m_block_storage->created(); return r; }
 	bool closeHelper() { assert(m_block_storage); m_lru.evict_all(); return m_block_storage->close(); }
 
+	bool readonly() const { assert(m_block_storage); return m_block_storage->readonly(); }
+
 	/* -- Node I/O - low level (direct) ---------------------------- */
 
 	bool has_id(node_id_t node_id) { assert(m_block_storage); return m_block_storage->hasId(static_cast<block_id_t>(node_id)); }
@@ -230,6 +244,7 @@ public:
 	void node_dealloc(MW_SHPTR<node_type>& node);
 	MW_SHPTR<node_type> node_read(node_id_t node_id);
 	MW_SHPTR<node_type> node_write(MW_SHPTR<node_type>& node);
+	void node_prefetch(const std::vector<node_id_t>& node_ids);
 
 	/* -- Header I/O ----------------------------------------------- */
 
@@ -61,6 +61,22 @@ BTreeFileStorage<BLOCKSIZE, B_, KeyTraits, TTraits, Compare>::~BTreeFileStorage(
 	}
 }
 
+template < size_t BLOCKSIZE, int B_, typename KeyTraits, typename TTraits, class Compare >
+bool BTreeFileStorage<BLOCKSIZE, B_, KeyTraits, TTraits, Compare>::flush()
+{
+	assert(m_block_storage);
+	if (! isOpen())
+		return false;
+	if (readonly())
+		return true;
+
+	/* nodes down to blocks, then commit a new snapshot */
+	if (! header_write())
+		return false;
+	m_lru.evict_all();
+	return m_block_storage->flush();
+}
+
 template < size_t BLOCKSIZE, int B_, typename KeyTraits, typename TTraits, class Compare >
 void BTreeFileStorage<BLOCKSIZE, B_, KeyTraits, TTraits, Compare>::node_dispose_id_helper(node_id_t node_id)
 {
@@ -138,6 +154,7 @@ MW_SHPTR<typename BTreeFileStorage<BLOCKSIZE, B_, KeyTraits, TTraits, Compare>::
 	MW_SHPTR<node_type> node_ptr( this->manager().get_object(node_id) );
 	assert(node_ptr && (node_ptr->id() == node_id));
 	m_lru.set(node_id, node_ptr);
+	m_lru.modified(node_id);
 	assert(! node_ptr->dirty());
 	// std::cerr << "nFS::node_alloc(" << node_id << ") <- " << node_ptr << "\n";
 	return node_ptr;
@@ -154,6 +171,7 @@ void BTreeFileStorage<BLOCKSIZE, B_, KeyTraits, TTraits, Compare>::node_dealloc(
 
 		base_type::node_dealloc(node_);
 
+		m_lru.forget(node_id);
 		MW_SHPTR<node_type> cached_ptr;
 		if (m_lru.get(cached_ptr, node_id))
 		{
@@ -200,10 +218,10 @@ MW_SHPTR<typename BTreeFileStorage<BLOCKSIZE, B_, KeyTraits, TTraits, Compare>::
 	node_id_t node_id = node_->id();
 	assert(node_id != NODE_ID_INVALID);
 	assert(! node_->dirty());
+	/* an evicted node must not be reloaded from storage: that would overwrite the changes being written */
 	MW_SHPTR<node_type> node_ptr;
-	if (m_lru.get(node_ptr, node_id))
+	if (m_lru.has(node_id) && m_lru.get(node_ptr, node_id) && node_ptr)
 	{
-		assert(node_ptr);
 		if (node_ptr != node_)
 			*node_ptr = *node_;
 	} else
@@ -211,10 +229,28 @@ MW_SHPTR<typename BTreeFileStorage<BLOCKSIZE, B_, KeyTraits, TTraits, Compare>::
 		node_ptr = node_;
 		m_lru.set(node_id, node_);
 	}
+	m_lru.modified(node_id);
 	assert(! node_ptr->dirty());
 	return node_ptr;
 }
 
+template < size_t BLOCKSIZE, int B_, typename KeyTraits, typename TTraits, class Compare >
+void BTreeFileStorage<BLOCKSIZE, B_, KeyTraits, TTraits, Compare>::node_prefetch(const std::vector<node_id_t>& node_ids)
+{
+	assert(m_block_storage);
+
+	/* cached nodes don't need their blocks */
+	std::vector<block_id_t> block_ids;
+	std::vector<node_id_t>::const_iterator it;
+	for (it = node_ids.begin(); it != node_ids.end(); ++it)
+	{
+		if (node_id_valid(*it) && (! m_lru.has(*it)))
+			block_ids.push_back(static_cast<block_id_t>(*it));
+	}
+	if (! block_ids.empty())
+		m_block_storage->prefetch(block_ids.size(), &block_ids[0]);
+}
+
 /* -- Header I/O ----------------------------------------------- */
 
 #define MAX_USER_HEADER 240
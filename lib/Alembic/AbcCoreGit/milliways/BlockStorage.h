@@ -31,6 +31,8 @@
 #include <fstream>
 #include <string>
 #include <vector>
+#include <set>
+#include <algorithm>
 #include <functional>
 
 #include <map>
@@ -57,10 +59,25 @@
 #include <boost/weak_ptr.hpp>
 #endif
 
+#if defined(COMPILER_SUPPORTS_CXX11) && (! defined(MILLIWAYS_DISABLE_WRITE_BEHIND_THREAD))
+	#define MILLIWAYS_WRITE_BEHIND_THREAD 1
+#endif
+
+#if defined(COMPILER_SUPPORTS_CXX11)
+#include <mutex>
+#endif
+#if defined(MILLIWAYS_WRITE_BEHIND_THREAD)
+#include <thread>
+#include <condition_variable>
+#include <chrono>
+#endif
+
 #include <stdint.h>
 #include <assert.h>
 
 #include "LRUCache.h"
+#include "Snapshot.h"
+#include "WriteAheadLog.h"
 #include "Utils.h"
 
 namespace milliways {
@@ -291,6 +308,10 @@ public:
 
 	virtual bool read(block_t& dst) = 0;
 	virtual bool write(block_t& src) = 0;
+	/* write 'n' blocks at once, 'ids' ascending and 'data' holding n * BLOCKSIZE bytes */
+	virtual bool write(size_t n, const block_id_t* ids, const char* data) = 0;
+	/* read 'n' blocks at once into 'data' (n * BLOCKSIZE bytes), returns how many were found ('loaded') */
+	virtual size_t read(size_t n, const block_id_t* ids, char* data, std::vector<bool>& loaded) = 0;
 
 	/* -- Node Manager --------------------------------------------- */
 
@@ -305,6 +326,109 @@ private:
 	manager_type m_manager;
 };
 
+/* ----------------------------------------------------------------- *
+ *   WriteBehind                                                     *
+ * ----------------------------------------------------------------- */
+
+/*
+ * Copies of modified blocks waiting to be written to the storage by a
+ * background flusher thread, so that the thread modifying the blocks
+ * rarely has to wait for I/O.
+ *
+ * The flusher wakes up once the low watermark is reached (or after
+ * FLUSH_INTERVAL_MS), and writes everything staged in block id order,
+ * BATCH_SIZE blocks per storage write so that adjacent blocks can be
+ * written together. stage() blocks the caller while the high watermark
+ * is reached, until the flusher makes room.
+ *
+ * Without C++11 threads (or with MILLIWAYS_DISABLE_WRITE_BEHIND_THREAD)
+ * the staged blocks are written by stage() itself, when reaching the
+ * high watermark.
+ */
+template <size_t BLOCKSIZE>
+class WriteBehind
+{
+public:
+	static const size_t BlockSize = BLOCKSIZE;
+	static const size_t BATCH_SIZE = 64;
+	static const int FLUSH_INTERVAL_MS = 50;
+
+	typedef BlockStorage<BLOCKSIZE>* storage_ptr_type;
+
+	WriteBehind(storage_ptr_type storage, size_t low_watermark, size_t high_watermark) :
+		m_storage(storage), m_low_watermark(low_watermark), m_high_watermark(high_watermark),
+		m_staged(), m_in_flight(), m_sequence(0), m_failed(false), m_stop(false), m_running(false) {}
+	~WriteBehind() { stop(); }
+
+	size_t lowWatermark() const { return m_low_watermark; }
+	size_t highWatermark() const { return m_high_watermark; }
+
+	/* queue a copy of the block for writing, replacing any older one */
+	bool stage(block_id_t block_id, const char* data);
+	/* latest staged copy of the block, if any */
+	bool staged(block_id_t block_id, char* dst);
+	/* forget the staged copies of blocks [first, last] (waiting for them if being written) */
+	void cancel(block_id_t first, block_id_t last);
+	/* write everything staged, false if any write failed since the last drain() */
+	bool drain();
+	/* drain() and terminate the flusher */
+	bool stop();
+
+private:
+	WriteBehind(const WriteBehind& other);
+	WriteBehind& operator= (const WriteBehind& other);
+
+	struct Entry
+	{
+		Entry() : sequence(0), data() {}
+
+		uint64_t sequence;
+		std::string data;
+	};
+
+	typedef std::map<block_id_t, Entry> staged_t;
+
+	/* the following expect m_mutex to be held (when there is one) */
+	bool take_batch(std::vector<block_id_t>& ids, std::vector<uint64_t>& sequences, std::string& data);
+	void done_batch(const std::vector<block_id_t>& ids, const std::vector<uint64_t>& sequences, bool ok);
+	bool in_flight(block_id_t first, block_id_t last) const;
+
+	bool write_batch(const std::vector<block_id_t>& ids, const std::string& data);
+
+#if defined(MILLIWAYS_WRITE_BEHIND_THREAD)
+	void run();
+	void start();
+#endif
+
+	storage_ptr_type m_storage;
+	size_t m_low_watermark;
+	size_t m_high_watermark;
+	staged_t m_staged;
+	std::set<block_id_t> m_in_flight;
+	uint64_t m_sequence;
+	bool m_failed;
+	bool m_stop;
+	bool m_running;
+#if defined(MILLIWAYS_WRITE_BEHIND_THREAD)
+	std::mutex m_mutex;
+	std::condition_variable m_work;				/* flusher: something to do */
+	std::condition_variable m_progress;			/* stagers / drain(): something was written */
+	std::thread m_thread;
+#endif
+};
+
+/* ----------------------------------------------------------------- *
+ *   LRUBlockCache                                                   *
+ * ----------------------------------------------------------------- */
+
+/*
+ * Blocks handed back with FileBlockStorage::put() are tracked as
+ * modified: when evicted they are staged for writing by the write-behind
+ * flusher (unmodified ones are simply dropped), and once
+ * DIRTY_LOW_WATERMARK of them pile up in the cache they are all staged
+ * (in block id order) while staying cached, so that closing a large
+ * store doesn't have to write the whole cache at once.
+ */
 template <size_t BLOCKSIZE, size_t CACHESIZE>
 class LRUBlockCache : public LRUCache< CACHESIZE, block_id_t, MW_SHPTR< Block<BLOCKSIZE> > >
 {
@@ -322,9 +446,29 @@ public:
 	static const size_type Size = CACHESIZE;
 	static const size_type BlockSize = BLOCKSIZE;
 	static const block_id_t InvalidCacheKey = BLOCK_ID_INVALID;
+	static const size_type DIRTY_LOW_WATERMARK = (CACHESIZE >= 8) ? (CACHESIZE / 8) : 1;
+	static const size_type DIRTY_HIGH_WATERMARK = (CACHESIZE >= 2) ? (CACHESIZE / 2) : 1;
+	static const size_type READ_AHEAD_MAX = (CACHESIZE >= 4) ? (CACHESIZE / 4) : 1;
 
 	LRUBlockCache(storage_ptr_type storage) :
-		base_type(LRUBlockCache::InvalidCacheKey), m_storage(storage) {}
+		base_type(LRUBlockCache::InvalidCacheKey), m_storage(storage), m_modified(),
+		m_write_behind(storage, DIRTY_LOW_WATERMARK, DIRTY_HIGH_WATERMARK) {}
+
+	/* -- Write-behind --------------------------------------------- */
+
+	void modified(block_id_t block_id);
+	/* stage all the modified blocks still in the cache */
+	void stage_modified();
+	/* drop pending writes of blocks [first, last] (disposed, or written directly) */
+	void discard(block_id_t first, block_id_t last);
+	/* write everything staged so far */
+	bool drain() { return m_write_behind.drain(); }
+	bool stop() { return m_write_behind.stop(); }
+
+	/* -- Read-ahead ----------------------------------------------- */
+
+	/* load the blocks not cached yet with a single batched read (up to READ_AHEAD_MAX of them) */
+	size_t prefetch(size_t n, const block_id_t* ids);
 
 	bool on_miss(typename base_type::op_type op, const key_type& key, mapped_type& value)
 	{
@@ -341,7 +485,7 @@ public:
 				block_ptr = m_storage->manager().get_object(block_id);
 				assert(block_ptr && (block_ptr->index() == block_id));
 				if (! block_ptr) return false;
-				rv = m_storage->read(*block_ptr);
+				rv = read_block(*block_ptr);
 				assert(rv || block_ptr->dirty());
 				value = block_ptr;
 				return rv;
@@ -358,7 +502,7 @@ public:
 				assert(block_ptr && (block_ptr->index() == block_id));
 				if (! block_ptr) return false;
 				//assert(value);
-				rv = m_storage->read(*block_ptr);
+				rv = read_block(*block_ptr);
 				assert(rv || block_ptr->dirty());
 				value = block_ptr;
 				return rv;
@@ -377,26 +521,20 @@ public:
 		return true;
 	}
 	//bool on_delete(const key_type& key);
-	bool on_eviction(const key_type& /* key */, mapped_type& value)
+	bool on_eviction(const key_type& key, mapped_type& value)
 	{
-		/* write back block */
-		/* block_id_t block_id = key; */
+		/* hand modified blocks to the flusher, the others are already in storage */
 		block_type* block = value.get();
-		if (block)
+		if (m_modified.erase(key) == 0)
+			return true;
+		if (block && block->valid())
 		{
-			if (block->valid())
-			{
 #ifdef NDEBUG
-				m_storage->write(*block);
+			m_write_behind.stage(key, block->data());
 #else
-				bool ok = m_storage->write(*block);
-				assert(ok);
+			bool ok = m_write_behind.stage(key, block->data());
+			assert(ok);
 #endif
-				// if (ok) block->dirty(false);
-			}
-			// block->dirty(true);
-			// block->index(BLOCK_ID_INVALID);
-			// value.reset();
 		}
 		return true;
 	}
@@ -405,7 +543,20 @@ private:
 	LRUBlockCache(const LRUBlockCache&) {}
 	LRUBlockCache& operator= (const LRUBlockCache&) {}
 
+	bool read_block(block_type& block)
+	{
+		/* the latest copy may still be waiting for the flusher */
+		if (m_write_behind.staged(block.index(), block.data()))
+		{
+			block.dirty(false);
+			return true;
+		}
+		return m_storage->read(block);
+	}
+
 	storage_ptr_type m_storage;
+	std::set<block_id_t> m_modified;
+	WriteBehind<BLOCKSIZE> m_write_behind;
 };
 
 template <size_t BLOCKSIZE>
@@ -420,6 +571,36 @@ class WriteStream;
 template <size_t BLOCKSIZE, int CACHE_SIZE>
 class ReadStream;
 
+/*
+ * FileBlockStorage
+ *
+ * Blocks handed out to the upper layers are *logical* blocks, mapped to
+ * physical blocks of the file by a block map, so that the file can
+ * be shared by a single writer and any number of snapshot readers:
+ *
+ *   - the writer never overwrites a physical block that is part of a
+ *     committed snapshot: the first write to such a block in a
+ *     transaction goes to a new physical block (copy-on-write);
+ *   - flush() commits the transaction, writing the changed block map
+ *     pages and then the superblock, alternating between the two
+ *     superblock slots (physical blocks 0 and 1), so that the previous
+ *     commit stays intact until the new one is complete;
+ *   - readers open read-only, pick the valid superblock with the
+ *     highest generation and keep seeing that snapshot until closed;
+ *   - physical blocks released by a commit are recycled only once no
+ *     reader is pinning an older generation (see SnapshotLock).
+ *
+ * Files written before the block map existed are opened with an
+ * identity map and converted on the first commit.
+ *
+ * In WAL mode (see wal()) the writer appends the blocks it writes to a
+ * write-ahead log instead, and flush() only appends a commit record and
+ * syncs the log once for the whole group of changes. The log is copied
+ * into the main file (checkpoint) when it grows past WAL_CHECKPOINT_SIZE
+ * and when the store is closed. A log left behind by a crash is replayed
+ * (up to its last commit) by whoever opens the store next, readers
+ * included, whether they use WAL mode or not.
+ */
 template <size_t BLOCKSIZE, int CACHE_SIZE>
 class FileBlockStorage : public BlockStorage<BLOCKSIZE>
 {
@@ -427,10 +608,21 @@ public:
 	static const size_t BlockSize = BLOCKSIZE;
 	static const int CacheSize = CACHE_SIZE;
 
+	static const int SUPERBLOCK_MAJOR_VERSION = 1;
+	static const int SUPERBLOCK_MINOR_VERSION = 0;
+	static const block_id_t SUPERBLOCK_SLOTS = 2;
+	static const size_t MAP_PAGE_ENTRIES = BLOCKSIZE / sizeof(uint32_t);
+	static const size_t CHAIN_BLOCK_WORDS = (BLOCKSIZE / sizeof(uint32_t)) - 2;
+	static const int SNAPSHOT_OPEN_RETRIES = 64;
+	static const uint64_t WAL_CHECKPOINT_SIZE = 64 * 1024 * 1024;
+	static const size_t READ_AHEAD_BLOCKS = LRUBlockCache<BLOCKSIZE, CACHE_SIZE>::READ_AHEAD_MAX;
+
 	typedef Block<BLOCKSIZE> block_t;
 	typedef size_t size_type;
 	typedef ssize_t ssize_type;
 	typedef BlockStorage<BLOCKSIZE> base_type;
+	typedef SnapshotLock::generation_t generation_t;
+	typedef WriteAheadLog<BLOCKSIZE> wal_t;
 
 	typedef LRUBlockCache<BLOCKSIZE, CACHE_SIZE> cache_t;
 
@@ -439,9 +631,12 @@ public:
 	typedef WriteStream<BLOCKSIZE, CACHE_SIZE> write_stream_t;
 	typedef ReadStream<BLOCKSIZE, CACHE_SIZE> read_stream_t;
 
-	FileBlockStorage(const std::string& pathname_) :
+	FileBlockStorage(const std::string& pathname_, bool readonly_ = false) :
 		BlockStorage<BLOCKSIZE>(),
-		m_pathname(pathname_), m_stream(), m_created(false), m_count(-1), m_next_block_id(BLOCK_ID_INVALID), m_lru(this) {}
+		m_pathname(pathname_), m_stream(), m_readonly(readonly_), m_created(false), m_next_block_id(BLOCK_ID_INVALID),
+		m_generation(0), m_next_physical_id(SUPERBLOCK_SLOTS), m_map(), m_fresh(), m_map_pages(), m_map_page_dirty(),
+		m_chain_blocks(), m_free_pool(), m_free_pending(), m_snapshot_lock(),
+		m_wal_mode(false), m_wal(), m_wal_index(), m_wal_floor(BLOCK_ID_INVALID), m_lru(this) {}
 	~FileBlockStorage(); 	/* call close() before destruction! */
 
 	/* -- General I/O ---------------------------------------------- */
@@ -454,6 +649,25 @@ public:
 	bool flush();
 
 	bool created() const { return m_created; }
+	bool readonly() const { return m_readonly; }
+
+	/* -- Snapshots ------------------------------------------------ */
+
+	/* generation of the committed snapshot we are reading (readers) or building upon (writer) */
+	generation_t generation() const { return m_generation; }
+
+	bool commit();
+
+	/* -- Write-ahead log ------------------------------------------ */
+
+	/* WAL mode for the writer, set before open() */
+	bool wal() const { return m_wal_mode; }
+	bool wal(bool value) { assert(! isOpen()); bool old = m_wal_mode; m_wal_mode = value; return old; }
+
+	std::string walPathname() const { return m_pathname + ".wal"; }
+
+	/* copy the committed log into the main file and start a new log */
+	bool checkpoint();
 
 	/* -- Misc ----------------------------------------------------- */
 
@@ -473,11 +687,17 @@ public:
 
 	bool read(block_t& dst);
 	bool write(block_t& src);
+	size_t read(size_t n, const block_id_t* ids, char* data, std::vector<bool>& loaded);
+	bool write(size_t n, const block_id_t* ids, const char* data);
 
 	/* cached I/O */
 	MW_SHPTR<block_t> get(block_id_t block_id, bool createIfNotFound = true);
 	bool put(const block_t& src);
 
+	/* bring the given blocks into the cache, reading the missing ones in one go */
+	size_t prefetch(size_t n, const block_id_t* ids) { return m_lru.prefetch(n, ids); }
+	size_t prefetch(block_id_t first, size_t count);
+
 	/* -- Streaming I/O -------------------------------------------- */
 
 	/* streaming read */
@@ -490,6 +710,47 @@ public:
 
 protected:
 	void _updateCount();
+	void reset_state();
+
+	/* -- Physical I/O --------------------------------------------- */
+
+	bool read_physical(block_id_t physical_id, char* dst, size_t n_blocks = 1);
+	bool write_physical(block_id_t physical_id, const char* src, size_t n_blocks = 1);
+
+	block_id_t physical(block_id_t block_id) const { return (block_id < m_map.size()) ? m_map[block_id] : BLOCK_ID_INVALID; }
+	void physical(block_id_t block_id, block_id_t physical_id);
+
+	block_id_t alloc_physical(bool recycle = true);
+	void release_physical(block_id_t physical_id, bool committed);
+	void reclaim();
+
+	bool read_block(block_id_t block_id, char* dst);
+	bool write_block(block_id_t block_id, const char* data);
+	block_id_t place_block(block_id_t block_id);
+	bool log_block(block_id_t block_id, const char* data);
+	bool commit_snapshot();
+
+	/* -- Superblock / block map ----------------------------------- */
+
+	bool read_superblock(block_id_t slot, generation_t& generation, block_id_t& n_logical, block_id_t& next_physical_id,
+						 block_id_t& map_root, block_id_t& free_root);
+	bool write_superblock(block_id_t slot, generation_t generation, block_id_t map_root, block_id_t free_root);
+	int latest_superblock(generation_t& generation, block_id_t& n_logical, block_id_t& next_physical_id,
+						  block_id_t& map_root, block_id_t& free_root);
+
+	bool load_snapshot();
+	bool load_legacy();
+
+	bool read_chain(block_id_t root, std::vector<uint32_t>& words, bool track);
+	block_id_t write_chain(const std::vector<uint32_t>& words);
+
+	static uint32_t checksum(const char* data, size_t size);
+
+	/* -- Write-ahead log ------------------------------------------ */
+
+	bool load_wal(bool& retry);
+	bool checkpoint_wal(bool keep);
+	bool walActive() const { return m_wal.isOpen(); }
 
 private:
 	FileBlockStorage();
@@ -498,10 +759,30 @@ private:
 
 	std::string m_pathname;
 	std::fstream m_stream;
+	bool m_readonly;
 	bool m_created;
-	ssize_t m_count;
 	block_id_t m_next_block_id;
 
+	generation_t m_generation;
+	block_id_t m_next_physical_id;
+	std::vector<block_id_t> m_map;						/* logical -> physical */
+	std::vector<bool> m_fresh;							/* logical block already copied in this transaction */
+	std::vector<block_id_t> m_map_pages;				/* physical blocks of the committed map */
+	std::vector<bool> m_map_page_dirty;
+	std::vector<block_id_t> m_chain_blocks;				/* physical blocks of the committed map directory / free list */
+	std::vector<block_id_t> m_free_pool;				/* recyclable physical blocks */
+	std::vector< std::pair<generation_t, block_id_t> > m_free_pending;	/* (releasing generation, physical block) */
+	SnapshotLock m_snapshot_lock;
+
+#if defined(COMPILER_SUPPORTS_CXX11)
+	std::mutex m_io_mutex;								/* the write-behind flusher writes concurrently */
+#endif
+
+	bool m_wal_mode;
+	wal_t m_wal;
+	ITYPENAME wal_t::index_t m_wal_index;				/* logical block -> latest image in the log */
+	block_id_t m_wal_floor;								/* blocks from here on not in the log are disposed */
+
 	cache_t m_lru;
 };
 
@@ -882,7 +1163,7 @@ public:
 
 	ReadStream(block_storage_t* bs, const sized_locator_t& location_) :
 		m_bs(bs), m_location_start(location_), m_location(location_),
-		m_srcp(NULL), m_src_block(),
+		m_srcp(NULL), m_src_block(), m_read_ahead_end(BLOCK_ID_INVALID),
 		m_nread(0), m_fail(false), m_fast_data() {}
 	~ReadStream() { m_src_block.reset(); }
 
@@ -931,6 +1212,7 @@ private:
 
 	bool fetch_block() {
 		if ((! m_src_block) || (m_src_block->index() != m_location.block_id())) {
+			read_ahead();
 			m_src_block = m_bs->get(m_location.block_id());
 			m_srcp = m_src_block->data() + m_location.offset();
 			if (! m_src_block)
@@ -940,6 +1222,19 @@ private:
 		return true;
 	}
 
+	/* entering a block past the last read-ahead window: load the next window of the stream at once */
+	void read_ahead() {
+		block_id_t block_id = m_location.block_id();
+		if ((m_read_ahead_end != BLOCK_ID_INVALID) && (block_id < m_read_ahead_end))
+			return;
+		size_t n_blocks = (static_cast<size_t>(m_location.offset()) + m_location.size() + BLOCKSIZE - 1) / BLOCKSIZE;
+		if (n_blocks > block_storage_t::READ_AHEAD_BLOCKS)
+			n_blocks = block_storage_t::READ_AHEAD_BLOCKS;
+		m_read_ahead_end = block_id + static_cast<block_id_t>(n_blocks);
+		if (n_blocks > 1)
+			m_bs->prefetch(block_id, n_blocks);
+	}
+
 	block_id_t     src_block_id() const    { return m_location.block_id(); }
 	block_offset_t src_offset() const      { return m_location.offset(); }
 	MW_SHPTR<block_type>& src_block()      { return m_src_block; }
@@ -949,6 +1244,7 @@ private:
 	sized_locator_t      m_location;
 	char*                m_srcp;
 	MW_SHPTR<block_type> m_src_block;
+	block_id_t           m_read_ahead_end;
 	size_t               m_nread;
 	bool                 m_fail;
 
@@ -207,6 +207,259 @@ bool BlockStorage<BLOCKSIZE>::dispose(block_t& block)
 	return true;
 }
 
+/* ----------------------------------------------------------------- *
+ *   WriteBehind                                                     *
+ * ----------------------------------------------------------------- */
+
+template <size_t BLOCKSIZE> const size_t WriteBehind<BLOCKSIZE>::BlockSize;
+template <size_t BLOCKSIZE> const size_t WriteBehind<BLOCKSIZE>::BATCH_SIZE;
+template <size_t BLOCKSIZE> const int WriteBehind<BLOCKSIZE>::FLUSH_INTERVAL_MS;
+
+#if defined(MILLIWAYS_WRITE_BEHIND_THREAD)
+	#define MW_WRITE_BEHIND_LOCK std::unique_lock<std::mutex> write_behind_lock_(m_mutex)
+	#define MW_WRITE_BEHIND_UNLOCK write_behind_lock_.unlock()
+	#define MW_WRITE_BEHIND_RELOCK write_behind_lock_.lock()
+#else
+	#define MW_WRITE_BEHIND_LOCK do { } while (0)
+	#define MW_WRITE_BEHIND_UNLOCK do { } while (0)
+	#define MW_WRITE_BEHIND_RELOCK do { } while (0)
+#endif
+
+template <size_t BLOCKSIZE>
+bool WriteBehind<BLOCKSIZE>::stage(block_id_t block_id, const char* data)
+{
+	assert(block_id != BLOCK_ID_INVALID);
+
+	MW_WRITE_BEHIND_LOCK;
+
+#if defined(MILLIWAYS_WRITE_BEHIND_THREAD)
+	/* back-pressure: don't let the writer get too far ahead of the flusher */
+	while (m_running && (m_staged.size() >= m_high_watermark) && (m_staged.count(block_id) == 0))
+		m_progress.wait(write_behind_lock_);
+#endif
+
+	Entry& entry = m_staged[block_id];
+	entry.sequence = ++m_sequence;
+	entry.data.assign(data, BlockSize);
+
+#if defined(MILLIWAYS_WRITE_BEHIND_THREAD)
+	if (m_staged.size() >= m_low_watermark)
+	{
+		if (! m_running)
+			start();
+		m_work.notify_one();
+	}
+	return true;
+#else
+	/* no flusher: write synchronously, in batches */
+	if (m_staged.size() < m_high_watermark)
+		return true;
+	std::vector<block_id_t> ids;
+	std::vector<uint64_t> sequences;
+	std::string batch;
+	bool ok = true;
+	while (take_batch(ids, sequences, batch))
+	{
+		bool batch_ok = write_batch(ids, batch);
+		done_batch(ids, sequences, batch_ok);
+		ok = ok && batch_ok;
+	}
+	return ok;
+#endif
+}
+
+template <size_t BLOCKSIZE>
+bool WriteBehind<BLOCKSIZE>::staged(block_id_t block_id, char* dst)
+{
+	MW_WRITE_BEHIND_LOCK;
+
+	ITYPENAME staged_t::const_iterator it = m_staged.find(block_id);
+	if (it == m_staged.end())
+		return false;
+	assert(it->second.data.size() == BlockSize);
+	memcpy(dst, it->second.data.data(), BlockSize);
+	return true;
+}
+
+template <size_t BLOCKSIZE>
+void WriteBehind<BLOCKSIZE>::cancel(block_id_t first, block_id_t last)
+{
+	MW_WRITE_BEHIND_LOCK;
+
+#if defined(MILLIWAYS_WRITE_BEHIND_THREAD)
+	while (in_flight(first, last))
+		m_progress.wait(write_behind_lock_);
+#endif
+
+	ITYPENAME staged_t::iterator it = m_staged.lower_bound(first);
+	while ((it != m_staged.end()) && (it->first <= last))
+		m_staged.erase(it++);
+}
+
+template <size_t BLOCKSIZE>
+bool WriteBehind<BLOCKSIZE>::drain()
+{
+	MW_WRITE_BEHIND_LOCK;
+
+	std::vector<block_id_t> ids;
+	std::vector<uint64_t> sequences;
+	std::string batch;
+	for (;;)
+	{
+#if defined(MILLIWAYS_WRITE_BEHIND_THREAD)
+		/* blocks being written by the flusher may have been staged again meanwhile */
+		while (! m_in_flight.empty())
+			m_progress.wait(write_behind_lock_);
+#endif
+		if (! take_batch(ids, sequences, batch))
+			break;
+
+		MW_WRITE_BEHIND_UNLOCK;
+		bool ok = write_batch(ids, batch);
+		MW_WRITE_BEHIND_RELOCK;
+
+		done_batch(ids, sequences, ok);
+	}
+
+	bool ok = ! m_failed;
+	m_failed = false;
+	return ok;
+}
+
+template <size_t BLOCKSIZE>
+bool WriteBehind<BLOCKSIZE>::stop()
+{
+	bool ok = drain();
+
+#if defined(MILLIWAYS_WRITE_BEHIND_THREAD)
+	{
+		MW_WRITE_BEHIND_LOCK;
+		if (! m_running)
+			return ok;
+		m_stop = true;
+		m_work.notify_all();
+	}
+	m_thread.join();
+
+	MW_WRITE_BEHIND_LOCK;
+	m_running = false;
+	m_stop = false;
+	/* anything staged while stopping */
+	if (! m_staged.empty())
+	{
+		MW_WRITE_BEHIND_UNLOCK;
+		ok = drain() && ok;
+	}
+#endif
+	return ok;
+}
+
+template <size_t BLOCKSIZE>
+bool WriteBehind<BLOCKSIZE>::take_batch(std::vector<block_id_t>& ids, std::vector<uint64_t>& sequences, std::string& data)
+{
+	ids.clear();
+	sequences.clear();
+	data.clear();
+
+	/* lowest block ids first, so that the storage can coalesce adjacent ones */
+	ITYPENAME staged_t::const_iterator it;
+	for (it = m_staged.begin(); (it != m_staged.end()) && (ids.size() < BATCH_SIZE); ++it)
+	{
+		if (m_in_flight.count(it->first) > 0)
+			continue;
+		ids.push_back(it->first);
+		sequences.push_back(it->second.sequence);
+		data.append(it->second.data);
+		m_in_flight.insert(it->first);
+	}
+	return ! ids.empty();
+}
+
+template <size_t BLOCKSIZE>
+void WriteBehind<BLOCKSIZE>::done_batch(const std::vector<block_id_t>& ids, const std::vector<uint64_t>& sequences, bool ok)
+{
+	assert(ids.size() == sequences.size());
+	for (size_t i = 0; i < ids.size(); i++)
+	{
+		m_in_flight.erase(ids[i]);
+		/* keep the blocks staged again while being written */
+		ITYPENAME staged_t::iterator it = m_staged.find(ids[i]);
+		if ((it != m_staged.end()) && (it->second.sequence == sequences[i]))
+			m_staged.erase(it);
+	}
+	if (! ok)
+	{
+		/* a failed batch is dropped rather than retried forever, and reported by the next drain() */
+		std::cerr << "ERROR: write-behind of " << ids.size() << " blocks failed" << std::endl;
+		m_failed = true;
+	}
+
+#if defined(MILLIWAYS_WRITE_BEHIND_THREAD)
+	m_progress.notify_all();
+#endif
+}
+
+template <size_t BLOCKSIZE>
+bool WriteBehind<BLOCKSIZE>::in_flight(block_id_t first, block_id_t last) const
+{
+	std::set<block_id_t>::const_iterator it = m_in_flight.lower_bound(first);
+	return (it != m_in_flight.end()) && (*it <= last);
+}
+
+template <size_t BLOCKSIZE>
+bool WriteBehind<BLOCKSIZE>::write_batch(const std::vector<block_id_t>& ids, const std::string& data)
+{
+	assert(m_storage);
+	assert(data.size() == (ids.size() * BlockSize));
+	return m_storage->write(ids.size(), &ids[0], data.data());
+}
+
+#if defined(MILLIWAYS_WRITE_BEHIND_THREAD)
+template <size_t BLOCKSIZE>
+void WriteBehind<BLOCKSIZE>::start()
+{
+	/* called with m_mutex held */
+	assert(! m_running);
+	m_stop = false;
+	m_running = true;
+	m_thread = std::thread(&WriteBehind<BLOCKSIZE>::run, this);
+}
+
+template <size_t BLOCKSIZE>
+void WriteBehind<BLOCKSIZE>::run()
+{
+	MW_WRITE_BEHIND_LOCK;
+
+	std::vector<block_id_t> ids;
+	std::vector<uint64_t> sequences;
+	std::string batch;
+	while (! m_stop)
+	{
+		if (m_staged.size() < m_low_watermark)
+		{
+			/* trickle out what's left after a quiet interval */
+			if (m_work.wait_for(write_behind_lock_, std::chrono::milliseconds(FLUSH_INTERVAL_MS)) == std::cv_status::no_timeout)
+				continue;
+		}
+
+		while ((! m_stop) && take_batch(ids, sequences, batch))
+		{
+			MW_WRITE_BEHIND_UNLOCK;
+			bool ok = write_batch(ids, batch);
+			MW_WRITE_BEHIND_RELOCK;
+
+			done_batch(ids, sequences, ok);
+			if (m_staged.size() < m_low_watermark)
+				break;
+		}
+	}
+}
+#endif
+
+#undef MW_WRITE_BEHIND_LOCK
+#undef MW_WRITE_BEHIND_UNLOCK
+#undef MW_WRITE_BEHIND_RELOCK
+
 /* ----------------------------------------------------------------- *
  *   LRUBlockCache                                                   *
  * ----------------------------------------------------------------- */
@@ -220,10 +473,114 @@ const typename LRUBlockCache<BLOCKSIZE, CACHESIZE>::size_type LRUBlockCache<BLOC
 template < size_t BLOCKSIZE, size_t CACHESIZE >
 const block_id_t LRUBlockCache<BLOCKSIZE, CACHESIZE>::InvalidCacheKey;
 
+template < size_t BLOCKSIZE, size_t CACHESIZE >
+const typename LRUBlockCache<BLOCKSIZE, CACHESIZE>::size_type LRUBlockCache<BLOCKSIZE, CACHESIZE>::DIRTY_LOW_WATERMARK;
+
+template < size_t BLOCKSIZE, size_t CACHESIZE >
+const typename LRUBlockCache<BLOCKSIZE, CACHESIZE>::size_type LRUBlockCache<BLOCKSIZE, CACHESIZE>::DIRTY_HIGH_WATERMARK;
+
+template < size_t BLOCKSIZE, size_t CACHESIZE >
+const typename LRUBlockCache<BLOCKSIZE, CACHESIZE>::size_type LRUBlockCache<BLOCKSIZE, CACHESIZE>::READ_AHEAD_MAX;
+
+template < size_t BLOCKSIZE, size_t CACHESIZE >
+void LRUBlockCache<BLOCKSIZE, CACHESIZE>::modified(block_id_t block_id)
+{
+	m_modified.insert(block_id);
+	if (m_modified.size() >= DIRTY_LOW_WATERMARK)
+		stage_modified();
+}
+
+template < size_t BLOCKSIZE, size_t CACHESIZE >
+void LRUBlockCache<BLOCKSIZE, CACHESIZE>::stage_modified()
+{
+	/* the blocks stay cached: the flusher gets copies, in block id order */
+	std::set<block_id_t>::const_iterator it;
+	for (it = m_modified.begin(); it != m_modified.end(); ++it)
+	{
+		mapped_type block_ptr;
+		if ((! this->peek(block_ptr, *it)) || (! block_ptr) || (! block_ptr->valid()))
+			continue;
+		m_write_behind.stage(*it, block_ptr->data());
+	}
+	m_modified.clear();
+}
+
+template < size_t BLOCKSIZE, size_t CACHESIZE >
+void LRUBlockCache<BLOCKSIZE, CACHESIZE>::discard(block_id_t first, block_id_t last)
+{
+	std::set<block_id_t>::iterator it = m_modified.lower_bound(first);
+	while ((it != m_modified.end()) && (*it <= last))
+		m_modified.erase(it++);
+	m_write_behind.cancel(first, last);
+}
+
+template < size_t BLOCKSIZE, size_t CACHESIZE >
+size_t LRUBlockCache<BLOCKSIZE, CACHESIZE>::prefetch(size_t n, const block_id_t* ids)
+{
+	std::vector<block_id_t> missing;
+	std::vector<block_ptr_type> blocks;
+	size_t n_loaded = 0;
+	for (size_t i = 0; (i < n) && ((missing.size() + n_loaded) < READ_AHEAD_MAX); i++)
+	{
+		block_id_t block_id = ids[i];
+		if ((block_id == BLOCK_ID_INVALID) || this->has(block_id) || (! m_storage->hasId(block_id)))
+			continue;
+
+		block_ptr_type block_ptr( m_storage->manager().get_object(block_id) );
+		assert(block_ptr && (block_ptr->index() == block_id));
+		if (! block_ptr)
+			continue;
+
+		/* like on_miss(): the latest copy may still be waiting for the flusher */
+		if (m_write_behind.staged(block_id, block_ptr->data()))
+		{
+			block_ptr->dirty(false);
+			this->set(block_id, block_ptr);
+			n_loaded++;
+			continue;
+		}
+		missing.push_back(block_id);
+		blocks.push_back(block_ptr);
+	}
+	if (missing.empty())
+		return n_loaded;
+
+	std::vector<char> data(missing.size() * BLOCKSIZE);
+	std::vector<bool> loaded;
+	m_storage->read(missing.size(), &missing[0], &data[0], loaded);
+	for (size_t i = 0; i < missing.size(); i++)
+	{
+		if (! loaded[i])
+			continue;
+		memcpy(blocks[i]->data(), &data[i * BLOCKSIZE], BLOCKSIZE);
+		blocks[i]->dirty(false);
+		this->set(missing[i], blocks[i]);
+		n_loaded++;
+	}
+	return n_loaded;
+}
+
 /* ----------------------------------------------------------------- *
  *   FileBlockStorage                                                *
  * ----------------------------------------------------------------- */
 
+template <size_t BLOCKSIZE, int CACHE_SIZE> const int FileBlockStorage<BLOCKSIZE, CACHE_SIZE>::SUPERBLOCK_MAJOR_VERSION;
+template <size_t BLOCKSIZE, int CACHE_SIZE> const int FileBlockStorage<BLOCKSIZE, CACHE_SIZE>::SUPERBLOCK_MINOR_VERSION;
+template <size_t BLOCKSIZE, int CACHE_SIZE> const block_id_t FileBlockStorage<BLOCKSIZE, CACHE_SIZE>::SUPERBLOCK_SLOTS;
+template <size_t BLOCKSIZE, int CACHE_SIZE> const size_t FileBlockStorage<BLOCKSIZE, CACHE_SIZE>::MAP_PAGE_ENTRIES;
+template <size_t BLOCKSIZE, int CACHE_SIZE> const size_t FileBlockStorage<BLOCKSIZE, CACHE_SIZE>::CHAIN_BLOCK_WORDS;
+template <size_t BLOCKSIZE, int CACHE_SIZE> const int FileBlockStorage<BLOCKSIZE, CACHE_SIZE>::SNAPSHOT_OPEN_RETRIES;
+template <size_t BLOCKSIZE, int CACHE_SIZE> const uint64_t FileBlockStorage<BLOCKSIZE, CACHE_SIZE>::WAL_CHECKPOINT_SIZE;
+template <size_t BLOCKSIZE, int CACHE_SIZE> const size_t FileBlockStorage<BLOCKSIZE, CACHE_SIZE>::READ_AHEAD_BLOCKS;
+
+static const char* const BS_SUPERBLOCK_MAGIC = "MWSUPERBLOCK";
+
+#if defined(COMPILER_SUPPORTS_CXX11)
+	#define MW_FILE_IO_GUARD std::lock_guard<std::mutex> file_io_guard_(m_io_mutex)
+#else
+	#define MW_FILE_IO_GUARD do { } while (0)
+#endif
+
 template <size_t BLOCKSIZE, int CACHE_SIZE>
 FileBlockStorage<BLOCKSIZE, CACHE_SIZE>::~FileBlockStorage()
 {
@@ -243,24 +600,87 @@ bool FileBlockStorage<BLOCKSIZE, CACHE_SIZE>::openHelper()
 		return true;
 
 	assert(! isOpen());
-	m_stream.open(m_pathname.c_str(), std::fstream::binary | std::fstream::in | std::fstream::out);
-	if (m_stream.is_open())
+
+	m_snapshot_lock.open(m_pathname);
+
+	if (m_readonly)
 	{
+		m_stream.open(m_pathname.c_str(), std::fstream::binary | std::fstream::in);
+		if (! m_stream.is_open())
+		{
+			std::cerr << "ERROR: can't open '" << m_pathname << "' for reading" << std::endl;
+			m_snapshot_lock.close();
+			return false;
+		}
 		m_created = false;
-	} else if (! m_stream.is_open())
+	} else
 	{
-		std::cerr << "file '" << m_pathname << "' doesn't exist. Creating..." << std::endl;
-		m_stream.open(m_pathname.c_str(), std::fstream::binary | std::fstream::in | std::fstream::out | std::fstream::trunc);
-		m_created = true;
+		if (! m_snapshot_lock.lockWriter())
+		{
+			std::cerr << "ERROR: '" << m_pathname << "' is already open for writing" << std::endl;
+			m_snapshot_lock.close();
+			return false;
+		}
+
+		m_stream.open(m_pathname.c_str(), std::fstream::binary | std::fstream::in | std::fstream::out);
+		if (m_stream.is_open())
+		{
+			m_created = false;
+		} else if (! m_stream.is_open())
+		{
+			std::cerr << "file '" << m_pathname << "' doesn't exist. Creating..." << std::endl;
+			m_stream.open(m_pathname.c_str(), std::fstream::binary | std::fstream::in | std::fstream::out | std::fstream::trunc);
+			m_created = true;
+		}
 	}
 
 	assert(m_stream.is_open());
 
-	m_count = -1;
+	/* readers retry if a checkpoint replaced the log while they were opening */
+	bool loaded = false;
+	for (int attempt = 0; (! loaded) && (attempt < SNAPSHOT_OPEN_RETRIES); attempt++)
+	{
+		reset_state();
+
+		bool retry = false;
+		if (((! m_created) && (! load_snapshot())) || ((! load_wal(retry)) && (! retry)))
+			break;
+		loaded = ! retry;
+	}
+
+	if (! loaded)
+	{
+		if (m_readonly)
+			std::cerr << "ERROR: can't get a stable snapshot of '" << m_pathname << "'" << std::endl;
+		m_wal.close();
+		m_stream.close();
+		m_snapshot_lock.close();
+		return false;
+	}
 
 	return isOpen();
 }
 
+template <size_t BLOCKSIZE, int CACHE_SIZE>
+void FileBlockStorage<BLOCKSIZE, CACHE_SIZE>::reset_state()
+{
+	m_snapshot_lock.unpin();
+	m_wal.close();
+
+	m_next_block_id = BLOCK_ID_INVALID;
+	m_generation = 0;
+	m_next_physical_id = SUPERBLOCK_SLOTS;
+	m_map.clear();
+	m_fresh.clear();
+	m_map_pages.clear();
+	m_map_page_dirty.clear();
+	m_chain_blocks.clear();
+	m_free_pool.clear();
+	m_free_pending.clear();
+	m_wal_index.clear();
+	m_wal_floor = BLOCK_ID_INVALID;
+}
+
 template <size_t BLOCKSIZE, int CACHE_SIZE>
 bool FileBlockStorage<BLOCKSIZE, CACHE_SIZE>::closeHelper()
 {
@@ -269,20 +689,34 @@ bool FileBlockStorage<BLOCKSIZE, CACHE_SIZE>::closeHelper()
 
 	m_lru.evict_all();
 
+	/* the flusher must be done with the file before it goes away */
+	bool ok = m_lru.stop();
+	if (! m_readonly)
+		ok = (walActive() ? checkpoint_wal(/* keep */ false) : commit()) && ok;
+
+	m_wal.close();
 	m_stream.close();
+	m_snapshot_lock.close();
 
 	m_created = false;
-	m_count = -1;
+	m_next_block_id = BLOCK_ID_INVALID;
 
-	return true;
+	return ok;
 }
 
 template <size_t BLOCKSIZE, int CACHE_SIZE>
 bool FileBlockStorage<BLOCKSIZE, CACHE_SIZE>::flush()
 {
-	// TODO: flush cache
+	if (! isOpen())
+		return false;
+	if (m_readonly)
+		return true;
 
-	return true;
+	if (! this->writeHeader())
+		return false;
+	m_lru.evict_all();
+
+	return commit();
 }
 
 template <size_t BLOCKSIZE, int CACHE_SIZE>
@@ -291,34 +725,17 @@ typename FileBlockStorage<BLOCKSIZE, CACHE_SIZE>::size_type FileBlockStorage<BLO
 	if (! isOpen())
 		return 0;
 
-	if (m_count < 0)
-		_updateCount();
-
-	assert(m_count >= 0);
-	return static_cast<size_type>(m_count);
+	return static_cast<size_type>(nextId());
 }
 
 template <size_t BLOCKSIZE, int CACHE_SIZE>
 void FileBlockStorage<BLOCKSIZE, CACHE_SIZE>::_updateCount()
 {
-#if STACK_PROTECTOR
-	char dummy[8]; UNUSED(dummy);	/* for -fstack-protector -Wstack-protector */
-#endif
-
 	if (! isOpen())
 		return;
 
-	assert(m_stream.is_open());
-
-	m_stream.seekg(0, std::ios_base::end);
-	std::ifstream::pos_type pos = m_stream.tellg();
-	assert(pos != static_cast<std::ifstream::pos_type>(-1));
-	assert((pos % static_cast<std::ifstream::pos_type>(BlockSize)) == 0);
-	m_count = static_cast<ssize_t>(pos / static_cast<std::ifstream::pos_type>(BlockSize));
-//	std::cout << "block count:" << m_count << std::endl;
-
 	if (m_next_block_id == BLOCK_ID_INVALID)
-		m_next_block_id = static_cast<block_id_t>(m_count);
+		m_next_block_id = static_cast<block_id_t>(m_map.size());
 }
 
 template <size_t BLOCKSIZE, int CACHE_SIZE>
@@ -338,9 +755,7 @@ template <size_t BLOCKSIZE, int CACHE_SIZE>
 block_id_t FileBlockStorage<BLOCKSIZE, CACHE_SIZE>::allocId(int n_blocks)
 {
 	// std::cerr << "FBS::allocId(" << n_blocks << ")" << std::endl;
-	// block_id_t block_id = m_next_block_id;
-	// if (block_id == BLOCK_ID_INVALID)
-	// 	block_id = static_cast<block_id_t>(count());
+	assert(! m_readonly);
 	block_id_t block_id = nextId();
 	m_next_block_id = block_id + static_cast<block_id_t>(n_blocks);
 	return block_id;
@@ -356,7 +771,36 @@ bool FileBlockStorage<BLOCKSIZE, CACHE_SIZE>::dispose(block_id_t block_id, int c
 
 	nextId();	// force update of m_next_block_id if necessary
 	if (m_next_block_id == (block_id + static_cast<block_id_t>(count_)))
+	{
+		/* pending write-behind copies of the disposed blocks must not resurrect them */
+		m_lru.discard(block_id, BLOCK_ID_INVALID);
+
+		MW_FILE_IO_GUARD;
+
+		if ((! m_readonly) && walActive())
+		{
+			/* the block map is left alone until the next checkpoint */
+			if (! m_wal.appendDispose(block_id, static_cast<block_id_t>(count_)))
+				return false;
+			ITYPENAME wal_t::index_t::iterator it = m_wal_index.lower_bound(block_id);
+			while (it != m_wal_index.end())
+				m_wal_index.erase(it++);
+			if (block_id < m_wal_floor)
+				m_wal_floor = block_id;
+		} else if (! m_readonly)
+		{
+			for (block_id_t id = block_id; id < m_next_block_id; id++)
+			{
+				block_id_t physical_id = physical(id);
+				if (! block_id_valid(physical_id))
+					continue;
+				release_physical(physical_id, /* committed */ ! m_fresh[id]);
+				physical(id, BLOCK_ID_INVALID);
+				m_fresh[id] = false;
+			}
+		}
 		m_next_block_id -= static_cast<block_id_t>(count_);
+	}
 
 	return true;
 }
@@ -364,51 +808,106 @@ bool FileBlockStorage<BLOCKSIZE, CACHE_SIZE>::dispose(block_id_t block_id, int c
 template <size_t BLOCKSIZE, int CACHE_SIZE>
 bool FileBlockStorage<BLOCKSIZE, CACHE_SIZE>::read(block_t& dst)
 {
-#if STACK_PROTECTOR
-	char dummy[8]; UNUSED(dummy);	/* for -fstack-protector -Wstack-protector */
-#endif
-
 	// std::cerr << "bs.read(" << dst.index() << ")" << std::endl;
 	assert(dst.index() != BLOCK_ID_INVALID);
 
-	size_t pos = dst.index() * BlockSize;
+	MW_FILE_IO_GUARD;
 
-	try {
-		m_stream.seekg(static_cast<std::streamoff>(pos));
-	} catch (std::ios::failure) {
-		assert(false);
+	if (! read_block(dst.index(), dst.data()))
+	{
+		dst.dirty(true);
 		return false;
 	}
 
-	try {
-		m_stream.read(dst.data(), BlockSize);
-	} catch (std::ios_base::failure& e) {
-		std::cerr << "error reading block " << dst.index() << ":" << e.what() << std::endl;
-		assert(false);
-		return false;
+	dst.dirty(false);
+	return true;
+}
+
+template <size_t BLOCKSIZE, int CACHE_SIZE>
+bool FileBlockStorage<BLOCKSIZE, CACHE_SIZE>::read_block(block_id_t block_id, char* dst)
+{
+	if (walActive())
+	{
+		ITYPENAME wal_t::index_t::const_iterator it = m_wal_index.find(block_id);
+		if (it != m_wal_index.end())
+			return m_wal.readBlock(it->second, dst);
+		if (block_id >= m_wal_floor)
+			return false;
 	}
 
-	if (m_stream.fail())
+	/* allocated but never written blocks read as missing, like blocks past the end of file */
+	block_id_t physical_id = physical(block_id);
+	return block_id_valid(physical_id) && read_physical(physical_id, dst);
+}
+
+template <size_t BLOCKSIZE, int CACHE_SIZE>
+size_t FileBlockStorage<BLOCKSIZE, CACHE_SIZE>::read(size_t n, const block_id_t* ids, char* data, std::vector<bool>& loaded)
+{
+	loaded.assign(n, false);
+
+	MW_FILE_IO_GUARD;
+
+	/* locate the blocks first (see read_block()), then read runs of adjacent physical blocks at once */
+	size_t n_loaded = 0;
+	std::vector< std::pair<block_id_t, size_t> > located;
+	located.reserve(n);
+	for (size_t i = 0; i < n; i++)
 	{
-		// std::cerr << "can't read block " << dst.index() << "\n";
-		dst.dirty(true);
-		m_stream.clear();
-		// std::cerr << "FBS::read() failure" << std::endl;
-		return false;
-	} else
-		dst.dirty(false);
+		block_id_t block_id = ids[i];
+		if (walActive())
+		{
+			ITYPENAME wal_t::index_t::const_iterator it = m_wal_index.find(block_id);
+			if (it != m_wal_index.end())
+			{
+				if (m_wal.readBlock(it->second, data + i * BlockSize))
+				{
+					loaded[i] = true;
+					n_loaded++;
+				}
+				continue;
+			}
+			if (block_id >= m_wal_floor)
+				continue;
+		}
 
-	// std::cerr << "FBS::read(" << dst.index() << ") block dump:" << std::endl << s_hexdump(dst.data(), 128) << std::endl;
+		block_id_t physical_id = physical(block_id);
+		if (block_id_valid(physical_id))
+			located.push_back(std::make_pair(physical_id, i));
+	}
+	std::sort(located.begin(), located.end());
 
-//	if (m_stream.fail())
-//	{
-//		std::cerr << "stream fail reading block " << dst.index() << ", error: " << strerror(errno) << std::endl;
-//		assert(false);
-//		return false;
-//	}
+	std::vector<char> run;
+	size_t first = 0;
+	while (first < located.size())
+	{
+		size_t last = first + 1;
+		while ((last < located.size()) && (located[last].first == (located[last - 1].first + 1)))
+			last++;
 
-	assert(! m_stream.fail());
-	return true;
+		bool ok = false;
+		if ((last - first) > 1)
+		{
+			run.resize((last - first) * BlockSize);
+			ok = read_physical(located[first].first, &run[0], last - first);
+			if (ok)
+			{
+				for (size_t i = first; i < last; i++)
+					memcpy(data + located[i].second * BlockSize, &run[(i - first) * BlockSize], BlockSize);
+			}
+		}
+		/* single blocks, and runs reaching past the end of file */
+		for (size_t i = first; i < last; i++)
+		{
+			if (ok || read_physical(located[i].first, data + located[i].second * BlockSize))
+			{
+				loaded[located[i].second] = true;
+				n_loaded++;
+			}
+		}
+
+		first = last;
+	}
+	return n_loaded;
 }
 
 template <size_t BLOCKSIZE, int CACHE_SIZE>
@@ -421,45 +920,776 @@ bool FileBlockStorage<BLOCKSIZE, CACHE_SIZE>::write(block_t& src)
 	// std::cerr << "bs.write(" << src.index() << ")" << std::endl;
 	assert(src.index() != BLOCK_ID_INVALID);
 
-	size_t pos = src.index() * BlockSize;
-
-	try {
-		m_stream.seekp(static_cast<std::streamoff>(pos));
-	} catch (std::ios::failure& e) {
-		std::cerr << "error writing (seeking) block " << src.index() << ":" << e.what() << std::endl;
-		src.dirty(true);
-		assert(false);
-		return false;
+	/* snapshot readers never modify blocks: write-backs from their caches are dropped */
+	if (m_readonly)
+	{
+		src.dirty(false);
+		return true;
 	}
 
-	try {
-		m_stream.write(src.data(), BlockSize);
-	} catch (std::ios_base::failure& e) {
-		std::cerr << "error writing block " << src.index() << ":" << e.what() << std::endl;
-		src.dirty(true);
-		assert(false);
-		return false;
-	}
+	/* an older copy still waiting for the flusher would overwrite this one */
+	m_lru.discard(src.index(), src.index());
 
+	MW_FILE_IO_GUARD;
+
+	bool ok = walActive() ? log_block(src.index(), src.data()) : write_block(src.index(), src.data());
+	src.dirty(! ok);
+	return ok;
+}
+
+template <size_t BLOCKSIZE, int CACHE_SIZE>
+bool FileBlockStorage<BLOCKSIZE, CACHE_SIZE>::write(size_t n, const block_id_t* ids, const char* data)
+{
+	/* called by the write-behind flusher: stay away from m_next_block_id */
+	if (m_readonly)
+		return true;
+
+	MW_FILE_IO_GUARD;
+
+	if (walActive())
+	{
+		for (size_t i = 0; i < n; i++)
+		{
+			if (! log_block(ids[i], data + i * BlockSize))
+				return false;
+		}
+		return true;
+	}
+
+	/* map the blocks first, then write runs of adjacent physical blocks at once */
+	std::vector< std::pair<block_id_t, size_t> > placed;
+	placed.reserve(n);
+	for (size_t i = 0; i < n; i++)
+		placed.push_back(std::make_pair(place_block(ids[i]), i));
+	std::sort(placed.begin(), placed.end());
+
+	std::string run;
+	size_t first = 0;
+	while (first < placed.size())
+	{
+		size_t last = first + 1;
+		while ((last < placed.size()) && (placed[last].first == (placed[last - 1].first + 1)))
+			last++;
+
+		bool ok;
+		if ((last - first) == 1)
+			ok = write_physical(placed[first].first, data + placed[first].second * BlockSize);
+		else
+		{
+			run.clear();
+			for (size_t i = first; i < last; i++)
+				run.append(data + placed[i].second * BlockSize, BlockSize);
+			ok = write_physical(placed[first].first, run.data(), last - first);
+		}
+		if (! ok)
+			return false;
+
+		first = last;
+	}
+	return true;
+}
+
+template <size_t BLOCKSIZE, int CACHE_SIZE>
+bool FileBlockStorage<BLOCKSIZE, CACHE_SIZE>::log_block(block_id_t block_id, const char* data)
+{
+	/* the caches only write back the blocks they saw modified, no need to compare */
+	typename wal_t::offset_t offset = m_wal.appendBlock(block_id, data);
+	if (offset == 0)
+		return false;
+	m_wal_index[block_id] = offset;
+	return true;
+}
+
+template <size_t BLOCKSIZE, int CACHE_SIZE>
+bool FileBlockStorage<BLOCKSIZE, CACHE_SIZE>::write_block(block_id_t block_id, const char* data)
+{
+	block_id_t physical_id = place_block(block_id);
+	assert(block_id_valid(physical_id));
+	return write_physical(physical_id, data);
+}
+
+template <size_t BLOCKSIZE, int CACHE_SIZE>
+block_id_t FileBlockStorage<BLOCKSIZE, CACHE_SIZE>::place_block(block_id_t block_id)
+{
+	block_id_t physical_id = physical(block_id);
+	bool fresh = (block_id < m_fresh.size()) && m_fresh[block_id];
+
+	if (block_id_valid(physical_id) && (! fresh))
+	{
+		/* the block belongs to the committed snapshot: copy it */
+		release_physical(physical_id, /* committed */ true);
+		physical_id = BLOCK_ID_INVALID;
+	}
+
+	if (! block_id_valid(physical_id))
+	{
+		physical_id = alloc_physical();
+		physical(block_id, physical_id);
+	}
+	m_fresh[block_id] = true;
+
+	return physical_id;
+}
+
+/* -- Snapshots ------------------------------------------------ */
+
+template <size_t BLOCKSIZE, int CACHE_SIZE>
+bool FileBlockStorage<BLOCKSIZE, CACHE_SIZE>::commit()
+{
+	if (! isOpen())
+		return false;
+	if (m_readonly)
+		return true;
+
+	/* everything staged so far belongs to this commit */
+	if (! m_lru.drain())
+		return false;
+
+	MW_FILE_IO_GUARD;
+
+	if (! walActive())
+		return commit_snapshot();
+
+	/* group commit: everything written since the last commit, one sync */
+	if (! m_wal.commit(nextId()))
+		return false;
+	if (m_wal.size() >= WAL_CHECKPOINT_SIZE)
+		return checkpoint_wal(/* keep */ true);
+	return true;
+}
+
+template <size_t BLOCKSIZE, int CACHE_SIZE>
+bool FileBlockStorage<BLOCKSIZE, CACHE_SIZE>::checkpoint()
+{
+	if (! m_lru.drain())
+		return false;
+
+	MW_FILE_IO_GUARD;
+
+	return checkpoint_wal(/* keep */ true);
+}
+
+template <size_t BLOCKSIZE, int CACHE_SIZE>
+bool FileBlockStorage<BLOCKSIZE, CACHE_SIZE>::commit_snapshot()
+{
+	generation_t new_generation = m_generation + 1;
+
+	/* changed block map pages, copied like any other committed block */
+	nextId();
+	size_t n_pages = (static_cast<size_t>(m_next_block_id) + MAP_PAGE_ENTRIES - 1) / MAP_PAGE_ENTRIES;
+	while (m_map_pages.size() > n_pages)
+	{
+		release_physical(m_map_pages.back(), /* committed */ true);
+		m_map_pages.pop_back();
+		m_map_page_dirty.pop_back();
+	}
+	if (m_map_pages.size() < n_pages)
+	{
+		m_map_pages.resize(n_pages, BLOCK_ID_INVALID);
+		m_map_page_dirty.resize(n_pages, true);
+	}
+
+	for (size_t page = 0; page < n_pages; page++)
+	{
+		if ((! m_map_page_dirty[page]) && block_id_valid(m_map_pages[page]))
+			continue;
+
+		seriously::Packer<BLOCKSIZE> packer;
+		for (size_t i = 0; i < MAP_PAGE_ENTRIES; i++)
+		{
+			size_t block_id = page * MAP_PAGE_ENTRIES + i;
+			block_id_t physical_id = (block_id < static_cast<size_t>(m_next_block_id)) ? physical(static_cast<block_id_t>(block_id)) : BLOCK_ID_INVALID;
+			packer << static_cast<uint32_t>(physical_id);
+		}
+		assert(! packer.error());
+
+		release_physical(m_map_pages[page], /* committed */ true);
+		m_map_pages[page] = alloc_physical();
+		if (! write_physical(m_map_pages[page], packer.data()))
+			return false;
+		m_map_page_dirty[page] = false;
+	}
+
+	/* map directory and free list, rewritten at each commit */
+	std::vector<block_id_t>::const_iterator it;
+	for (it = m_chain_blocks.begin(); it != m_chain_blocks.end(); ++it)
+		release_physical(*it, /* committed */ true);
+	m_chain_blocks.clear();
+
+	std::vector<uint32_t> words(m_map_pages.begin(), m_map_pages.end());
+	block_id_t map_root = write_chain(words);
+	if ((! words.empty()) && (! block_id_valid(map_root)))
+		return false;
+
+	words.clear();
+	for (it = m_free_pool.begin(); it != m_free_pool.end(); ++it)
+	{
+		words.push_back(static_cast<uint32_t>(*it));
+		words.push_back(0);
+		words.push_back(0);
+	}
+	typename std::vector< std::pair<generation_t, block_id_t> >::const_iterator pit;
+	for (pit = m_free_pending.begin(); pit != m_free_pending.end(); ++pit)
+	{
+		words.push_back(static_cast<uint32_t>(pit->second));
+		words.push_back(static_cast<uint32_t>(pit->first & 0xFFFFFFFF));
+		words.push_back(static_cast<uint32_t>(pit->first >> 32));
+	}
+	block_id_t free_root = write_chain(words);
+	if ((! words.empty()) && (! block_id_valid(free_root)))
+		return false;
+
+	/* everything the new snapshot references must be in the file before its superblock */
+	m_stream.flush();
 	if (m_stream.fail())
 	{
-		std::cerr << "stream fail writing block " << src.index() << ", error: " << strerror(errno) << std::endl;
-		src.dirty(true);
+		std::cerr << "ERROR: can't commit '" << m_pathname << "', error: " << strerror(errno) << std::endl;
+		m_stream.clear();
+		return false;
+	}
+
+	if (! write_superblock(static_cast<block_id_t>(new_generation % SUPERBLOCK_SLOTS), new_generation, map_root, free_root))
+		return false;
+	m_stream.flush();
+
+	m_generation = new_generation;
+	m_fresh.assign(m_fresh.size(), false);
+
+	reclaim();
+	return true;
+}
+
+/* -- Physical I/O --------------------------------------------- */
+
+template <size_t BLOCKSIZE, int CACHE_SIZE>
+bool FileBlockStorage<BLOCKSIZE, CACHE_SIZE>::read_physical(block_id_t physical_id, char* dst, size_t n_blocks)
+{
+#if STACK_PROTECTOR
+	char dummy[8]; UNUSED(dummy);	/* for -fstack-protector -Wstack-protector */
+#endif
+
+	assert(physical_id != BLOCK_ID_INVALID);
+
+	size_t pos = static_cast<size_t>(physical_id) * BlockSize;
+
+	try {
+		m_stream.seekg(static_cast<std::streamoff>(pos));
+	} catch (std::ios::failure) {
 		assert(false);
 		return false;
-	} else
-		src.dirty(false);
+	}
+
+	try {
+		m_stream.read(dst, static_cast<std::streamsize>(n_blocks * BlockSize));
+	} catch (std::ios_base::failure& e) {
+		std::cerr << "error reading block " << physical_id << ":" << e.what() << std::endl;
+		assert(false);
+		return false;
+	}
+
+	if (m_stream.fail())
+	{
+		// std::cerr << "can't read block " << physical_id << "\n";
+		m_stream.clear();
+		return false;
+	}
 
 	assert(! m_stream.fail());
+	return true;
+}
+
+template <size_t BLOCKSIZE, int CACHE_SIZE>
+bool FileBlockStorage<BLOCKSIZE, CACHE_SIZE>::write_physical(block_id_t physical_id, const char* src, size_t n_blocks)
+{
+#if STACK_PROTECTOR
+	char dummy[8]; UNUSED(dummy);	/* for -fstack-protector -Wstack-protector */
+#endif
+
+	assert(physical_id != BLOCK_ID_INVALID);
+	assert(! m_readonly);
+
+	size_t pos = static_cast<size_t>(physical_id) * BlockSize;
+
+	try {
+		m_stream.seekp(static_cast<std::streamoff>(pos));
+	} catch (std::ios::failure& e) {
+		std::cerr << "error writing (seeking) block " << physical_id << ":" << e.what() << std::endl;
+		assert(false);
+		return false;
+	}
+
+	try {
+		m_stream.write(src, static_cast<std::streamsize>(n_blocks * BlockSize));
+	} catch (std::ios_base::failure& e) {
+		std::cerr << "error writing block " << physical_id << ":" << e.what() << std::endl;
+		assert(false);
+		return false;
+	}
 
-	pos += BlockSize;
-	if (pos >= (static_cast<size_t>(m_count) * BlockSize))
-		m_count = static_cast<ssize_t>(pos / BlockSize);
+	if (m_stream.fail())
+	{
+		std::cerr << "stream fail writing block " << physical_id << ", error: " << strerror(errno) << std::endl;
+		assert(false);
+		return false;
+	}
 
-	// std::cerr << "FBS::write(" << src.index() << ") block dump:" << std::endl << s_hexdump(src.data(), 128) << std::endl;
+	assert(! m_stream.fail());
 	return true;
 }
 
+template <size_t BLOCKSIZE, int CACHE_SIZE>
+void FileBlockStorage<BLOCKSIZE, CACHE_SIZE>::physical(block_id_t block_id, block_id_t physical_id)
+{
+	assert(block_id != BLOCK_ID_INVALID);
+	if (block_id >= m_map.size())
+	{
+		m_map.resize(static_cast<size_t>(block_id) + 1, BLOCK_ID_INVALID);
+		m_fresh.resize(static_cast<size_t>(block_id) + 1, false);
+	}
+	m_map[block_id] = physical_id;
+
+	size_t page = static_cast<size_t>(block_id) / MAP_PAGE_ENTRIES;
+	if (page >= m_map_pages.size())
+	{
+		m_map_pages.resize(page + 1, BLOCK_ID_INVALID);
+		m_map_page_dirty.resize(page + 1, true);
+	}
+	m_map_page_dirty[page] = true;
+}
+
+template <size_t BLOCKSIZE, int CACHE_SIZE>
+block_id_t FileBlockStorage<BLOCKSIZE, CACHE_SIZE>::alloc_physical(bool recycle)
+{
+	if (recycle && (! m_free_pool.empty()))
+	{
+		block_id_t physical_id = m_free_pool.back();
+		m_free_pool.pop_back();
+		return physical_id;
+	}
+	return m_next_physical_id++;
+}
+
+template <size_t BLOCKSIZE, int CACHE_SIZE>
+void FileBlockStorage<BLOCKSIZE, CACHE_SIZE>::release_physical(block_id_t physical_id, bool committed)
+{
+	if (! block_id_valid(physical_id))
+		return;
+	assert(physical_id >= SUPERBLOCK_SLOTS);
+
+	/* blocks of the committed snapshot stay readable until the next commit is no longer pinned */
+	if (committed)
+		m_free_pending.push_back(std::pair<generation_t, block_id_t>(m_generation + 1, physical_id));
+	else
+		m_free_pool.push_back(physical_id);
+}
+
+template <size_t BLOCKSIZE, int CACHE_SIZE>
+void FileBlockStorage<BLOCKSIZE, CACHE_SIZE>::reclaim()
+{
+	if (m_readonly || m_free_pending.empty())
+		return;
+
+	/*
+	 * a block released by commit 'g' is still referenced by snapshots
+	 * older than 'g', so it can be recycled once 'g' is committed and
+	 * no reader pins an older generation
+	 */
+	generation_t horizon = m_snapshot_lock.oldest(m_generation);
+
+	size_t kept = 0;
+	for (size_t i = 0; i < m_free_pending.size(); i++)
+	{
+		if (m_free_pending[i].first <= horizon)
+			m_free_pool.push_back(m_free_pending[i].second);
+		else
+			m_free_pending[kept++] = m_free_pending[i];
+	}
+	m_free_pending.resize(kept);
+}
+
+/* -- Superblock / block map ----------------------------------- */
+
+template <size_t BLOCKSIZE, int CACHE_SIZE>
+uint32_t FileBlockStorage<BLOCKSIZE, CACHE_SIZE>::checksum(const char* data, size_t size)
+{
+	/* FNV-1a */
+	uint32_t hash = 2166136261U;
+	for (size_t i = 0; i < size; i++)
+	{
+		hash ^= static_cast<uint8_t>(data[i]);
+		hash *= 16777619U;
+	}
+	return hash;
+}
+
+template <size_t BLOCKSIZE, int CACHE_SIZE>
+bool FileBlockStorage<BLOCKSIZE, CACHE_SIZE>::read_superblock(block_id_t slot, generation_t& generation, block_id_t& n_logical, block_id_t& next_physical_id,
+															   block_id_t& map_root, block_id_t& free_root)
+{
+	char data[BLOCKSIZE];
+	if (! read_physical(slot, data))
+		return false;
+
+	seriously::Packer<BLOCKSIZE> packer(data, BLOCKSIZE);
+	std::string v_magic;
+	uint32_t v_major, v_minor, v_blocksize;
+	uint64_t v_generation;
+	uint32_t v_n_logical, v_next_physical_id, v_map_root, v_free_root, v_checksum;
+
+	packer >> v_magic;
+	if (packer.error() || (v_magic != BS_SUPERBLOCK_MAGIC))
+		return false;
+	packer >> v_major >> v_minor >> v_blocksize >> v_generation >>
+		v_n_logical >> v_next_physical_id >> v_map_root >> v_free_root >> v_checksum;
+	if (packer.error())
+		return false;
+
+	seriously::Packer<BLOCKSIZE> check;
+	check << v_magic << v_major << v_minor << v_blocksize << v_generation <<
+		v_n_logical << v_next_physical_id << v_map_root << v_free_root;
+	if (checksum(check.data(), check.size()) != v_checksum)
+		return false;
+
+	if ((static_cast<int>(v_major) > SUPERBLOCK_MAJOR_VERSION) || (static_cast<size_t>(v_blocksize) != BLOCKSIZE))
+	{
+		std::cerr << "ERROR: '" << m_pathname << "' superblock version or block size not supported (found:" <<
+			v_major << "." << v_minor << " blocksize:" << v_blocksize << ")" << std::endl;
+		return false;
+	}
+
+	generation = v_generation;
+	n_logical = v_n_logical;
+	next_physical_id = v_next_physical_id;
+	map_root = v_map_root;
+	free_root = v_free_root;
+	return true;
+}
+
+template <size_t BLOCKSIZE, int CACHE_SIZE>
+bool FileBlockStorage<BLOCKSIZE, CACHE_SIZE>::write_superblock(block_id_t slot, generation_t generation, block_id_t map_root, block_id_t free_root)
+{
+	assert(slot < SUPERBLOCK_SLOTS);
+
+	seriously::Packer<BLOCKSIZE> packer;
+	packer << std::string(BS_SUPERBLOCK_MAGIC) <<
+		static_cast<uint32_t>(SUPERBLOCK_MAJOR_VERSION) << static_cast<uint32_t>(SUPERBLOCK_MINOR_VERSION) <<
+		static_cast<uint32_t>(BLOCKSIZE) << static_cast<uint64_t>(generation) <<
+		static_cast<uint32_t>(m_next_block_id) << static_cast<uint32_t>(m_next_physical_id) <<
+		static_cast<uint32_t>(map_root) << static_cast<uint32_t>(free_root);
+	packer << checksum(packer.data(), packer.size());
+	assert(! packer.error());
+
+	char data[BLOCKSIZE];
+	memset(data, 0, sizeof(data));
+	memcpy(data, packer.data(), packer.size());
+	return write_physical(slot, data);
+}
+
+template <size_t BLOCKSIZE, int CACHE_SIZE>
+int FileBlockStorage<BLOCKSIZE, CACHE_SIZE>::latest_superblock(generation_t& generation, block_id_t& n_logical, block_id_t& next_physical_id,
+															   block_id_t& map_root, block_id_t& free_root)
+{
+	int latest = -1;
+	for (block_id_t slot = 0; slot < SUPERBLOCK_SLOTS; slot++)
+	{
+		generation_t v_generation;
+		block_id_t v_n_logical, v_next_physical_id, v_map_root, v_free_root;
+		if (! read_superblock(slot, v_generation, v_n_logical, v_next_physical_id, v_map_root, v_free_root))
+			continue;
+		if ((latest >= 0) && (v_generation <= generation))
+			continue;
+		latest = static_cast<int>(slot);
+		generation = v_generation;
+		n_logical = v_n_logical;
+		next_physical_id = v_next_physical_id;
+		map_root = v_map_root;
+		free_root = v_free_root;
+	}
+	return latest;
+}
+
+template <size_t BLOCKSIZE, int CACHE_SIZE>
+bool FileBlockStorage<BLOCKSIZE, CACHE_SIZE>::load_snapshot()
+{
+	for (int attempt = 0; attempt < SNAPSHOT_OPEN_RETRIES; attempt++)
+	{
+		generation_t generation = 0;
+		block_id_t n_logical = 0, next_physical_id = 0, map_root = BLOCK_ID_INVALID, free_root = BLOCK_ID_INVALID;
+
+		int slot = latest_superblock(generation, n_logical, next_physical_id, map_root, free_root);
+		if (slot < 0)
+			return load_legacy();
+
+		if (m_readonly)
+		{
+			/* pin first, then make sure the writer didn't commit (and recycle) in the meantime */
+			m_snapshot_lock.pin(generation);
+
+			generation_t check_generation = 0;
+			block_id_t check_n_logical, check_next_physical_id, check_map_root, check_free_root;
+			int check_slot = latest_superblock(check_generation, check_n_logical, check_next_physical_id, check_map_root, check_free_root);
+			if ((check_slot != slot) || (check_generation != generation))
+			{
+				m_snapshot_lock.unpin();
+				continue;
+			}
+		}
+
+		m_generation = generation;
+		m_next_block_id = n_logical;
+		m_next_physical_id = next_physical_id;
+
+		std::vector<uint32_t> words;
+		m_chain_blocks.clear();
+		if (! read_chain(map_root, words, /* track */ true))
+			return false;
+
+		m_map_pages.assign(words.begin(), words.end());
+		m_map_page_dirty.assign(m_map_pages.size(), false);
+		m_map.assign(static_cast<size_t>(n_logical), BLOCK_ID_INVALID);
+		m_fresh.assign(static_cast<size_t>(n_logical), false);
+
+		char data[BLOCKSIZE];
+		for (size_t page = 0; page < m_map_pages.size(); page++)
+		{
+			if (! read_physical(m_map_pages[page], data))
+			{
+				std::cerr << "ERROR: can't read block map page " << page << " of '" << m_pathname << "'" << std::endl;
+				return false;
+			}
+			seriously::Packer<BLOCKSIZE> packer(data, BLOCKSIZE);
+			for (size_t i = 0; i < MAP_PAGE_ENTRIES; i++)
+			{
+				uint32_t v_physical_id;
+				packer >> v_physical_id;
+				size_t block_id = page * MAP_PAGE_ENTRIES + i;
+				if (block_id < m_map.size())
+					m_map[block_id] = static_cast<block_id_t>(v_physical_id);
+			}
+			assert(! packer.error());
+		}
+
+		if (! m_readonly)
+		{
+			words.clear();
+			if (! read_chain(free_root, words, /* track */ true))
+				return false;
+			for (size_t i = 0; (i + 2) < words.size(); i += 3)
+			{
+				generation_t released = static_cast<generation_t>(words[i + 1]) | (static_cast<generation_t>(words[i + 2]) << 32);
+				if (released == 0)
+					m_free_pool.push_back(static_cast<block_id_t>(words[i]));
+				else
+					m_free_pending.push_back(std::pair<generation_t, block_id_t>(released, static_cast<block_id_t>(words[i])));
+			}
+			reclaim();
+		}
+
+		return true;
+	}
+
+	std::cerr << "ERROR: can't get a stable snapshot of '" << m_pathname << "'" << std::endl;
+	return false;
+}
+
+template <size_t BLOCKSIZE, int CACHE_SIZE>
+bool FileBlockStorage<BLOCKSIZE, CACHE_SIZE>::load_legacy()
+{
+	/* file written before the block map: every block is at its own position */
+	m_stream.seekg(0, std::ios_base::end);
+	std::ifstream::pos_type pos = m_stream.tellg();
+	if (pos == static_cast<std::ifstream::pos_type>(-1))
+		return false;
+	block_id_t n_blocks = static_cast<block_id_t>(pos / static_cast<std::ifstream::pos_type>(BlockSize));
+
+	m_generation = 0;
+	m_next_block_id = n_blocks;
+	m_next_physical_id = (n_blocks > SUPERBLOCK_SLOTS) ? n_blocks : SUPERBLOCK_SLOTS;
+	m_map.resize(static_cast<size_t>(n_blocks));
+	m_fresh.assign(static_cast<size_t>(n_blocks), false);
+	for (block_id_t block_id = 0; block_id < n_blocks; block_id++)
+		m_map[block_id] = block_id;
+	m_map_pages.assign((static_cast<size_t>(n_blocks) + MAP_PAGE_ENTRIES - 1) / MAP_PAGE_ENTRIES, BLOCK_ID_INVALID);
+	m_map_page_dirty.assign(m_map_pages.size(), true);
+
+	if (! m_readonly)
+	{
+		/* move the blocks sitting where the superblocks go */
+		char data[BLOCKSIZE];
+		for (block_id_t block_id = 0; (block_id < SUPERBLOCK_SLOTS) && (block_id < n_blocks); block_id++)
+		{
+			if (! read_physical(block_id, data))
+				return false;
+			block_id_t physical_id = alloc_physical(/* recycle */ false);
+			if (! write_physical(physical_id, data))
+				return false;
+			physical(block_id, physical_id);
+			m_fresh[block_id] = true;
+		}
+	}
+
+	return true;
+}
+
+/* -- Write-ahead log ------------------------------------------ */
+
+template <size_t BLOCKSIZE, int CACHE_SIZE>
+bool FileBlockStorage<BLOCKSIZE, CACHE_SIZE>::load_wal(bool& retry)
+{
+	retry = false;
+
+	if (m_readonly)
+	{
+		if (! m_wal.open(walPathname(), /* readonly */ true))
+			return true;
+		if (m_wal.baseGeneration() != m_generation)
+		{
+			/* older logs are leftovers of a checkpoint, a newer one means we lost a race with it */
+			retry = (m_wal.baseGeneration() > m_generation);
+			m_wal.close();
+			return true;
+		}
+		block_id_t n_logical = nextId();
+		if (m_wal.replay(m_wal_index, n_logical, m_wal_floor))
+			m_next_block_id = n_logical;
+		return true;
+	}
+
+	bool has_log = m_wal.open(walPathname(), /* readonly */ false);
+	if (has_log && (! m_created) && (m_wal.baseGeneration() == m_generation))
+	{
+		/* recovery: the changes committed to the log are part of the store */
+		block_id_t n_logical = nextId();
+		if (m_wal.replay(m_wal_index, n_logical, m_wal_floor))
+			m_next_block_id = n_logical;
+		return m_wal_mode ? true : checkpoint_wal(/* keep */ false);
+	}
+
+	if (! m_wal_mode)
+		return has_log ? m_wal.remove() : true;
+	return m_wal.create(walPathname(), m_generation);
+}
+
+template <size_t BLOCKSIZE, int CACHE_SIZE>
+bool FileBlockStorage<BLOCKSIZE, CACHE_SIZE>::checkpoint_wal(bool keep)
+{
+	if (! isOpen())
+		return false;
+	if (m_readonly || (! walActive()))
+		return true;
+
+	if ((m_wal.pending() > 0) && (! m_wal.commit(nextId())))
+		return false;
+
+	/* blocks disposed since the log was started, unless written again */
+	size_t first = (static_cast<size_t>(m_wal_floor) < m_map.size()) ? static_cast<size_t>(m_wal_floor) : m_map.size();
+	for (size_t i = first; i < m_map.size(); i++)
+	{
+		block_id_t block_id = static_cast<block_id_t>(i);
+		if ((block_id < m_next_block_id) && (m_wal_index.count(block_id) > 0))
+			continue;
+		block_id_t physical_id = physical(block_id);
+		if (! block_id_valid(physical_id))
+			continue;
+		release_physical(physical_id, /* committed */ ! m_fresh[i]);
+		physical(block_id, BLOCK_ID_INVALID);
+		m_fresh[i] = false;
+	}
+
+	char data[BLOCKSIZE];
+	ITYPENAME wal_t::index_t::const_iterator it;
+	for (it = m_wal_index.begin(); it != m_wal_index.end(); ++it)
+	{
+		if ((! m_wal.readBlock(it->second, data)) || (! write_block(it->first, data)))
+		{
+			std::cerr << "ERROR: can't checkpoint block " << it->first << " of '" << m_pathname << "'" << std::endl;
+			return false;
+		}
+	}
+
+	if (! commit_snapshot())
+		return false;
+
+	/* the log goes away only once the snapshot replacing it is durable */
+	if (! sync_pathname(m_pathname))
+	{
+		std::cerr << "ERROR: can't sync '" << m_pathname << "', error: " << strerror(errno) << std::endl;
+		return false;
+	}
+
+	m_wal_index.clear();
+	m_wal_floor = BLOCK_ID_INVALID;
+
+	return keep ? m_wal.create(walPathname(), m_generation) : m_wal.remove();
+}
+
+template <size_t BLOCKSIZE, int CACHE_SIZE>
+bool FileBlockStorage<BLOCKSIZE, CACHE_SIZE>::read_chain(block_id_t root, std::vector<uint32_t>& words, bool track)
+{
+	char data[BLOCKSIZE];
+	block_id_t chain_id = root;
+	size_t n_chain = 0;
+	while (block_id_valid(chain_id))
+	{
+		if ((chain_id >= m_next_physical_id) || (++n_chain > static_cast<size_t>(m_next_physical_id)) ||
+			(! read_physical(chain_id, data)))
+		{
+			std::cerr << "ERROR: can't read block chain of '" << m_pathname << "' at block " << chain_id << std::endl;
+			return false;
+		}
+		if (track)
+			m_chain_blocks.push_back(chain_id);
+
+		seriously::Packer<BLOCKSIZE> packer(data, BLOCKSIZE);
+		uint32_t v_next, v_count;
+		packer >> v_next >> v_count;
+		if (packer.error() || (v_count > CHAIN_BLOCK_WORDS))
+			return false;
+		for (uint32_t i = 0; i < v_count; i++)
+		{
+			uint32_t v_word;
+			packer >> v_word;
+			words.push_back(v_word);
+		}
+		chain_id = static_cast<block_id_t>(v_next);
+	}
+	return true;
+}
+
+template <size_t BLOCKSIZE, int CACHE_SIZE>
+block_id_t FileBlockStorage<BLOCKSIZE, CACHE_SIZE>::write_chain(const std::vector<uint32_t>& words)
+{
+	if (words.empty())
+		return BLOCK_ID_INVALID;
+
+	/* from the tail of the file: this must not change the free list being written */
+	size_t n_chain = (words.size() + CHAIN_BLOCK_WORDS - 1) / CHAIN_BLOCK_WORDS;
+	std::vector<block_id_t> chain;
+	for (size_t i = 0; i < n_chain; i++)
+		chain.push_back(alloc_physical(/* recycle */ false));
+
+	for (size_t i = 0; i < n_chain; i++)
+	{
+		size_t first = i * CHAIN_BLOCK_WORDS;
+		size_t count_ = min(CHAIN_BLOCK_WORDS, words.size() - first);
+
+		seriously::Packer<BLOCKSIZE> packer;
+		packer << static_cast<uint32_t>(((i + 1) < n_chain) ? chain[i + 1] : BLOCK_ID_INVALID) << static_cast<uint32_t>(count_);
+		for (size_t w = first; w < (first + count_); w++)
+			packer << words[w];
+		assert(! packer.error());
+
+		char data[BLOCKSIZE];
+		memset(data, 0, sizeof(data));
+		memcpy(data, packer.data(), packer.size());
+		if (! write_physical(chain[i], data))
+			return BLOCK_ID_INVALID;
+		m_chain_blocks.push_back(chain[i]);
+	}
+
+	return chain[0];
+}
+
 /* cached I/O */
 
 template <size_t BLOCKSIZE, int CACHE_SIZE>
@@ -479,6 +1709,16 @@ MW_SHPTR<typename FileBlockStorage<BLOCKSIZE, CACHE_SIZE>::block_t> FileBlockSto
 	}
 }
 
+template <size_t BLOCKSIZE, int CACHE_SIZE>
+size_t FileBlockStorage<BLOCKSIZE, CACHE_SIZE>::prefetch(block_id_t first, size_t count)
+{
+	std::vector<block_id_t> ids;
+	ids.reserve(count);
+	for (size_t i = 0; i < count; i++)
+		ids.push_back(first + static_cast<block_id_t>(i));
+	return ids.empty() ? 0 : prefetch(ids.size(), &ids[0]);
+}
+
 template <size_t BLOCKSIZE, int CACHE_SIZE>
 bool FileBlockStorage<BLOCKSIZE, CACHE_SIZE>::put(const block_t& src)
 {
@@ -491,6 +1731,7 @@ bool FileBlockStorage<BLOCKSIZE, CACHE_SIZE>::put(const block_t& src)
 			*cached_ptr = src;
 			assert(src.dirty() == (*cached_ptr).dirty());
 		}
+		m_lru.modified(src.index());
 		return true;
 	} else
 	{
@@ -498,12 +1739,17 @@ bool FileBlockStorage<BLOCKSIZE, CACHE_SIZE>::put(const block_t& src)
 		MW_SHPTR<block_t> src_ptr( this->manager().get_object(bid) );
 		assert(src_ptr);
 		*src_ptr = src;
-		return m_lru.set(bid, src_ptr) ? true : false;
+		if (! m_lru.set(bid, src_ptr))
+			return false;
+		m_lru.modified(bid);
+		return true;
 	}
 
 	return false;
 }
 
+#undef MW_FILE_IO_GUARD
+
 /* -- Streaming I/O -------------------------------------------- */
 
 	/* streaming read */
@@ -47,6 +47,7 @@ static const size_t KV_BLOCKSIZE = MILLIWAYS_DEFAULT_BLOCK_SIZE;			/* default: 4
 static const int KV_BLOCK_CACHESIZE = MILLIWAYS_DEFAULT_BLOCK_CACHE_SIZE;	/* default: 8192 */
 static const int KV_NODE_CACHESIZE = MILLIWAYS_DEFAULT_NODE_CACHE_SIZE;		/* default: 1024 */
 static const int KV_B = MILLIWAYS_DEFAULT_B_FACTOR;							/* default: 73   */
+static const size_t KV_SMALL_VALUE_MAX_SIZE = MILLIWAYS_DEFAULT_SMALL_VALUE_SIZE;	/* default: 512  */
 
 typedef uint64_t serialized_data_pos_type;
 typedef uint16_t serialized_data_offset_type;
@@ -60,28 +61,66 @@ typedef uint32_t serialized_value_size_type;
 typedef StreamPos<KV_BLOCKSIZE> kv_stream_pos_t;
 typedef StreamSizedPos<KV_BLOCKSIZE> kv_stream_sized_pos_t;
 
+/* ----------------------------------------------------------------- *
+ *   Small values                                                    *
+ *     values up to KV_SMALL_VALUE_MAX_SIZE bytes are stored without *
+ *     envelope, packed in the value blocks, and their length is     *
+ *     kept in the B+Tree leaf entry together with the position      *
+ * ----------------------------------------------------------------- */
+
+static const int      KV_SMALL_LENGTH_SHIFT = 48;
+static const uint64_t KV_SMALL_FLAG         = (static_cast<uint64_t>(1) << 62);
+static const uint64_t KV_SMALL_LENGTH_MASK  = 0x3FFF;
+static const uint64_t KV_SMALL_POS_MASK     = ((static_cast<uint64_t>(1) << KV_SMALL_LENGTH_SHIFT) - 1);
+
+inline bool kv_small_pos_is_small(const kv_stream_pos_t& pos)
+{
+	return pos.valid() && ((static_cast<uint64_t>(pos.pos()) & KV_SMALL_FLAG) != 0);
+}
+
+inline size_t kv_small_pos_length(const kv_stream_pos_t& pos)
+{
+	return static_cast<size_t>((static_cast<uint64_t>(pos.pos()) >> KV_SMALL_LENGTH_SHIFT) & KV_SMALL_LENGTH_MASK);
+}
+
+inline kv_stream_pos_t kv_small_pos_decode(const kv_stream_pos_t& pos)
+{
+	return kv_stream_pos_t(static_cast<kv_stream_pos_t::offset_t>(static_cast<uint64_t>(pos.pos()) & KV_SMALL_POS_MASK));
+}
+
+inline kv_stream_pos_t kv_small_pos_encode(const kv_stream_pos_t& pos, size_t length)
+{
+	assert(pos.valid());
+	assert((static_cast<uint64_t>(pos.pos()) & ~KV_SMALL_POS_MASK) == 0);
+	assert(static_cast<uint64_t>(length) <= KV_SMALL_LENGTH_MASK);
+	uint64_t v = KV_SMALL_FLAG |
+		((static_cast<uint64_t>(length) & KV_SMALL_LENGTH_MASK) << KV_SMALL_LENGTH_SHIFT) |
+		(static_cast<uint64_t>(pos.pos()) & KV_SMALL_POS_MASK);
+	return kv_stream_pos_t(static_cast<kv_stream_pos_t::offset_t>(v));
+}
+
 struct FullLocator : public kv_stream_sized_pos_t
 {
 public:
 	static const size_type ENVELOPE_SIZE = (2 * sizeof(serialized_value_size_type));
 
-	FullLocator() : kv_stream_sized_pos_t(), m_uncompressed(0) {}
+	FullLocator() : kv_stream_sized_pos_t(), m_uncompressed(0), m_envelope(ENVELOPE_SIZE) {}
 	FullLocator(size_t linear_pos_, size_t size_) :
-		kv_stream_sized_pos_t(linear_pos_, size_), m_uncompressed(0) {}
+		kv_stream_sized_pos_t(linear_pos_, size_), m_uncompressed(0), m_envelope(ENVELOPE_SIZE) {}
 	FullLocator(const FullLocator& other) :
-		kv_stream_sized_pos_t(other.pos(), other.full_size()), m_uncompressed(other.m_uncompressed) {}
+		kv_stream_sized_pos_t(other.pos(), other.full_size()), m_uncompressed(other.m_uncompressed), m_envelope(other.m_envelope) {}
 	FullLocator(const kv_stream_sized_pos_t& sizedLocator_, size_t uncompressed_) :
-		kv_stream_sized_pos_t(sizedLocator_), m_uncompressed(uncompressed_) {}
+		kv_stream_sized_pos_t(sizedLocator_), m_uncompressed(uncompressed_), m_envelope(ENVELOPE_SIZE) {}
 	FullLocator(const FullLocator& other, offset_t delta_) :
-		kv_stream_sized_pos_t(other.pos(), other.full_size()), m_uncompressed(other.m_uncompressed) { delta(delta_); }
-	FullLocator& operator=(const FullLocator& other) { m_pos = other.m_pos; m_full_size = other.m_full_size; m_uncompressed = other.m_uncompressed; return *this; }
+		kv_stream_sized_pos_t(other.pos(), other.full_size()), m_uncompressed(other.m_uncompressed), m_envelope(other.m_envelope) { delta(delta_); }
+	FullLocator& operator=(const FullLocator& other) { m_pos = other.m_pos; m_full_size = other.m_full_size; m_uncompressed = other.m_uncompressed; m_envelope = other.m_envelope; return *this; }
 	FullLocator& operator=(const kv_stream_sized_pos_t& sl) { m_pos = sl.pos(); m_full_size = sl.size(); return *this; }
 	FullLocator& operator=(const kv_stream_pos_t& dl) { m_pos = dl.pos(); return *this; }
 
 	bool operator==(const FullLocator& rhs) const
 	{
 		return (((m_pos < 0) && (rhs.m_pos < 0)) ||
-		        ((m_pos == rhs.m_pos) && (m_full_size == rhs.m_full_size) && (m_uncompressed == rhs.m_uncompressed)));
+		        ((m_pos == rhs.m_pos) && (m_full_size == rhs.m_full_size) && (m_uncompressed == rhs.m_uncompressed) && (m_envelope == rhs.m_envelope)));
 	}
 	bool operator!=(const FullLocator& rhs) const { return (!(*this == rhs)); }
 	bool operator<(const FullLocator& rhs) const {
@@ -110,10 +149,10 @@ public:
 	size_type full_size() const { return m_full_size; }
 	size_type full_size(size_type value) { size_type old = m_full_size; m_full_size = value; return old; }
 
-	size_type header_size() const { return FullLocator::ENVELOPE_SIZE; }
+	size_type header_size() const { return m_envelope; }
 
 	/* compressed _payload_ (only) size */
-	size_type compressed_size() const { return (enveloped_size() - ENVELOPE_SIZE); }
+	size_type compressed_size() const { return (enveloped_size() - m_envelope); }
 
 	/* uncompressed data (only) size */
 	size_type uncompressed_size() const { return (m_uncompressed == 0) ? compressed_size() : m_uncompressed; }
@@ -127,24 +166,30 @@ public:
 	FullLocator& set_uncompressed(size_type contents_) { m_uncompressed = 0; payload_size(contents_); return *this; }
 	FullLocator& set_compressed(size_type compressed_, size_type contents_) { payload_size(compressed_); m_uncompressed = contents_; return *this; }
 
+	/* small values have no envelope (their size is kept in the btree) */
+	FullLocator& set_small(size_type contents_) { m_envelope = 0; m_uncompressed = 0; payload_size(contents_); return *this; }
+	FullLocator& set_enveloped() { m_envelope = ENVELOPE_SIZE; return *this; }
+
 	bool isCompressed() const { return (m_uncompressed != 0); }
+	bool isSmall() const { return (m_envelope == 0); }
 
 	kv_stream_sized_pos_t headLocator() const { return sizedLocator(); }
-	kv_stream_sized_pos_t payloadLocator() const { size_t off = FullLocator::ENVELOPE_SIZE; kv_stream_sized_pos_t pl = sizedLocator(); pl.delta(static_cast<offset_t>(off)); pl.shrink(off); return pl; }
+	kv_stream_sized_pos_t payloadLocator() const { size_t off = m_envelope; kv_stream_sized_pos_t pl = sizedLocator(); pl.delta(static_cast<offset_t>(off)); pl.shrink(off); return pl; }
 
 protected:
 	size_type enveloped_size() const { return full_size(); }
 	size_type enveloped_size(size_type value) { return full_size(value); }
-	size_type compressed_size(size_type value) { return enveloped_size(value + ENVELOPE_SIZE); }
+	size_type compressed_size(size_type value) { return enveloped_size(value + m_envelope); }
 	size_type payload_size(size_type value) { return compressed_size(value); }
 
 	size_type m_uncompressed;		// uncompressed size (w/o header)
+	size_type m_envelope;			// envelope size (0 for small values)
 };
 
 inline std::ostream& operator<< (std::ostream& out, const FullLocator& value)
 {
 	if (value.valid())
-		out << "<KVFullLocator block:" << value.block_id() << " offset:" << (int)value.offset() << " enveloped-size:" << value.full_size() << " compressed-size:" << value.compressed_size() << " contents-size:" << value.contents_size() << ">";
+		out << "<KVFullLocator block:" << value.block_id() << " offset:" << (int)value.offset() << " enveloped-size:" << value.full_size() << " compressed-size:" << value.compressed_size() << " contents-size:" << value.contents_size() << (value.isSmall() ? " small" : "") << ">";
 	else
 		out << "<KVFullLocator invalid>";
 	return out;
@@ -215,8 +260,8 @@ namespace milliways {
 class KeyValueStore
 {
 public:
-	static const uint32_t MAJOR_VERSION = 0;
-	static const uint32_t MINOR_VERSION = 1;
+	static const uint32_t MAJOR_VERSION = 1;
+	static const uint32_t MINOR_VERSION = 0;
 
 
 	static const size_t BLOCKSIZE = KV_BLOCKSIZE;
@@ -227,6 +272,8 @@ public:
 
 	static const size_t KEY_MAX_SIZE = 20;
 
+	static const size_t SMALL_VALUE_MAX_SIZE = KV_SMALL_VALUE_MAX_SIZE;
+
 	class kv_write_stream;
 	class kv_read_stream;
 
@@ -310,7 +357,7 @@ public:
 
 		const FullLocator& headLocator() const { return locator(); }
 		FullLocator& headLocator() { return locator(); }
-		kv_stream_sized_pos_t payloadLocator() const { size_t off = FullLocator::ENVELOPE_SIZE; kv_stream_sized_pos_t pl = locator().sizedLocator(); pl.delta(static_cast<offset_t>(off)); pl.shrink(off); return pl; }
+		kv_stream_sized_pos_t payloadLocator() const { return locator().payloadLocator(); }
 
 		kv_stream_pos_t headDataLocator() const { return headLocator().dataLocator(); }
 		kv_stream_pos_t payloadDataLocator() const { return payloadLocator().dataLocator(); }
@@ -329,8 +376,10 @@ public:
 
 		FullLocator& set_uncompressed(size_type contents_) { return m_full_loc.set_uncompressed(contents_); }
 		FullLocator& set_compressed(size_type compressed_, size_type contents_) { return m_full_loc.set_compressed(compressed_, contents_); }
+		FullLocator& set_small(size_type contents_) { return m_full_loc.set_small(contents_); }
 
 		bool isCompressed() const { return m_full_loc.isCompressed(); }
+		bool isSmall() const { return m_full_loc.isSmall(); }
 
 	private:
 		Search(const kv_tree_lookup_type& lookup_, const FullLocator& vl) :
@@ -346,6 +395,9 @@ public:
 	bool isOpen() const;
 	bool open();
 	bool close();
+	bool flush();						/* commit: make the changes visible to readers opening from now on */
+
+	bool readonly() const { assert(m_blockstorage); return m_blockstorage->readonly(); }
 
 	bool has(const std::string& key);
 	bool find(const std::string& key, Search& result);
@@ -359,6 +411,7 @@ public:
 	std::string get(const iterator& it) { std::string value; get(it, value); return value; }
 	bool put(const std::string& key, const std::string& value, bool overwrite = true);
 	bool rename(const std::string& old_key, const std::string& new_key);
+	bool remove(const std::string& key);		/* the value space is only reclaimed by compacting the store */
 
 	/* -- Iteration ------------------------------------------------ */
 
@@ -500,6 +553,8 @@ protected:
 	bool write_lz4(write_stream_t& ws, const char*& srcp, size_t nbytes, size_t& compressed_size) { return m_blockstorage->write_lz4(ws, srcp, nbytes, compressed_size); }
 	bool write_lz4(write_stream_t& ws, const std::string& src, size_t& compressed_size) { const char *srcp = src.data(); return write_lz4(ws, srcp, src.length(), compressed_size); }
 
+	bool put_small(const std::string& key, const std::string& value, Search& result, bool present);
+
 	bool alloc_space(kv_stream_sized_pos_t& dst, size_t amount);
 	bool extend_allocated_space(kv_stream_sized_pos_t& dst, size_t amount);
 	size_t size_in_blocks(size_t size);
@@ -150,6 +150,14 @@ inline KeyValueStore::KeyValueStore(block_storage_type* blockstorage) :
 	assert(B <= max_B);
 #endif
 
+	/* small value locators: 48-bit position, 14-bit length, flag in bit 62 */
+	static_assert(sizeof(kv_stream_pos_t::offset_t) >= sizeof(uint64_t), "small value locators need 64-bit stream offsets");
+	static_assert(KV_SMALL_LENGTH_SHIFT + 14 <= 62, "small value length overlaps the small flag");
+	static_assert(((KV_SMALL_LENGTH_MASK << KV_SMALL_LENGTH_SHIFT) & KV_SMALL_FLAG) == 0, "small value length overlaps the small flag");
+	static_assert((KV_SMALL_POS_MASK & (KV_SMALL_LENGTH_MASK << KV_SMALL_LENGTH_SHIFT)) == 0, "small value position overlaps the length");
+	static_assert(SMALL_VALUE_MAX_SIZE <= KV_SMALL_LENGTH_MASK, "small values must fit the 14-bit length field");
+	static_assert(SMALL_VALUE_MAX_SIZE < KV_COMPRESSION_MIN_LENGTH, "small values must never be compressed");
+
 	m_storage = new kv_tree_storage_type(m_blockstorage);
 	m_kv_tree = new kv_tree_type(m_storage);
 
@@ -192,9 +200,15 @@ inline bool KeyValueStore::open()
 	if (isOpen())
 		return true;
 	bool ok = m_kv_tree->open();
+	if (! ok)
+		return false;
 	if (m_kv_tree->storage()->created())
+	{
+		/* readers can't create the root: commit an empty one right away */
+		m_kv_tree->root();
 		header_write();
-	else
+		ok = flush();
+	} else
 		header_read();
 	return ok;
 }
@@ -208,6 +222,17 @@ inline bool KeyValueStore::close()
 	return m_kv_tree->close();
 }
 
+inline bool KeyValueStore::flush()
+{
+	assert(m_kv_tree);
+	if (! isOpen())
+		return false;
+	if (readonly())
+		return true;
+	header_write();
+	return m_kv_tree->flush();
+}
+
 inline bool KeyValueStore::has(const std::string& key)
 {
 	kv_stream_pos_t head_pos;
@@ -235,9 +260,20 @@ inline bool KeyValueStore::find(const std::string& key, Search& result)
 		MW_SHPTR<kv_tree_node_type> node( where.node() );
 		assert(node);
 
+		kv_stream_pos_t data_pos(node->value(where.pos()));
+		if (kv_small_pos_is_small(data_pos))
+		{
+			// small value: no envelope, the size is in the btree
+			result.dataLocator(kv_small_pos_decode(data_pos));
+			result.set_small(static_cast<kv_stream_sized_pos_t::size_type>(kv_small_pos_length(data_pos)));
+			assert(result.valid());
+			return true;
+		}
+
 		// we store only the position inside the btree
 		// so we need to read the size separately
-		result.dataLocator(node->value(where.pos()));
+		result.dataLocator(data_pos);
+		result.locator().set_enveloped();
 
 		result.full_size(0);
 		assert(result.locator().valid());
@@ -260,6 +296,9 @@ inline bool KeyValueStore::find(const std::string& key, Search& result)
 	 * value-length: (4 bytes) value length in bytes (serialized)
 	 * key: key data (key-length bytes)
 	 * value: value data (value-length bytes)
+	 *
+	 * Small values (up to SMALL_VALUE_MAX_SIZE bytes) are stored
+	 * as value data only, see put_small().
 	 */
 
 	/*
@@ -549,6 +588,11 @@ inline bool KeyValueStore::get(const iterator& it, std::string& value, ssize_t p
 
 inline bool KeyValueStore::rename(const std::string& old_key, const std::string& new_key)
 {
+	if (readonly())
+	{
+		std::cerr << "WARNING: can't rename keys in read-only store '" << m_blockstorage->pathname() << "'" << std::endl;
+		return false;
+	}
 	if ((old_key.length() > KEY_MAX_SIZE) || (new_key.length() > KEY_MAX_SIZE))
 		return false;
 
@@ -570,8 +614,27 @@ inline bool KeyValueStore::rename(const std::string& old_key, const std::string&
 	return true;
 }
 
+inline bool KeyValueStore::remove(const std::string& key)
+{
+	if (readonly())
+	{
+		std::cerr << "WARNING: can't remove keys from read-only store '" << m_blockstorage->pathname() << "'" << std::endl;
+		return false;
+	}
+	if (key.length() > KEY_MAX_SIZE)
+		return false;
+
+	kv_tree_lookup_type where;
+	return m_kv_tree->remove(where, key);
+}
+
 inline bool KeyValueStore::put(const std::string& key, const std::string& value, bool overwrite)
 {
+	if (readonly())
+	{
+		std::cerr << "WARNING: can't put values in read-only store '" << m_blockstorage->pathname() << "'" << std::endl;
+		return false;
+	}
 	if (key.length() > KEY_MAX_SIZE)
 		return false;
 	assert(key.length() <= KEY_MAX_SIZE);
@@ -594,9 +657,15 @@ inline bool KeyValueStore::put(const std::string& key, const std::string& value,
 
 		if (! overwrite)
 			return false;
+	}
 
+	if (value.length() <= SMALL_VALUE_MAX_SIZE)
+		return put_small(key, value, result, present);
+
+	if (present)
+	{
 		// TODO: handle allocation decision when using compression
-		if (do_compress)
+		if (do_compress || result.isSmall())
 			do_allocate = true;
 		else
 		{
@@ -711,7 +780,9 @@ inline bool KeyValueStore::put(const std::string& key, const std::string& value,
 		return false;
 	}
 
-	assert(do_compress || (ws.nwritten() == static_cast<size_t>(head_loc.size())));
+	/* overwriting in place, a shorter value leaves the tail of the old one unused */
+	assert(do_compress || (ws.nwritten() == (value.length() + FullLocator::ENVELOPE_SIZE)));
+	assert(ws.nwritten() <= static_cast<size_t>(head_loc.size()));
 
 	// -- update the key-value map --
 
@@ -735,6 +806,60 @@ inline bool KeyValueStore::put(const std::string& key, const std::string& value,
 	return ok;
 }
 
+inline bool KeyValueStore::put_small(const std::string& key, const std::string& value, Search& result, bool present)
+{
+	/*
+	 * Small values are written without envelope, packed one after the
+	 * other in the value blocks (alloc_space() never makes a small
+	 * allocation straddle two blocks). Their length is encoded in the
+	 * btree leaf entry together with the position, so that a lookup
+	 * needs only the btree descent and the read of the value block.
+	 */
+	assert(value.length() <= SMALL_VALUE_MAX_SIZE);
+
+	bool reuse = present && result.isSmall() && (result.contents_size() == value.length());
+
+	kv_stream_sized_pos_t loc;
+	if (reuse)
+		loc = result.payloadLocator();
+	else if (! alloc_space(loc, value.length()))
+		return false;
+
+	assert(loc.valid());
+	assert(loc.size() == value.length());
+
+	if (value.length() > 0)
+	{
+		write_stream_t ws(m_blockstorage, loc);
+		ws << value;
+		ws.flush();
+		if (ws.fail()) {
+			std::cerr << "WARNING: write FAILED" << std::endl;
+			assert(false);
+			return false;
+		}
+	}
+
+	if (reuse)
+		return true;
+
+	// -- update the key-value map --
+
+	kv_stream_pos_t data_pos(kv_small_pos_encode(loc.dataLocator(), value.length()));
+
+	assert(m_kv_tree);
+	if (present)
+	{
+		if (! m_kv_tree->update(key, data_pos))
+			return false;
+	} else
+	{
+		if (! m_kv_tree->insert(key, data_pos))
+			return false;
+	}
+	return true;
+}
+
 inline bool KeyValueStore::find(const std::string& key, kv_stream_pos_t& data_pos)
 {
 	assert(m_kv_tree);
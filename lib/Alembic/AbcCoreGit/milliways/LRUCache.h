@@ -87,6 +87,8 @@ public:
 
 	bool has(const key_type& key) const;
 	bool get(mapped_type& dst, const key_type& key);
+	/* like get(), but leaves the LRU order alone and never calls on_miss() */
+	bool peek(mapped_type& dst, const key_type& key) const;
 	bool set(const key_type& key, mapped_type& value);
 	bool del(key_type& key);
 
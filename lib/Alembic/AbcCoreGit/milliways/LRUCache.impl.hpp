@@ -84,6 +84,16 @@ bool LRUCache<SIZE, Key, T>::has(const key_type& key) const
 	return (m_key2age.count(key) > 0) ? true : false;
 }
 
+template <size_t SIZE, typename Key, typename T>
+bool LRUCache<SIZE, Key, T>::peek(mapped_type& dst, const key_type& key) const
+{
+	typename map_t::const_iterator m_it = m_cache.find(key);
+	if (m_it == m_cache.end())
+		return false;
+	dst = m_it->second;
+	return true;
+}
+
 template <size_t SIZE, typename Key, typename T>
 bool LRUCache<SIZE, Key, T>::get(mapped_type& dst, const key_type& key)
 {
@@ -0,0 +1,137 @@
+/*
+ * milliways - B+ trees and key-value store C++ library
+ *
+ * Author: Marco Pantaleoni <marco.pantaleoni@gmail.com>
+ * Copyright (C) 2016 Marco Pantaleoni. All rights reserved.
+ *
+ * Distributed under the Apache License, Version 2.0
+ * See the NOTICE file distributed with this work for
+ * additional information regarding copyright ownership.
+ * The author licenses this file to you under the Apache
+ * License, Version 2.0 (the "License"); you may not use
+ * this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef MILLIWAYS_SNAPSHOT_H
+#define MILLIWAYS_SNAPSHOT_H
+
+#include "config.h"
+
+#include <iostream>
+#include <string>
+#include <map>
+#include <set>
+
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+
+#if defined(HAVE_FCNTL_H) && defined(HAVE_UNISTD_H) && (! defined(_WIN32))
+	#define MILLIWAYS_SNAPSHOT_FCNTL_LOCKS 1
+#endif
+
+#if defined(COMPILER_SUPPORTS_CXX11)
+#include <mutex>
+#endif
+
+namespace milliways {
+
+/* ----------------------------------------------------------------- *
+ *   SnapshotLock                                                    *
+ * ----------------------------------------------------------------- */
+
+/*
+ * Coordinates the single writer and the snapshot readers of a store.
+ *
+ * Every reader pins the generation of the committed snapshot it is
+ * reading from; the writer only recycles blocks released by a commit
+ * once no reader is pinning an older generation.
+ *
+ * Pins and the writer slot live in a process-wide registry and, on
+ * POSIX systems, are also published as fcntl() byte-range locks on a
+ * "<pathname>.lock" side file so that other processes see them too:
+ *   byte 0             : writer (exclusive)
+ *   byte 1 + gen       : readers of generation 'gen' (shared)
+ * The side file is opened once per process and never by anything else,
+ * since closing any descriptor on a file drops all the fcntl() locks
+ * the process holds on it.
+ */
+class SnapshotLock
+{
+public:
+	typedef uint64_t generation_t;
+
+	SnapshotLock() :
+		m_pathname(), m_open(false), m_writer(false), m_pinned(false), m_pin() {}
+	~SnapshotLock() { close(); }
+
+	bool open(const std::string& pathname_);
+	void close();
+	bool isOpen() const { return m_open; }
+
+	const std::string& pathname() const { return m_pathname; }
+
+	/* -- Writer --------------------------------------------------- */
+
+	bool lockWriter();
+	void unlockWriter();
+	bool writer() const { return m_writer; }
+
+	/* -- Readers -------------------------------------------------- */
+
+	bool pin(generation_t generation);
+	void unpin();
+	bool pinned() const { return m_pinned; }
+	generation_t pinnedGeneration() const { return m_pin; }
+
+	/* oldest generation pinned by any reader, or 'limit' if none is older */
+	generation_t oldest(generation_t limit) const;
+
+private:
+	SnapshotLock(const SnapshotLock& other);
+	SnapshotLock& operator= (const SnapshotLock& other);
+
+	struct Entry
+	{
+		Entry() : fd(-1), refcnt(0), writer(false), pins() {}
+
+		int fd;
+		int refcnt;
+		bool writer;
+		std::multiset<generation_t> pins;
+	};
+
+	typedef std::map<std::string, Entry> registry_t;
+
+	static registry_t& registry();
+#if defined(COMPILER_SUPPORTS_CXX11)
+	static std::mutex& registry_mutex();
+#endif
+
+	enum lock_mode_t { lock_release, lock_shared, lock_exclusive };
+
+	static bool fd_lock(int fd, lock_mode_t mode, generation_t start, generation_t len);
+	static bool fd_test(int fd, generation_t start, generation_t len, generation_t& holder_start);
+
+	std::string m_pathname;
+	bool m_open;
+	bool m_writer;
+	bool m_pinned;
+	generation_t m_pin;
+};
+
+} /* end of namespace milliways */
+
+#include "Snapshot.impl.hpp"
+
+#endif /* MILLIWAYS_SNAPSHOT_H */
@@ -0,0 +1,276 @@
+/*
+ * milliways - B+ trees and key-value store C++ library
+ *
+ * Author: Marco Pantaleoni <marco.pantaleoni@gmail.com>
+ * Copyright (C) 2016 Marco Pantaleoni. All rights reserved.
+ *
+ * Distributed under the Apache License, Version 2.0
+ * See the NOTICE file distributed with this work for
+ * additional information regarding copyright ownership.
+ * The author licenses this file to you under the Apache
+ * License, Version 2.0 (the "License"); you may not use
+ * this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef MILLIWAYS_SNAPSHOT_H
+#include "Snapshot.h"
+#endif
+
+#if defined(MILLIWAYS_SNAPSHOT_FCNTL_LOCKS)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#endif
+
+#ifndef MILLIWAYS_SNAPSHOT_IMPL_H
+//#define MILLIWAYS_SNAPSHOT_IMPL_H
+
+namespace milliways {
+
+/* byte offset of the first reader pin in the lock file (byte 0 is the writer) */
+static const uint64_t SNAPSHOT_LOCK_PIN_BASE = 1;
+
+#if defined(COMPILER_SUPPORTS_CXX11)
+	#define MW_SNAPSHOT_REGISTRY_GUARD std::lock_guard<std::mutex> registry_guard_(registry_mutex())
+#else
+	#define MW_SNAPSHOT_REGISTRY_GUARD do { } while (0)
+#endif
+
+/* ----------------------------------------------------------------- *
+ *   SnapshotLock                                                    *
+ * ----------------------------------------------------------------- */
+
+inline SnapshotLock::registry_t& SnapshotLock::registry()
+{
+	static registry_t s_registry;
+	return s_registry;
+}
+
+#if defined(COMPILER_SUPPORTS_CXX11)
+inline std::mutex& SnapshotLock::registry_mutex()
+{
+	static std::mutex s_mutex;
+	return s_mutex;
+}
+#endif
+
+inline bool SnapshotLock::open(const std::string& pathname_)
+{
+	if (m_open)
+		return (pathname_ == m_pathname);
+
+	MW_SNAPSHOT_REGISTRY_GUARD;
+
+	Entry& entry = registry()[pathname_];
+	if (entry.refcnt == 0)
+	{
+#if defined(MILLIWAYS_SNAPSHOT_FCNTL_LOCKS)
+		std::string lock_pathname = pathname_ + ".lock";
+		entry.fd = ::open(lock_pathname.c_str(), O_RDWR | O_CREAT, 0666);
+		if (entry.fd < 0)
+			entry.fd = ::open(lock_pathname.c_str(), O_RDONLY);
+		if (entry.fd < 0)
+			std::cerr << "WARNING: can't open lock file '" << lock_pathname << "', snapshots are not protected from other processes" << std::endl;
+#endif
+	}
+	entry.refcnt++;
+
+	m_pathname = pathname_;
+	m_open = true;
+	return true;
+}
+
+inline void SnapshotLock::close()
+{
+	if (! m_open)
+		return;
+
+	unpin();
+	unlockWriter();
+
+	MW_SNAPSHOT_REGISTRY_GUARD;
+
+	registry_t::iterator it = registry().find(m_pathname);
+	assert(it != registry().end());
+	if (it != registry().end())
+	{
+		Entry& entry = it->second;
+		assert(entry.refcnt > 0);
+		if (--entry.refcnt == 0)
+		{
+#if defined(MILLIWAYS_SNAPSHOT_FCNTL_LOCKS)
+			if (entry.fd >= 0)
+				::close(entry.fd);
+#endif
+			registry().erase(it);
+		}
+	}
+
+	m_open = false;
+}
+
+/* -- Writer --------------------------------------------------- */
+
+inline bool SnapshotLock::lockWriter()
+{
+	assert(m_open);
+	if (m_writer)
+		return true;
+
+	MW_SNAPSHOT_REGISTRY_GUARD;
+
+	Entry& entry = registry()[m_pathname];
+	if (entry.writer)
+		return false;
+	if ((entry.fd >= 0) && (! fd_lock(entry.fd, lock_exclusive, 0, 1)))
+		return false;
+
+	entry.writer = true;
+	m_writer = true;
+	return true;
+}
+
+inline void SnapshotLock::unlockWriter()
+{
+	if (! m_writer)
+		return;
+
+	MW_SNAPSHOT_REGISTRY_GUARD;
+
+	Entry& entry = registry()[m_pathname];
+	assert(entry.writer);
+	if (entry.fd >= 0)
+		fd_lock(entry.fd, lock_release, 0, 1);
+	entry.writer = false;
+	m_writer = false;
+}
+
+/* -- Readers -------------------------------------------------- */
+
+inline bool SnapshotLock::pin(generation_t generation)
+{
+	assert(m_open);
+	assert(! m_pinned);
+
+	MW_SNAPSHOT_REGISTRY_GUARD;
+
+	Entry& entry = registry()[m_pathname];
+	if ((entry.pins.count(generation) == 0) && (entry.fd >= 0))
+	{
+		if (! fd_lock(entry.fd, lock_shared, SNAPSHOT_LOCK_PIN_BASE + generation, 1))
+			std::cerr << "WARNING: can't publish snapshot " << generation << " pin for '" << m_pathname << "'" << std::endl;
+	}
+	entry.pins.insert(generation);
+
+	m_pin = generation;
+	m_pinned = true;
+	return true;
+}
+
+inline void SnapshotLock::unpin()
+{
+	if (! m_pinned)
+		return;
+
+	MW_SNAPSHOT_REGISTRY_GUARD;
+
+	Entry& entry = registry()[m_pathname];
+	std::multiset<generation_t>::iterator it = entry.pins.find(m_pin);
+	assert(it != entry.pins.end());
+	if (it != entry.pins.end())
+		entry.pins.erase(it);
+	if ((entry.pins.count(m_pin) == 0) && (entry.fd >= 0))
+		fd_lock(entry.fd, lock_release, SNAPSHOT_LOCK_PIN_BASE + m_pin, 1);
+
+	m_pinned = false;
+}
+
+inline SnapshotLock::generation_t SnapshotLock::oldest(generation_t limit) const
+{
+	assert(m_open);
+
+	MW_SNAPSHOT_REGISTRY_GUARD;
+
+	generation_t oldest_ = limit;
+
+	Entry& entry = registry()[m_pathname];
+	if ((! entry.pins.empty()) && (*entry.pins.begin() < oldest_))
+		oldest_ = *entry.pins.begin();
+
+	/*
+	 * fcntl() reports one conflicting lock per query (not necessarily
+	 * the lowest one), so keep narrowing the range below it
+	 */
+	generation_t holder = 0;
+	while ((oldest_ > 0) && (entry.fd >= 0) &&
+		   fd_test(entry.fd, SNAPSHOT_LOCK_PIN_BASE, oldest_, holder))
+	{
+		assert(holder >= SNAPSHOT_LOCK_PIN_BASE);
+		assert((holder - SNAPSHOT_LOCK_PIN_BASE) < oldest_);
+		oldest_ = holder - SNAPSHOT_LOCK_PIN_BASE;
+	}
+
+	return oldest_;
+}
+
+/* -- fcntl() helpers ------------------------------------------ */
+
+inline bool SnapshotLock::fd_lock(int fd, lock_mode_t mode, generation_t start, generation_t len)
+{
+#if defined(MILLIWAYS_SNAPSHOT_FCNTL_LOCKS)
+	struct flock fl;
+	memset(&fl, 0, sizeof(fl));
+	switch (mode)
+	{
+	case lock_shared:    fl.l_type = F_RDLCK; break;
+	case lock_exclusive: fl.l_type = F_WRLCK; break;
+	default:             fl.l_type = F_UNLCK; break;
+	}
+	fl.l_whence = SEEK_SET;
+	fl.l_start = static_cast<off_t>(start);
+	fl.l_len = static_cast<off_t>(len);
+	return (fcntl(fd, F_SETLK, &fl) != -1);
+#else
+	(void)fd; (void)mode; (void)start; (void)len;
+	return true;
+#endif
+}
+
+inline bool SnapshotLock::fd_test(int fd, generation_t start, generation_t len, generation_t& holder_start)
+{
+#if defined(MILLIWAYS_SNAPSHOT_FCNTL_LOCKS)
+	struct flock fl;
+	memset(&fl, 0, sizeof(fl));
+	fl.l_type = F_WRLCK;
+	fl.l_whence = SEEK_SET;
+	fl.l_start = static_cast<off_t>(start);
+	fl.l_len = static_cast<off_t>(len);
+	if (fcntl(fd, F_GETLK, &fl) == -1)
+		return false;
+	if (fl.l_type == F_UNLCK)
+		return false;
+	/* the conflicting lock may start before the queried range */
+	holder_start = (static_cast<generation_t>(fl.l_start) > start) ? static_cast<generation_t>(fl.l_start) : start;
+	return true;
+#else
+	(void)fd; (void)start; (void)len; (void)holder_start;
+	return false;
+#endif
+}
+
+#undef MW_SNAPSHOT_REGISTRY_GUARD
+
+} /* end of namespace milliways */
+
+#endif /* MILLIWAYS_SNAPSHOT_IMPL_H */
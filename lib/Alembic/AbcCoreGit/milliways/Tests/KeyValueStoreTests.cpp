@@ -0,0 +1,194 @@
+/*
+ * milliways - B+ trees and key-value store C++ library
+ *
+ * Author: Marco Pantaleoni <marco.pantaleoni@gmail.com>
+ * Copyright (C) 2016 Marco Pantaleoni. All rights reserved.
+ *
+ * Distributed under the Apache License, Version 2.0
+ * See the NOTICE file distributed with this work for
+ * additional information regarding copyright ownership.
+ * The author licenses this file to you under the Apache
+ * License, Version 2.0 (the "License"); you may not use
+ * this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+#include "TestUtils.h"
+
+using namespace milliways;
+using namespace milliways::tests;
+
+static const size_t SMALL = KeyValueStore::SMALL_VALUE_MAX_SIZE;
+static const size_t LARGE = SMALL + 1500;							/* enveloped, uncompressed */
+static const size_t COMPRESSED = 3 * KeyValueStore::BLOCKSIZE;		/* enveloped, compressed */
+
+TEST_CASE( "small values are stored without envelope and read back", "[kv][small]" )
+{
+	std::string pathname = store_pathname("kv_small");
+	remove_store(pathname);
+
+	contents_type contents;
+	{
+		block_storage_type bs(pathname);
+		KeyValueStore kv(&bs);
+		REQUIRE( kv.open() );
+
+		/* every small length, including the boundaries */
+		for (size_t length = 1; length <= SMALL; length++)
+		{
+			std::string key = test_key(static_cast<int>(length));
+			contents[key] = test_value(static_cast<int>(length), length);
+			REQUIRE( kv.put(key, contents[key]) );
+		}
+		contents[test_key(0)] = test_value(0, LARGE);
+		REQUIRE( kv.put(test_key(0), contents[test_key(0)]) );
+
+		REQUIRE( kv.search(test_key(1)).isSmall() );
+		REQUIRE( kv.search(test_key(static_cast<int>(SMALL))).isSmall() );
+		REQUIRE( kv.search(test_key(static_cast<int>(SMALL))).contents_size() == SMALL );
+		REQUIRE( ! kv.search(test_key(0)).isSmall() );
+
+		REQUIRE( count_mismatches(kv, contents) == 0 );
+		REQUIRE( kv.close() );
+		bs.close();
+	}
+
+	REQUIRE( count_mismatches(pathname, contents) == 0 );
+	remove_store(pathname);
+}
+
+TEST_CASE( "overwriting values across the small / large boundary", "[kv][small][overwrite]" )
+{
+	std::string pathname = store_pathname("kv_overwrite");
+	remove_store(pathname);
+
+	/* (initial length, overwriting length) */
+	static const size_t transitions[][2] = {
+		{ 100, LARGE },					/* small -> large */
+		{ 100, COMPRESSED },			/* small -> compressed */
+		{ LARGE, 100 },					/* large -> small */
+		{ COMPRESSED, 100 },			/* compressed -> small */
+		{ LARGE, SMALL + 1 },			/* large -> shorter large, in place */
+		{ SMALL + 1, LARGE },			/* large -> longer large */
+		{ 100, 200 },					/* small -> other small */
+		{ 200, 200 },					/* small -> same size small, in place */
+		{ COMPRESSED, LARGE },			/* compressed -> large */
+	};
+	static const int n_transitions = static_cast<int>(sizeof(transitions) / sizeof(transitions[0]));
+
+	contents_type contents;
+	{
+		block_storage_type bs(pathname);
+		KeyValueStore kv(&bs);
+		REQUIRE( kv.open() );
+
+		for (int i = 0; i < n_transitions; i++)
+		{
+			contents[test_key(i)] = test_value(i, transitions[i][0], transitions[i][0] == COMPRESSED);
+			REQUIRE( kv.put(test_key(i), contents[test_key(i)]) );
+		}
+		REQUIRE( kv.flush() );
+
+		for (int i = 0; i < n_transitions; i++)
+		{
+			contents[test_key(i)] = test_value(i + 1000, transitions[i][1], transitions[i][1] == COMPRESSED);
+			REQUIRE( kv.put(test_key(i), contents[test_key(i)]) );
+			REQUIRE( kv.search(test_key(i)).isSmall() == (transitions[i][1] <= SMALL) );
+			REQUIRE( kv.get(test_key(i)) == contents[test_key(i)] );
+		}
+
+		REQUIRE( count_mismatches(kv, contents) == 0 );
+		REQUIRE( kv.close() );
+		bs.close();
+	}
+
+	REQUIRE( count_mismatches(pathname, contents) == 0 );
+	remove_store(pathname);
+}
+
+/* contents of testdata/kv-0.1.mw, written by the 0.1 key-value store (before the block map) */
+static const int LEGACY_N_KEYS = 60;
+
+static std::string legacy_value(int i)
+{
+	size_t length = (i % 10 == 0) ? 6000 : static_cast<size_t>((i * 37) % 700);
+	std::string value;
+	for (size_t j = 0; j < length; j++)
+		value.push_back(static_cast<char>('a' + ((static_cast<size_t>(i) * 7 + j) % 26)));
+	return value;
+}
+
+static contents_type legacy_contents()
+{
+	contents_type contents;
+	for (int i = 0; i < LEGACY_N_KEYS; i++)
+		contents[test_key(i)] = legacy_value(i);
+	return contents;
+}
+
+TEST_CASE( "pre-1.0 stores open for reading", "[kv][legacy]" )
+{
+	std::string pathname = store_pathname("kv_legacy_read");
+	remove_store(pathname);
+	REQUIRE( copy_file(std::string(MILLIWAYS_TEST_DATA_DIR) + "/kv-0.1.mw", pathname) );
+
+	contents_type contents = legacy_contents();
+	REQUIRE( count_mismatches(pathname, contents, /* readonly */ true) == 0 );
+	/* readers leave the file alone */
+	REQUIRE( count_mismatches(pathname, contents, /* readonly */ true) == 0 );
+
+	remove_store(pathname);
+}
+
+TEST_CASE( "pre-1.0 stores open for writing", "[kv][legacy]" )
+{
+	std::string pathname = store_pathname("kv_legacy_write");
+	remove_store(pathname);
+	REQUIRE( copy_file(std::string(MILLIWAYS_TEST_DATA_DIR) + "/kv-0.1.mw", pathname) );
+
+	contents_type contents = legacy_contents();
+	{
+		block_storage_type bs(pathname);
+		KeyValueStore kv(&bs);
+		REQUIRE( kv.open() );
+		REQUIRE( count_mismatches(kv, contents) == 0 );
+
+		/* new values of every kind next to the legacy ones */
+		for (int i = LEGACY_N_KEYS; i < LEGACY_N_KEYS + 30; i++)
+		{
+			size_t length = (i % 3 == 0) ? 50 : ((i % 3 == 1) ? LARGE : COMPRESSED);
+			contents[test_key(i)] = test_value(i, length, length == COMPRESSED);
+			REQUIRE( kv.put(test_key(i), contents[test_key(i)]) );
+		}
+		/* legacy (enveloped) small values becoming small ones, and the other way round */
+		contents[test_key(1)] = test_value(1, 20);
+		REQUIRE( kv.put(test_key(1), contents[test_key(1)]) );
+		contents[test_key(10)] = test_value(10, 30);
+		REQUIRE( kv.put(test_key(10), contents[test_key(10)]) );
+		contents[test_key(2)] = test_value(2, LARGE);
+		REQUIRE( kv.put(test_key(2), contents[test_key(2)]) );
+
+		REQUIRE( count_mismatches(kv, contents) == 0 );
+		REQUIRE( kv.close() );
+		bs.close();
+	}
+
+	REQUIRE( count_mismatches(pathname, contents, /* readonly */ true) == 0 );
+	/* and once more for writing, now that the file has been converted */
+	REQUIRE( count_mismatches(pathname, contents, /* readonly */ false) == 0 );
+	REQUIRE( count_mismatches(pathname, contents, /* readonly */ true) == 0 );
+
+	remove_store(pathname);
+}
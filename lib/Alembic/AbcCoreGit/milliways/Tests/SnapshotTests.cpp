@@ -0,0 +1,146 @@
+/*
+ * milliways - B+ trees and key-value store C++ library
+ *
+ * Author: Marco Pantaleoni <marco.pantaleoni@gmail.com>
+ * Copyright (C) 2016 Marco Pantaleoni. All rights reserved.
+ *
+ * Distributed under the Apache License, Version 2.0
+ * See the NOTICE file distributed with this work for
+ * additional information regarding copyright ownership.
+ * The author licenses this file to you under the Apache
+ * License, Version 2.0 (the "License"); you may not use
+ * this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+#include "TestUtils.h"
+
+using namespace milliways;
+using namespace milliways::tests;
+
+static const int N_KEYS = 1500;
+
+/* a mix of small, large and compressed values, different for each generation */
+static std::string generation_value(int i, int generation)
+{
+	int seed = i + generation * 100000;
+	switch (i % 4)
+	{
+	case 0:  return test_value(seed, 40 + (i % 400));
+	case 1:  return test_value(seed, KeyValueStore::SMALL_VALUE_MAX_SIZE + 100 + (i % 3000));
+	case 2:  return test_value(seed, 3 * KeyValueStore::BLOCKSIZE, /* compressible */ true);
+	default: return test_value(seed, 1 + (i % 100));
+	}
+}
+
+static void run_reader_isolation(bool wal)
+{
+	std::string pathname = store_pathname(wal ? "snapshot_wal" : "snapshot");
+	remove_store(pathname);
+
+	contents_type committed;
+	contents_type updated;
+	{
+		block_storage_type bs(pathname);
+		bs.wal(wal);
+		KeyValueStore kv(&bs);
+		REQUIRE( kv.open() );
+
+		for (int i = 0; i < N_KEYS; i++)
+		{
+			committed[test_key(i)] = generation_value(i, 0);
+			REQUIRE( kv.put(test_key(i), committed[test_key(i)]) );
+		}
+		REQUIRE( kv.flush() );
+
+		{
+			block_storage_type rbs(pathname, /* readonly */ true);
+			KeyValueStore rkv(&rbs);
+			REQUIRE( rkv.open() );
+			REQUIRE( count_mismatches(rkv, committed) == 0 );
+
+			/* the writer overwrites half of the values, adds new ones and commits, more than once */
+			updated = committed;
+			for (int i = 1; i < N_KEYS; i += 2)
+			{
+				updated[test_key(i)] = generation_value(i, 1);
+				REQUIRE( kv.put(test_key(i), updated[test_key(i)]) );
+			}
+			REQUIRE( kv.flush() );
+			for (int i = N_KEYS; i < 2 * N_KEYS; i++)
+			{
+				updated[test_key(i)] = generation_value(i, 1);
+				REQUIRE( kv.put(test_key(i), updated[test_key(i)]) );
+				if ((i % 500) == 0)
+					REQUIRE( kv.flush() );
+			}
+			REQUIRE( kv.flush() );
+			REQUIRE( count_mismatches(kv, updated) == 0 );
+
+			/* the reader still sees its own snapshot, and nothing newer */
+			REQUIRE( count_mismatches(rkv, committed) == 0 );
+			std::string value;
+			REQUIRE( ! rkv.get(test_key(N_KEYS), value) );
+			REQUIRE( ! rkv.get(test_key(2 * N_KEYS - 1), value) );
+
+			/* while a reader opened now sees the last commit */
+			REQUIRE( count_mismatches(pathname, updated) == 0 );
+
+			REQUIRE( rkv.close() );
+			rbs.close();
+		}
+
+		REQUIRE( kv.close() );
+		bs.close();
+	}
+
+	REQUIRE( count_mismatches(pathname, updated) == 0 );
+	remove_store(pathname);
+}
+
+TEST_CASE( "readers keep their snapshot while the writer commits", "[snapshot]" )
+{
+	run_reader_isolation(/* wal */ false);
+}
+
+TEST_CASE( "readers keep their snapshot while the writer commits through the log", "[snapshot][wal]" )
+{
+	run_reader_isolation(/* wal */ true);
+}
+
+TEST_CASE( "readers can search a store that was just created", "[snapshot]" )
+{
+	std::string pathname = store_pathname("snapshot_empty");
+	remove_store(pathname);
+
+	block_storage_type bs(pathname);
+	KeyValueStore kv(&bs);
+	REQUIRE( kv.open() );
+
+	{
+		block_storage_type rbs(pathname, /* readonly */ true);
+		KeyValueStore rkv(&rbs);
+		REQUIRE( rkv.open() );
+		std::string value;
+		REQUIRE( ! rkv.get(test_key(0), value) );
+		REQUIRE( rkv.close() );
+		rbs.close();
+	}
+
+	REQUIRE( kv.close() );
+	bs.close();
+	remove_store(pathname);
+}
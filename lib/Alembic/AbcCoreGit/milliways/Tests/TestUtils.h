@@ -0,0 +1,114 @@
+/*
+ * milliways - B+ trees and key-value store C++ library
+ *
+ * Author: Marco Pantaleoni <marco.pantaleoni@gmail.com>
+ * Copyright (C) 2016 Marco Pantaleoni. All rights reserved.
+ *
+ * Distributed under the Apache License, Version 2.0
+ * See the NOTICE file distributed with this work for
+ * additional information regarding copyright ownership.
+ * The author licenses this file to you under the Apache
+ * License, Version 2.0 (the "License"); you may not use
+ * this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef MILLIWAYS_TESTS_TESTUTILS_H
+#define MILLIWAYS_TESTS_TESTUTILS_H
+
+#include <string>
+#include <fstream>
+#include <map>
+
+#include <stdio.h>
+
+#include "KeyValueStore.h"
+
+namespace milliways {
+namespace tests {
+
+typedef KeyValueStore::block_storage_type block_storage_type;
+typedef std::map<std::string, std::string> contents_type;
+
+/* store files are created in the working directory (the build tree under ctest) */
+inline std::string store_pathname(const std::string& name)
+{
+	return std::string("milliways_") + name + ".mw";
+}
+
+inline void remove_store(const std::string& pathname)
+{
+	::remove(pathname.c_str());
+	::remove((pathname + ".wal").c_str());
+	::remove((pathname + ".lock").c_str());
+}
+
+inline bool copy_file(const std::string& src, const std::string& dst)
+{
+	std::ifstream in(src.c_str(), std::ios::binary);
+	std::ofstream out(dst.c_str(), std::ios::binary | std::ios::trunc);
+	if ((! in) || (! out))
+		return false;
+	out << in.rdbuf();
+	return out.good();
+}
+
+inline std::string test_key(int i)
+{
+	char buffer[32];
+	snprintf(buffer, sizeof(buffer), "key-%06d", i);
+	return std::string(buffer);
+}
+
+/* deterministic contents, compressible when 'compressible' is set */
+inline std::string test_value(int i, size_t length, bool compressible = false)
+{
+	std::string value(length, '\0');
+	uint32_t state = static_cast<uint32_t>(i) * 2654435761u + static_cast<uint32_t>(length);
+	for (size_t j = 0; j < length; j++)
+	{
+		state = state * 1103515245u + 12345u;
+		value[j] = compressible ? static_cast<char>('a' + ((static_cast<size_t>(i) * 7 + j) % 26)) : static_cast<char>(state >> 16);
+	}
+	return value;
+}
+
+/* number of entries of 'contents' missing or different in the store */
+inline int count_mismatches(KeyValueStore& kv, const contents_type& contents)
+{
+	int mismatches = 0;
+	for (contents_type::const_iterator it = contents.begin(); it != contents.end(); ++it)
+	{
+		std::string value;
+		if ((! kv.get(it->first, value)) || (value != it->second))
+			mismatches++;
+	}
+	return mismatches;
+}
+
+/* open the store at pathname (read-only or not) and compare it with 'contents' */
+inline int count_mismatches(const std::string& pathname, const contents_type& contents, bool readonly = true)
+{
+	block_storage_type bs(pathname, readonly);
+	KeyValueStore kv(&bs);
+	if (! kv.open())
+		return -1;
+	int mismatches = count_mismatches(kv, contents);
+	kv.close();
+	bs.close();
+	return mismatches;
+}
+
+} /* end of namespace tests */
+} /* end of namespace milliways */
+
+#endif /* MILLIWAYS_TESTS_TESTUTILS_H */
@@ -0,0 +1,155 @@
+/*
+ * milliways - B+ trees and key-value store C++ library
+ *
+ * Author: Marco Pantaleoni <marco.pantaleoni@gmail.com>
+ * Copyright (C) 2016 Marco Pantaleoni. All rights reserved.
+ *
+ * Distributed under the Apache License, Version 2.0
+ * See the NOTICE file distributed with this work for
+ * additional information regarding copyright ownership.
+ * The author licenses this file to you under the Apache
+ * License, Version 2.0 (the "License"); you may not use
+ * this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+#include "TestUtils.h"
+
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace milliways;
+using namespace milliways::tests;
+
+static const int N_COMMITTED = 2000;
+static const int N_UNCOMMITTED = 200;
+
+static std::string wal_value(int i)
+{
+	return test_value(i, static_cast<size_t>((i * 131) % 3000), (i % 3) == 0);
+}
+
+/* writes and commits in a child process that dies without closing the store */
+static bool crash_after_flush(const std::string& pathname)
+{
+	pid_t pid = fork();
+	if (pid < 0)
+		return false;
+	if (pid == 0)
+	{
+		block_storage_type bs(pathname);
+		bs.wal(true);
+		KeyValueStore kv(&bs);
+		if (! kv.open())
+			_exit(1);
+		for (int i = 0; i < N_COMMITTED; i++)
+			if (! kv.put(test_key(i), wal_value(i)))
+				_exit(1);
+		if (! kv.flush())
+			_exit(1);
+		for (int i = N_COMMITTED; i < N_COMMITTED + N_UNCOMMITTED; i++)
+			kv.put(test_key(i), wal_value(i));
+		_exit(0);
+	}
+
+	int status = 0;
+	if (waitpid(pid, &status, 0) != pid)
+		return false;
+	return WIFEXITED(status) && (WEXITSTATUS(status) == 0);
+}
+
+static int count_present(const std::string& pathname, int first, int last)
+{
+	block_storage_type bs(pathname, /* readonly */ true);
+	KeyValueStore kv(&bs);
+	if (! kv.open())
+		return -1;
+	int present = 0;
+	for (int i = first; i < last; i++)
+	{
+		std::string value;
+		if (kv.get(test_key(i), value))
+			present++;
+	}
+	kv.close();
+	bs.close();
+	return present;
+}
+
+TEST_CASE( "committed changes survive a crash after the flush", "[wal]" )
+{
+	std::string pathname = store_pathname("wal_crash");
+	remove_store(pathname);
+
+	REQUIRE( crash_after_flush(pathname) );
+
+	contents_type contents;
+	for (int i = 0; i < N_COMMITTED; i++)
+		contents[test_key(i)] = wal_value(i);
+
+	/* readers replay the log without touching the files */
+	REQUIRE( count_mismatches(pathname, contents, /* readonly */ true) == 0 );
+	REQUIRE( count_present(pathname, N_COMMITTED, N_COMMITTED + N_UNCOMMITTED) == 0 );
+
+	/* the next writer takes over the store and goes on from the recovered state */
+	{
+		block_storage_type bs(pathname);
+		bs.wal(true);
+		KeyValueStore kv(&bs);
+		REQUIRE( kv.open() );
+		REQUIRE( count_mismatches(kv, contents) == 0 );
+
+		for (int i = N_COMMITTED; i < N_COMMITTED + N_UNCOMMITTED; i++)
+		{
+			contents[test_key(i)] = test_value(i, 100);
+			REQUIRE( kv.put(test_key(i), contents[test_key(i)]) );
+		}
+		REQUIRE( kv.close() );
+		bs.close();
+	}
+
+	REQUIRE( count_mismatches(pathname, contents, /* readonly */ true) == 0 );
+	REQUIRE( count_mismatches(pathname, contents, /* readonly */ false) == 0 );
+	remove_store(pathname);
+}
+
+TEST_CASE( "a crash before any flush leaves an empty store", "[wal]" )
+{
+	std::string pathname = store_pathname("wal_crash_early");
+	remove_store(pathname);
+
+	pid_t pid = fork();
+	REQUIRE( pid >= 0 );
+	if (pid == 0)
+	{
+		block_storage_type bs(pathname);
+		bs.wal(true);
+		KeyValueStore kv(&bs);
+		if (! kv.open())
+			_exit(1);
+		for (int i = 0; i < N_UNCOMMITTED; i++)
+			kv.put(test_key(i), wal_value(i));
+		_exit(0);
+	}
+	int status = 0;
+	REQUIRE( waitpid(pid, &status, 0) == pid );
+	REQUIRE( WIFEXITED(status) );
+	REQUIRE( WEXITSTATUS(status) == 0 );
+
+	REQUIRE( count_present(pathname, 0, N_UNCOMMITTED) == 0 );
+	remove_store(pathname);
+}
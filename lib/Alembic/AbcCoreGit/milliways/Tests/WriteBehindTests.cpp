@@ -0,0 +1,227 @@
+/*
+ * milliways - B+ trees and key-value store C++ library
+ *
+ * Author: Marco Pantaleoni <marco.pantaleoni@gmail.com>
+ * Copyright (C) 2016 Marco Pantaleoni. All rights reserved.
+ *
+ * Distributed under the Apache License, Version 2.0
+ * See the NOTICE file distributed with this work for
+ * additional information regarding copyright ownership.
+ * The author licenses this file to you under the Apache
+ * License, Version 2.0 (the "License"); you may not use
+ * this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+#include "TestUtils.h"
+
+#include <algorithm>
+
+using namespace milliways;
+using namespace milliways::tests;
+
+static const size_t TEST_BLOCKSIZE = 256;
+
+typedef WriteBehind<TEST_BLOCKSIZE> write_behind_type;
+
+/* in-memory storage recording the batched writes of the flusher */
+class MemoryStorage : public BlockStorage<TEST_BLOCKSIZE>
+{
+public:
+	typedef BlockStorage<TEST_BLOCKSIZE> base_type;
+	typedef base_type::block_t block_t;
+
+	MemoryStorage() : base_type(), blocks(), n_batches(0), max_batch(0), unordered(false), fail(false) {}
+
+	bool isOpen() const { return true; }
+	bool flush() { return true; }
+	bool created() const { return false; }
+	bool openHelper() { return true; }
+	bool closeHelper() { return true; }
+	size_type count() { return blocks.size(); }
+
+	bool hasId(block_id_t block_id) { return blocks.count(block_id) != 0; }
+	block_id_t nextId() { return blocks.empty() ? 0 : (blocks.rbegin()->first + 1); }
+	block_id_t allocId(int /* n_blocks */) { return nextId(); }
+	block_id_t firstId() { return 0; }
+	bool dispose(block_id_t /* block_id */, int /* count */) { return true; }
+
+	bool read(block_t& /* dst */) { return false; }
+	bool write(block_t& /* src */) { return false; }
+	size_t read(size_t /* n */, const block_id_t* /* ids */, char* /* data */, std::vector<bool>& /* loaded */) { return 0; }
+	bool write(size_t n, const block_id_t* ids, const char* data)
+	{
+		if (fail)
+			return false;
+		n_batches++;
+		max_batch = std::max(max_batch, n);
+		for (size_t i = 0; i < n; i++)
+		{
+			if ((i > 0) && (ids[i] <= ids[i - 1]))
+				unordered = true;
+			blocks[ids[i]] = std::string(data + i * TEST_BLOCKSIZE, TEST_BLOCKSIZE);
+		}
+		return true;
+	}
+
+	std::map<block_id_t, std::string> blocks;
+	size_t n_batches;
+	size_t max_batch;
+	bool unordered;
+	bool fail;
+};
+
+static std::string block_data(block_id_t block_id, int generation)
+{
+	return test_value(static_cast<int>(block_id) + generation * 100000, TEST_BLOCKSIZE);
+}
+
+TEST_CASE( "stopping the flusher writes everything staged", "[write_behind]" )
+{
+	MemoryStorage storage;
+	write_behind_type wb(&storage, /* low */ 8, /* high */ 64);
+
+	static const block_id_t N_BLOCKS = 500;
+	std::map<block_id_t, std::string> expected;
+
+	/* staged out of order, some of them more than once */
+	for (block_id_t i = 0; i < N_BLOCKS; i++)
+	{
+		block_id_t block_id = (i * 7919) % N_BLOCKS;
+		expected[block_id] = block_data(block_id, 0);
+		REQUIRE( wb.stage(block_id, expected[block_id].data()) );
+	}
+	for (block_id_t block_id = 0; block_id < N_BLOCKS; block_id += 5)
+	{
+		expected[block_id] = block_data(block_id, 1);
+		REQUIRE( wb.stage(block_id, expected[block_id].data()) );
+	}
+
+	REQUIRE( wb.stop() );
+
+	REQUIRE( storage.blocks.size() == static_cast<size_t>(N_BLOCKS) );
+	REQUIRE( storage.blocks == expected );
+	REQUIRE( ! storage.unordered );
+	REQUIRE( storage.max_batch <= write_behind_type::BATCH_SIZE );
+
+	/* nothing left behind */
+	char data[TEST_BLOCKSIZE];
+	for (block_id_t block_id = 0; block_id < N_BLOCKS; block_id++)
+		REQUIRE( ! wb.staged(block_id, data) );
+
+	/* and the queue can be used again once stopped */
+	expected[3] = block_data(3, 2);
+	REQUIRE( wb.stage(3, expected[3].data()) );
+	REQUIRE( wb.stop() );
+	REQUIRE( storage.blocks == expected );
+}
+
+TEST_CASE( "staged copies are readable until written, and cancelled ones are never written", "[write_behind]" )
+{
+	MemoryStorage storage;
+	/* watermarks high enough that nothing is written before drain() */
+	write_behind_type wb(&storage, /* low */ 1000, /* high */ 1000);
+
+	std::string first = block_data(1, 0);
+	std::string second = block_data(2, 0);
+	REQUIRE( wb.stage(1, first.data()) );
+	REQUIRE( wb.stage(2, second.data()) );
+
+	char data[TEST_BLOCKSIZE];
+	REQUIRE( wb.staged(1, data) );
+	REQUIRE( std::string(data, TEST_BLOCKSIZE) == first );
+
+	wb.cancel(2, 2);
+	REQUIRE( ! wb.staged(2, data) );
+
+	REQUIRE( wb.stop() );
+	REQUIRE( storage.blocks.size() == 1 );
+	REQUIRE( storage.blocks[1] == first );
+}
+
+TEST_CASE( "write errors are reported by drain()", "[write_behind]" )
+{
+	MemoryStorage storage;
+	write_behind_type wb(&storage, /* low */ 8, /* high */ 64);
+
+	storage.fail = true;
+	for (block_id_t block_id = 0; block_id < 20; block_id++)
+		REQUIRE( wb.stage(block_id, block_data(block_id, 0).data()) );
+	REQUIRE( ! wb.drain() );
+
+	/* reported once */
+	storage.fail = false;
+	REQUIRE( wb.stage(0, block_data(0, 1).data()) );
+	REQUIRE( wb.stop() );
+	REQUIRE( storage.blocks[0] == block_data(0, 1) );
+}
+
+static void run_close_drains(bool wal)
+{
+	typedef block_storage_type::block_t block_t;
+	typedef block_storage_type::cache_t cache_t;
+
+	std::string pathname = store_pathname(wal ? "write_behind_wal" : "write_behind");
+	remove_store(pathname);
+
+	/* enough modified blocks to get the flusher going */
+	const block_id_t n_blocks = static_cast<block_id_t>(3 * cache_t::DIRTY_LOW_WATERMARK);
+	std::vector<block_id_t> ids;
+	{
+		block_storage_type bs(pathname);
+		bs.wal(wal);
+		REQUIRE( bs.open() );
+		for (block_id_t i = 0; i < n_blocks; i++)
+		{
+			block_id_t block_id = bs.allocId();
+			MW_SHPTR<block_t> block( bs.get(block_id) );
+			REQUIRE( block );
+			std::string data = test_value(static_cast<int>(block_id), block_t::BlockSize);
+			memcpy(block->data(), data.data(), data.size());
+			REQUIRE( bs.put(*block) );
+			ids.push_back(block_id);
+		}
+		/* no flush: close() has to wait for the flusher and commit */
+		REQUIRE( bs.close() );
+	}
+
+	{
+		block_storage_type bs(pathname, /* readonly */ true);
+		REQUIRE( bs.open() );
+		int mismatches = 0;
+		for (size_t i = 0; i < ids.size(); i++)
+		{
+			MW_SHPTR<block_t> block( bs.get(ids[i]) );
+			std::string data = test_value(static_cast<int>(ids[i]), block_t::BlockSize);
+			if ((! block) || (memcmp(block->data(), data.data(), data.size()) != 0))
+				mismatches++;
+		}
+		REQUIRE( mismatches == 0 );
+		bs.close();
+	}
+
+	remove_store(pathname);
+}
+
+TEST_CASE( "closing a store drains the flusher", "[write_behind]" )
+{
+	run_close_drains(/* wal */ false);
+}
+
+TEST_CASE( "closing a store drains the flusher into the log", "[write_behind][wal]" )
+{
+	run_close_drains(/* wal */ true);
+}
@@ -0,0 +1,166 @@
+/*
+ * milliways - B+ trees and key-value store C++ library
+ *
+ * Author: Marco Pantaleoni <marco.pantaleoni@gmail.com>
+ * Copyright (C) 2016 Marco Pantaleoni. All rights reserved.
+ *
+ * Distributed under the Apache License, Version 2.0
+ * See the NOTICE file distributed with this work for
+ * additional information regarding copyright ownership.
+ * The author licenses this file to you under the Apache
+ * License, Version 2.0 (the "License"); you may not use
+ * this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef MILLIWAYS_WRITEAHEADLOG_H
+#define MILLIWAYS_WRITEAHEADLOG_H
+
+#include "config.h"
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <map>
+
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+
+#if defined(HAVE_FCNTL_H) && defined(HAVE_UNISTD_H) && (! defined(_WIN32))
+	#define MILLIWAYS_WAL_FSYNC 1
+#endif
+
+namespace milliways {
+
+/* make the data written so far to 'pathname' durable (no-op where fsync() isn't available) */
+inline bool sync_pathname(const std::string& pathname);
+
+/* ----------------------------------------------------------------- *
+ *   WriteAheadLog                                                   *
+ * ----------------------------------------------------------------- */
+
+/*
+ * Sequential log of block images on top of a committed snapshot of a
+ * FileBlockStorage ("<pathname>.wal").
+ *
+ * The writer appends a record for every block it writes and for every
+ * disposal, and commit() closes the group of records appended since the
+ * previous commit with a commit record and a single fsync(). Records
+ * following the last commit record (a torn write, a crash before commit)
+ * are ignored on replay.
+ *
+ * The log applies to the snapshot of generation baseGeneration() only:
+ * a checkpoint copies the logged blocks into the main file, commits a
+ * new snapshot and then replaces the log with an empty one, atomically
+ * (rename), so that readers holding the previous log keep reading it.
+ *
+ * Layout:
+ *   header   : magic, version, block size, base generation, salt, checksum
+ *   'B'      : block id, block image (BLOCKSIZE bytes), checksum
+ *   'D'      : first block id, count, checksum
+ *   'C'      : number of logical blocks, sequence number, checksum
+ * Checksums are seeded with the salt of the log they belong to.
+ */
+template <size_t BLOCKSIZE>
+class WriteAheadLog
+{
+public:
+	static const int MAJOR_VERSION = 1;
+	static const int MINOR_VERSION = 0;
+	static const size_t HEADER_SIZE = 64;
+	static const size_t BLOCK_RECORD_SIZE = 3 * sizeof(uint32_t) + BLOCKSIZE;
+	static const size_t DISPOSE_RECORD_SIZE = 4 * sizeof(uint32_t);
+	static const size_t COMMIT_RECORD_SIZE = 3 * sizeof(uint32_t) + sizeof(uint64_t);
+
+	static const uint32_t RECORD_BLOCK = 'B';
+	static const uint32_t RECORD_DISPOSE = 'D';
+	static const uint32_t RECORD_COMMIT = 'C';
+
+	typedef uint32_t block_id_type;
+	typedef uint64_t generation_t;
+	typedef uint64_t offset_t;
+	typedef std::map<block_id_type, offset_t> index_t;	/* block id -> offset of its latest image */
+
+	WriteAheadLog() :
+		m_pathname(), m_stream(), m_readonly(true), m_base_generation(0), m_salt(0),
+		m_committed_end(0), m_end(0), m_sequence(0), m_sync_fd(-1) {}
+	~WriteAheadLog() { close(); }
+
+	/* open an existing log, false if there is none (or it isn't a valid log) */
+	bool open(const std::string& pathname_, bool readonly_);
+	/* (writer) replace any log at 'pathname_' with an empty one on top of 'base_generation' */
+	bool create(const std::string& pathname_, generation_t base_generation);
+	void close();
+	/* (writer) close and delete the log */
+	bool remove();
+
+	bool isOpen() const { return m_stream.is_open(); }
+	bool readonly() const { return m_readonly; }
+	const std::string& pathname() const { return m_pathname; }
+
+	generation_t baseGeneration() const { return m_base_generation; }
+
+	offset_t size() const { return m_end; }
+	/* bytes appended since the last commit */
+	offset_t pending() const { return m_end - m_committed_end; }
+
+	/*
+	 * rebuild the state left by the committed records: latest image of
+	 * every logged block, number of logical blocks and lowest disposed
+	 * block id ('floor', unchanged if nothing was disposed); false if
+	 * the log has no committed records (the writer drops the uncommitted
+	 * tail)
+	 */
+	bool replay(index_t& index, block_id_type& n_logical, block_id_type& floor);
+
+	/* -- Writer --------------------------------------------------- */
+
+	/* returns the offset of the block image, or 0 on error */
+	offset_t appendBlock(block_id_type block_id, const char* data);
+	bool appendDispose(block_id_type block_id, block_id_type count);
+	bool commit(block_id_type n_logical);
+
+	/* -- Reading -------------------------------------------------- */
+
+	bool readBlock(offset_t offset, char* dst);
+
+	static uint32_t checksum(uint32_t seed, const char* data, size_t size);
+
+protected:
+	bool open_stream(bool truncate);
+	bool read_header();
+	bool read_at(offset_t offset, char* dst, size_t size);
+	bool append(const char* data, size_t size);
+	bool truncate(offset_t size);
+
+private:
+	WriteAheadLog(const WriteAheadLog& other);
+	WriteAheadLog& operator= (const WriteAheadLog& other);
+
+	std::string m_pathname;
+	std::fstream m_stream;
+	bool m_readonly;
+	generation_t m_base_generation;
+	uint32_t m_salt;
+	offset_t m_committed_end;
+	offset_t m_end;
+	uint64_t m_sequence;
+	int m_sync_fd;
+};
+
+} /* end of namespace milliways */
+
+#include "WriteAheadLog.impl.hpp"
+
+#endif /* MILLIWAYS_WRITEAHEADLOG_H */
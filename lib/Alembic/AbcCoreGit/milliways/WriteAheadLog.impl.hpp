@@ -0,0 +1,483 @@
+/*
+ * milliways - B+ trees and key-value store C++ library
+ *
+ * Author: Marco Pantaleoni <marco.pantaleoni@gmail.com>
+ * Copyright (C) 2016 Marco Pantaleoni. All rights reserved.
+ *
+ * Distributed under the Apache License, Version 2.0
+ * See the NOTICE file distributed with this work for
+ * additional information regarding copyright ownership.
+ * The author licenses this file to you under the Apache
+ * License, Version 2.0 (the "License"); you may not use
+ * this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef MILLIWAYS_WRITEAHEADLOG_H
+#include "WriteAheadLog.h"
+#endif
+
+#include <stdio.h>
+#include <time.h>
+#include <errno.h>
+
+#if defined(MILLIWAYS_WAL_FSYNC)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#endif
+
+#include "Seriously.h"
+
+#ifndef MILLIWAYS_WRITEAHEADLOG_IMPL_H
+//#define MILLIWAYS_WRITEAHEADLOG_IMPL_H
+
+namespace milliways {
+
+static const char* const WAL_MAGIC = "MWWAL";
+
+inline bool sync_pathname(const std::string& pathname)
+{
+#if defined(MILLIWAYS_WAL_FSYNC)
+	int fd = ::open(pathname.c_str(), O_RDONLY);
+	if (fd < 0)
+		return false;
+	bool ok = (::fsync(fd) == 0);
+	::close(fd);
+	return ok;
+#else
+	(void)pathname;
+	return true;
+#endif
+}
+
+/* ----------------------------------------------------------------- *
+ *   WriteAheadLog                                                   *
+ * ----------------------------------------------------------------- */
+
+template <size_t BLOCKSIZE> const int WriteAheadLog<BLOCKSIZE>::MAJOR_VERSION;
+template <size_t BLOCKSIZE> const int WriteAheadLog<BLOCKSIZE>::MINOR_VERSION;
+template <size_t BLOCKSIZE> const size_t WriteAheadLog<BLOCKSIZE>::HEADER_SIZE;
+template <size_t BLOCKSIZE> const size_t WriteAheadLog<BLOCKSIZE>::BLOCK_RECORD_SIZE;
+template <size_t BLOCKSIZE> const size_t WriteAheadLog<BLOCKSIZE>::DISPOSE_RECORD_SIZE;
+template <size_t BLOCKSIZE> const size_t WriteAheadLog<BLOCKSIZE>::COMMIT_RECORD_SIZE;
+template <size_t BLOCKSIZE> const uint32_t WriteAheadLog<BLOCKSIZE>::RECORD_BLOCK;
+template <size_t BLOCKSIZE> const uint32_t WriteAheadLog<BLOCKSIZE>::RECORD_DISPOSE;
+template <size_t BLOCKSIZE> const uint32_t WriteAheadLog<BLOCKSIZE>::RECORD_COMMIT;
+
+template <size_t BLOCKSIZE>
+bool WriteAheadLog<BLOCKSIZE>::open(const std::string& pathname_, bool readonly_)
+{
+	close();
+
+	m_pathname = pathname_;
+	m_readonly = readonly_;
+
+	if (! open_stream(/* truncate */ false))
+		return false;
+	if (! read_header())
+	{
+		close();
+		return false;
+	}
+
+	m_stream.seekg(0, std::ios_base::end);
+	std::fstream::pos_type pos = m_stream.tellg();
+	if (pos == static_cast<std::fstream::pos_type>(-1))
+	{
+		close();
+		return false;
+	}
+	m_end = static_cast<offset_t>(pos);
+	m_committed_end = m_end;
+	return true;
+}
+
+template <size_t BLOCKSIZE>
+bool WriteAheadLog<BLOCKSIZE>::create(const std::string& pathname_, generation_t base_generation)
+{
+	close();
+
+	m_pathname = pathname_;
+	m_readonly = false;
+	m_base_generation = base_generation;
+	m_salt = static_cast<uint32_t>(base_generation) ^ static_cast<uint32_t>(time(NULL)) ^
+		static_cast<uint32_t>(reinterpret_cast<uintptr_t>(this));
+	m_sequence = 0;
+
+	seriously::Packer<HEADER_SIZE> packer;
+	packer << std::string(WAL_MAGIC) <<
+		static_cast<uint32_t>(MAJOR_VERSION) << static_cast<uint32_t>(MINOR_VERSION) <<
+		static_cast<uint32_t>(BLOCKSIZE) << static_cast<uint64_t>(m_base_generation) << m_salt;
+	packer << checksum(0, packer.data(), packer.size());
+	assert(! packer.error());
+
+	char header[HEADER_SIZE];
+	memset(header, 0, sizeof(header));
+	memcpy(header, packer.data(), packer.size());
+
+	/* build the new log aside and swap it in, readers of the old one keep their copy */
+	std::string final_pathname = m_pathname;
+	m_pathname = final_pathname + ".new";
+	bool ok = open_stream(/* truncate */ true) && append(header, HEADER_SIZE);
+	if (ok)
+	{
+		m_stream.flush();
+		ok = (! m_stream.fail()) && sync_pathname(m_pathname);
+	}
+	close();
+#if defined(_WIN32)
+	::remove(final_pathname.c_str());
+#endif
+	if (ok && (::rename((final_pathname + ".new").c_str(), final_pathname.c_str()) != 0))
+		ok = false;
+	m_pathname = final_pathname;
+	if (! ok)
+	{
+		std::cerr << "ERROR: can't create write-ahead log '" << final_pathname << "', error: " << strerror(errno) << std::endl;
+		return false;
+	}
+
+	if (! open_stream(/* truncate */ false))
+		return false;
+	m_end = HEADER_SIZE;
+	m_committed_end = m_end;
+	return true;
+}
+
+template <size_t BLOCKSIZE>
+void WriteAheadLog<BLOCKSIZE>::close()
+{
+	if (m_stream.is_open())
+		m_stream.close();
+#if defined(MILLIWAYS_WAL_FSYNC)
+	if (m_sync_fd >= 0)
+		::close(m_sync_fd);
+#endif
+	m_sync_fd = -1;
+	m_committed_end = 0;
+	m_end = 0;
+}
+
+template <size_t BLOCKSIZE>
+bool WriteAheadLog<BLOCKSIZE>::remove()
+{
+	assert(! m_readonly);
+	close();
+	if (m_pathname.empty())
+		return true;
+	if ((::remove(m_pathname.c_str()) != 0) && (errno != ENOENT))
+	{
+		std::cerr << "WARNING: can't remove write-ahead log '" << m_pathname << "', error: " << strerror(errno) << std::endl;
+		return false;
+	}
+	return true;
+}
+
+template <size_t BLOCKSIZE>
+bool WriteAheadLog<BLOCKSIZE>::replay(index_t& index, block_id_type& n_logical, block_id_type& floor)
+{
+	assert(isOpen());
+
+	/* effects of the records of the group being read, applied when its commit record is found */
+	index_t group_index;
+	std::vector< std::pair<block_id_type, block_id_type> > group_disposals;	/* (first id, count) */
+
+	bool committed = false;
+	offset_t pos = HEADER_SIZE;
+	offset_t committed_end = HEADER_SIZE;
+	char buffer[BLOCK_RECORD_SIZE];
+
+	while (true)
+	{
+		if (! read_at(pos, buffer, sizeof(uint32_t)))
+			break;
+		seriously::Packer<sizeof(uint32_t)> type_packer(buffer, sizeof(uint32_t));
+		uint32_t v_type = 0;
+		type_packer >> v_type;
+
+		size_t record_size = 0;
+		if (v_type == RECORD_BLOCK)
+			record_size = BLOCK_RECORD_SIZE;
+		else if (v_type == RECORD_DISPOSE)
+			record_size = DISPOSE_RECORD_SIZE;
+		else if (v_type == RECORD_COMMIT)
+			record_size = COMMIT_RECORD_SIZE;
+		else
+			break;
+
+		if (! read_at(pos, buffer, record_size))
+			break;
+
+		const char* sump = buffer + record_size - sizeof(uint32_t);
+		seriously::Packer<sizeof(uint32_t)> sum_packer(sump, sizeof(uint32_t));
+		uint32_t v_checksum = 0;
+		sum_packer >> v_checksum;
+		if (checksum(m_salt, buffer, record_size - sizeof(uint32_t)) != v_checksum)
+			break;
+
+		size_t fields_size = record_size - 2 * sizeof(uint32_t) - ((v_type == RECORD_BLOCK) ? BLOCKSIZE : 0);
+		seriously::Packer<2 * sizeof(uint32_t) + sizeof(uint64_t)> packer(buffer + sizeof(uint32_t), fields_size);
+		if (v_type == RECORD_BLOCK)
+		{
+			uint32_t v_block_id;
+			packer >> v_block_id;
+			group_index[static_cast<block_id_type>(v_block_id)] = pos + 2 * sizeof(uint32_t);
+		} else if (v_type == RECORD_DISPOSE)
+		{
+			uint32_t v_block_id, v_count;
+			packer >> v_block_id >> v_count;
+			/* disposals drop the images logged before them in the same group */
+			typename index_t::iterator it = group_index.lower_bound(static_cast<block_id_type>(v_block_id));
+			while ((it != group_index.end()) && (it->first < (v_block_id + v_count)))
+				group_index.erase(it++);
+			group_disposals.push_back(std::pair<block_id_type, block_id_type>(v_block_id, v_count));
+		} else
+		{
+			uint32_t v_n_logical;
+			uint64_t v_sequence;
+			packer >> v_n_logical >> v_sequence;
+
+			typename std::vector< std::pair<block_id_type, block_id_type> >::const_iterator dit;
+			for (dit = group_disposals.begin(); dit != group_disposals.end(); ++dit)
+			{
+				typename index_t::iterator it = index.lower_bound(dit->first);
+				while ((it != index.end()) && (it->first < (dit->first + dit->second)))
+					index.erase(it++);
+				if (dit->first < floor)
+					floor = dit->first;
+			}
+			typename index_t::const_iterator git;
+			for (git = group_index.begin(); git != group_index.end(); ++git)
+				index[git->first] = git->second;
+			group_index.clear();
+			group_disposals.clear();
+
+			n_logical = static_cast<block_id_type>(v_n_logical);
+			m_sequence = v_sequence + 1;
+			committed = true;
+			committed_end = pos + record_size;
+		}
+
+		pos += record_size;
+	}
+
+	m_committed_end = committed_end;
+	m_end = committed_end;
+	if ((! m_readonly) && (! truncate(committed_end)))
+		return false;
+	return committed;
+}
+
+/* -- Writer --------------------------------------------------- */
+
+template <size_t BLOCKSIZE>
+typename WriteAheadLog<BLOCKSIZE>::offset_t WriteAheadLog<BLOCKSIZE>::appendBlock(block_id_type block_id, const char* data)
+{
+	assert(isOpen() && (! m_readonly));
+
+	seriously::Packer<2 * sizeof(uint32_t)> packer;
+	packer << RECORD_BLOCK << static_cast<uint32_t>(block_id);
+	assert(! packer.error());
+
+	uint32_t sum = checksum(m_salt, packer.data(), packer.size());
+	sum = checksum(sum ^ 2166136261U, data, BLOCKSIZE);	/* chain, see checksum() */
+	seriously::Packer<sizeof(uint32_t)> sum_packer;
+	sum_packer << sum;
+
+	offset_t offset = m_end + packer.size();
+	if ((! append(packer.data(), packer.size())) || (! append(data, BLOCKSIZE)) ||
+		(! append(sum_packer.data(), sum_packer.size())))
+		return 0;
+	return offset;
+}
+
+template <size_t BLOCKSIZE>
+bool WriteAheadLog<BLOCKSIZE>::appendDispose(block_id_type block_id, block_id_type count)
+{
+	assert(isOpen() && (! m_readonly));
+
+	seriously::Packer<DISPOSE_RECORD_SIZE> packer;
+	packer << RECORD_DISPOSE << static_cast<uint32_t>(block_id) << static_cast<uint32_t>(count);
+	packer << checksum(m_salt, packer.data(), packer.size());
+	assert(! packer.error());
+	return append(packer.data(), packer.size());
+}
+
+template <size_t BLOCKSIZE>
+bool WriteAheadLog<BLOCKSIZE>::commit(block_id_type n_logical)
+{
+	assert(isOpen() && (! m_readonly));
+
+	seriously::Packer<COMMIT_RECORD_SIZE> packer;
+	packer << RECORD_COMMIT << static_cast<uint32_t>(n_logical) << static_cast<uint64_t>(m_sequence);
+	packer << checksum(m_salt, packer.data(), packer.size());
+	assert(! packer.error());
+	if (! append(packer.data(), packer.size()))
+		return false;
+
+	/* the whole group becomes durable with a single sync */
+	m_stream.flush();
+	if (m_stream.fail())
+	{
+		std::cerr << "ERROR: can't commit write-ahead log '" << m_pathname << "', error: " << strerror(errno) << std::endl;
+		m_stream.clear();
+		return false;
+	}
+#if defined(MILLIWAYS_WAL_FSYNC)
+	if ((m_sync_fd >= 0) && (::fsync(m_sync_fd) != 0))
+	{
+		std::cerr << "ERROR: can't sync write-ahead log '" << m_pathname << "', error: " << strerror(errno) << std::endl;
+		return false;
+	}
+#endif
+
+	m_sequence++;
+	m_committed_end = m_end;
+	return true;
+}
+
+/* -- Reading -------------------------------------------------- */
+
+template <size_t BLOCKSIZE>
+bool WriteAheadLog<BLOCKSIZE>::readBlock(offset_t offset, char* dst)
+{
+	assert(isOpen());
+	assert((offset >= HEADER_SIZE) && ((offset + BLOCKSIZE) <= m_end));
+	return read_at(offset, dst, BLOCKSIZE);
+}
+
+template <size_t BLOCKSIZE>
+uint32_t WriteAheadLog<BLOCKSIZE>::checksum(uint32_t seed, const char* data, size_t size)
+{
+	/* FNV-1a, offset basis mixed with 'seed' */
+	uint32_t hash = 2166136261U ^ seed;
+	for (size_t i = 0; i < size; i++)
+	{
+		hash ^= static_cast<uint8_t>(data[i]);
+		hash *= 16777619U;
+	}
+	return hash;
+}
+
+/* -- Helpers -------------------------------------------------- */
+
+template <size_t BLOCKSIZE>
+bool WriteAheadLog<BLOCKSIZE>::open_stream(bool truncate_)
+{
+	std::ios_base::openmode mode = std::fstream::binary | std::fstream::in;
+	if (! m_readonly)
+		mode |= std::fstream::out;
+	if (truncate_)
+		mode |= std::fstream::trunc;
+
+	m_stream.open(m_pathname.c_str(), mode);
+	if (! m_stream.is_open())
+		return false;
+
+#if defined(MILLIWAYS_WAL_FSYNC)
+	if (! m_readonly)
+	{
+		m_sync_fd = ::open(m_pathname.c_str(), O_WRONLY);
+		if (m_sync_fd < 0)
+			std::cerr << "WARNING: can't open '" << m_pathname << "' for syncing, commits won't be durable" << std::endl;
+	}
+#endif
+	return true;
+}
+
+template <size_t BLOCKSIZE>
+bool WriteAheadLog<BLOCKSIZE>::read_header()
+{
+	char header[HEADER_SIZE];
+	if (! read_at(0, header, HEADER_SIZE))
+		return false;
+
+	seriously::Packer<HEADER_SIZE> packer(header, HEADER_SIZE);
+	std::string v_magic;
+	uint32_t v_major, v_minor, v_blocksize, v_salt, v_checksum;
+	uint64_t v_base_generation;
+
+	packer >> v_magic;
+	if (packer.error() || (v_magic != WAL_MAGIC))
+		return false;
+	packer >> v_major >> v_minor >> v_blocksize >> v_base_generation >> v_salt >> v_checksum;
+	if (packer.error())
+		return false;
+
+	seriously::Packer<HEADER_SIZE> check;
+	check << v_magic << v_major << v_minor << v_blocksize << v_base_generation << v_salt;
+	if (checksum(0, check.data(), check.size()) != v_checksum)
+		return false;
+
+	if ((static_cast<int>(v_major) > MAJOR_VERSION) || (static_cast<size_t>(v_blocksize) != BLOCKSIZE))
+	{
+		std::cerr << "ERROR: write-ahead log '" << m_pathname << "' version or block size not supported (found:" <<
+			v_major << "." << v_minor << " blocksize:" << v_blocksize << ")" << std::endl;
+		return false;
+	}
+
+	m_base_generation = v_base_generation;
+	m_salt = v_salt;
+	m_sequence = 0;
+	return true;
+}
+
+template <size_t BLOCKSIZE>
+bool WriteAheadLog<BLOCKSIZE>::read_at(offset_t offset, char* dst, size_t size)
+{
+	m_stream.seekg(static_cast<std::streamoff>(offset));
+	m_stream.read(dst, static_cast<std::streamsize>(size));
+	if (m_stream.fail())
+	{
+		m_stream.clear();
+		return false;
+	}
+	return true;
+}
+
+template <size_t BLOCKSIZE>
+bool WriteAheadLog<BLOCKSIZE>::append(const char* data, size_t size)
+{
+	m_stream.seekp(static_cast<std::streamoff>(m_end));
+	m_stream.write(data, static_cast<std::streamsize>(size));
+	if (m_stream.fail())
+	{
+		std::cerr << "ERROR: can't append to write-ahead log '" << m_pathname << "', error: " << strerror(errno) << std::endl;
+		m_stream.clear();
+		return false;
+	}
+	m_end += size;
+	return true;
+}
+
+template <size_t BLOCKSIZE>
+bool WriteAheadLog<BLOCKSIZE>::truncate(offset_t size)
+{
+	/* drop a torn tail, so that new records don't follow garbage */
+#if defined(MILLIWAYS_WAL_FSYNC)
+	m_stream.flush();
+	if (::truncate(m_pathname.c_str(), static_cast<off_t>(size)) != 0)
+	{
+		std::cerr << "ERROR: can't truncate write-ahead log '" << m_pathname << "', error: " << strerror(errno) << std::endl;
+		return false;
+	}
+#else
+	(void)size;
+#endif
+	return true;
+}
+
+} /* end of namespace milliways */
+
+#endif /* MILLIWAYS_WRITEAHEADLOG_IMPL_H */
@@ -12,6 +12,7 @@
 #cmakedefine HAVE_STRING_H 1
 #cmakedefine HAVE_LIMITS_H 1
 #cmakedefine HAVE_ERRNO_H 1
+#cmakedefine HAVE_FCNTL_H 1
 #cmakedefine HAVE_ARPA_INET_H 1
 #cmakedefine HAVE_WINDOWS_H 1
 #cmakedefine HAVE_BASETSD_H 1
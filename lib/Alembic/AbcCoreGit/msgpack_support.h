@@ -505,6 +505,23 @@ struct MsgPackTraits<Stream, std::vector<int> >
 
 // packing
 
+/*
+ * msgpack output stream appending to a caller's std::string, which can then
+ * go to the object database as is (a std::stringstream would need its
+ * contents copied out with str() first)
+ */
+
+class MsgPackStringBuffer
+{
+public:
+    explicit MsgPackStringBuffer(std::string& str) : m_str(str) {}
+
+    void write(const char* buf, size_t len) { m_str.append(buf, len); }
+
+private:
+    std::string& m_str;
+};
+
 /*
  * template <typename Stream, typename T>
  *   bool mp_pack(msgpack::packer<Stream>& pk, const T& value);
@@ -575,6 +592,36 @@ inline bool mp_pack(msgpack::object::with_zone& pko, const Util::bool_t& value)
     return true;
 }
 
+// unpacking
+
+/*
+ * msgpack unpacker reading objects straight from a caller's buffer (e.g. the
+ * content of a git blob) instead of a copy of it, as msgpack::unpacker needs.
+ * The buffer must outlive the unpacked objects.
+ */
+
+class MsgPackBufferUnpacker
+{
+public:
+    MsgPackBufferUnpacker(const char* data, size_t size) :
+        m_data(data), m_size(size), m_offset(0) {}
+
+    bool next(msgpack::unpacked* msg)
+    {
+        if (m_offset >= m_size)
+            return false;
+        msgpack::unpack(msg, m_data, m_size, &m_offset);
+        return true;
+    }
+
+    size_t consumed() const { return m_offset; }
+
+private:
+    const char* m_data;
+    size_t m_size;
+    size_t m_offset;
+};
+
 /*
  * template <typename T>
  * bool mp_unpack(const msgpack::object& pko, T& value);
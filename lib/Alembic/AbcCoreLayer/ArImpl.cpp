@@ -37,13 +37,55 @@
 #include <Alembic/AbcCoreLayer/ArImpl.h>
 #include <Alembic/AbcCoreFactory/IFactory.h>
 #include <Alembic/AbcCoreLayer/OrImpl.h>
+#include <Alembic/AbcCoreLayer/FlatHierarchy.h>
+
+#if !defined(ALEMBIC_LIB_USES_TR1) && __cplusplus >= 201103L
+#include <atomic>
+#include <exception>
+#include <thread>
+#endif
 
 namespace Alembic {
 namespace AbcCoreLayer {
 namespace ALEMBIC_VERSION_NS {
 
+namespace {
+
+// getting the top object and its properties is where the layers do their
+// reading
+void ResolveTop( AbcA::ArchiveReaderPtr iArchive,
+                 AbcA::ObjectReaderPtr & oTop )
+{
+    oTop = iArchive->getTop();
+    oTop->getProperties();
+}
+
+#if !defined(ALEMBIC_LIB_USES_TR1) && __cplusplus >= 201103L
+// resolves the tops of the archives handed out by ioNext until there are
+// none left, the errors are kept to be rethrown on the calling thread
+void ResolveTops( const ArchiveReaderPtrs & iArchives,
+                  std::vector< AbcA::ObjectReaderPtr > & oTops,
+                  std::vector< std::exception_ptr > & oErrors,
+                  std::atomic< std::size_t > & ioNext )
+{
+    for ( std::size_t i = ioNext++; i < iArchives.size(); i = ioNext++ )
+    {
+        try
+        {
+            ResolveTop( iArchives[i], oTops[i] );
+        }
+        catch ( ... )
+        {
+            oErrors[i] = std::current_exception();
+        }
+    }
+}
+#endif
+
+} // End anonymous namespace
+
 //-*****************************************************************************
-ArImpl::ArImpl( ArchiveReaderPtrs & iArchives )
+ArImpl::ArImpl( ArchiveReaderPtrs & iArchives, bool iFlattenHierarchy )
 {
     m_archiveVersion = -1;
     m_header.reset( new AbcA::ObjectHeader() );
@@ -111,6 +153,46 @@ ArImpl::ArImpl( ArchiveReaderPtrs & iArchives )
         m_archiveVersion = std::max( m_archiveVersion,
                                      (*it)->getArchiveVersion() );
     }
+
+    // each layer is resolved on its own thread, so that opening them all
+    // takes about as long as the slowest one, the results stay in layer
+    // order
+    m_tops.resize( m_archives.size() );
+#if !defined(ALEMBIC_LIB_USES_TR1) && __cplusplus >= 201103L
+    std::vector< std::exception_ptr > errors( m_archives.size() );
+    std::atomic< std::size_t > next( 0 );
+    std::vector< std::thread > threads;
+    for ( std::size_t i = 1; i < m_archives.size(); ++i )
+    {
+        threads.push_back( std::thread( ResolveTops, std::cref( m_archives ),
+                                        std::ref( m_tops ),
+                                        std::ref( errors ),
+                                        std::ref( next ) ) );
+    }
+    ResolveTops( m_archives, m_tops, errors, next );
+    for ( std::size_t i = 0; i < threads.size(); ++i )
+    {
+        threads[i].join();
+    }
+
+    for ( std::size_t i = 0; i < errors.size(); ++i )
+    {
+        if ( errors[i] )
+        {
+            std::rethrow_exception( errors[i] );
+        }
+    }
+#else
+    for ( std::size_t i = 0; i < m_archives.size(); ++i )
+    {
+        ResolveTop( m_archives[i], m_tops[i] );
+    }
+#endif
+
+    if ( iFlattenHierarchy )
+    {
+        m_flat.reset( new FlatHierarchy( m_tops, m_header ) );
+    }
 }
 
 //-*****************************************************************************
@@ -134,16 +216,12 @@ const AbcA::MetaData & ArImpl::getMetaData() const
 //-*****************************************************************************
 AbcA::ObjectReaderPtr ArImpl::getTop()
 {
-
-    std::vector< AbcA::ObjectReaderPtr > tops;
-    tops.reserve( m_archives.size() );
-    ArchiveReaderPtrs::iterator arItr = m_archives.begin();
-    for ( ; arItr != m_archives.end(); ++arItr )
+    if ( m_flat )
     {
-        tops.push_back( (*arItr)->getTop() );
+        return OrImplPtr( new OrImpl( shared_from_this(), m_flat ) );
     }
 
-    return OrImplPtr( new OrImpl( shared_from_this(), tops, m_header ) );
+    return OrImplPtr( new OrImpl( shared_from_this(), m_tops, m_header ) );
 }
 
 //-*****************************************************************************
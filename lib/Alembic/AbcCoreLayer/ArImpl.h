@@ -54,7 +54,7 @@ class ArImpl
 private:
     friend class ReadArchive;
 
-    ArImpl( ArchiveReaderPtrs & iArchives );
+    ArImpl( ArchiveReaderPtrs & iArchives, bool iFlattenHierarchy=false );
 
 
 public:
@@ -90,14 +90,17 @@ private:
 
     ArchiveReaderPtrs m_archives;
 
+    // the top object of each archive, resolved when we are created
+    std::vector< AbcA::ObjectReaderPtr > m_tops;
+
     std::vector <  AbcA::TimeSamplingPtr > m_timeSamples;
     std::vector <  AbcA::index_t > m_maxSamples;
     ObjectHeaderPtr m_header;
 
     Util::int32_t m_archiveVersion;
 
-    // TODO, should we keep the top object (OrImplPtr) in a weak ptr
-    // or can we just rebuild it everytime getTop is called?
+    // only when the hierarchy is flattened up front
+    FlatHierarchyPtr m_flat;
 };
 
 } // End namespace ALEMBIC_VERSION_NS
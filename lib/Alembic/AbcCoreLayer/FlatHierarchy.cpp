@@ -0,0 +1,112 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2016,
+//  Sony Pictures Imageworks, Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#include <Alembic/AbcCoreLayer/FlatHierarchy.h>
+#include <Alembic/AbcCoreLayer/OrImpl.h>
+
+namespace Alembic {
+namespace AbcCoreLayer {
+namespace ALEMBIC_VERSION_NS {
+
+//-*****************************************************************************
+FlatHierarchy::FlatHierarchy(
+    const std::vector< AbcA::ObjectReaderPtr > & iTops,
+    ObjectHeaderPtr iHeader )
+{
+    m_nodes.resize( 1 );
+    m_nodes[0].header = iHeader;
+    m_nodes[0].objects = iTops;
+
+    // breadth first, so even very deep hierarchies don't recurse
+    for ( size_t n = 0; n < m_nodes.size(); ++n )
+    {
+        std::vector< ObjectHeaderPtr > childHeaders;
+        std::vector< std::vector< ObjectAndIndex > > children;
+        ChildNameMap childNameMap;
+        LayerChildren( m_nodes[n].objects, childHeaders, children,
+                       childNameMap );
+
+        m_nodes[n].children.reserve( children.size() );
+        for ( size_t i = 0; i < children.size(); ++i )
+        {
+            Node child;
+            child.header = childHeaders[i];
+            child.objects.reserve( children[i].size() );
+
+            std::vector< ObjectAndIndex >::iterator it = children[i].begin();
+            for ( ; it != children[i].end(); ++it )
+            {
+                child.objects.push_back( it->first->getChild( it->second ) );
+            }
+
+            Util::uint32_t nameId = m_nameIds.size();
+            nameId = m_nameIds.insert( std::make_pair(
+                child.header->getName(), nameId ) ).first->second;
+            m_childIndices[ childKey( n, nameId ) ] = i;
+
+            m_nodes[n].children.push_back( m_nodes.size() );
+            m_nodes.push_back( child );
+        }
+    }
+}
+
+//-*****************************************************************************
+bool FlatHierarchy::findChild( size_t iNode, const std::string & iName,
+                               size_t & oIndex ) const
+{
+    Alembic::Util::unordered_map< std::string, Util::uint32_t >::const_iterator
+        nameIt = m_nameIds.find( iName );
+
+    if ( nameIt == m_nameIds.end() )
+    {
+        return false;
+    }
+
+    Alembic::Util::unordered_map< Util::uint64_t, size_t >::const_iterator
+        childIt = m_childIndices.find( childKey( iNode, nameIt->second ) );
+
+    if ( childIt == m_childIndices.end() )
+    {
+        return false;
+    }
+
+    oIndex = childIt->second;
+    return true;
+}
+
+} // End namespace ALEMBIC_VERSION_NS
+} // End namespace AbcCoreLayer
+} // End namespace Alembic
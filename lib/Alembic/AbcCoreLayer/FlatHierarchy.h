@@ -0,0 +1,101 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2016,
+//  Sony Pictures Imageworks, Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#ifndef _Alembic_AbcCoreLayer_FlatHierarchy_h_
+#define _Alembic_AbcCoreLayer_FlatHierarchy_h_
+
+#include <Alembic/AbcCoreLayer/Foundation.h>
+
+namespace Alembic {
+namespace AbcCoreLayer {
+namespace ALEMBIC_VERSION_NS {
+
+//-*****************************************************************************
+// The whole layered object hierarchy, merged once when the archive is opened
+// so that creating an OrImpl doesn't have to layer its children again.
+// Every child name is interned once, and a child is looked up by the node of
+// its parent and the id of its name.
+class FlatHierarchy : private Alembic::Util::noncopyable
+{
+public:
+
+    struct Node
+    {
+        ObjectHeaderPtr header;
+
+        // the objects this one is layered from, in the order of the archives
+        std::vector< AbcA::ObjectReaderPtr > objects;
+
+        // the nodes of our children
+        std::vector< size_t > children;
+    };
+
+    FlatHierarchy( const std::vector< AbcA::ObjectReaderPtr > & iTops,
+                   ObjectHeaderPtr iHeader );
+
+    // node 0 is the top object
+    const Node & getNode( size_t iNode ) const { return m_nodes[iNode]; }
+
+    size_t getNumNodes() const { return m_nodes.size(); }
+
+    // finds the child called iName of iNode, and sets oIndex to its index
+    // amongst the children of iNode
+    bool findChild( size_t iNode, const std::string & iName,
+                    size_t & oIndex ) const;
+
+private:
+
+    Util::uint64_t childKey( size_t iNode, Util::uint32_t iNameId ) const
+    {
+        return ( ( Util::uint64_t ) iNode << 32 ) | iNameId;
+    }
+
+    std::vector< Node > m_nodes;
+
+    Alembic::Util::unordered_map< std::string, Util::uint32_t > m_nameIds;
+
+    // childKey -> index of the child amongst the children of the node
+    Alembic::Util::unordered_map< Util::uint64_t, size_t > m_childIndices;
+};
+
+} // End namespace ALEMBIC_VERSION_NS
+
+using namespace ALEMBIC_VERSION_NS;
+
+} // End namespace AbcCoreLayer
+} // End namespace Alembic
+
+#endif //_Alembic_AbcCoreLayer_FlatHierarchy_h_
@@ -56,6 +56,9 @@ typedef Alembic::Util::shared_ptr< OrImpl > OrImplPtr;
 
 typedef Alembic::Util::shared_ptr<AbcA::ObjectHeader> ObjectHeaderPtr;
 
+class FlatHierarchy;
+typedef Alembic::Util::shared_ptr< FlatHierarchy > FlatHierarchyPtr;
+
 class CprImpl;
 typedef Alembic::Util::shared_ptr< CprImpl > CprImplPtr;
 
@@ -36,6 +36,7 @@
 
 #include <Alembic/AbcCoreLayer/OrImpl.h>
 #include <Alembic/AbcCoreLayer/CprImpl.h>
+#include <Alembic/AbcCoreLayer/FlatHierarchy.h>
 #include <Alembic/Abc/ICompoundProperty.h>
 
 namespace Alembic {
@@ -56,18 +57,48 @@ OrImpl::OrImpl( ArImplPtr iArchive,
               , m_index( 0 )
               , m_archive( iArchive )
               , m_header( iHeader )
+              , m_node( 0 )
 {
     ABCA_ASSERT( m_archive, "Invalid archive in OrImpl(Archive)" );
     init( iTops );
 }
 
+OrImpl::OrImpl( ArImplPtr iArchive, FlatHierarchyPtr iFlat )
+              : m_parent( OrImplPtr() )
+              , m_index( 0 )
+              , m_archive( iArchive )
+              , m_flat( iFlat )
+              , m_node( 0 )
+{
+    ABCA_ASSERT( m_archive, "Invalid archive in OrImpl(Archive)" );
+    ABCA_ASSERT( m_flat, "Invalid hierarchy in OrImpl(Archive)" );
+
+    const FlatHierarchy::Node & node = m_flat->getNode( m_node );
+    m_header = node.header;
+    init( node.objects );
+}
+
 OrImpl::OrImpl( OrImplPtr iParent, size_t iIndex )
               : m_parent( iParent )
               , m_index( iIndex )
+              , m_node( 0 )
 {
     ABCA_ASSERT( m_parent, "Invalid object in OrImpl(OrImplPtr, size_t)" );
 
     m_archive = m_parent->m_archive;
+
+    // our children and objects were all gathered up front
+    if ( m_parent->m_flat )
+    {
+        m_flat = m_parent->m_flat;
+        m_node = m_flat->getNode( m_parent->m_node ).children[m_index];
+
+        const FlatHierarchy::Node & node = m_flat->getNode( m_node );
+        m_header = node.header;
+        init( node.objects );
+        return;
+    }
+
     m_header = m_parent->m_childHeaders[m_index];
 
     // get our objects for the init
@@ -118,21 +149,43 @@ AbcA::CompoundPropertyReaderPtr OrImpl::getProperties()
 //-*****************************************************************************
 size_t OrImpl::getNumChildren()
 {
+    if ( m_flat )
+    {
+        return m_flat->getNode( m_node ).children.size();
+    }
+
     return m_childHeaders.size();
 }
 
 //-*****************************************************************************
 const AbcA::ObjectHeader & OrImpl::getChildHeader( size_t i )
 {
-    ABCA_ASSERT( i < m_childHeaders.size(),
+    ABCA_ASSERT( i < getNumChildren(),
         "Out of range index in OrData::getChildHeader: " << i );
 
+    if ( m_flat )
+    {
+        return *( m_flat->getNode(
+            m_flat->getNode( m_node ).children[i] ).header );
+    }
+
     return *( m_childHeaders[i] );
 }
 
 //-*****************************************************************************
 const AbcA::ObjectHeader * OrImpl::getChildHeader( const std::string &iName )
 {
+    if ( m_flat )
+    {
+        size_t index = 0;
+        if ( m_flat->findChild( m_node, iName, index ) )
+        {
+            return &getChildHeader( index );
+        }
+
+        return 0;
+    }
+
     ChildNameMap::iterator findChildItr = m_childNameMap.find( iName );
 
     if( findChildItr != m_childNameMap.end() )
@@ -146,6 +199,17 @@ const AbcA::ObjectHeader * OrImpl::getChildHeader( const std::string &iName )
 //-*****************************************************************************
 AbcA::ObjectReaderPtr OrImpl::getChild( const std::string &iName )
 {
+    if ( m_flat )
+    {
+        size_t index = 0;
+        if ( m_flat->findChild( m_node, iName, index ) )
+        {
+            return OrImplPtr( new OrImpl( shared_from_this(), index ) );
+        }
+
+        return AbcA::ObjectReaderPtr();
+    }
+
     ChildNameMap::iterator findChildItr = m_childNameMap.find( iName );
 
     if( findChildItr != m_childNameMap.end() )
@@ -159,7 +223,7 @@ AbcA::ObjectReaderPtr OrImpl::getChild( const std::string &iName )
 
 AbcA::ObjectReaderPtr OrImpl::getChild( size_t i )
 {
-    if ( i < m_childHeaders.size() )
+    if ( i < getNumChildren() )
     {
         return OrImplPtr( new OrImpl( shared_from_this(), i ) );
     }
@@ -181,6 +245,17 @@ bool OrImpl::getPropertiesHash( Util::Digest & oDigest )
         return false;
     }
 
+    if ( m_flat )
+    {
+        const FlatHierarchy::Node & node = m_flat->getNode( m_node );
+        if ( node.objects.size() == 1 )
+        {
+            return node.objects[0]->getPropertiesHash( oDigest );
+        }
+
+        return false;
+    }
+
     const std::vector< ObjectAndIndex >  & childVec =
         m_parent->m_children[m_index];
 
@@ -201,6 +276,17 @@ bool OrImpl::getChildrenHash( Util::Digest & oDigest )
         return false;
     }
 
+    if ( m_flat )
+    {
+        const FlatHierarchy::Node & node = m_flat->getNode( m_node );
+        if ( node.objects.size() == 1 )
+        {
+            return node.objects[0]->getChildrenHash( oDigest );
+        }
+
+        return false;
+    }
+
     const std::vector< ObjectAndIndex >  & childVec =
         m_parent->m_children[m_index];
 
@@ -216,10 +302,10 @@ bool OrImpl::getChildrenHash( Util::Digest & oDigest )
 
 //-*****************************************************************************
 // This layers the children together, and creates
-void OrImpl::init( std::vector< AbcA::ObjectReaderPtr > & iObjects )
+void OrImpl::init( const std::vector< AbcA::ObjectReaderPtr > & iObjects )
 {
 
-    std::vector< AbcA::ObjectReaderPtr >::iterator it =
+    std::vector< AbcA::ObjectReaderPtr >::const_iterator it =
         iObjects.begin();
 
     m_properties.reserve( iObjects.size() );
@@ -227,6 +313,26 @@ void OrImpl::init( std::vector< AbcA::ObjectReaderPtr > & iObjects )
     for ( ; it != iObjects.end(); ++it )
     {
         m_properties.push_back( (*it)->getProperties() );
+    }
+
+    // the flattened hierarchy has already layered our children
+    if ( !m_flat )
+    {
+        LayerChildren( iObjects, m_childHeaders, m_children, m_childNameMap );
+    }
+}
+
+//-*****************************************************************************
+void LayerChildren( const std::vector< AbcA::ObjectReaderPtr > & iObjects,
+                    std::vector< ObjectHeaderPtr > & oChildHeaders,
+                    std::vector< std::vector< ObjectAndIndex > > & oChildren,
+                    ChildNameMap & oChildNameMap )
+{
+    std::vector< AbcA::ObjectReaderPtr >::const_iterator it =
+        iObjects.begin();
+
+    for ( ; it != iObjects.end(); ++it )
+    {
         for ( size_t i = 0; i < (*it)->getNumChildren(); ++i )
         {
             AbcA::ObjectHeader objHeader = (*it)->getChildHeader( i );
@@ -236,23 +342,23 @@ void OrImpl::init( std::vector< AbcA::ObjectReaderPtr > & iObjects )
             bool shouldReplace =
                 ( objHeader.getMetaData().get( "replace" ) == "1" );
 
-            ChildNameMap::iterator nameIt = m_childNameMap.find(
+            ChildNameMap::iterator nameIt = oChildNameMap.find(
                 objHeader.getName() );
 
             size_t index = 0;
 
             // brand new child, add it (if not pruning) and continue
-            if ( nameIt == m_childNameMap.end() )
+            if ( nameIt == oChildNameMap.end() )
             {
                 if ( !shouldPrune )
                 {
-                    index = m_childNameMap.size();
-                    m_childNameMap[ objHeader.getName() ] = index;
+                    index = oChildNameMap.size();
+                    oChildNameMap[ objHeader.getName() ] = index;
                     ObjectHeaderPtr headerPtr(
                         new AbcA::ObjectHeader( objHeader ) );
-                    m_childHeaders.push_back( headerPtr );
-                    m_children.resize( index + 1 );
-                    m_children[ index ].push_back( ObjectAndIndex( *it, i ) );
+                    oChildHeaders.push_back( headerPtr );
+                    oChildren.resize( index + 1 );
+                    oChildren[ index ].push_back( ObjectAndIndex( *it, i ) );
                 }
 
                 continue;
@@ -265,28 +371,28 @@ void OrImpl::init( std::vector< AbcA::ObjectReaderPtr > & iObjects )
             {
                 if ( shouldReplace )
                 {
-                    m_children[ index ].clear();
-                    m_childHeaders[ index ]->getMetaData() = AbcA::MetaData();
+                    oChildren[ index ].clear();
+                    oChildHeaders[ index ]->getMetaData() = AbcA::MetaData();
                 }
 
                 // add parent and index to the existing child element, and then
                 // update the MetaData
-                m_children[ index ].push_back( ObjectAndIndex( *it, i ) );
+                oChildren[ index ].push_back( ObjectAndIndex( *it, i ) );
 
                 // update the found childs meta data
-                m_childHeaders[ index ]->getMetaData().appendOnlyUnique(
+                oChildHeaders[ index ]->getMetaData().appendOnlyUnique(
                     objHeader.getMetaData() );
                 continue;
             }
 
             // prune, time to clear out existing data
-            m_children.erase( m_children.begin() + index );
-            m_childHeaders.erase( m_childHeaders.begin() + index );
-            m_childNameMap.erase( nameIt );
+            oChildren.erase( oChildren.begin() + index );
+            oChildHeaders.erase( oChildHeaders.begin() + index );
+            oChildNameMap.erase( nameIt );
 
             // since we removed an element, update the indices in our name map
-            for ( nameIt = m_childNameMap.begin();
-                  nameIt != m_childNameMap.end(); ++nameIt )
+            for ( nameIt = oChildNameMap.begin();
+                  nameIt != oChildNameMap.end(); ++nameIt )
             {
                 if ( nameIt->second > index )
                 {
@@ -58,6 +58,9 @@ public:
             std::vector< AbcA::ObjectReaderPtr > & iTops,
             ObjectHeaderPtr iHeader);
 
+    // the top object of a flattened hierarchy
+    OrImpl( ArImplPtr iArchive, FlatHierarchyPtr iFlat );
+
     OrImpl( OrImplPtr iParent, size_t iIndex );
 
     virtual ~OrImpl();
@@ -93,7 +96,7 @@ public:
 private:
 
     // builds up our data
-    void init( std::vector< AbcA::ObjectReaderPtr > & iObjects );
+    void init( const std::vector< AbcA::ObjectReaderPtr > & iObjects );
 
     // The parent object
     OrImplPtr m_parent;
@@ -118,8 +121,22 @@ private:
     std::vector< AbcA::CompoundPropertyReaderPtr > m_properties;
 
     ChildNameMap m_childNameMap;
+
+    // when the archive flattened its hierarchy our children come from our
+    // node in it, instead of m_childHeaders, m_children and m_childNameMap
+    FlatHierarchyPtr m_flat;
+    size_t m_node;
 };
 
+//-*****************************************************************************
+// Layers the children of iObjects together according to their prune and
+// replace MetaData, for each resulting child this gathers its header and the
+// objects (and the index of the child in them) that it is made up of
+void LayerChildren( const std::vector< AbcA::ObjectReaderPtr > & iObjects,
+                    std::vector< ObjectHeaderPtr > & oChildHeaders,
+                    std::vector< std::vector< ObjectAndIndex > > & oChildren,
+                    ChildNameMap & oChildNameMap );
+
 } // End namespace ALEMBIC_VERSION_NS
 
 using namespace ALEMBIC_VERSION_NS;
@@ -45,6 +45,13 @@ namespace ALEMBIC_VERSION_NS {
 //-*****************************************************************************
 ReadArchive::ReadArchive()
 {
+    m_flattenHierarchy = false;
+}
+
+//-*****************************************************************************
+ReadArchive::ReadArchive( bool iFlattenHierarchy )
+{
+    m_flattenHierarchy = iFlattenHierarchy;
 }
 
 //-*****************************************************************************
@@ -52,7 +59,7 @@ Alembic::AbcCoreAbstract::ArchiveReaderPtr
 ReadArchive::operator()( ArchiveReaderPtrs & iArchives ) const
 {
     AbcA::ArchiveReaderPtr archivePtr = Alembic::Util::shared_ptr<ArImpl>(
-        new ArImpl( iArchives ) );
+        new ArImpl( iArchives, m_flattenHierarchy ) );
 
     return archivePtr;
 }
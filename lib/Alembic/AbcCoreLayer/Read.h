@@ -53,9 +53,17 @@ class ALEMBIC_EXPORT ReadArchive
 public:
     ReadArchive();
 
+    // With iFlattenHierarchy the whole layered hierarchy is merged once when
+    // the archive is opened, instead of every time an object is read.
+    // Opening costs more, but walking the hierarchy again doesn't.
+    ReadArchive( bool iFlattenHierarchy );
+
     // open the file
     Alembic::AbcCoreAbstract::ArchiveReaderPtr
     operator()(ArchiveReaderPtrs & ) const;
+
+private:
+    bool m_flattenHierarchy;
 };
 
 } // End namespace ALEMBIC_VERSION_NS
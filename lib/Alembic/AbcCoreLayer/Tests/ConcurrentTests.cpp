@@ -0,0 +1,250 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2026,
+//  Sony Pictures Imageworks, Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#include <Alembic/Abc/All.h>
+#include <Alembic/AbcCoreLayer/Read.h>
+#include <Alembic/AbcCoreOgawa/All.h>
+#include <Alembic/AbcCoreFactory/All.h>
+
+#include <Alembic/AbcCoreAbstract/Tests/Assert.h>
+
+#include <sstream>
+#include <cstring>
+
+using namespace Alembic::Abc;
+
+static const int kNumLayers = 6;
+
+//-*****************************************************************************
+std::string layerName( int i )
+{
+    std::ostringstream name;
+    name << "concurrentLayer" << i << ".abc";
+    return name.str();
+}
+
+//-*****************************************************************************
+std::string indexedName( const std::string & iPrefix, int i )
+{
+    std::ostringstream name;
+    name << iPrefix << i;
+    return name.str();
+}
+
+//-*****************************************************************************
+// what layer i contributes: a child and a property under the shared object,
+// samples on the shared object and a hierarchy of its own
+void writeLayer( OObject & iShared, OCompoundProperty & iSharedProps,
+                 int i )
+{
+    OObject layerChild( iShared, indexedName( "layer", i ) );
+    OInt32ArrayProperty arrayProp( layerChild.getProperties(), "array" );
+    std::vector< Alembic::Util::int32_t > vals;
+    for ( int s = 0; s < 3; ++s )
+    {
+        vals.push_back( i * 100 + s );
+        arrayProp.set( Int32ArraySample( vals ) );
+    }
+
+    OInt32Property prop( iShared.getProperties(), indexedName( "p", i ) );
+    for ( int s = 0; s < 3; ++s )
+    {
+        prop.set( i * 10 + s );
+    }
+
+    OCompoundProperty layerProps( iSharedProps, indexedName( "c", i ) );
+    OInt32Property value( layerProps, "v" );
+    value.set( i );
+}
+
+//-*****************************************************************************
+// every layer on its own, and one archive with all of them merged, opening
+// that one is the serial reference
+void writeArchives()
+{
+    for ( int i = 0; i < kNumLayers; ++i )
+    {
+        OArchive archive( Alembic::AbcCoreOgawa::WriteArchive(),
+                          layerName( i ) );
+        OObject shared( archive.getTop(), "shared" );
+        OCompoundProperty sharedProps( archive.getTop().getProperties(),
+                                       "shared" );
+        writeLayer( shared, sharedProps, i );
+
+        OObject only( archive.getTop(), indexedName( "only", i ) );
+        OObject leaf( only, "leaf" );
+    }
+
+    OArchive archive( Alembic::AbcCoreOgawa::WriteArchive(),
+                      "concurrentMerged.abc" );
+    OObject shared( archive.getTop(), "shared" );
+    OCompoundProperty sharedProps( archive.getTop().getProperties(),
+                                   "shared" );
+    for ( int i = 0; i < kNumLayers; ++i )
+    {
+        writeLayer( shared, sharedProps, i );
+    }
+
+    for ( int i = 0; i < kNumLayers; ++i )
+    {
+        OObject only( archive.getTop(), indexedName( "only", i ) );
+        OObject leaf( only, "leaf" );
+    }
+}
+
+//-*****************************************************************************
+void compareProperties( ICompoundProperty iA, ICompoundProperty iB )
+{
+    TESTING_ASSERT( iA.getNumProperties() == iB.getNumProperties() );
+    for ( std::size_t i = 0; i < iA.getNumProperties(); ++i )
+    {
+        const PropertyHeader & header = iA.getPropertyHeader( i );
+        const PropertyHeader & bHeader = iB.getPropertyHeader( i );
+        TESTING_ASSERT( header.getName() == bHeader.getName() );
+        TESTING_ASSERT(
+            header.getPropertyType() == bHeader.getPropertyType() );
+
+        if ( header.isCompound() )
+        {
+            compareProperties( ICompoundProperty( iA, header.getName() ),
+                               ICompoundProperty( iB, header.getName() ) );
+        }
+        else if ( header.isScalar() )
+        {
+            IScalarProperty a( iA, header.getName() );
+            IScalarProperty b( iB, header.getName() );
+            TESTING_ASSERT( a.getNumSamples() == b.getNumSamples() );
+
+            std::size_t numBytes = a.getDataType().getNumBytes();
+            std::vector< char > aData( numBytes );
+            std::vector< char > bData( numBytes );
+            for ( std::size_t s = 0; s < a.getNumSamples(); ++s )
+            {
+                a.get( &aData.front(), ISampleSelector( ( index_t ) s ) );
+                b.get( &bData.front(), ISampleSelector( ( index_t ) s ) );
+                TESTING_ASSERT( aData == bData );
+            }
+        }
+        else
+        {
+            IArrayProperty a( iA, header.getName() );
+            IArrayProperty b( iB, header.getName() );
+            TESTING_ASSERT( a.getNumSamples() == b.getNumSamples() );
+
+            for ( std::size_t s = 0; s < a.getNumSamples(); ++s )
+            {
+                AbcA::ArraySamplePtr aSamp;
+                AbcA::ArraySamplePtr bSamp;
+                a.get( aSamp, ISampleSelector( ( index_t ) s ) );
+                b.get( bSamp, ISampleSelector( ( index_t ) s ) );
+                TESTING_ASSERT( aSamp->getDimensions().numPoints() ==
+                                bSamp->getDimensions().numPoints() );
+                TESTING_ASSERT( memcmp( aSamp->getData(), bSamp->getData(),
+                    aSamp->getDimensions().numPoints() *
+                    aSamp->getDataType().getNumBytes() ) == 0 );
+            }
+        }
+    }
+}
+
+//-*****************************************************************************
+void compareObjects( IObject iA, IObject iB )
+{
+    TESTING_ASSERT( iA.getFullName() == iB.getFullName() );
+    compareProperties( iA.getProperties(), iB.getProperties() );
+
+    TESTING_ASSERT( iA.getNumChildren() == iB.getNumChildren() );
+    for ( std::size_t i = 0; i < iA.getNumChildren(); ++i )
+    {
+        compareObjects( iA.getChild( i ), iB.getChild( i ) );
+    }
+}
+
+//-*****************************************************************************
+void concurrentTest( bool iFlatten )
+{
+    std::vector< std::string > files;
+    for ( int i = 0; i < kNumLayers; ++i )
+    {
+        files.push_back( layerName( i ) );
+    }
+
+    Alembic::AbcCoreFactory::IFactory factory;
+    factory.setLayerFlattenHierarchy( iFlatten );
+
+    // a single layer is opened and resolved on this thread
+    std::vector< std::string > mergedFiles( 1, "concurrentMerged.abc" );
+    IArchive merged = factory.getArchive( mergedFiles );
+    TESTING_ASSERT( merged.valid() );
+
+    IObject shared = merged.getTop().getChild( "shared" );
+    TESTING_ASSERT( shared.getNumChildren() == kNumLayers );
+    TESTING_ASSERT( shared.getProperties().getNumProperties() == kNumLayers );
+    TESTING_ASSERT( merged.getTop().getNumChildren() == kNumLayers + 1 );
+
+    // the layers opened one after the other on this thread
+    Alembic::AbcCoreLayer::ArchiveReaderPtrs readers;
+    for ( std::size_t i = 0; i < files.size(); ++i )
+    {
+        readers.push_back( factory.getArchive( files[i] ).getPtr() );
+    }
+    Alembic::AbcCoreLayer::ReadArchive layer( iFlatten );
+    IArchive serial( layer( readers ), kWrapExisting );
+
+    // opened again and again, so that the threads race differently
+    for ( int j = 0; j < 20; ++j )
+    {
+        IArchive archive = factory.getArchive( files );
+        TESTING_ASSERT( archive.valid() );
+        compareObjects( merged.getTop(), archive.getTop() );
+        compareObjects( serial.getTop(), archive.getTop() );
+    }
+
+    // a missing file is skipped the same way on every thread
+    std::vector< std::string > withMissing( files );
+    withMissing.insert( withMissing.begin() + 2, "concurrentMissing.abc" );
+    IArchive archive = factory.getArchive( withMissing );
+    compareObjects( merged.getTop(), archive.getTop() );
+}
+
+//-*****************************************************************************
+int main( int argc, char *argv[] )
+{
+    writeArchives();
+    concurrentTest( false );
+    concurrentTest( true );
+    return 0;
+}
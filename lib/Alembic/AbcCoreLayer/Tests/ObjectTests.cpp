@@ -45,7 +45,7 @@
 using namespace Alembic::Abc;
 
 //-*****************************************************************************
-void layerTest()
+void layerTest( bool iFlatten )
 {
     std::string fileName = "objectLayer1.abc";
     std::string fileName2 = "objectLayer2.abc";
@@ -75,6 +75,7 @@ void layerTest()
         files.push_back( fileName2 );
 
         Alembic::AbcCoreFactory::IFactory factory;
+        factory.setLayerFlattenHierarchy( iFlatten );
         IArchive archive = factory.getArchive( files );
 
         // child, childA, childB
@@ -102,7 +103,7 @@ void layerTest()
 }
 
 //-*****************************************************************************
-void pruneTest()
+void pruneTest( bool iFlatten )
 {
     std::string fileName = "objectPrune1.abc";
     std::string fileName2 = "objectPrune2.abc";
@@ -140,6 +141,7 @@ void pruneTest()
         files.push_back( fileName2 );
 
         Alembic::AbcCoreFactory::IFactory factory;
+        factory.setLayerFlattenHierarchy( iFlatten );
         IArchive archive = factory.getArchive( files );
 
         // child, childA, childB
@@ -156,7 +158,7 @@ void pruneTest()
 }
 
 //-*****************************************************************************
-void replaceTest()
+void replaceTest( bool iFlatten )
 {
     std::string fileName = "objectReplace1.abc";
     std::string fileName2 = "objectReplace2.abc";
@@ -203,6 +205,7 @@ void replaceTest()
         files.push_back( fileName2 );
 
         Alembic::AbcCoreFactory::IFactory factory;
+        factory.setLayerFlattenHierarchy( iFlatten );
         IArchive archive = factory.getArchive( files );
 
         IObject root = archive.getTop();
@@ -242,8 +245,11 @@ void replaceTest()
 //-*****************************************************************************
 int main( int argc, char *argv[] )
 {
-    layerTest();
-    pruneTest();
-    replaceTest();
+    layerTest( false );
+    layerTest( true );
+    pruneTest( false );
+    pruneTest( true );
+    replaceTest( false );
+    replaceTest( true );
     return 0;
 }
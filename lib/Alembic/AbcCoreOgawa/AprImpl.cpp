@@ -104,14 +104,35 @@ void AprImpl::getSample( index_t iSampleIndex, AbcA::ArraySamplePtr &oSample )
 {
     size_t index = m_header->verifyIndex( iSampleIndex ) * 2;
 
-    StreamIDPtr streamId = Alembic::Util::dynamic_pointer_cast< ArImpl,
-        AbcA::ArchiveReader > ( getObject()->getArchive() )->getStreamID();
+    Alembic::Util::shared_ptr< ArImpl > archive =
+        Alembic::Util::dynamic_pointer_cast< ArImpl, AbcA::ArchiveReader >(
+            getObject()->getArchive() );
+    StreamIDPtr streamId = archive->getStreamID();
 
     std::size_t id = streamId->getID();
     Ogawa::IDataPtr dims = m_group->getData(index + 1, id);
     Ogawa::IDataPtr data = m_group->getData(index, id);
 
-    ReadArraySample( dims, data, id, m_header->header.getDataType(), oSample );
+    const AbcA::DataType & dataType = m_header->header.getDataType();
+
+    AbcA::ReadArraySampleCachePtr cache =
+        archive->getReadArraySampleCachePtr();
+    AbcA::ArraySample::Key key;
+    if ( cache && ReadArraySampleCacheKey( dims, data, id, dataType, key ) )
+    {
+        AbcA::ReadArraySampleID found = cache->find( key );
+        if ( found )
+        {
+            oSample = found.getSample();
+            return;
+        }
+
+        ReadArraySample( dims, data, id, dataType, oSample );
+        oSample = cache->store( key, oSample ).getSample();
+        return;
+    }
+
+    ReadArraySample( dims, data, id, dataType, oSample );
 }
 
 //-*****************************************************************************
@@ -143,8 +143,10 @@ void ApwImpl::setSample( const AbcA::ArraySample & iSamp )
         ", does not match the DataType of the Array property: " <<
         m_header->header.getDataType() );
 
+    AbcA::ArchiveWriterPtr awp = this->getObject()->getArchive();
+
     // The Key helps us analyze the sample.
-     AbcA::ArraySample::Key key = iSamp.getKey();
+     AbcA::ArraySample::Key key = GetSampleKey( awp, iSamp );
 
      // mask out the non-string POD since Ogawa can safely share the same data
      // even if it originated from a different POD
@@ -179,8 +181,6 @@ void ApwImpl::setSample( const AbcA::ArraySample & iSamp )
 
         // Write this sample, which will update its internal
         // cache of what the previously written sample was.
-        AbcA::ArchiveWriterPtr awp = this->getObject()->getArchive();
-
         // Write the sample.
         // This distinguishes between string, wstring, and regular arrays.
         m_previousWrittenSampleID =
@@ -39,15 +39,141 @@
 #include <Alembic/AbcCoreOgawa/OrImpl.h>
 #include <Alembic/AbcCoreOgawa/ReadUtil.h>
 
+#if !defined(ALEMBIC_LIB_USES_TR1) && __cplusplus >= 201103L
+#include <atomic>
+#include <thread>
+#endif
+
 namespace Alembic {
 namespace AbcCoreOgawa {
 namespace ALEMBIC_VERSION_NS {
 
+//-*****************************************************************************
+namespace {
+
+// a group of an object or of a compound property whose headers are preloaded
+struct HeaderTask
+{
+    HeaderTask( Ogawa::IGroupPtr iGroup, const std::string & iName,
+                bool iIsObject )
+        : group( iGroup ), name( iName ), isObject( iIsObject ) {}
+
+    Ogawa::IGroupPtr group;
+
+    // the full name of the object, which its children headers need
+    std::string name;
+
+    bool isObject;
+};
+
+// one level of the hierarchy, the results are kept per task so that the
+// threads never write to the same place
+struct HeaderLevel
+{
+    void resize()
+    {
+        objectHeaders.resize( tasks.size() );
+        propertyHeaders.resize( tasks.size() );
+        next.resize( tasks.size() );
+    }
+
+    std::vector< HeaderTask > tasks;
+    std::vector< std::vector< ObjectHeaderPtr > > objectHeaders;
+    std::vector< PropertyHeaderPtrs > propertyHeaders;
+
+    // the groups of the next level found by each task
+    std::vector< std::vector< HeaderTask > > next;
+};
+
+#if !defined(ALEMBIC_LIB_USES_TR1) && __cplusplus >= 201103L
+typedef std::atomic< std::size_t > TaskCounter;
+#else
+typedef std::size_t TaskCounter;
+#endif
+
+// reads the headers of the tasks handed out by ioNext until there are none
+// left
+void ReadHeaderTasks( ArImpl & iArchive, HeaderLevel & ioLevel,
+                      TaskCounter & ioNext )
+{
+    StreamIDPtr streamId = iArchive.getStreamID();
+    std::size_t id = streamId->getID();
+
+    const std::vector< AbcA::MetaData > & indexedMetaData =
+        iArchive.getIndexedMetaData();
+
+    for ( std::size_t i = ioNext++; i < ioLevel.tasks.size(); i = ioNext++ )
+    {
+        Ogawa::IGroupPtr group = ioLevel.tasks[i].group;
+        std::vector< HeaderTask > & next = ioLevel.next[i];
+
+        std::size_t numChildren = group->getNumChildren();
+        if ( numChildren == 0 )
+        {
+            continue;
+        }
+
+        // the first child is the top compound property, then one group
+        // per child object, and finally the headers of those children
+        if ( ioLevel.tasks[i].isObject && group->isChildGroup( 0 ) )
+        {
+            next.push_back( HeaderTask( group->getGroup( 0, false, id ),
+                                        std::string(), false ) );
+        }
+
+        if ( !group->isChildData( numChildren - 1 ) )
+        {
+            continue;
+        }
+
+        if ( ioLevel.tasks[i].isObject )
+        {
+            std::vector< ObjectHeaderPtr > & headers =
+                ioLevel.objectHeaders[i];
+            ReadObjectHeaders( group, numChildren - 1, id,
+                               ioLevel.tasks[i].name, indexedMetaData,
+                               headers );
+
+            for ( std::size_t j = 0; j < headers.size(); ++j )
+            {
+                if ( group->isChildGroup( j + 1 ) )
+                {
+                    next.push_back( HeaderTask(
+                        group->getGroup( j + 1, false, id ),
+                        headers[j]->getFullName(), true ) );
+                }
+            }
+        }
+        // one group per property, and finally their headers
+        else
+        {
+            PropertyHeaderPtrs & headers = ioLevel.propertyHeaders[i];
+            ReadPropertyHeaders( group, numChildren - 1, id, iArchive,
+                                 indexedMetaData, headers );
+
+            for ( std::size_t j = 0; j < headers.size(); ++j )
+            {
+                if ( headers[j]->header.isCompound() &&
+                     group->isChildGroup( j ) )
+                {
+                    next.push_back( HeaderTask(
+                        group->getGroup( j, false, id ),
+                        std::string(), false ) );
+                }
+            }
+        }
+    }
+}
+
+}
+
 //-*****************************************************************************
 ArImpl::ArImpl( const std::string &iFileName,
-                std::size_t iNumStreams )
+                std::size_t iNumStreams,
+                bool iUseMMap,
+                bool iPreloadHeaders )
   : m_fileName( iFileName )
-  , m_archive( iFileName, iNumStreams )
+  , m_archive( iFileName, iNumStreams, iUseMMap )
   , m_header( new AbcA::ObjectHeader() )
   , m_manager( iNumStreams )
 {
@@ -58,6 +184,22 @@ ArImpl::ArImpl( const std::string &iFileName,
         "Ogawa file not cleanly closed while being written: " << m_fileName );
 
     init();
+
+    if ( iPreloadHeaders )
+    {
+        // without the mapping, threads beyond the streams would just wait
+        // on each other
+        std::size_t numThreads = 1;
+#if !defined(ALEMBIC_LIB_USES_TR1) && __cplusplus >= 201103L
+        numThreads = std::max( 1u, std::thread::hardware_concurrency() );
+#endif
+        if ( !iUseMMap )
+        {
+            numThreads = std::min( numThreads, iNumStreams );
+        }
+
+        preloadHeaders( numThreads );
+    }
 }
 
 //-*****************************************************************************
@@ -140,6 +282,107 @@ void ArImpl::init()
 
 }
 
+//-*****************************************************************************
+// Walks the whole hierarchy breadth first, reading every object and compound
+// property header with iNumThreads threads, so that creating the OrData and
+// CprData doesn't have to read anything.
+void ArImpl::preloadHeaders( std::size_t iNumThreads )
+{
+    HeaderLevel level;
+    level.tasks.push_back(
+        HeaderTask( m_archive.getGroup()->getGroup( 2, false, 0 ),
+                    std::string(), true ) );
+
+    while ( !level.tasks.empty() )
+    {
+        level.resize();
+
+#if !defined(ALEMBIC_LIB_USES_TR1) && __cplusplus >= 201103L
+        TaskCounter next( 0 );
+        std::vector< std::thread > threads;
+        std::size_t numThreads = std::min( iNumThreads, level.tasks.size() );
+        for ( std::size_t i = 1; i < numThreads; ++i )
+        {
+            threads.push_back( std::thread( ReadHeaderTasks,
+                                            std::ref( *this ),
+                                            std::ref( level ),
+                                            std::ref( next ) ) );
+        }
+        ReadHeaderTasks( *this, level, next );
+        for ( std::size_t i = 0; i < threads.size(); ++i )
+        {
+            threads[i].join();
+        }
+#else
+        TaskCounter next = 0;
+        ReadHeaderTasks( *this, level, next );
+#endif
+
+        m_objectHeaders.reserve( m_objectHeaders.size() +
+                                 level.tasks.size() );
+        m_propertyHeaders.reserve( m_propertyHeaders.size() +
+                                   level.tasks.size() );
+
+        HeaderLevel nextLevel;
+        for ( std::size_t i = 0; i < level.tasks.size(); ++i )
+        {
+            Util::uint64_t pos = level.tasks[i].group->getPos();
+            if ( level.tasks[i].isObject )
+            {
+                m_objectHeaders[pos].swap( level.objectHeaders[i] );
+            }
+            else
+            {
+                m_propertyHeaders[pos].swap( level.propertyHeaders[i] );
+            }
+
+            nextLevel.tasks.insert( nextLevel.tasks.end(),
+                                    level.next[i].begin(),
+                                    level.next[i].end() );
+        }
+
+        level.tasks.swap( nextLevel.tasks );
+        level.objectHeaders.clear();
+        level.propertyHeaders.clear();
+        level.next.clear();
+    }
+}
+
+//-*****************************************************************************
+bool ArImpl::getPreloadedHeaders( Ogawa::IGroupPtr iGroup,
+                                  std::vector< ObjectHeaderPtr > & oHeaders )
+    const
+{
+    Alembic::Util::unordered_map< Util::uint64_t,
+        std::vector< ObjectHeaderPtr > >::const_iterator it =
+        m_objectHeaders.find( iGroup->getPos() );
+
+    if ( it == m_objectHeaders.end() )
+    {
+        return false;
+    }
+
+    oHeaders = it->second;
+    return true;
+}
+
+//-*****************************************************************************
+bool ArImpl::getPreloadedHeaders( Ogawa::IGroupPtr iGroup,
+                                  PropertyHeaderPtrs & oHeaders ) const
+{
+    Alembic::Util::unordered_map< Util::uint64_t,
+        PropertyHeaderPtrs >::const_iterator it =
+        m_propertyHeaders.find( iGroup->getPos() );
+
+    if ( it == m_propertyHeaders.end() )
+    {
+        return false;
+    }
+
+    oHeaders = it->second;
+    return true;
+}
+
 //-*****************************************************************************
 const std::string &ArImpl::getName() const
 {
@@ -56,7 +56,9 @@ private:
     friend class ReadArchive;
 
     ArImpl( const std::string &iFileName,
-            size_t iNumStreams=1 );
+            size_t iNumStreams=1,
+            bool iUseMMap=false,
+            bool iPreloadHeaders=false );
 
     ArImpl( const std::vector< std::istream * > & iStreams );
 
@@ -79,12 +81,13 @@ public:
 
     virtual AbcA::ReadArraySampleCachePtr getReadArraySampleCachePtr()
     {
-        return AbcA::ReadArraySampleCachePtr();
+        return m_readArraySampleCache;
     }
 
     virtual void
     setReadArraySampleCachePtr( AbcA::ReadArraySampleCachePtr iPtr )
     {
+        m_readArraySampleCache = iPtr;
     }
 
     virtual AbcA::index_t getMaxNumSamplesForTimeSamplingIndex(
@@ -104,9 +107,20 @@ public:
 
     const std::vector< AbcA::MetaData > & getIndexedMetaData();
 
+    // The headers read up front when the archive was opened with
+    // iPreloadHeaders, looked up by the group they were read from.
+    // Returns false if they weren't.
+    bool getPreloadedHeaders( Ogawa::IGroupPtr iGroup,
+                              std::vector< ObjectHeaderPtr > & oHeaders ) const;
+
+    bool getPreloadedHeaders( Ogawa::IGroupPtr iGroup,
+                              PropertyHeaderPtrs & oHeaders ) const;
+
 private:
     void init();
 
+    void preloadHeaders( std::size_t iNumThreads );
+
     std::string m_fileName;
     size_t m_numStreams;
 
@@ -126,6 +140,15 @@ private:
     StreamManager m_manager;
 
     std::vector< AbcA::MetaData > m_indexMetaData;
+
+    // keyed by the position of the group, filled by preloadHeaders and
+    // only read from afterwards
+    Alembic::Util::unordered_map< Util::uint64_t,
+        std::vector< ObjectHeaderPtr > > m_objectHeaders;
+    Alembic::Util::unordered_map< Util::uint64_t,
+        PropertyHeaderPtrs > m_propertyHeaders;
+
+    AbcA::ReadArraySampleCachePtr m_readArraySampleCache;
 };
 
 } // End namespace ALEMBIC_VERSION_NS
@@ -45,11 +45,14 @@ namespace ALEMBIC_VERSION_NS {
 
 //-*****************************************************************************
 AwImpl::AwImpl( const std::string &iFileName,
-                const AbcA::MetaData &iMetaData )
+                const AbcA::MetaData &iMetaData,
+                bool iAsyncWrite,
+                std::size_t iNumHashThreads )
   : m_fileName( iFileName )
   , m_metaData( iMetaData )
-  , m_archive( iFileName )
+  , m_archive( iFileName, iAsyncWrite )
   , m_metaDataMap( new MetaDataMap() )
+  , m_numHashThreads( iNumHashThreads )
 {
 
     // add default time sampling
@@ -67,10 +70,13 @@ AwImpl::AwImpl( const std::string &iFileName,
 
 //-*****************************************************************************
 AwImpl::AwImpl( std::ostream * iStream,
-                const AbcA::MetaData &iMetaData )
+                const AbcA::MetaData &iMetaData,
+                bool iAsyncWrite,
+                std::size_t iNumHashThreads )
   : m_metaData( iMetaData )
-  , m_archive( iStream )
+  , m_archive( iStream, iAsyncWrite )
   , m_metaDataMap( new MetaDataMap() )
+  , m_numHashThreads( iNumHashThreads )
 {
     // add default time sampling
     AbcA::TimeSamplingPtr ts( new AbcA::TimeSampling() );
@@ -57,10 +57,14 @@ private:
     friend class WriteArchive;
 
     AwImpl( const std::string &iFileName,
-            const AbcA::MetaData &iMetaData );
+            const AbcA::MetaData &iMetaData,
+            bool iAsyncWrite,
+            std::size_t iNumHashThreads );
 
     AwImpl( std::ostream * iStream,
-            const AbcA::MetaData & iMetaData );
+            const AbcA::MetaData & iMetaData,
+            bool iAsyncWrite,
+            std::size_t iNumHashThreads );
 
 public:
     virtual ~AwImpl();
@@ -89,6 +93,11 @@ public:
         return m_metaDataMap;
     }
 
+    std::size_t getNumHashThreads() const
+    {
+        return m_numHashThreads;
+    }
+
     virtual Util::uint32_t addTimeSampling( const AbcA::TimeSampling & iTs );
 
     virtual AbcA::TimeSamplingPtr getTimeSampling( Util::uint32_t iIndex );
@@ -117,6 +126,7 @@ private:
 
     WrittenSampleMap m_writtenSampleMap;
     MetaDataMapPtr m_metaDataMap;
+    std::size_t m_numHashThreads;
 };
 
 } // End namespace ALEMBIC_VERSION_NS
@@ -62,8 +62,12 @@ CprData::CprData( Ogawa::IGroupPtr iGroup,
     if ( numChildren > 0 && m_group->isChildData( numChildren - 1 ) )
     {
         PropertyHeaderPtrs headers;
-        ReadPropertyHeaders( m_group, numChildren - 1, iThreadId,
-                             iArchive, iIndexedMetaData, headers );
+        ArImpl * archive = dynamic_cast< ArImpl * >( &iArchive );
+        if ( !archive || !archive->getPreloadedHeaders( m_group, headers ) )
+        {
+            ReadPropertyHeaders( m_group, numChildren - 1, iThreadId,
+                                 iArchive, iIndexedMetaData, headers );
+        }
 
         m_propertyHeaders = new SubProperty[ headers.size() ];
         for ( std::size_t i = 0; i < headers.size(); ++i )
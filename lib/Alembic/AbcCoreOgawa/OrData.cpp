@@ -39,6 +39,7 @@
 #include <Alembic/AbcCoreOgawa/CprData.h>
 #include <Alembic/AbcCoreOgawa/CprImpl.h>
 #include <Alembic/AbcCoreOgawa/ReadUtil.h>
+#include <Alembic/AbcCoreOgawa/ArImpl.h>
 
 namespace Alembic {
 namespace AbcCoreOgawa {
@@ -61,8 +62,12 @@ OrData::OrData( Ogawa::IGroupPtr iGroup,
     if ( numChildren > 0 && m_group->isChildData( numChildren - 1 ) )
     {
         std::vector< ObjectHeaderPtr > headers;
-        ReadObjectHeaders( m_group, numChildren - 1, iThreadId,
-                           iParentName, iIndexedMetaData, headers );
+        ArImpl * archive = dynamic_cast< ArImpl * >( &iArchive );
+        if ( !archive || !archive->getPreloadedHeaders( m_group, headers ) )
+        {
+            ReadObjectHeaders( m_group, numChildren - 1, iThreadId,
+                               iParentName, iIndexedMetaData, headers );
+        }
 
         if ( !headers.empty() )
         {
@@ -35,17 +35,7 @@
 //-*****************************************************************************
 
 #include <Alembic/AbcCoreOgawa/ReadUtil.h>
-
-#if defined(_MSC_VER)
-#  if defined(max)
-#    undef max
-#  endif
-#  if defined(min)
-#    undef min
-#  endif
-#endif
-
-#include <halfLimits.h>
+#include <Alembic/Util/ConvertPOD.h>
 
 namespace Alembic {
 namespace AbcCoreOgawa {
@@ -95,1218 +85,6 @@ ReadDimensions( Ogawa::IDataPtr iDims,
     }
 }
 
-//-*****************************************************************************
-template < typename FROMPOD >
-void ConvertToBool( char * fromBuffer, void * toBuffer, std::size_t iSize )
-{
-    std::size_t numConvert = iSize / sizeof( FROMPOD );
-
-    FROMPOD * fromPodBuffer = ( FROMPOD * ) ( fromBuffer );
-    Util::bool_t * toPodBuffer = (Util::bool_t *) ( toBuffer );
-
-    for ( std::size_t i = 0; i < numConvert; ++i )
-    {
-        Util::bool_t t = ( fromPodBuffer[i] != 0 );
-        toPodBuffer[i] = t;
-    }
-
-}
-
-//-*****************************************************************************
-template < typename TOPOD >
-void ConvertFromBool( char * fromBuffer, void * toBuffer, std::size_t iSize )
-{
-    // bool_t is stored as 1 bytes so iSize really is the size of the array
-
-    TOPOD * toPodBuffer = ( TOPOD * ) ( toBuffer );
-
-    // do it backwards so we don't accidentally clobber over ourself
-    for ( std::size_t i = iSize; i > 0; --i )
-    {
-        TOPOD t = static_cast< TOPOD >( fromBuffer[i-1] != 0 );
-        toPodBuffer[i-1] = t;
-    }
-
-}
-
-//-*****************************************************************************
-template < typename TOPOD >
-void getMinAndMax(TOPOD & iMin, TOPOD & iMax)
-{
-    iMin = std::numeric_limits<TOPOD>::min();
-    iMax = std::numeric_limits<TOPOD>::max();
-}
-
-//-*****************************************************************************
-template <>
-void getMinAndMax<Util::float16_t>(
-    Util::float16_t & iMin, Util::float16_t & iMax )
-{
-    iMax = std::numeric_limits<Util::float16_t>::max();
-    iMin = -iMax;
-}
-
-//-*****************************************************************************
-template <>
-void getMinAndMax<Util::float32_t>(
-    Util::float32_t & iMin, Util::float32_t & iMax )
-{
-    iMax = std::numeric_limits<Util::float32_t>::max();
-    iMin = -iMax;
-}
-
-//-*****************************************************************************
-template <>
-void getMinAndMax<Util::float64_t>(
-    Util::float64_t & iMin, Util::float64_t & iMax )
-{
-    iMax = std::numeric_limits<Util::float64_t>::max();
-    iMin = -iMax;
-}
-
-//-*****************************************************************************
-template < typename FROMPOD, typename TOPOD >
-void ConvertData( char * fromBuffer, void * toBuffer, std::size_t iSize )
-{
-    std::size_t numConvert = iSize / sizeof( FROMPOD );
-
-    FROMPOD * fromPodBuffer = ( FROMPOD * ) ( fromBuffer );
-    TOPOD * toPodBuffer = ( TOPOD * ) ( toBuffer );
-
-    if ( sizeof( FROMPOD ) > sizeof( TOPOD ) )
-    {
-        // get the min and max of the smaller TOPOD type
-        TOPOD toPodMin = 0;
-        TOPOD toPodMax = 0;
-        getMinAndMax< TOPOD >( toPodMin, toPodMax );
-
-        // cast it back into the larger FROMPOD
-        FROMPOD podMin = static_cast< FROMPOD >( toPodMin );
-        FROMPOD podMax = static_cast< FROMPOD >( toPodMax );
-
-        // handle from signed to unsigned wrap case
-        if ( podMin > podMax )
-        {
-            podMin = 0;
-        }
-
-        for ( std::size_t i = 0; i < numConvert; ++i )
-        {
-            FROMPOD f = fromPodBuffer[i];
-            if ( f < podMin )
-            {
-                f = podMin;
-            }
-            else if ( f > podMax )
-            {
-                f = podMax;
-            }
-            TOPOD t = static_cast< TOPOD >( f );
-            toPodBuffer[i] = t;
-        }
-    }
-    else
-    {
-        TOPOD toPodMin = 0;
-        TOPOD toPodMax = 0;
-        getMinAndMax< TOPOD >( toPodMin, toPodMax);
-
-        FROMPOD podMin = 0;
-        FROMPOD podMax = 0;
-        getMinAndMax< FROMPOD >( podMin, podMax);
-
-        if ( podMin != 0 && toPodMin == 0 )
-        {
-            podMin = 0;
-        }
-        // adjust max when converting to signed from unsigned of the same
-        // sized integral
-        else if ( podMin == 0 && toPodMin != 0 &&
-                  sizeof( FROMPOD ) == sizeof( TOPOD ) )
-        {
-            podMax = static_cast< FROMPOD >( toPodMax );
-        }
-
-        // do it backwards so we don't accidentally clobber over ourself
-        for ( std::size_t i = numConvert; i > 0; --i )
-        {
-            FROMPOD f = fromPodBuffer[i-1];
-            if ( f < podMin )
-            {
-                f = podMin;
-            }
-            else if ( f > podMax )
-            {
-                f = podMax;
-            }
-
-            TOPOD t = static_cast< TOPOD >( f );
-            toPodBuffer[i-1] = t;
-        }
-    }
-
-}
-
-//-*****************************************************************************
-void
-ConvertData( Alembic::Util::PlainOldDataType fromPod,
-             Alembic::Util::PlainOldDataType toPod,
-             char * fromBuffer,
-             void * toBuffer,
-             std::size_t iSize )
-{
-
-    switch (fromPod)
-    {
-        case Util::kBooleanPOD:
-        {
-            switch (toPod)
-            {
-                case Util::kUint8POD:
-                {
-                    ConvertFromBool< Util::uint8_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kInt8POD:
-                {
-                    ConvertFromBool< Util::int8_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kUint16POD:
-                {
-                    ConvertFromBool< Util::uint16_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kInt16POD:
-                {
-                    ConvertFromBool< Util::int16_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kUint32POD:
-                {
-                    ConvertFromBool< Util::uint32_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kInt32POD:
-                {
-                    ConvertFromBool< Util::int32_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kUint64POD:
-                {
-                    ConvertFromBool< Util::uint64_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kInt64POD:
-                {
-                    ConvertFromBool< Util::int64_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kFloat16POD:
-                {
-                    ConvertFromBool< Util::float16_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kFloat32POD:
-                {
-                    ConvertFromBool< Util::float32_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kFloat64POD:
-                {
-                    ConvertFromBool< Util::float64_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                default:
-                break;
-            }
-        }
-        break;
-
-        case Util::kUint8POD:
-        {
-            switch (toPod)
-            {
-                case Util::kBooleanPOD:
-                {
-                    ConvertToBool< Util::uint8_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kInt8POD:
-                {
-                    ConvertData< Util::uint8_t, Util::int8_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kUint16POD:
-                {
-                    ConvertData< Util::uint8_t, Util::uint16_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kInt16POD:
-                {
-                    ConvertData< Util::uint8_t, Util::int16_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kUint32POD:
-                {
-                    ConvertData< Util::uint8_t, Util::uint32_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kInt32POD:
-                {
-                    ConvertData< Util::uint8_t, Util::int32_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kUint64POD:
-                {
-                    ConvertData< Util::uint8_t, Util::uint64_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kInt64POD:
-                {
-                    ConvertData< Util::uint8_t, Util::int64_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kFloat16POD:
-                {
-                    ConvertData< Util::uint8_t, Util::float16_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kFloat32POD:
-                {
-                    ConvertData< Util::uint8_t, Util::float32_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kFloat64POD:
-                {
-                    ConvertData< Util::uint8_t, Util::float64_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                default:
-                break;
-            }
-        }
-        break;
-
-        case Util::kInt8POD:
-        {
-            switch (toPod)
-            {
-                case Util::kBooleanPOD:
-                {
-                    ConvertToBool< Util::int8_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kUint8POD:
-                {
-                    ConvertData< Util::int8_t, Util::uint8_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kUint16POD:
-                {
-                    ConvertData< Util::int8_t, Util::uint16_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kInt16POD:
-                {
-                    ConvertData< Util::int8_t, Util::int16_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kUint32POD:
-                {
-                    ConvertData< Util::int8_t, Util::uint32_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kInt32POD:
-                {
-                    ConvertData< Util::int8_t, Util::int32_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kUint64POD:
-                {
-                    ConvertData< Util::int8_t, Util::uint64_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kInt64POD:
-                {
-                    ConvertData< Util::int8_t, Util::int64_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kFloat16POD:
-                {
-                    ConvertData< Util::int8_t, Util::float16_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kFloat32POD:
-                {
-                    ConvertData< Util::int8_t, Util::float32_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kFloat64POD:
-                {
-                    ConvertData< Util::int8_t, Util::float64_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                default:
-                break;
-            }
-        }
-        break;
-
-        case Util::kUint16POD:
-        {
-            switch (toPod)
-            {
-                case Util::kBooleanPOD:
-                {
-                    ConvertToBool< Util::uint16_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kUint8POD:
-                {
-                    ConvertData< Util::uint16_t, Util::uint8_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kInt8POD:
-                {
-                    ConvertData< Util::uint16_t, Util::int8_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kInt16POD:
-                {
-                    ConvertData< Util::uint16_t, Util::int16_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kUint32POD:
-                {
-                    ConvertData< Util::uint16_t, Util::uint32_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kInt32POD:
-                {
-                    ConvertData< Util::uint16_t, Util::int32_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kUint64POD:
-                {
-                    ConvertData< Util::uint16_t, Util::uint64_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kInt64POD:
-                {
-                    ConvertData< Util::uint16_t, Util::int64_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kFloat16POD:
-                {
-                    ConvertData< Util::uint16_t, Util::float16_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kFloat32POD:
-                {
-                    ConvertData< Util::uint16_t, Util::float32_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kFloat64POD:
-                {
-                    ConvertData< Util::uint16_t, Util::float64_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                default:
-                break;
-            }
-        }
-        break;
-
-        case Util::kInt16POD:
-        {
-            switch (toPod)
-            {
-                case Util::kBooleanPOD:
-                {
-                    ConvertToBool< Util::int16_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kUint8POD:
-                {
-                    ConvertData< Util::int16_t, Util::uint8_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kInt8POD:
-                {
-                    ConvertData< Util::int16_t, Util::int8_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kUint16POD:
-                {
-                    ConvertData< Util::int16_t, Util::uint16_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kUint32POD:
-                {
-                    ConvertData< Util::int16_t, Util::uint32_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kInt32POD:
-                {
-                    ConvertData< Util::int16_t, Util::int32_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kUint64POD:
-                {
-                    ConvertData< Util::int16_t, Util::uint64_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kInt64POD:
-                {
-                    ConvertData< Util::int16_t, Util::int64_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kFloat16POD:
-                {
-                    ConvertData< Util::int16_t, Util::float16_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kFloat32POD:
-                {
-                    ConvertData< Util::int16_t, Util::float32_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kFloat64POD:
-                {
-                    ConvertData< Util::int16_t, Util::float64_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                default:
-                break;
-            }
-        }
-        break;
-
-        case Util::kUint32POD:
-        {
-            switch (toPod)
-            {
-                case Util::kBooleanPOD:
-                {
-                    ConvertToBool< Util::uint32_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kUint8POD:
-                {
-                    ConvertData< Util::uint32_t, Util::uint8_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kInt8POD:
-                {
-                    ConvertData< Util::uint32_t, Util::int8_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kUint16POD:
-                {
-                    ConvertData< Util::uint32_t, Util::uint16_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kInt16POD:
-                {
-                    ConvertData< Util::uint32_t, Util::int16_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kInt32POD:
-                {
-                    ConvertData< Util::uint32_t, Util::int32_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kUint64POD:
-                {
-                    ConvertData< Util::uint32_t, Util::uint64_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kInt64POD:
-                {
-                    ConvertData< Util::uint32_t, Util::int64_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kFloat16POD:
-                {
-                    ConvertData< Util::uint32_t, Util::float16_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kFloat32POD:
-                {
-                    ConvertData< Util::uint32_t, Util::float32_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kFloat64POD:
-                {
-                    ConvertData< Util::uint32_t, Util::float64_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                default:
-                break;
-            }
-        }
-        break;
-
-        case Util::kInt32POD:
-        {
-            switch (toPod)
-            {
-                case Util::kBooleanPOD:
-                {
-                    ConvertToBool< Util::int32_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kUint8POD:
-                {
-                    ConvertData< Util::int32_t, Util::uint8_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kInt8POD:
-                {
-                    ConvertData< Util::int32_t, Util::int8_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kUint16POD:
-                {
-                    ConvertData< Util::int32_t, Util::uint16_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kInt16POD:
-                {
-                    ConvertData< Util::int32_t, Util::int16_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kUint32POD:
-                {
-                    ConvertData< Util::int32_t, Util::uint32_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kUint64POD:
-                {
-                    ConvertData< Util::int32_t, Util::uint64_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kInt64POD:
-                {
-                    ConvertData< Util::int32_t, Util::int64_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kFloat16POD:
-                {
-                    ConvertData< Util::int32_t, Util::float16_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kFloat32POD:
-                {
-                    ConvertData< Util::int32_t, Util::float32_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kFloat64POD:
-                {
-                    ConvertData< Util::int32_t, Util::float64_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                default:
-                break;
-            }
-        }
-        break;
-
-        case Util::kUint64POD:
-        {
-            switch (toPod)
-            {
-                case Util::kBooleanPOD:
-                {
-                    ConvertToBool< Util::uint64_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kUint8POD:
-                {
-                    ConvertData< Util::uint64_t, Util::uint8_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kInt8POD:
-                {
-                    ConvertData< Util::uint64_t, Util::int8_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kUint16POD:
-                {
-                    ConvertData< Util::uint64_t, Util::uint16_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kInt16POD:
-                {
-                    ConvertData< Util::uint64_t, Util::int16_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kUint32POD:
-                {
-                    ConvertData< Util::uint64_t, Util::uint32_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kInt32POD:
-                {
-                    ConvertData< Util::uint64_t, Util::int32_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kInt64POD:
-                {
-                    ConvertData< Util::uint64_t, Util::int64_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kFloat16POD:
-                {
-                    ConvertData< Util::uint64_t, Util::float16_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kFloat32POD:
-                {
-                    ConvertData< Util::uint64_t, Util::float32_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kFloat64POD:
-                {
-                    ConvertData< Util::uint64_t, Util::float64_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                default:
-                break;
-            }
-        }
-        break;
-
-        case Util::kInt64POD:
-        {
-            switch (toPod)
-            {
-                case Util::kBooleanPOD:
-                {
-                    ConvertToBool<  Util::int64_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kUint8POD:
-                {
-                    ConvertData< Util::int64_t, Util::uint8_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kInt8POD:
-                {
-                    ConvertData< Util::int64_t, Util::int8_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kUint16POD:
-                {
-                    ConvertData< Util::int64_t, Util::uint16_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kInt16POD:
-                {
-                    ConvertData< Util::int64_t, Util::int16_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kUint32POD:
-                {
-                    ConvertData< Util::int64_t, Util::uint32_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kInt32POD:
-                {
-                    ConvertData< Util::int64_t, Util::int32_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kUint64POD:
-                {
-                    ConvertData< Util::int64_t, Util::uint64_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kFloat16POD:
-                {
-                    ConvertData< Util::int64_t, Util::float16_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kFloat32POD:
-                {
-                    ConvertData< Util::int64_t, Util::float32_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kFloat64POD:
-                {
-                    ConvertData< Util::int64_t, Util::float64_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                default:
-                break;
-            }
-        }
-        break;
-
-        case Util::kFloat16POD:
-        {
-            switch (toPod)
-            {
-                case Util::kBooleanPOD:
-                {
-                    ConvertToBool< Util::float16_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kUint8POD:
-                {
-                    ConvertData< Util::float16_t, Util::uint8_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kInt8POD:
-                {
-                    ConvertData< Util::float16_t, Util::int8_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kUint16POD:
-                {
-                    ConvertData< Util::float16_t, Util::uint16_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kInt16POD:
-                {
-                    ConvertData< Util::float16_t, Util::int16_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kUint32POD:
-                {
-                    ConvertData< Util::float16_t, Util::uint32_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kInt32POD:
-                {
-                    ConvertData< Util::float16_t, Util::int32_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kUint64POD:
-                {
-                    ConvertData< Util::float16_t, Util::uint64_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kInt64POD:
-                {
-                    ConvertData< Util::float16_t, Util::int64_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kFloat32POD:
-                {
-                    ConvertData< Util::float16_t, Util::float32_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kFloat64POD:
-                {
-                    ConvertData< Util::float16_t, Util::float64_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                default:
-                break;
-            }
-        }
-        break;
-
-        case Util::kFloat32POD:
-        {
-            switch (toPod)
-            {
-                case Util::kBooleanPOD:
-                {
-                    ConvertToBool< Util::float32_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kUint8POD:
-                {
-                    ConvertData< Util::float32_t, Util::uint8_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kInt8POD:
-                {
-                    ConvertData< Util::float32_t, Util::int8_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kUint16POD:
-                {
-                    ConvertData< Util::float32_t, Util::uint16_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kInt16POD:
-                {
-                    ConvertData< Util::float32_t, Util::int16_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kUint32POD:
-                {
-                    ConvertData< Util::float32_t, Util::uint32_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kInt32POD:
-                {
-                    ConvertData< Util::float32_t, Util::int32_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kUint64POD:
-                {
-                    ConvertData< Util::float32_t, Util::uint64_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kInt64POD:
-                {
-                    ConvertData< Util::float32_t, Util::int64_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kFloat16POD:
-                {
-                    ConvertData< Util::float32_t, Util::float16_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kFloat64POD:
-                {
-                    ConvertData< Util::float32_t, Util::float64_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                default:
-                break;
-            }
-        }
-        break;
-
-        case Util::kFloat64POD:
-        {
-            switch (toPod)
-            {
-                case Util::kBooleanPOD:
-                {
-                    ConvertToBool< Util::float64_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kUint8POD:
-                {
-                    ConvertData< Util::float64_t, Util::uint8_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kInt8POD:
-                {
-                    ConvertData< Util::float64_t, Util::int8_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kUint16POD:
-                {
-                    ConvertData< Util::float64_t, Util::uint16_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kInt16POD:
-                {
-                    ConvertData< Util::float64_t, Util::int16_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kUint32POD:
-                {
-                    ConvertData< Util::float64_t, Util::uint32_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kInt32POD:
-                {
-                    ConvertData< Util::float64_t, Util::int32_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kUint64POD:
-                {
-                    ConvertData< Util::float64_t, Util::uint64_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kInt64POD:
-                {
-                    ConvertData< Util::float64_t, Util::int64_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kFloat16POD:
-                {
-                    ConvertData< Util::float64_t, Util::float16_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                case Util::kFloat32POD:
-                {
-                    ConvertData< Util::float64_t, Util::float32_t >(
-                        fromBuffer, toBuffer, iSize );
-                }
-                break;
-
-                default:
-                break;
-            }
-        }
-        break;
-
-        default:
-        break;
-    }
-}
-
 //-*****************************************************************************
 void
 ReadData( void * iIntoLocation,
@@ -1406,7 +184,7 @@ ReadData( void * iIntoLocation,
         iData->read( numBytes, iIntoLocation, 16, iThreadId );
 
         char * buf = static_cast< char * >( iIntoLocation );
-        ConvertData( curPod, iAsPod, buf, iIntoLocation, numBytes );
+        Util::ConvertData( curPod, iAsPod, buf, iIntoLocation, numBytes );
 
     }
     else if ( PODNumBytes( curPod ) > PODNumBytes( iAsPod ) )
@@ -1418,13 +196,34 @@ ReadData( void * iIntoLocation,
         char * buf = new char[ numBytes ];
         iData->read( numBytes, buf, 16, iThreadId );
 
-        ConvertData( curPod, iAsPod, buf, iIntoLocation, numBytes );
+        Util::ConvertData( curPod, iAsPod, buf, iIntoLocation, numBytes );
 
         delete [] buf;
     }
 
 }
 
+//-*****************************************************************************
+namespace {
+
+// keeps the Ogawa data (and with it the memory mapping) alive for as long
+// as an ArraySample aliases it
+class MappedArraySampleDeleter
+{
+public:
+    MappedArraySampleDeleter( Ogawa::IDataPtr iData ) : m_data( iData ) {}
+
+    void operator()( AbcA::ArraySample * iSample )
+    {
+        delete iSample;
+    }
+
+private:
+    Ogawa::IDataPtr m_data;
+};
+
+}
+
 //-*****************************************************************************
 void
 ReadArraySample( Ogawa::IDataPtr iDims,
@@ -1437,6 +236,26 @@ ReadArraySample( Ogawa::IDataPtr iDims,
     Util::Dimensions dims;
     ReadDimensions( iDims, iData, iThreadId, iDataType, dims );
 
+    // when the archive is memory mapped and the data needs no conversion
+    // the sample can alias the mapping directly, the deleter holds on to
+    // iData so the mapping outlives the sample
+    Util::PlainOldDataType pod = iDataType.getPod();
+    Alembic::Util::uint64_t dataSize = iData->getSize();
+    if ( pod != Util::kStringPOD && pod != Util::kWstringPOD &&
+         dataSize > 16 && dataSize - 16 ==
+         ( Alembic::Util::uint64_t ) dims.numPoints() * iDataType.getNumBytes() )
+    {
+        const void * view = iData->view( dataSize - 16, 16 );
+        if ( view != NULL &&
+             ( reinterpret_cast< std::size_t >( view ) %
+               Util::PODNumBytes( pod ) ) == 0 )
+        {
+            oSample.reset( new AbcA::ArraySample( view, iDataType, dims ),
+                           MappedArraySampleDeleter( iData ) );
+            return;
+        }
+    }
+
     oSample = AbcA::AllocateArraySample( iDataType, dims );
 
     ReadData( const_cast<void*>( oSample->getData() ), iData,
@@ -1444,6 +263,48 @@ ReadArraySample( Ogawa::IDataPtr iDims,
 
 }
 
+//-*****************************************************************************
+bool
+ReadArraySampleCacheKey( Ogawa::IDataPtr iDims,
+                         Ogawa::IDataPtr iData,
+                         size_t iThreadId,
+                         const AbcA::DataType &iDataType,
+                         AbcA::ArraySample::Key &oKey )
+{
+    if ( !iDims || !iData || iData->getSize() <= 16 )
+    {
+        return false;
+    }
+
+    Util::Dimensions dims;
+    ReadDimensions( iDims, iData, iThreadId, iDataType, dims );
+
+    Util::Digest digest;
+    iData->read( 16, digest.d, 0, iThreadId );
+
+    Util::uint8_t dataType[2] = { ( Util::uint8_t ) iDataType.getPod(),
+                                  iDataType.getExtent() };
+
+    Util::SpookyHash hash;
+    hash.Init( 0, 0 );
+    hash.Update( digest.d, 16 );
+    hash.Update( dataType, 2 );
+    if ( dims.rank() > 0 )
+    {
+        hash.Update( dims.rootPtr(), dims.rank() * 8 );
+    }
+
+    Util::uint64_t hash0, hash1;
+    hash.Final( &hash0, &hash1 );
+
+    oKey.digest.words[0] = hash0;
+    oKey.digest.words[1] = hash1;
+    oKey.numBytes = iData->getSize() - 16;
+    oKey.origPOD = iDataType.getPod();
+    oKey.readPOD = oKey.origPOD;
+    return true;
+}
+
 //-*****************************************************************************
 void
 ReadTimeSamplesAndMax( Ogawa::IDataPtr iData,
@@ -72,6 +72,18 @@ ReadArraySample( Ogawa::IDataPtr iDims,
                  const AbcA::DataType &iDataType,
                  AbcA::ArraySamplePtr &oSample );
 
+//-*****************************************************************************
+// The digest stored with the data only covers its bytes, which can be shared
+// by samples with different data types or dimensions, so both are hashed
+// into the key used with a ReadArraySampleCache.
+// Returns false for empty samples, which aren't worth caching.
+bool
+ReadArraySampleCacheKey( Ogawa::IDataPtr iDims,
+                         Ogawa::IDataPtr iData,
+                         size_t iThreadId,
+                         const AbcA::DataType &iDataType,
+                         AbcA::ArraySample::Key &oKey );
+
 //-*****************************************************************************
 void
 ReadTimeSamplesAndMax( Ogawa::IDataPtr iData,
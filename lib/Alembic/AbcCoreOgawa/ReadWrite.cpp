@@ -46,6 +46,15 @@ namespace ALEMBIC_VERSION_NS {
 //-*****************************************************************************
 WriteArchive::WriteArchive()
 {
+    m_asyncWrite = false;
+    m_numHashThreads = 1;
+}
+
+//-*****************************************************************************
+WriteArchive::WriteArchive( bool iAsyncWrite, std::size_t iNumHashThreads )
+{
+    m_asyncWrite = iAsyncWrite;
+    m_numHashThreads = iNumHashThreads;
 }
 
 //-*****************************************************************************
@@ -54,7 +63,8 @@ WriteArchive::operator()( const std::string &iFileName,
                           const AbcA::MetaData &iMetaData ) const
 {
     Alembic::Util::shared_ptr<AwImpl> archivePtr(
-        new AwImpl( iFileName, iMetaData ) );
+        new AwImpl( iFileName, iMetaData, m_asyncWrite,
+                    m_numHashThreads ) );
     return archivePtr;
 }
 
@@ -64,7 +74,8 @@ WriteArchive::operator()( std::ostream * iStream,
                           const AbcA::MetaData &iMetaData ) const
 {
     Alembic::Util::shared_ptr<AwImpl> archivePtr(
-        new AwImpl( iStream, iMetaData ) );
+        new AwImpl( iStream, iMetaData, m_asyncWrite,
+                    m_numHashThreads ) );
     return archivePtr;
 }
 
@@ -72,17 +83,23 @@ WriteArchive::operator()( std::ostream * iStream,
 ReadArchive::ReadArchive()
 {
     m_numStreams = 1;
+    m_useMMap = false;
+    m_preloadHeaders = false;
 }
 
 //-*****************************************************************************
-ReadArchive::ReadArchive( size_t iNumStreams )
+ReadArchive::ReadArchive( size_t iNumStreams, bool iUseMMap,
+                          bool iPreloadHeaders )
 {
     m_numStreams = iNumStreams;
+    m_useMMap = iUseMMap;
+    m_preloadHeaders = iPreloadHeaders;
 }
 
 //-*****************************************************************************
 ReadArchive::ReadArchive( const std::vector< std::istream * > & iStreams )
-    : m_numStreams( 1 ), m_streams( iStreams )
+    : m_numStreams( 1 ), m_useMMap( false ), m_preloadHeaders( false )
+    , m_streams( iStreams )
 {
 }
 
@@ -95,7 +112,8 @@ ReadArchive::operator()( const std::string &iFileName ) const
     if ( m_streams.empty() )
     {
         archivePtr = Alembic::Util::shared_ptr<ArImpl>(
-            new ArImpl( iFileName, m_numStreams ) );
+            new ArImpl( iFileName, m_numStreams, m_useMMap,
+                        m_preloadHeaders ) );
     }
     else
     {
@@ -106,7 +124,6 @@ ReadArchive::operator()( const std::string &iFileName ) const
 }
 
 //-*****************************************************************************
-// The given cache is ignored.
 AbcA::ArchiveReaderPtr
 ReadArchive::operator()( const std::string &iFileName,
             AbcA::ReadArraySampleCachePtr iCache ) const
@@ -116,13 +133,16 @@ ReadArchive::operator()( const std::string &iFileName,
     if ( m_streams.empty() )
     {
         archivePtr = Alembic::Util::shared_ptr<ArImpl> (
-            new ArImpl( iFileName, m_numStreams ) );
+            new ArImpl( iFileName, m_numStreams, m_useMMap,
+                        m_preloadHeaders ) );
     }
     else
     {
         archivePtr = Alembic::Util::shared_ptr<ArImpl> (
             new ArImpl( m_streams ) );
     }
+
+    archivePtr->setReadArraySampleCachePtr( iCache );
     return archivePtr;
 }
 
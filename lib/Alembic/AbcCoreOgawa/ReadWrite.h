@@ -51,6 +51,14 @@ class ALEMBIC_EXPORT WriteArchive
 public:
     WriteArchive();
 
+    // With iAsyncWrite the data is buffered and written to disk by a
+    // background thread, so the caller overlaps its own work with the I/O.
+    // With iNumHashThreads > 1 large array samples are hashed in chunks on
+    // that many threads, their keys (and so the stored digests) differ from
+    // the ones computed with a single thread but don't depend on the
+    // number of threads.
+    WriteArchive( bool iAsyncWrite, std::size_t iNumHashThreads=1 );
+
     ::Alembic::AbcCoreAbstract::ArchiveWriterPtr
     operator()( const std::string &iFileName,
                 const ::Alembic::AbcCoreAbstract::MetaData &iMetaData ) const;
@@ -58,6 +66,10 @@ public:
     ::Alembic::AbcCoreAbstract::ArchiveWriterPtr
     operator()( std::ostream * iStream,
                 const ::Alembic::AbcCoreAbstract::MetaData &iMetaData ) const;
+
+private:
+    bool m_asyncWrite;
+    std::size_t m_numHashThreads;
 };
 
 //-*****************************************************************************
@@ -68,8 +80,18 @@ class ALEMBIC_EXPORT ReadArchive
 public:
     ReadArchive();
 
-    // Open the file iNumStreams times and manage them internally
-    ReadArchive( size_t iNumStreams );
+    // Open the file iNumStreams times and manage them internally, or with
+    // iUseMMap memory map it once and let any number of threads read from
+    // it without locking (iNumStreams is then irrelevant)
+    // A mapped file must not be truncated or rewritten in place while it is
+    // open: reading a page past its new end raises SIGBUS instead of the
+    // std::runtime_error that streams throw, and array samples may point
+    // straight into the mapping, so this lasts as long as they are alive
+    // With iPreloadHeaders every object and property header is read up
+    // front by several threads when the archive is opened, instead of
+    // when it is walked
+    ReadArchive( size_t iNumStreams, bool iUseMMap=false,
+                 bool iPreloadHeaders=false );
 
     // Read from the provided streams, we do not own these, expect them
     // to remain open and all have the same data in them, and do not try to
@@ -80,7 +102,8 @@ public:
     ::Alembic::AbcCoreAbstract::ArchiveReaderPtr
     operator()( const std::string &iFileName ) const;
 
-    // The given cache is ignored.
+    // open the file and look up array samples in iCache before reading
+    // them, the cache may be shared with other archives
     ::Alembic::AbcCoreAbstract::ArchiveReaderPtr
     operator()( const std::string &iFileName,
                 ::Alembic::AbcCoreAbstract::ReadArraySampleCachePtr iCache
@@ -88,6 +111,8 @@ public:
 
 private:
     size_t m_numStreams;
+    bool m_useMMap;
+    bool m_preloadHeaders;
     std::vector< std::istream * > m_streams;
 };
 
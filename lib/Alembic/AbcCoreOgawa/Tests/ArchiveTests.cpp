@@ -39,8 +39,11 @@
 #include <Alembic/Util/All.h>
 
 #include <Alembic/AbcCoreAbstract/Tests/Assert.h>
+#include <Alembic/Ogawa/Tests/ReadMode.h>
 
+#include <fstream>
 #include <iostream>
+#include <iterator>
 #include <sstream>
 #include <vector>
 
@@ -74,7 +77,7 @@ void testReadWriteEmptyArchive()
 
         TESTING_ASSERT(archive->getFullName() == "/");
 
-        Alembic::AbcCoreOgawa::ReadArchive r;
+        Alembic::AbcCoreOgawa::ReadArchive r( 1, kOgawaTestUseMMap );
 
         // can't read an already open archive (for now)
         TESTING_ASSERT_THROW(r( archiveName ), Alembic::Util::Exception);
@@ -82,7 +85,7 @@ void testReadWriteEmptyArchive()
     }
 
     {
-        AO::ReadArchive r;
+        AO::ReadArchive r( 1, kOgawaTestUseMMap );
         ABCA::ArchiveReaderPtr a = r( archiveName );
         ABCA::ObjectReaderPtr archive = a->getTop();
         ABCA::MetaData m = archive->getHeader().getMetaData();
@@ -105,7 +108,7 @@ void testReadWriteEmptyArchive()
         TESTING_ASSERT(parent->getNumProperties() == 0);
 
         // get it again to make sure we clean ourselves up properly
-        AO::ReadArchive r2;
+        AO::ReadArchive r2( 1, kOgawaTestUseMMap );
         ABCA::ArchiveReaderPtr a2 = r2( archiveName );
         ABCA::ObjectReaderPtr archive2 = a2->getTop();
         ABCA::CompoundPropertyReaderPtr p2 = archive2->getProperties();
@@ -170,7 +173,7 @@ void testReadWriteTimeSamplingArchive()
     }
 
     {
-        AO::ReadArchive r;
+        AO::ReadArchive r( 1, kOgawaTestUseMMap );
         ABCA::ArchiveReaderPtr a = r( archiveName );
 
         TESTING_ASSERT(a->getNumTimeSamplings() == 4);
@@ -250,7 +253,7 @@ void testReadWriteMaxNumSamplesArchive()
     }
 
     {
-        AO::ReadArchive r;
+        AO::ReadArchive r( 1, kOgawaTestUseMMap );
         ABCA::ArchiveReaderPtr a = r( archiveName );
 
 
@@ -378,11 +381,93 @@ void writeVeryEmptyArchive( const std::string & iName )
 
 void readVeryEmptyArchive( const std::string & iName )
 {
-    Alembic::AbcCoreOgawa::ReadArchive r;
+    Alembic::AbcCoreOgawa::ReadArchive r( 1, kOgawaTestUseMMap );
     ABCA::ArchiveReaderPtr a = r( iName );
     TESTING_ASSERT(a->getTop()->getNumChildren() == 0);
 }
 
+//-*****************************************************************************
+// big enough to go through several of the asynchronous write buffers
+void writeBigArchive( const std::string & iName, AO::WriteArchive & iWriter )
+{
+    ABCA::MetaData m;
+    m.set( "potato", "salad" );
+    ABCA::ArchiveWriterPtr a = iWriter( iName, m );
+
+    ABCA::TimeSamplingPtr ts( new ABCA::TimeSampling( 1.0 / 24.0, 0.0 ) );
+    Alembic::Util::uint32_t tsIndex = a->addTimeSampling( *ts );
+
+    ABCA::DataType f32d( Alembic::Util::kFloat32POD, 1 );
+    ABCA::DataType i32d( Alembic::Util::kInt32POD, 1 );
+
+    std::vector< float32_t > vals( 300 * 1024 );
+    for ( std::size_t i = 0; i < 4; ++i )
+    {
+        std::ostringstream name;
+        name << "child" << i;
+        ABCA::ObjectWriterPtr child = a->getTop()->createChild(
+            ABCA::ObjectHeader( name.str(), m ) );
+        ABCA::CompoundPropertyWriterPtr props = child->getProperties();
+
+        ABCA::ArrayPropertyWriterPtr arr = props->createArrayProperty(
+            "arr", m, f32d, tsIndex );
+        ABCA::ScalarPropertyWriterPtr sca = props->createScalarProperty(
+            "sca", m, i32d, tsIndex );
+
+        for ( std::size_t j = 0; j < 6; ++j )
+        {
+            for ( std::size_t k = 0; k < vals.size(); ++k )
+            {
+                vals[k] = i * 1000.0f + j + k * 0.25f;
+            }
+
+            // repeat a sample now and then so some are deduplicated
+            arr->setSample( ABCA::ArraySample( &( vals.front() ), f32d,
+                Dimensions( vals.size() - ( j % 3 == 2 ? 0 : j ) ) ) );
+            int32_t val = ( int32_t )( i * 10 + j );
+            sca->setSample( &val );
+        }
+    }
+}
+
+//-*****************************************************************************
+std::string fileContents( const std::string & iName )
+{
+    std::ifstream file( iName.c_str(), std::ios::binary );
+    return std::string( ( std::istreambuf_iterator< char >( file ) ),
+                        std::istreambuf_iterator< char >() );
+}
+
+//-*****************************************************************************
+void testAsyncWriteArchive()
+{
+    {
+        AO::WriteArchive w;
+        writeBigArchive( "bigSyncWrite.abc", w );
+    }
+    {
+        AO::WriteArchive w( true );
+        writeBigArchive( "bigAsyncWrite.abc", w );
+    }
+
+    std::string syncData = fileContents( "bigSyncWrite.abc" );
+    TESTING_ASSERT( syncData.size() > 16 * 1024 * 1024 );
+    TESTING_ASSERT( syncData == fileContents( "bigAsyncWrite.abc" ) );
+
+    AO::ReadArchive r( 1, kOgawaTestUseMMap );
+    ABCA::ArchiveReaderPtr a = r( "bigAsyncWrite.abc" );
+    TESTING_ASSERT( a->getTop()->getNumChildren() == 4 );
+    ABCA::ArrayPropertyReaderPtr arr =
+        a->getTop()->getChild( 3 )->getProperties()->getArrayProperty( "arr" );
+    TESTING_ASSERT( arr->getNumSamples() == 6 );
+
+    ABCA::ArraySamplePtr samp;
+    arr->getSample( 4, samp );
+    TESTING_ASSERT( samp->size() == 300 * 1024 - 4 );
+    TESTING_ASSERT( ( ( const float32_t * ) samp->getData() )[8] ==
+                    3000.0f + 4 + 8 * 0.25f );
+}
+
 int main ( int argc, char *argv[] )
 {
     testReadWriteEmptyArchive();
@@ -401,5 +486,7 @@ int main ( int argc, char *argv[] )
 
     testReadWriteMaxNumSamplesArchive();
 
+    testAsyncWriteArchive();
+
     return 0;
 }
@@ -39,6 +39,7 @@
 #include <Alembic/Util/All.h>
 
 #include <Alembic/AbcCoreAbstract/Tests/Assert.h>
+#include <Alembic/Ogawa/Tests/ReadMode.h>
 
 #include <iostream>
 #include <vector>
@@ -141,7 +142,7 @@ void testDuplicateArray()
     }
 
     {
-        AO::ReadArchive r;
+        AO::ReadArchive r( 1, kOgawaTestUseMMap );
         ABCA::ArchiveReaderPtr a = r( archiveName );
         ABCA::ObjectReaderPtr archive = a->getTop();
         ABCA::CompoundPropertyReaderPtr parent = archive->getProperties();
@@ -615,7 +616,7 @@ void testReadWriteArrays()
 
     // now we read what we've written
     {
-        AO::ReadArchive r;
+        AO::ReadArchive r( 1, kOgawaTestUseMMap );
         ABCA::ArchiveReaderPtr a = r( archiveName );
         ABCA::ObjectReaderPtr archive = a->getTop();
         ABCA::CompoundPropertyReaderPtr parent = archive->getProperties();
@@ -1229,7 +1230,7 @@ void testEmptyArray()
     }
 
     {
-        AO::ReadArchive r;
+        AO::ReadArchive r( 1, kOgawaTestUseMMap );
         ABCA::ArchiveReaderPtr a = r( archiveName );
         ABCA::ObjectReaderPtr archive = a->getTop();
         ABCA::CompoundPropertyReaderPtr parent = archive->getProperties();
@@ -1324,7 +1325,7 @@ void testEmptyArray()
     }
 
     {
-        AO::ReadArchive r;
+        AO::ReadArchive r( 1, kOgawaTestUseMMap );
         ABCA::ArchiveReaderPtr a = r( archiveName );
         ABCA::ObjectReaderPtr archive = a->getTop();
         ABCA::CompoundPropertyReaderPtr parent = archive->getProperties();
@@ -1452,7 +1453,7 @@ void testExtentArrayStrings()
     }
 
     {
-        AO::ReadArchive r;
+        AO::ReadArchive r( 1, kOgawaTestUseMMap );
         ABCA::ArchiveReaderPtr a = r( archiveName );
         ABCA::ObjectReaderPtr archive = a->getTop();
         ABCA::CompoundPropertyReaderPtr parent = archive->getProperties();
@@ -1682,7 +1683,7 @@ void testArrayStringsRepeats()
     }
 
     {
-        AO::ReadArchive r;
+        AO::ReadArchive r( 1, kOgawaTestUseMMap );
         ABCA::ArchiveReaderPtr a = r( archiveName );
         ABCA::ObjectReaderPtr archive = a->getTop();
         ABCA::CompoundPropertyReaderPtr parent = archive->getProperties();
@@ -1838,7 +1839,7 @@ void testArraySamples()
     }
 
     {
-        AO::ReadArchive r;
+        AO::ReadArchive r( 1, kOgawaTestUseMMap );
         ABCA::ArchiveReaderPtr a = r( archiveName );
         ABCA::ObjectReaderPtr archive = a->getTop();
         ABCA::ObjectReaderPtr obj = archive->getChild(0);
@@ -1925,6 +1926,8 @@ void testWriteWhileRead()
     }
 
     {
+        // streams only: rewriting a memory mapped file truncates the mapping
+        // under the reader, which then gets SIGBUS instead of an exception
         AO::ReadArchive r;
         ABCA::ArchiveReaderPtr a = r( archiveName );
         ABCA::ObjectReaderPtr archive = a->getTop();
@@ -1966,6 +1969,218 @@ void testWriteWhileRead()
     }
 }
 
+//-*****************************************************************************
+void testReadArraySampleCache()
+{
+    std::string archiveName = "readArraySampleCache.abc";
+
+    std::vector < Alembic::Util::int32_t > vals( 6 );
+    for ( std::size_t i = 0; i < vals.size(); ++i )
+    {
+        vals[i] = i * 7;
+    }
+
+    std::vector < Alembic::Util::int32_t > otherVals( vals.size(), 3 );
+
+    ABCA::DataType dtype( Alembic::Util::kInt32POD );
+    ABCA::DataType dtype3( Alembic::Util::kInt32POD, 3 );
+
+    {
+        AO::WriteArchive w;
+        ABCA::ArchiveWriterPtr a = w( archiveName, ABCA::MetaData() );
+        ABCA::ObjectWriterPtr archive = a->getTop();
+        ABCA::CompoundPropertyWriterPtr parent = archive->getProperties();
+
+        // a and b share the same bytes on disk
+        ABCA::ArrayPropertyWriterPtr prop =
+            parent->createArrayProperty( "a", ABCA::MetaData(), dtype, 0 );
+        prop->setSample( ABCA::ArraySample( &( vals.front() ), dtype,
+            Alembic::Util::Dimensions( vals.size() ) ) );
+        prop->setSample( ABCA::ArraySample( &( otherVals.front() ), dtype,
+            Alembic::Util::Dimensions( otherVals.size() ) ) );
+
+        prop = parent->createArrayProperty( "b", ABCA::MetaData(), dtype3, 0 );
+        prop->setSample( ABCA::ArraySample( &( vals.front() ), dtype3,
+            Alembic::Util::Dimensions( vals.size() / 3 ) ) );
+    }
+
+    {
+        ABCA::LRUReadArraySampleCachePtr cache(
+            new ABCA::LRUReadArraySampleCache( 1024 * 1024 ) );
+
+        // the cache is shared by both archives
+        AO::ReadArchive r( 1, kOgawaTestUseMMap );
+        ABCA::ArchiveReaderPtr a = r( archiveName, cache );
+        ABCA::ArchiveReaderPtr b = r( archiveName );
+        b->setReadArraySampleCachePtr( cache );
+        TESTING_ASSERT( b->getReadArraySampleCachePtr() == cache );
+
+        ABCA::ArraySamplePtr sampA;
+        a->getTop()->getProperties()->getArrayProperty( "a" )->getSample(
+            0, sampA );
+
+        ABCA::ArraySamplePtr sampB;
+        b->getTop()->getProperties()->getArrayProperty( "a" )->getSample(
+            0, sampB );
+
+        TESTING_ASSERT( sampA == sampB );
+        TESTING_ASSERT( sampA->getDimensions().numPoints() == vals.size() );
+        const Alembic::Util::int32_t * data =
+            ( const Alembic::Util::int32_t * ) sampA->getData();
+        for ( std::size_t i = 0; i < vals.size(); ++i )
+        {
+            TESTING_ASSERT( data[i] == vals[i] );
+        }
+
+        // same bytes, but a different DataType and Dimensions
+        ABCA::ArraySamplePtr samp3;
+        b->getTop()->getProperties()->getArrayProperty( "b" )->getSample(
+            0, samp3 );
+        TESTING_ASSERT( samp3 != sampA );
+        TESTING_ASSERT( samp3->getDataType() == dtype3 );
+        TESTING_ASSERT( samp3->getDimensions().numPoints() == 2 );
+
+        ABCA::LRUReadArraySampleCache::Stats stats = cache->getStats();
+        TESTING_ASSERT( stats.hits == 1 );
+        TESTING_ASSERT( stats.misses == 2 );
+        TESTING_ASSERT( stats.stores == 2 );
+        TESTING_ASSERT( stats.numSamples == 2 );
+        TESTING_ASSERT( stats.numBytes == 2 * vals.size() * 4 );
+
+        // samples that are still referenced are never evicted
+        cache->clear();
+        TESTING_ASSERT( cache->getStats().numSamples == 2 );
+        samp3.reset();
+        cache->clear();
+        TESTING_ASSERT( cache->getStats().numSamples == 1 );
+        TESTING_ASSERT( cache->getStats().evictions == 1 );
+    }
+
+    {
+        // only enough room for one of the samples
+        ABCA::LRUReadArraySampleCachePtr cache(
+            new ABCA::LRUReadArraySampleCache( vals.size() * 4, 1 ) );
+
+        AO::ReadArchive r( 1, kOgawaTestUseMMap );
+        ABCA::ArchiveReaderPtr a = r( archiveName, cache );
+        ABCA::ArrayPropertyReaderPtr prop =
+            a->getTop()->getProperties()->getArrayProperty( "a" );
+
+        ABCA::ArraySamplePtr samp;
+        prop->getSample( 0, samp );
+        prop->getSample( 1, samp );
+        TESTING_ASSERT( cache->getStats().evictions == 1 );
+        TESTING_ASSERT( cache->getStats().numSamples == 1 );
+        TESTING_ASSERT(
+            ( ( const Alembic::Util::int32_t * ) samp->getData() )[0] == 3 );
+
+        prop->getSample( 1, samp );
+        TESTING_ASSERT( cache->getStats().hits == 1 );
+    }
+}
+
+//-*****************************************************************************
+void testMappedArraySamples()
+{
+    std::string archiveName = "mappedArraySamples.abc";
+
+    // the odd sized pad samples shift the doubles written after them, so
+    // that only some of those end up 8 byte aligned in the file
+    const std::size_t numSamples = 16;
+    const std::size_t numVals = 5;
+
+    ABCA::DataType u8dtype( Alembic::Util::kUint8POD );
+    ABCA::DataType f64dtype( Alembic::Util::kFloat64POD );
+
+    {
+        AO::WriteArchive w;
+        ABCA::ArchiveWriterPtr a = w( archiveName, ABCA::MetaData() );
+        ABCA::CompoundPropertyWriterPtr parent = a->getTop()->getProperties();
+
+        ABCA::ArrayPropertyWriterPtr pad =
+            parent->createArrayProperty( "pad", ABCA::MetaData(), u8dtype, 0 );
+        ABCA::ArrayPropertyWriterPtr vals = parent->createArrayProperty(
+            "vals", ABCA::MetaData(), f64dtype, 0 );
+
+        for ( std::size_t i = 0; i < numSamples; ++i )
+        {
+            std::vector < Alembic::Util::uint8_t > padVals( i + 1,
+                ( Alembic::Util::uint8_t ) i );
+            pad->setSample( ABCA::ArraySample( &( padVals.front() ), u8dtype,
+                Alembic::Util::Dimensions( padVals.size() ) ) );
+
+            std::vector < Alembic::Util::float64_t > f64Vals( numVals );
+            for ( std::size_t j = 0; j < numVals; ++j )
+            {
+                f64Vals[j] = i + j * 0.5;
+            }
+            vals->setSample( ABCA::ArraySample( &( f64Vals.front() ),
+                f64dtype, Alembic::Util::Dimensions( numVals ) ) );
+        }
+    }
+
+    {
+        // no cache, so that every getSample reads the file
+        AO::ReadArchive r( 1, kOgawaTestUseMMap );
+        ABCA::ArchiveReaderPtr a = r( archiveName,
+                                      ABCA::ReadArraySampleCachePtr() );
+        ABCA::ArrayPropertyReaderPtr vals =
+            a->getTop()->getProperties()->getArrayProperty( "vals" );
+        TESTING_ASSERT( vals->getNumSamples() == numSamples );
+
+        std::size_t numAliased = 0;
+        std::size_t numCopied = 0;
+        for ( std::size_t i = 0; i < numSamples; ++i )
+        {
+            ABCA::ArraySamplePtr first;
+            ABCA::ArraySamplePtr second;
+            vals->getSample( i, first );
+            vals->getSample( i, second );
+
+            // zero copy samples both point into the mapping
+            if ( first->getData() == second->getData() )
+            {
+                numAliased++;
+            }
+            else
+            {
+                numCopied++;
+            }
+
+            TESTING_ASSERT( ( ( std::size_t ) first->getData() ) %
+                sizeof( Alembic::Util::float64_t ) == 0 );
+            TESTING_ASSERT( first->getDimensions().numPoints() == numVals );
+
+            const Alembic::Util::float64_t * data =
+                ( const Alembic::Util::float64_t * ) first->getData();
+            for ( std::size_t j = 0; j < numVals; ++j )
+            {
+                TESTING_ASSERT( data[j] == i + j * 0.5 );
+            }
+        }
+
+        if ( kOgawaTestUseMMap )
+        {
+            // the aligned samples alias the mapping, the rest fall back
+            // to a copy
+            TESTING_ASSERT( numAliased > 0 );
+            TESTING_ASSERT( numCopied > 0 );
+        }
+        else
+        {
+            TESTING_ASSERT( numAliased == 0 );
+        }
+
+        // a sample keeps the mapping alive after its archive is gone
+        ABCA::ArraySamplePtr last;
+        vals->getSample( numSamples - 1, last );
+        vals.reset();
+        a.reset();
+        TESTING_ASSERT( ( ( const Alembic::Util::float64_t * )
+            last->getData() )[numVals - 1] == ( numSamples - 1 ) + 2.0 );
+    }
+}
+
 int main ( int argc, char *argv[] )
 {
     testEmptyArray();
@@ -1975,5 +2190,7 @@ int main ( int argc, char *argv[] )
     testArrayStringsRepeats();
     testArraySamples();
     testWriteWhileRead();
+    testReadArraySampleCache();
+    testMappedArraySamples();
     return 0;
 }
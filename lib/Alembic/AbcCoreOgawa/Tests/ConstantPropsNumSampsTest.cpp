@@ -39,6 +39,7 @@
 #include <Alembic/Util/All.h>
 
 #include <Alembic/AbcCoreAbstract/Tests/Assert.h>
+#include <Alembic/Ogawa/Tests/ReadMode.h>
 
 //-*****************************************************************************
 namespace AO = Alembic::AbcCoreOgawa;
@@ -104,7 +105,7 @@ void testProps()
     }
 
     {
-        AO::ReadArchive r;
+        AO::ReadArchive r( 1, kOgawaTestUseMMap );
         ArchiveReaderPtr a = r( archiveName );
         ObjectReaderPtr top = a->getTop();
         TESTING_ASSERT( top->getNumChildren() == 1 );
@@ -39,8 +39,13 @@
 #include <Alembic/Util/All.h>
 
 #include <Alembic/AbcCoreAbstract/Tests/Assert.h>
+#include <Alembic/Ogawa/Tests/ReadMode.h>
+#include <Alembic/Util/Murmur3.h>
 
+#include <cstring>
+#include <fstream>
 #include <iostream>
+#include <sstream>
 #include <vector>
 
 //-*****************************************************************************
@@ -238,7 +243,7 @@ void testArrayPropHashes()
     }
 
     {
-        AO::ReadArchive r;
+        AO::ReadArchive r( 1, kOgawaTestUseMMap );
         ABCA::ArchiveReaderPtr a = r( archiveName );
         ABCA::ObjectReaderPtr archive = a->getTop();
 
@@ -440,7 +445,7 @@ void testScalarPropHashes()
     }
 
     {
-        AO::ReadArchive r;
+        AO::ReadArchive r( 1, kOgawaTestUseMMap );
         ABCA::ArchiveReaderPtr a = r( archiveName );
         ABCA::ObjectReaderPtr archive = a->getTop();
 
@@ -575,7 +580,7 @@ void testCompoundPropHashes()
     }
 
     {
-        AO::ReadArchive r;
+        AO::ReadArchive r( 1, kOgawaTestUseMMap );
         ABCA::ArchiveReaderPtr a = r( archiveName );
         ABCA::ObjectReaderPtr archive = a->getTop();
 
@@ -695,7 +700,7 @@ void testObjectHashes()
     }
 
     {
-        AO::ReadArchive r;
+        AO::ReadArchive r( 1, kOgawaTestUseMMap );
         ABCA::ArchiveReaderPtr a = r( archiveName );
         ABCA::ObjectReaderPtr archive = a->getTop();
 
@@ -770,7 +775,7 @@ void testStringHashes()
     }
 
     {
-        AO::ReadArchive r;
+        AO::ReadArchive r( 1, kOgawaTestUseMMap );
         ABCA::ArchiveReaderPtr a = r( archiveName );
         ABCA::ObjectReaderPtr archive = a->getTop();
         ABCA::CompoundPropertyReaderPtr parent = archive->getProperties();
@@ -806,6 +811,115 @@ void testStringHashes()
     }
 }
 
+//-*****************************************************************************
+// the key WriteArchive documents for several hashing threads: 1MB chunks are
+// hashed on their own, then their digests are hashed in order
+ABCA::ArraySampleKey chunkedKey( const ABCA::ArraySample & iSamp )
+{
+    const std::size_t chunkSize = 1024 * 1024;
+    const char * data = ( const char * ) iSamp.getData();
+    std::size_t numBytes = iSamp.getDataType().getNumBytes() * iSamp.size();
+    std::size_t podSize = Alembic::Util::PODNumBytes(
+        iSamp.getDataType().getPod() );
+
+    std::vector< Alembic::Util::Digest > digests;
+    for ( std::size_t start = 0; start < numBytes; start += chunkSize )
+    {
+        digests.push_back( Alembic::Util::Digest() );
+        Alembic::Util::MurmurHash3_x64_128( data + start,
+            std::min( chunkSize, numBytes - start ), podSize,
+            digests.back().words );
+    }
+
+    ABCA::ArraySampleKey key;
+    key.numBytes = numBytes;
+    Alembic::Util::MurmurHash3_x64_128( &digests.front(),
+        digests.size() * sizeof( Alembic::Util::Digest ),
+        sizeof( Alembic::Util::uint64_t ), key.digest.words );
+    return key;
+}
+
+//-*****************************************************************************
+void testParallelHashKeys()
+{
+    // 3.5MB and a bit, so the last chunk is a short one
+    std::vector< Alembic::Util::float32_t > bigVals( 896 * 1024 + 5 );
+    for ( std::size_t i = 0; i < bigVals.size(); ++i )
+    {
+        bigVals[i] = i * 0.5f;
+    }
+    std::vector< Alembic::Util::float32_t > smallVals( bigVals.begin(),
+        bigVals.begin() + 1000 );
+
+    ABCA::DataType fdtype( Alembic::Util::kFloat32POD, 1 );
+    ABCA::DataType idtype( Alembic::Util::kInt32POD, 1 );
+    ABCA::ArraySample bigSamp( &( bigVals.front() ), fdtype,
+        Alembic::Util::Dimensions( bigVals.size() ) );
+    ABCA::ArraySample smallSamp( &( smallVals.front() ), fdtype,
+        Alembic::Util::Dimensions( smallVals.size() ) );
+    std::size_t bigBytes = bigVals.size() * sizeof( Alembic::Util::float32_t );
+
+    ABCA::ArraySampleKey serialKey = bigSamp.getKey();
+    ABCA::ArraySampleKey parallelKey = chunkedKey( bigSamp );
+    TESTING_ASSERT( serialKey.digest != parallelKey.digest );
+
+    const std::size_t numThreads[] = { 1, 2, 4, 7 };
+    for ( std::size_t t = 0; t < 4; ++t )
+    {
+        std::ostringstream archiveName;
+        archiveName << "parallelHashTest" << numThreads[t] << ".abc";
+        {
+            AO::WriteArchive w( false, numThreads[t] );
+            ABCA::ArchiveWriterPtr a = w( archiveName.str(), ABCA::MetaData() );
+            ABCA::CompoundPropertyWriterPtr props =
+                a->getTop()->getProperties();
+
+            props->createArrayProperty( "big", ABCA::MetaData(), fdtype, 0
+                )->setSample( bigSamp );
+            props->createArrayProperty( "small", ABCA::MetaData(), fdtype, 0
+                )->setSample( smallSamp );
+
+            // the same bytes, again and as another POD, are only written once
+            props->createArrayProperty( "same", ABCA::MetaData(), fdtype, 0
+                )->setSample( bigSamp );
+            props->createArrayProperty( "int", ABCA::MetaData(), idtype, 0
+                )->setSample( ABCA::ArraySample( &( bigVals.front() ), idtype,
+                    Alembic::Util::Dimensions( bigVals.size() ) ) );
+        }
+
+        std::ifstream file( archiveName.str().c_str(), std::ios::binary );
+        file.seekg( 0, std::ios::end );
+        TESTING_ASSERT( ( std::size_t ) file.tellg() > bigBytes );
+        TESTING_ASSERT( ( std::size_t ) file.tellg() < bigBytes * 2 );
+
+        AO::ReadArchive r( 1, kOgawaTestUseMMap );
+        ABCA::ArchiveReaderPtr a = r( archiveName.str() );
+        ABCA::CompoundPropertyReaderPtr props = a->getTop()->getProperties();
+
+        ABCA::ArraySampleKey key;
+        props->getArrayProperty( "big" )->getKey( 0, key );
+        TESTING_ASSERT( key.numBytes == bigBytes );
+        if ( numThreads[t] == 1 )
+        {
+            TESTING_ASSERT( key.digest == serialKey.digest );
+        }
+        else
+        {
+            TESTING_ASSERT( key.digest == parallelKey.digest );
+        }
+
+        // small samples always get the single threaded key
+        props->getArrayProperty( "small" )->getKey( 0, key );
+        TESTING_ASSERT( key.digest == smallSamp.getKey().digest );
+
+        ABCA::ArraySamplePtr samp;
+        props->getArrayProperty( "int" )->getSample( 0, samp );
+        TESTING_ASSERT( samp->size() == bigVals.size() );
+        TESTING_ASSERT( memcmp( samp->getData(), &( bigVals.front() ),
+                                bigBytes ) == 0 );
+    }
+}
+
 int main ( int argc, char *argv[] )
 {
     testArrayPropHashes();
@@ -813,5 +927,6 @@ int main ( int argc, char *argv[] )
     testCompoundPropHashes();
     testObjectHashes();
     testStringHashes();
+    testParallelHashKeys();
     return 0;
 }
@@ -40,6 +40,7 @@
 #include <Alembic/Util/All.h>
 
 #include <Alembic/AbcCoreAbstract/Tests/Assert.h>
+#include <Alembic/Ogawa/Tests/ReadMode.h>
 
 //-*****************************************************************************
 namespace AO = Alembic::AbcCoreOgawa;
@@ -130,7 +131,7 @@ void testObjects()
     }
 
     {
-        AO::ReadArchive r;
+        AO::ReadArchive r( 1, kOgawaTestUseMMap );
         AbcA::ArchiveReaderPtr a = r( archiveName );
         AbcA::ObjectReaderPtr archive = a->getTop();
         TESTING_ASSERT(archive->getNumChildren() == 3);
@@ -176,7 +177,7 @@ void testObjects()
         TESTING_ASSERT(gchild->getFullName() == "/foo/pizza");
         TESTING_ASSERT(gchild->getName() == "pizza");
 
-        AO::ReadArchive r2;
+        AO::ReadArchive r2( 1, kOgawaTestUseMMap );
         AbcA::ArchiveReaderPtr a2 = r2( archiveName );
         AbcA::ObjectReaderPtr archive2 = a2->getTop();
         AbcA::ObjectReaderPtr child2 = archive->getChild(0);
@@ -247,7 +248,7 @@ void testChildObjects()
     }
 
     {
-        AO::ReadArchive r;
+        AO::ReadArchive r( 1, kOgawaTestUseMMap );
         AbcA::ArchiveReaderPtr a = r( archiveName );
         AbcA::ObjectReaderPtr archive = a->getTop();
         AbcA::ObjectReaderPtr smallChild = archive->getChild(0);
@@ -285,7 +286,7 @@ void testMetaData()
     }
 
     {
-        AO::ReadArchive r;
+        AO::ReadArchive r( 1, kOgawaTestUseMMap );
         AbcA::ArchiveReaderPtr a = r( archiveName );
         AbcA::ObjectReaderPtr archive = a->getTop();
         AbcA::ObjectReaderPtr child = archive->getChild(0);
@@ -301,10 +302,109 @@ void testMetaData()
     }
 }
 
+//-*****************************************************************************
+void walkHierarchy( AbcA::CompoundPropertyReaderPtr iProp,
+                    std::ostream & oStrm )
+{
+    for ( size_t i = 0; i < iProp->getNumProperties(); ++i )
+    {
+        const AbcA::PropertyHeader & header = iProp->getPropertyHeader( i );
+        oStrm << header.getName() << " " << header.getPropertyType() << " "
+              << header.getMetaData().serialize() << "\n";
+
+        if ( header.isCompound() )
+        {
+            walkHierarchy( iProp->getCompoundProperty( header.getName() ),
+                           oStrm );
+        }
+        else if ( header.isArray() )
+        {
+            oStrm << header.getDataType() << " " <<
+                iProp->getArrayProperty( header.getName() )->getNumSamples()
+                << "\n";
+        }
+    }
+}
+
+void walkHierarchy( AbcA::ObjectReaderPtr iObj, std::ostream & oStrm )
+{
+    oStrm << iObj->getFullName() << " " << iObj->getMetaData().serialize()
+          << "\n";
+    walkHierarchy( iObj->getProperties(), oStrm );
+
+    for ( size_t i = 0; i < iObj->getNumChildren(); ++i )
+    {
+        TESTING_ASSERT( iObj->getChildHeader(
+            iObj->getChildHeader( i ).getName() ) );
+        walkHierarchy( iObj->getChild( i ), oStrm );
+    }
+}
+
+void testPreloadHeaders()
+{
+    std::string archiveName = "preloadHeadersTest.abc";
+    {
+        AO::WriteArchive w;
+        AbcA::ArchiveWriterPtr a = w(archiveName, AbcA::MetaData());
+
+        AbcA::DataType dtype( Alembic::Util::kFloat32POD, 3 );
+        std::vector< AbcA::ObjectWriterPtr > parents( 1, a->getTop() );
+        for ( size_t depth = 0; depth < 4; ++depth )
+        {
+            std::vector< AbcA::ObjectWriterPtr > children;
+            for ( size_t i = 0; i < parents.size(); ++i )
+            {
+                for ( size_t j = 0; j < 4; ++j )
+                {
+                    std::stringstream strm;
+                    strm << "child" << j;
+                    AbcA::MetaData md;
+                    md.set( "depth", strm.str() );
+
+                    AbcA::ObjectWriterPtr child = parents[i]->createChild(
+                        AbcA::ObjectHeader( strm.str(), md ) );
+                    children.push_back( child );
+
+                    AbcA::CompoundPropertyWriterPtr props =
+                        child->getProperties()->createCompoundProperty(
+                            "geom", md );
+                    props->createArrayProperty( "P", md, dtype, 0 );
+                    props->createCompoundProperty( "arb", md )->
+                        createScalarProperty( "s", md, dtype, 0 );
+                }
+            }
+            parents.swap( children );
+        }
+    }
+
+    std::stringstream lazy;
+    {
+        AO::ReadArchive r( 1, kOgawaTestUseMMap );
+        walkHierarchy( r( archiveName )->getTop(), lazy );
+    }
+
+    std::stringstream preloaded;
+    {
+        AO::ReadArchive r( 4, false, true );
+        walkHierarchy( r( archiveName )->getTop(), preloaded );
+    }
+
+    std::stringstream mapped;
+    {
+        AO::ReadArchive r( 1, true, true );
+        walkHierarchy( r( archiveName )->getTop(), mapped );
+    }
+
+    TESTING_ASSERT( !lazy.str().empty() );
+    TESTING_ASSERT( lazy.str() == preloaded.str() );
+    TESTING_ASSERT( lazy.str() == mapped.str() );
+}
+
 int main ( int argc, char *argv[] )
 {
     testObjects();
     testChildObjects();
     testMetaData();
+    testPreloadHeaders();
     return 0;
 }
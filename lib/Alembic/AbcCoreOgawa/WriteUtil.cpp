@@ -36,6 +36,12 @@
 
 #include <Alembic/AbcCoreOgawa/WriteUtil.h>
 #include <Alembic/AbcCoreOgawa/AwImpl.h>
+#include <Alembic/Util/Murmur3.h>
+
+#if !defined(ALEMBIC_LIB_USES_TR1) && __cplusplus >= 201103L
+#include <atomic>
+#include <thread>
+#endif
 
 namespace Alembic {
 namespace AbcCoreOgawa {
@@ -156,6 +162,89 @@ GetWrittenSampleMap( AbcA::ArchiveWriterPtr iVal )
     return ptr->getWrittenSampleMap();
 }
 
+//-*****************************************************************************
+namespace {
+
+// large samples are hashed in pieces of this size, a multiple of every POD
+// size so no element is split
+const std::size_t HASH_CHUNK_SIZE = 1024 * 1024;
+
+#if !defined(ALEMBIC_LIB_USES_TR1) && __cplusplus >= 201103L
+typedef std::atomic< std::size_t > ChunkCounter;
+#else
+typedef std::size_t ChunkCounter;
+#endif
+
+// hashes the chunks handed out by ioNext until there are none left
+void HashChunks( const char * iData, std::size_t iNumBytes,
+                 std::size_t iPodSize, std::vector< Util::Digest > & oDigests,
+                 ChunkCounter & ioNext )
+{
+    for ( std::size_t i = ioNext++; i < oDigests.size(); i = ioNext++ )
+    {
+        std::size_t start = i * HASH_CHUNK_SIZE;
+        std::size_t size = std::min( HASH_CHUNK_SIZE, iNumBytes - start );
+        Util::MurmurHash3_x64_128( iData + start, size, iPodSize,
+                                   oDigests[i].words );
+    }
+}
+
+}
+
+//-*****************************************************************************
+AbcA::ArraySample::Key GetSampleKey( AbcA::ArchiveWriterPtr iArchive,
+                                     const AbcA::ArraySample & iSamp )
+{
+    AwImpl *ptr = dynamic_cast<AwImpl*>( iArchive.get() );
+    ABCA_ASSERT( ptr, "NULL Impl Ptr" );
+
+    std::size_t numThreads = ptr->getNumHashThreads();
+    Util::PlainOldDataType pod = iSamp.getDataType().getPod();
+    std::size_t numBytes = iSamp.getDataType().getNumBytes() * iSamp.size();
+
+    if ( numThreads < 2 || pod == Util::kStringPOD ||
+         pod == Util::kWstringPOD || numBytes < 2 * HASH_CHUNK_SIZE )
+    {
+        return iSamp.getKey();
+    }
+
+    // hash the chunks, then the chunk digests in order, the result depends
+    // on the data only and not on how the chunks were spread over threads
+    std::vector< Util::Digest > digests(
+        ( numBytes + HASH_CHUNK_SIZE - 1 ) / HASH_CHUNK_SIZE );
+    const char * data = static_cast< const char * >( iSamp.getData() );
+    std::size_t podSize = Util::PODNumBytes( pod );
+
+#if !defined(ALEMBIC_LIB_USES_TR1) && __cplusplus >= 201103L
+    ChunkCounter next( 0 );
+    std::vector< std::thread > threads;
+    numThreads = std::min( numThreads, digests.size() );
+    for ( std::size_t i = 1; i < numThreads; ++i )
+    {
+        threads.push_back( std::thread( HashChunks, data, numBytes, podSize,
+                                        std::ref( digests ),
+                                        std::ref( next ) ) );
+    }
+    HashChunks( data, numBytes, podSize, digests, next );
+    for ( std::size_t i = 0; i < threads.size(); ++i )
+    {
+        threads[i].join();
+    }
+#else
+    ChunkCounter next = 0;
+    HashChunks( data, numBytes, podSize, digests, next );
+#endif
+
+    AbcA::ArraySample::Key k;
+    k.numBytes = numBytes;
+    k.origPOD = pod;
+    k.readPOD = pod;
+    Util::MurmurHash3_x64_128( &digests.front(),
+                               digests.size() * sizeof( Util::Digest ),
+                               sizeof( Util::uint64_t ), k.digest.words );
+    return k;
+}
+
 //-*****************************************************************************
 void WriteDimensions( Ogawa::OGroupPtr iGroup,
                       const AbcA::Dimensions & iDims,
@@ -59,6 +59,12 @@ void HashDimensions( const AbcA::Dimensions & iDims,
 WrittenSampleMap& GetWrittenSampleMap(
     AbcA::ArchiveWriterPtr iArchive );
 
+//-*****************************************************************************
+// The key of iSamp, computed on the archives hashing threads, see
+// WriteArchive
+AbcA::ArraySample::Key GetSampleKey( AbcA::ArchiveWriterPtr iArchive,
+                                     const AbcA::ArraySample & iSamp );
+
 //-*****************************************************************************
 void
 WriteDimensions( Ogawa::OGroupPtr iGroup,
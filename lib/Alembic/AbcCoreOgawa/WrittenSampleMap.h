@@ -100,6 +100,7 @@ public:
     // Returns 0 if it can't find it
     WrittenSampleIDPtr find( const AbcA::ArraySample::Key &key ) const
     {
+        Alembic::Util::scoped_lock l( m_lock );
         Map::const_iterator miter = m_map.find( key );
         if ( miter != m_map.end() )
         {
@@ -119,17 +120,22 @@ public:
             ABCA_THROW( "Invalid WrittenSampleIDPtr" );
         }
 
+        Alembic::Util::scoped_lock l( m_lock );
         m_map[r->getKey()] = r;
     }
 
     void clear()
     {
+        Alembic::Util::scoped_lock l( m_lock );
         m_map.clear();
     }
 
 protected:
     typedef AbcA::UnorderedMapUtil<WrittenSampleIDPtr>::umap_type Map;
     Map m_map;
+
+    // samples of different properties may be looked up concurrently
+    mutable Alembic::Util::mutex m_lock;
 };
 
 } // End namespace ALEMBIC_VERSION_NS
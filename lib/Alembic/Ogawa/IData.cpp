@@ -97,6 +97,18 @@ void IData::read(Alembic::Util::uint64_t iSize, void * iData,
     mData->streams->read(iThreadId, mData->pos + iOffset + 8, iSize, iData);
 }
 
+const void * IData::view(Alembic::Util::uint64_t iSize,
+                         Alembic::Util::uint64_t iOffset)
+{
+    if (iSize == 0 || mData->size == 0 || iOffset + iSize > mData->size)
+    {
+        return NULL;
+    }
+
+    // +8 is to account for the size
+    return mData->streams->view(mData->pos + iOffset + 8, iSize);
+}
+
 Alembic::Util::uint64_t IData::getSize() const
 {
     return mData->size;
@@ -53,6 +53,12 @@ public:
     void read(Alembic::Util::uint64_t iSize, void * iData,
               Alembic::Util::uint64_t iOffset, std::size_t iThreadId);
 
+    // zero copy version of read, points at the iSize bytes at iOffset
+    // inside the memory mapped file and stays valid for as long as this
+    // IData exists, NULL if the file isn't memory mapped (use read instead)
+    const void * view(Alembic::Util::uint64_t iSize,
+                      Alembic::Util::uint64_t iOffset);
+
     Alembic::Util::uint64_t getSize() const;
 
     // not really necessary for most workflows, it could be used by some
@@ -68,6 +68,10 @@ public:
 
     bool isLight() const;
 
+    // where the group lives in the file, which identifies it, it is 0 for
+    // an empty group
+    Alembic::Util::uint64_t getPos() const;
+
 private:
     friend class IArchive;
     IGroup(IStreamsPtr iStreams, Alembic::Util::uint64_t iPos, bool iLight,
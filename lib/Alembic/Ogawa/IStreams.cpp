@@ -36,6 +36,16 @@
 #include <Alembic/Ogawa/IStreams.h>
 #include <fstream>
 #include <stdexcept>
+#include <cstring>
+
+#ifndef _WIN32
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+#endif
 
 namespace Alembic {
 namespace Ogawa {
@@ -50,6 +60,9 @@ public:
         valid = false;
         frozen = false;
         version = 0;
+        fd = -1;
+        mapped = NULL;
+        mappedSize = 0;
     }
 
     ~PrivateData()
@@ -59,6 +72,18 @@ public:
             delete [] locks;
         }
 
+#ifndef _WIN32
+        if (mapped)
+        {
+            munmap(const_cast<char *>(mapped), mappedSize);
+        }
+
+        if (fd >= 0)
+        {
+            ::close(fd);
+        }
+#endif
+
         // only cleanup if we were the ones who opened it
         if (!fileName.empty())
         {
@@ -82,9 +107,15 @@ public:
     bool valid;
     bool frozen;
     Alembic::Util::uint16_t version;
+
+    // lock free reading, either through the mapping or with pread on fd
+    int fd;
+    const char * mapped;
+    Alembic::Util::uint64_t mappedSize;
 };
 
-IStreams::IStreams(const std::string & iFileName, std::size_t iNumStreams) :
+IStreams::IStreams(const std::string & iFileName, std::size_t iNumStreams,
+                   bool iUseMMap) :
     mData(new IStreams::PrivateData())
 {
 
@@ -111,9 +142,18 @@ IStreams::IStreams(const std::string & iFileName, std::size_t iNumStreams) :
     }
     else
     {
+        if (iUseMMap)
+        {
+            initLockFree(iFileName);
+        }
+
         // we are valid, so we'll allocate (but not open) the others
-        mData->streams.resize(iNumStreams, NULL);
-        mData->offsets.resize(iNumStreams, 0);
+        // unless we won't be needing them
+        if (!isLockFree())
+        {
+            mData->streams.resize(iNumStreams, NULL);
+            mData->offsets.resize(iNumStreams, 0);
+        }
     }
     mData->locks = new Alembic::Util::mutex[mData->streams.size()];
 }
@@ -192,6 +232,39 @@ void IStreams::init()
     mData->valid = true;
 }
 
+void IStreams::initLockFree(const std::string & iFileName)
+{
+#ifndef _WIN32
+    int fd = ::open(iFileName.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        return;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_size > 0)
+    {
+        void * mapped = mmap(NULL, static_cast<size_t>(st.st_size), PROT_READ,
+                             MAP_PRIVATE, fd, 0);
+        if (mapped != MAP_FAILED)
+        {
+            mData->mapped = static_cast<const char *>(mapped);
+            mData->mappedSize = static_cast<Alembic::Util::uint64_t>(
+                st.st_size);
+
+            // the mapping stays valid without the descriptor
+            ::close(fd);
+            return;
+        }
+    }
+
+    // couldn't map it (out of address space?) so pread from it instead
+    mData->fd = fd;
+#else
+    (void) iFileName;
+#endif
+}
+
 IStreams::~IStreams()
 {
 }
@@ -211,6 +284,23 @@ Alembic::Util::uint16_t IStreams::getVersion()
     return mData->version;
 }
 
+bool IStreams::isLockFree()
+{
+    return mData->mapped != NULL || mData->fd >= 0;
+}
+
+const void * IStreams::view(Alembic::Util::uint64_t iPos,
+                            Alembic::Util::uint64_t iSize)
+{
+    if (mData->mapped == NULL || iPos > mData->mappedSize ||
+        iSize > mData->mappedSize - iPos)
+    {
+        return NULL;
+    }
+
+    return mData->mapped + iPos;
+}
+
 void IStreams::read(std::size_t iThreadId, Alembic::Util::uint64_t iPos,
                     Alembic::Util::uint64_t iSize, void * oBuf)
 {
@@ -219,6 +309,47 @@ void IStreams::read(std::size_t iThreadId, Alembic::Util::uint64_t iPos,
         return;
     }
 
+    if (mData->mapped)
+    {
+        const void * src = view(iPos, iSize);
+        if (src == NULL)
+        {
+            throw std::runtime_error(
+                "Ogawa IStreams::read failed.");
+        }
+
+        memcpy(oBuf, src, iSize);
+        return;
+    }
+
+#ifndef _WIN32
+    if (mData->fd >= 0)
+    {
+        char * buf = static_cast<char *>(oBuf);
+        while (iSize > 0)
+        {
+            ssize_t numRead = pread(mData->fd, buf, iSize,
+                                    static_cast<off_t>(iPos));
+            if (numRead < 0 && errno == EINTR)
+            {
+                continue;
+            }
+
+            // an error, or we hit the end of the file
+            if (numRead <= 0)
+            {
+                throw std::runtime_error(
+                    "Ogawa IStreams::read failed.");
+            }
+
+            buf += numRead;
+            iPos += static_cast<Alembic::Util::uint64_t>(numRead);
+            iSize -= static_cast<Alembic::Util::uint64_t>(numRead);
+        }
+        return;
+    }
+#endif
+
     std::size_t threadId = 0;
     if (iThreadId < mData->streams.size())
     {
@@ -48,7 +48,14 @@ namespace ALEMBIC_VERSION_NS {
 class ALEMBIC_EXPORT IStreams
 {
 public:
-    IStreams(const std::string & iFileName, std::size_t iNumStreams=1);
+    // iUseMMap reads through a read-only memory mapping of the file (or
+    // pread where the file can't be mapped) instead of iNumStreams
+    // std::ifstreams, so any number of threads can read at once without
+    // locking, whatever their thread id
+    // Truncating a mapped file while it is open makes read raise SIGBUS
+    // rather than throw
+    IStreams(const std::string & iFileName, std::size_t iNumStreams=1,
+             bool iUseMMap=false);
     IStreams(const std::vector< std::istream * > & iStreams);
     ~IStreams();
 
@@ -56,16 +63,27 @@ public:
     bool isFrozen();
     Alembic::Util::uint16_t getVersion();
 
+    // true when reads go through the memory mapping or pread instead of
+    // the per thread streams
+    bool isLockFree();
+
     // locks on the threadId, seeks to iPos, and reads iSize bytes into oBuf
+    // (no locking or seeking when lock free)
     void read(std::size_t iThreadId, Alembic::Util::uint64_t iPos,
               Alembic::Util::uint64_t iSize, void * oBuf);
 
+    // the iSize bytes at iPos inside the memory mapping, or NULL when the
+    // file isn't memory mapped, valid for as long as this IStreams exists
+    const void * view(Alembic::Util::uint64_t iPos,
+                      Alembic::Util::uint64_t iSize);
+
 private:
     // noncopyable
     IStreams(const IStreams &);
     const IStreams & operator=(const IStreams &);
 
     void init();
+    void initLockFree(const std::string & iFileName);
 
     class PrivateData;
     Alembic::Util::unique_ptr< PrivateData > mData;
@@ -41,14 +41,14 @@ namespace Alembic {
 namespace Ogawa {
 namespace ALEMBIC_VERSION_NS {
 
-OArchive::OArchive(const std::string & iFileName) :
-    mStream(new OStream(iFileName))
+OArchive::OArchive(const std::string & iFileName, bool iAsync) :
+    mStream(new OStream(iFileName, iAsync))
 {
     mGroup.reset(new OGroup(mStream));
 }
 
-OArchive::OArchive(std::ostream * iStream) :
-    mStream(new OStream(iStream)), mGroup(new OGroup(mStream))
+OArchive::OArchive(std::ostream * iStream, bool iAsync) :
+    mStream(new OStream(iStream, iAsync)), mGroup(new OGroup(mStream))
 {
 }
 
@@ -48,8 +48,9 @@ namespace ALEMBIC_VERSION_NS {
 class ALEMBIC_EXPORT OArchive
 {
 public:
-    OArchive(const std::string & iFileName);
-    OArchive(std::ostream * iStream);
+    // iAsync writes through a background thread, see OStream
+    OArchive(const std::string & iFileName, bool iAsync=false);
+    OArchive(std::ostream * iStream, bool iAsync=false);
     ~OArchive();
 
     OGroupPtr getGroup();
@@ -34,18 +34,82 @@
 //-*****************************************************************************
 
 #include <Alembic/Ogawa/OStream.h>
+#include <algorithm>
+#include <cstring>
 #include <fstream>
 #include <stdexcept>
 
+#if !defined(ALEMBIC_LIB_USES_TR1) && __cplusplus >= 201103L
+#define OGAWA_OSTREAM_THREAD 1
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif
+
 namespace Alembic {
 namespace Ogawa {
 namespace ALEMBIC_VERSION_NS {
 
+namespace {
+
+// size of each of the two buffers used by the asynchronous mode, every
+// buffer after the first one starts on a WRITE_ALIGNMENT boundary of the
+// stream so the file sees large aligned writes
+const std::size_t WRITE_BUFFER_SIZE = 8 * 1024 * 1024;
+const std::size_t WRITE_ALIGNMENT = 4096;
+
+class WriteBuffer : Alembic::Util::noncopyable
+{
+public:
+    WriteBuffer() : raw(new char[WRITE_BUFFER_SIZE + WRITE_ALIGNMENT]),
+        pos(0), size(0), capacity(0)
+    {
+        std::size_t misaligned =
+            reinterpret_cast<std::size_t>(raw) % WRITE_ALIGNMENT;
+        data = raw + (misaligned ? WRITE_ALIGNMENT - misaligned : 0);
+    }
+
+    ~WriteBuffer()
+    {
+        delete [] raw;
+    }
+
+    // start collecting the data from iPos (iStreamPos in the underlying
+    // stream) on
+    void reset(Alembic::Util::uint64_t iPos, Alembic::Util::uint64_t iStreamPos)
+    {
+        pos = iPos;
+        size = 0;
+        capacity = WRITE_BUFFER_SIZE - iStreamPos % WRITE_ALIGNMENT;
+    }
+
+    char * raw;
+    char * data;
+    Alembic::Util::uint64_t pos;
+    std::size_t size;
+    std::size_t capacity;
+};
+
+// a write to data which was already handed off, applied at the very end
+struct Patch
+{
+    Alembic::Util::uint64_t pos;
+    std::size_t offset;
+    std::size_t size;
+};
+
+}
+
 class OStream::PrivateData
 {
 public:
     PrivateData(const std::string & iFileName) :
-        stream(NULL), fileName(iFileName), startPos(0), curPos(0), maxPos(0)
+        stream(NULL), fileName(iFileName), startPos(0), curPos(0), maxPos(0),
+        buffered(false), fill(NULL), pending(NULL), failed(false),
+        discarding(false)
+#ifdef OGAWA_OSTREAM_THREAD
+        , ioPending(false), ioStop(false)
+#endif
     {
         std::ofstream * filestream = new std::ofstream(fileName.c_str(),
             std::ios_base::trunc | std::ios_base::binary);
@@ -66,7 +130,12 @@ public:
     }
 
     PrivateData(std::ostream * iStream) :
-        stream(iStream), startPos(0), curPos(0), maxPos(0)
+        stream(iStream), startPos(0), curPos(0), maxPos(0),
+        buffered(false), fill(NULL), pending(NULL), failed(false),
+        discarding(false)
+#ifdef OGAWA_OSTREAM_THREAD
+        , ioPending(false), ioStop(false)
+#endif
     {
         if (stream)
         {
@@ -83,6 +152,9 @@ public:
 
     ~PrivateData()
     {
+        delete fill;
+        delete pending;
+
         // if this was done via file, try to clean it up
         if (!fileName.empty() && stream)
         {
@@ -95,6 +167,10 @@ public:
         }
     }
 
+    void startBuffering();
+    void bufferedWrite(const char * iBuf, Alembic::Util::uint64_t iSize);
+    bool finishBuffering();
+
 #if defined _WIN32 || defined _WIN64
     char buffer [STREAM_BUF_SIZE];
 #endif
@@ -104,25 +180,287 @@ public:
     Alembic::Util::uint64_t curPos;
     Alembic::Util::uint64_t maxPos;
     Alembic::Util::mutex lock;
+
+    // asynchronous mode, the caller appends to fill while the background
+    // thread writes out pending
+    bool buffered;
+    WriteBuffer * fill;
+    WriteBuffer * pending;
+    std::vector< Patch > patches;
+    std::vector< char > patchData;
+    bool failed;
+
+    // set once a failed background write has been reported, everything
+    // written afterwards is dropped so that freezing the groups on the way
+    // out (from destructors) doesn't throw again
+    bool discarding;
+
+private:
+    void append(const char * iBuf, Alembic::Util::uint64_t iSize);
+    void patch(Alembic::Util::uint64_t iPos, const char * iBuf,
+               Alembic::Util::uint64_t iSize);
+    void handOff();
+    void writeBuffer(const WriteBuffer & iBuffer);
+
+#ifdef OGAWA_OSTREAM_THREAD
+    void run();
+
+    std::thread ioThread;
+    std::mutex ioMutex;
+    std::condition_variable ioCond;
+    bool ioPending;
+    bool ioStop;
+#endif
 };
 
-OStream::OStream(const std::string & iFileName) :
+void OStream::PrivateData::startBuffering()
+{
+    fill = new WriteBuffer();
+    pending = new WriteBuffer();
+    fill->reset(curPos, curPos + startPos);
+    buffered = true;
+
+#ifdef OGAWA_OSTREAM_THREAD
+    ioThread = std::thread(&OStream::PrivateData::run, this);
+#endif
+}
+
+void OStream::PrivateData::bufferedWrite(const char * iBuf,
+                                         Alembic::Util::uint64_t iSize)
+{
+    if (discarding)
+    {
+        return;
+    }
+
+    // anything before maxPos is rewriting what is already there
+    if (curPos < maxPos)
+    {
+        Alembic::Util::uint64_t size = std::min(iSize, maxPos - curPos);
+        patch(curPos, iBuf, size);
+        curPos += size;
+        iBuf += size;
+        iSize -= size;
+    }
+
+    if (iSize == 0)
+    {
+        return;
+    }
+
+    if (curPos != maxPos)
+    {
+        throw std::runtime_error(
+            "Ogawa OStream can not write past the end of the stream.");
+    }
+
+    append(iBuf, iSize);
+    curPos += iSize;
+    maxPos = curPos;
+}
+
+void OStream::PrivateData::append(const char * iBuf,
+                                  Alembic::Util::uint64_t iSize)
+{
+    while (iSize > 0)
+    {
+        std::size_t size = (std::size_t) std::min(iSize,
+            (Alembic::Util::uint64_t)(fill->capacity - fill->size));
+        memcpy(fill->data + fill->size, iBuf, size);
+        fill->size += size;
+        iBuf += size;
+        iSize -= size;
+
+        if (fill->size == fill->capacity)
+        {
+            handOff();
+        }
+    }
+}
+
+void OStream::PrivateData::patch(Alembic::Util::uint64_t iPos,
+                                 const char * iBuf,
+                                 Alembic::Util::uint64_t iSize)
+{
+    // the part which is still in the fill buffer is patched in place, the
+    // rest is deferred, fill always holds the tail of the stream
+    if (iPos + iSize > fill->pos)
+    {
+        Alembic::Util::uint64_t start = std::max(iPos, fill->pos);
+        memcpy(fill->data + (start - fill->pos), iBuf + (start - iPos),
+               (std::size_t)(iPos + iSize - start));
+        iSize = start - iPos;
+    }
+
+    if (iSize > 0)
+    {
+        Patch p;
+        p.pos = iPos;
+        p.offset = patchData.size();
+        p.size = (std::size_t) iSize;
+        patches.push_back(p);
+        patchData.insert(patchData.end(), iBuf, iBuf + iSize);
+    }
+}
+
+void OStream::PrivateData::handOff()
+{
+    Alembic::Util::uint64_t next = fill->pos + fill->size;
+
+#ifdef OGAWA_OSTREAM_THREAD
+    {
+        std::unique_lock< std::mutex > l(ioMutex);
+        while (ioPending)
+        {
+            ioCond.wait(l);
+        }
+
+        if (failed)
+        {
+            discarding = true;
+            throw std::runtime_error("Ogawa OStream failed to write data.");
+        }
+
+        std::swap(fill, pending);
+        ioPending = true;
+    }
+    ioCond.notify_all();
+#else
+    try
+    {
+        writeBuffer(*fill);
+    }
+    catch (std::exception &)
+    {
+        discarding = true;
+        throw std::runtime_error("Ogawa OStream failed to write data.");
+    }
+#endif
+
+    fill->reset(next, next + startPos);
+}
+
+void OStream::PrivateData::writeBuffer(const WriteBuffer & iBuffer)
+{
+    stream->seekp(iBuffer.pos + startPos).write(iBuffer.data, iBuffer.size);
+}
+
+#ifdef OGAWA_OSTREAM_THREAD
+void OStream::PrivateData::run()
+{
+    std::unique_lock< std::mutex > l(ioMutex);
+    for (;;)
+    {
+        while (!ioPending && !ioStop)
+        {
+            ioCond.wait(l);
+        }
+
+        if (!ioPending)
+        {
+            break;
+        }
+
+        l.unlock();
+        bool ok = true;
+        try
+        {
+            writeBuffer(*pending);
+        }
+        catch (std::exception &)
+        {
+            ok = false;
+        }
+        l.lock();
+
+        if (!ok)
+        {
+            failed = true;
+        }
+        ioPending = false;
+        ioCond.notify_all();
+    }
+}
+#endif
+
+// flushes everything and applies the deferred patches, returns false if
+// any of it could not be written
+bool OStream::PrivateData::finishBuffering()
+{
+    bool ok = !discarding;
+    try
+    {
+        if (ok && fill->size > 0)
+        {
+            handOff();
+        }
+    }
+    catch (std::exception &)
+    {
+        ok = false;
+    }
+
+#ifdef OGAWA_OSTREAM_THREAD
+    {
+        std::unique_lock< std::mutex > l(ioMutex);
+        while (ioPending)
+        {
+            ioCond.wait(l);
+        }
+        ioStop = true;
+        ok = ok && !failed;
+    }
+    ioCond.notify_all();
+    ioThread.join();
+#endif
+
+    if (!ok)
+    {
+        return false;
+    }
+
+    try
+    {
+        std::vector< Patch >::const_iterator it;
+        for (it = patches.begin(); it != patches.end(); ++it)
+        {
+            stream->seekp(it->pos + startPos).write(
+                &patchData[it->offset], it->size);
+        }
+        stream->flush();
+    }
+    catch (std::exception &)
+    {
+        return false;
+    }
+
+    return true;
+}
+
+OStream::OStream(const std::string & iFileName, bool iAsync) :
     mData(new PrivateData(iFileName))
 {
-    init();
+    init(iAsync);
 }
 
 // we'll be writing from this already open stream which we don't own
-OStream::OStream(std::ostream * iStream) : mData(new PrivateData(iStream))
+OStream::OStream(std::ostream * iStream, bool iAsync) :
+    mData(new PrivateData(iStream))
 {
-    init();
+    init(iAsync);
 }
 
 OStream::~OStream()
 {
-    // write our "frozen" byte (totally done writing)
+    // write our "frozen" byte (totally done writing), unless the buffered
+    // data didn't make it
     if (isValid())
     {
+        if (mData->buffered && !mData->finishBuffering())
+        {
+            return;
+        }
+
         char frozen = 0xff;
         mData->stream->seekp(mData->startPos + 5).write(&frozen, 1).flush();
     }
@@ -133,7 +471,7 @@ bool OStream::isValid()
     return mData->stream != NULL;
 }
 
-void OStream::init()
+void OStream::init(bool iAsync)
 {
     // simple temporary endian check
     union {
@@ -162,6 +500,11 @@ void OStream::init()
         {
             mData->maxPos = mData->curPos;
         }
+
+        if (iAsync)
+        {
+            mData->startBuffering();
+        }
     }
 }
 
@@ -172,7 +515,10 @@ Alembic::Util::uint64_t OStream::getAndSeekEndPos()
         Alembic::Util::scoped_lock l(mData->lock);
 
         mData->curPos = mData->maxPos;
-        mData->stream->seekp(mData->curPos + mData->startPos);
+        if (!mData->buffered)
+        {
+            mData->stream->seekp(mData->curPos + mData->startPos);
+        }
         return mData->curPos;
     }
     return 0;
@@ -183,7 +529,10 @@ void OStream::seek(Alembic::Util::uint64_t iPos)
     if (isValid())
     {
         Alembic::Util::scoped_lock l(mData->lock);
-        mData->stream->seekp(iPos + mData->startPos);
+        if (!mData->buffered)
+        {
+            mData->stream->seekp(iPos + mData->startPos);
+        }
         mData->curPos = iPos;
     }
 }
@@ -193,6 +542,12 @@ void OStream::write(const void * iBuf, Alembic::Util::uint64_t iSize)
     if (isValid())
     {
         Alembic::Util::scoped_lock l(mData->lock);
+        if (mData->buffered)
+        {
+            mData->bufferedWrite((const char *)iBuf, iSize);
+            return;
+        }
+
         mData->stream->write((const char *)iBuf, iSize).flush();
         mData->curPos += iSize;
         if(mData->curPos > mData->maxPos)
@@ -52,8 +52,14 @@ namespace ALEMBIC_VERSION_NS {
 class ALEMBIC_EXPORT OStream
 {
 public:
-    OStream(const std::string & iFileName);
-    OStream(std::ostream * iStream);
+    // With iAsync the data is collected in large buffers which are written
+    // out by a background thread while the caller keeps going, seeks back
+    // to already handed off data (header patches) are deferred until the
+    // stream is destroyed. A failed background write is thrown by the write
+    // that hands off the next buffer, everything after it is dropped and
+    // the archive is not marked as frozen.
+    OStream(const std::string & iFileName, bool iAsync=false);
+    OStream(std::ostream * iStream, bool iAsync=false);
     ~OStream();
 
     bool isValid();
@@ -70,7 +76,7 @@ private:
     class PrivateData;
     Alembic::Util::unique_ptr< PrivateData > mData;
 
-    void init();
+    void init(bool iAsync);
 };
 
 typedef Alembic::Util::shared_ptr< OStream > OStreamPtr;
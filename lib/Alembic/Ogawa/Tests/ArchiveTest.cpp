@@ -36,20 +36,25 @@
 
 #include <Alembic/Ogawa/All.h>
 #include <Alembic/AbcCoreAbstract/Tests/Assert.h>
+#include <Alembic/Ogawa/Tests/ReadMode.h>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
 
 void test()
 {
     {
         Alembic::Ogawa::OArchive oa("archiveTest.ogawa");
         TESTING_ASSERT(oa.isValid());
-        Alembic::Ogawa::IArchive ia("archiveTest.ogawa");
+        Alembic::Ogawa::IArchive ia("archiveTest.ogawa", 1, kOgawaTestUseMMap);
         TESTING_ASSERT(ia.isValid());
         TESTING_ASSERT(!ia.isFrozen());
         TESTING_ASSERT(ia.getVersion() == 1);
         TESTING_ASSERT(ia.getGroup()->getNumChildren() == 0);
     }
 
-    Alembic::Ogawa::IArchive ia("archiveTest.ogawa");
+    Alembic::Ogawa::IArchive ia("archiveTest.ogawa", 1, kOgawaTestUseMMap);
     TESTING_ASSERT(ia.isValid());
     TESTING_ASSERT(ia.isFrozen());
     TESTING_ASSERT(ia.getVersion() == 1);
@@ -77,9 +82,172 @@ void stringStreamTest()
     TESTING_ASSERT(ia.getGroup()->getNumChildren() == 0);
 }
 
+// spans several of the buffers used by asynchronous writes, with rewrites
+// and group patches landing in data which was handed off long before
+void writeContents(Alembic::Ogawa::OArchive & oa)
+{
+    std::vector< char > buf(3 * 1024 * 1024 + 7);
+    for (std::size_t i = 0; i < buf.size(); ++i)
+    {
+        buf[i] = (char)(i * 31 + i / 4093);
+    }
+
+    Alembic::Ogawa::OGroupPtr top = oa.getGroup();
+
+    // frozen last
+    Alembic::Ogawa::OGroupPtr early = top->addGroup();
+    Alembic::Ogawa::ODataPtr first = early->addData(5, &buf[0]);
+
+    for (std::size_t i = 0; i < 12; ++i)
+    {
+        Alembic::Ogawa::OGroupPtr child = top->addGroup();
+        child->addData(buf.size() - i * 1001, &buf[i]);
+        child->addEmptyData();
+        child->addEmptyGroup();
+        child->addData(i + 1, &buf[i * 3]);
+        child->freeze();
+    }
+
+    first->rewrite(3, &buf[1000], 1);
+    early->addData(7, &buf[100]);
+    early->freeze();
+    top->addData(buf.size() / 2, &buf[11]);
+}
+
+void asyncTest()
+{
+    // the same archive, to a stream and to a file, synchronously or not
+    std::stringstream syncStrm;
+    std::stringstream asyncStrm;
+    syncStrm << "potato!";
+    asyncStrm << "potato!";
+    {
+        Alembic::Ogawa::OArchive oa(&syncStrm);
+        writeContents(oa);
+    }
+    {
+        Alembic::Ogawa::OArchive oa(&asyncStrm, true);
+        TESTING_ASSERT(oa.isValid());
+        writeContents(oa);
+    }
+    TESTING_ASSERT(syncStrm.str().size() > 16 * 1024 * 1024);
+    TESTING_ASSERT(syncStrm.str() == asyncStrm.str());
+
+    {
+        Alembic::Ogawa::OArchive oa("asyncSyncTest.ogawa");
+        writeContents(oa);
+    }
+    {
+        Alembic::Ogawa::OArchive oa("asyncTest.ogawa", true);
+        writeContents(oa);
+    }
+
+    std::ifstream syncFile("asyncSyncTest.ogawa", std::ios::binary);
+    std::ifstream asyncFile("asyncTest.ogawa", std::ios::binary);
+    std::string syncData((std::istreambuf_iterator< char >(syncFile)),
+                         std::istreambuf_iterator< char >());
+    std::string asyncData((std::istreambuf_iterator< char >(asyncFile)),
+                          std::istreambuf_iterator< char >());
+    TESTING_ASSERT(syncData == syncStrm.str().substr(7));
+    TESTING_ASSERT(syncData == asyncData);
+
+    Alembic::Ogawa::IArchive ia("asyncTest.ogawa", 1, kOgawaTestUseMMap);
+    TESTING_ASSERT(ia.isValid());
+    TESTING_ASSERT(ia.isFrozen());
+    TESTING_ASSERT(ia.getGroup()->getNumChildren() == 14);
+}
+
+// keeps the first iLimit bytes of the stream and fails any write past them
+class LimitedBuf : public std::streambuf
+{
+public:
+    LimitedBuf(std::size_t iLimit) : data(iLimit, 0), pos(0) {}
+
+    std::string data;
+
+protected:
+    std::streamsize xsputn(const char * iBuf, std::streamsize iSize)
+    {
+        if (pos + iSize > data.size())
+        {
+            return 0;
+        }
+        data.replace(pos, iSize, iBuf, iSize);
+        pos += iSize;
+        return iSize;
+    }
+
+    int_type overflow(int_type iChar)
+    {
+        if (traits_type::eq_int_type(iChar, traits_type::eof()))
+        {
+            return traits_type::not_eof(iChar);
+        }
+        char c = traits_type::to_char_type(iChar);
+        return xsputn(&c, 1) == 1 ? iChar : traits_type::eof();
+    }
+
+    pos_type seekoff(off_type iOff, std::ios_base::seekdir iDir,
+                     std::ios_base::openmode iMode)
+    {
+        if (iDir == std::ios_base::beg)
+        {
+            return seekpos(iOff, iMode);
+        }
+        else if (iDir == std::ios_base::cur)
+        {
+            return seekpos(pos + iOff, iMode);
+        }
+        return pos_type(off_type(-1));
+    }
+
+    pos_type seekpos(pos_type iPos, std::ios_base::openmode)
+    {
+        pos = (std::size_t) iPos;
+        return iPos;
+    }
+
+private:
+    std::size_t pos;
+};
+
+void asyncErrorTest()
+{
+    // a background write failure is thrown from a later write, and the
+    // archive is not marked as frozen
+    LimitedBuf limited(1024 * 1024);
+    std::ostream strm(&limited);
+    std::vector< char > buf(1024 * 1024);
+
+    bool threw = false;
+    {
+        Alembic::Ogawa::OArchive oa(&strm, true);
+        Alembic::Ogawa::OGroupPtr top = oa.getGroup();
+        try
+        {
+            for (std::size_t i = 0; i < 64; ++i)
+            {
+                top->addData(buf.size(), &buf[0]);
+            }
+        }
+        catch (std::runtime_error &)
+        {
+            threw = true;
+        }
+
+        // what is written afterwards, when freezing the groups, is dropped
+        top->addData(buf.size(), &buf[0]);
+    }
+    TESTING_ASSERT(threw);
+    TESTING_ASSERT(limited.data.compare(0, 5, "Ogawa") == 0);
+    TESTING_ASSERT(limited.data[5] == 0);
+}
+
 int main ( int argc, char *argv[] )
 {
     test();
     stringStreamTest();
+    asyncTest();
+    asyncErrorTest();
     return 0;
-}
\ No newline at end of file
+}
@@ -36,6 +36,7 @@
 
 #include <Alembic/Ogawa/All.h>
 #include <Alembic/AbcCoreAbstract/Tests/Assert.h>
+#include <Alembic/Ogawa/Tests/ReadMode.h>
 #include <iostream>
 
 void test()
@@ -80,7 +81,7 @@ void test()
     bcd->rewrite(1, &nine, 4); // 0 1 2 3 9 5 6 7
 }
 
-    Alembic::Ogawa::IArchive ia("simpleTest.ogawa");
+    Alembic::Ogawa::IArchive ia("simpleTest.ogawa", 1, kOgawaTestUseMMap);
     Alembic::Ogawa::IGroupPtr top = ia.getGroup();
 
     TESTING_ASSERT(top->getNumChildren() == 3);
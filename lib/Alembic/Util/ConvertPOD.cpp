@@ -0,0 +1,1518 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2013,
+//  Sony Pictures Imageworks, Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#include <Alembic/Util/ConvertPOD.h>
+
+#include <algorithm>
+#include <cstring>
+
+// this is MANDATORY to make std::numeric_limits<>::max() & co.
+// work for half (Util::float16_t) !
+#include <halfLimits.h>
+
+#if defined(_MSC_VER)
+#  if defined(max)
+#    undef max
+#  endif
+#  if defined(min)
+#    undef min
+#  endif
+#endif
+
+// vectorised float16, float32 and float64 conversions, picked at runtime
+// when the CPU supports them
+#if ( defined(__GNUC__) || defined(__clang__) ) && \
+    ( defined(__x86_64__) || defined(__i386__) )
+#define ALEMBIC_CONVERT_X86 1
+#include <cpuid.h>
+#include <immintrin.h>
+#endif
+
+namespace Alembic {
+namespace Util {
+namespace ALEMBIC_VERSION_NS {
+
+//-*****************************************************************************
+template < typename FROMPOD >
+void ConvertToBool( char * fromBuffer, void * toBuffer, std::size_t iSize )
+{
+    std::size_t numConvert = iSize / sizeof( FROMPOD );
+
+    FROMPOD * fromPodBuffer = ( FROMPOD * ) ( fromBuffer );
+    Util::bool_t * toPodBuffer = (Util::bool_t *) ( toBuffer );
+
+    for ( std::size_t i = 0; i < numConvert; ++i )
+    {
+        Util::bool_t t = ( fromPodBuffer[i] != 0 );
+        toPodBuffer[i] = t;
+    }
+
+}
+
+//-*****************************************************************************
+template < typename TOPOD >
+void ConvertFromBool( char * fromBuffer, void * toBuffer, std::size_t iSize )
+{
+    // bool_t is stored as 1 bytes so iSize really is the size of the array
+
+    TOPOD * toPodBuffer = ( TOPOD * ) ( toBuffer );
+
+    // do it backwards so we don't accidentally clobber over ourself
+    for ( std::size_t i = iSize; i > 0; --i )
+    {
+        TOPOD t = static_cast< TOPOD >( fromBuffer[i-1] != 0 );
+        toPodBuffer[i-1] = t;
+    }
+
+}
+
+//-*****************************************************************************
+template < typename TOPOD >
+void getMinAndMax(TOPOD & iMin, TOPOD & iMax)
+{
+    iMin = std::numeric_limits<TOPOD>::min();
+    iMax = std::numeric_limits<TOPOD>::max();
+}
+
+//-*****************************************************************************
+template <>
+void getMinAndMax<Util::float16_t>(
+    Util::float16_t & iMin, Util::float16_t & iMax )
+{
+    iMax = std::numeric_limits<Util::float16_t>::max();
+    iMin = -iMax;
+}
+
+//-*****************************************************************************
+template <>
+void getMinAndMax<Util::float32_t>(
+    Util::float32_t & iMin, Util::float32_t & iMax )
+{
+    iMax = std::numeric_limits<Util::float32_t>::max();
+    iMin = -iMax;
+}
+
+//-*****************************************************************************
+template <>
+void getMinAndMax<Util::float64_t>(
+    Util::float64_t & iMin, Util::float64_t & iMax )
+{
+    iMax = std::numeric_limits<Util::float64_t>::max();
+    iMin = -iMax;
+}
+
+//-*****************************************************************************
+// Number of elements converted at a time. Each block is copied to and from
+// the stack, so the conversion loop can't alias and the compiler is free to
+// vectorise it, and an in place conversion only has to get the order of the
+// blocks right.
+static const std::size_t CONVERT_BLOCK_SIZE = 256;
+
+//-*****************************************************************************
+template < typename FROMPOD, typename TOPOD >
+void ConvertBlock( const char * fromBuffer, char * toBuffer, std::size_t iNum,
+                   FROMPOD iMin, FROMPOD iMax )
+{
+    FROMPOD fromPods[CONVERT_BLOCK_SIZE];
+    TOPOD toPods[CONVERT_BLOCK_SIZE];
+
+    memcpy( fromPods, fromBuffer, iNum * sizeof( FROMPOD ) );
+
+    for ( std::size_t i = 0; i < iNum; ++i )
+    {
+        FROMPOD f = fromPods[i];
+        f = ( f < iMin ) ? iMin : f;
+        f = ( f > iMax ) ? iMax : f;
+        toPods[i] = static_cast< TOPOD >( f );
+    }
+
+    memcpy( toBuffer, toPods, iNum * sizeof( TOPOD ) );
+}
+
+//-*****************************************************************************
+template < typename FROMPOD, typename TOPOD >
+void ConvertData( char * fromBuffer, void * toBuffer, std::size_t iSize )
+{
+    std::size_t numConvert = iSize / sizeof( FROMPOD );
+
+    char * toCharBuffer = static_cast< char * >( toBuffer );
+
+    if ( sizeof( FROMPOD ) > sizeof( TOPOD ) )
+    {
+        // get the min and max of the smaller TOPOD type
+        TOPOD toPodMin = 0;
+        TOPOD toPodMax = 0;
+        getMinAndMax< TOPOD >( toPodMin, toPodMax );
+
+        // cast it back into the larger FROMPOD
+        FROMPOD podMin = static_cast< FROMPOD >( toPodMin );
+        FROMPOD podMax = static_cast< FROMPOD >( toPodMax );
+
+        // handle from signed to unsigned wrap case
+        if ( podMin > podMax )
+        {
+            podMin = 0;
+        }
+
+        for ( std::size_t i = 0; i < numConvert; i += CONVERT_BLOCK_SIZE )
+        {
+            ConvertBlock< FROMPOD, TOPOD >(
+                fromBuffer + i * sizeof( FROMPOD ),
+                toCharBuffer + i * sizeof( TOPOD ),
+                std::min( CONVERT_BLOCK_SIZE, numConvert - i ),
+                podMin, podMax );
+        }
+    }
+    else
+    {
+        TOPOD toPodMin = 0;
+        TOPOD toPodMax = 0;
+        getMinAndMax< TOPOD >( toPodMin, toPodMax);
+
+        FROMPOD podMin = 0;
+        FROMPOD podMax = 0;
+        getMinAndMax< FROMPOD >( podMin, podMax);
+
+        if ( podMin != 0 && toPodMin == 0 )
+        {
+            podMin = 0;
+        }
+        // adjust max when converting to signed from unsigned of the same
+        // sized integral
+        else if ( podMin == 0 && toPodMin != 0 &&
+                  sizeof( FROMPOD ) == sizeof( TOPOD ) )
+        {
+            podMax = static_cast< FROMPOD >( toPodMax );
+        }
+
+        // do it backwards so we don't accidentally clobber over ourself
+        for ( std::size_t i = numConvert; i > 0; )
+        {
+            std::size_t num = std::min( CONVERT_BLOCK_SIZE, i );
+            i -= num;
+            ConvertBlock< FROMPOD, TOPOD >(
+                fromBuffer + i * sizeof( FROMPOD ),
+                toCharBuffer + i * sizeof( TOPOD ),
+                num, podMin, podMax );
+        }
+    }
+
+}
+
+#ifdef ALEMBIC_CONVERT_X86
+//-*****************************************************************************
+enum CpuFeature
+{
+    kCpuAVX = 1,
+    kCpuF16C = 2
+};
+
+//-*****************************************************************************
+static int DetectCpuFeatures()
+{
+    unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+    if ( !__get_cpuid( 1, &eax, &ebx, &ecx, &edx ) )
+    {
+        return 0;
+    }
+
+    // AVX also needs the OS to save the YMM registers (OSXSAVE + XCR0)
+    const unsigned int osxsave = 1 << 27;
+    const unsigned int avx = 1 << 28;
+    const unsigned int f16c = 1 << 29;
+    if ( ( ecx & osxsave ) == 0 || ( ecx & avx ) == 0 )
+    {
+        return 0;
+    }
+
+    unsigned int xcr0 = 0, xcr0High = 0;
+    __asm__ __volatile__ ( "xgetbv" : "=a" ( xcr0 ), "=d" ( xcr0High ) :
+                           "c" ( 0 ) );
+    if ( ( xcr0 & 6 ) != 6 )
+    {
+        return 0;
+    }
+
+    return kCpuAVX | ( ( ecx & f16c ) ? kCpuF16C : 0 );
+}
+
+//-*****************************************************************************
+static bool HasCpuFeatures( int iFeatures )
+{
+    static const int features = DetectCpuFeatures();
+    return ( features & iFeatures ) == iFeatures;
+}
+
+//-*****************************************************************************
+// The kernels below convert a multiple of their vector width and clamp
+// exactly like ConvertData: min/max are given the bound first so that NaNs
+// are passed through. Within an iteration everything is loaded before it is
+// stored and narrowing goes forwards while widening goes backwards, so in
+// place conversions work.
+//-*****************************************************************************
+__attribute__(( target( "avx,f16c" ) ))
+static void HalfToFloatF16C( const char * fromBuffer, void * toBuffer,
+                             std::size_t iNum )
+{
+    const float halfMax =
+        static_cast< float >( std::numeric_limits< float16_t >::max() );
+    const __m256 lo = _mm256_set1_ps( -halfMax );
+    const __m256 hi = _mm256_set1_ps( halfMax );
+    float32_t * toPodBuffer = static_cast< float32_t * >( toBuffer );
+
+    for ( std::size_t i = iNum; i > 0; i -= 8 )
+    {
+        __m128i h = _mm_loadu_si128(
+            reinterpret_cast< const __m128i * >( fromBuffer + ( i - 8 ) * 2 ) );
+        __m256 f = _mm256_cvtph_ps( h );
+        f = _mm256_min_ps( hi, _mm256_max_ps( lo, f ) );
+        _mm256_storeu_ps( toPodBuffer + i - 8, f );
+    }
+}
+
+//-*****************************************************************************
+__attribute__(( target( "avx,f16c" ) ))
+static void FloatToHalfF16C( const char * fromBuffer, void * toBuffer,
+                             std::size_t iNum )
+{
+    const float halfMax =
+        static_cast< float >( std::numeric_limits< float16_t >::max() );
+    const __m256 lo = _mm256_set1_ps( -halfMax );
+    const __m256 hi = _mm256_set1_ps( halfMax );
+    const float32_t * fromPodBuffer =
+        reinterpret_cast< const float32_t * >( fromBuffer );
+    char * toCharBuffer = static_cast< char * >( toBuffer );
+
+    for ( std::size_t i = 0; i < iNum; i += 8 )
+    {
+        __m256 f = _mm256_loadu_ps( fromPodBuffer + i );
+        f = _mm256_min_ps( hi, _mm256_max_ps( lo, f ) );
+        __m128i h = _mm256_cvtps_ph( f, _MM_FROUND_TO_NEAREST_INT );
+        _mm_storeu_si128( reinterpret_cast< __m128i * >( toCharBuffer + i * 2 ),
+                          h );
+    }
+}
+
+//-*****************************************************************************
+__attribute__(( target( "avx" ) ))
+static void DoubleToFloatAVX( const char * fromBuffer, void * toBuffer,
+                              std::size_t iNum )
+{
+    const double floatMax = std::numeric_limits< float32_t >::max();
+    const __m256d lo = _mm256_set1_pd( -floatMax );
+    const __m256d hi = _mm256_set1_pd( floatMax );
+    const float64_t * fromPodBuffer =
+        reinterpret_cast< const float64_t * >( fromBuffer );
+    float32_t * toPodBuffer = static_cast< float32_t * >( toBuffer );
+
+    for ( std::size_t i = 0; i < iNum; i += 4 )
+    {
+        __m256d d = _mm256_loadu_pd( fromPodBuffer + i );
+        d = _mm256_min_pd( hi, _mm256_max_pd( lo, d ) );
+        _mm_storeu_ps( toPodBuffer + i, _mm256_cvtpd_ps( d ) );
+    }
+}
+
+//-*****************************************************************************
+__attribute__(( target( "avx" ) ))
+static void FloatToDoubleAVX( const char * fromBuffer, void * toBuffer,
+                              std::size_t iNum )
+{
+    const float floatMax = std::numeric_limits< float32_t >::max();
+    const __m128 lo = _mm_set1_ps( -floatMax );
+    const __m128 hi = _mm_set1_ps( floatMax );
+    const float32_t * fromPodBuffer =
+        reinterpret_cast< const float32_t * >( fromBuffer );
+    float64_t * toPodBuffer = static_cast< float64_t * >( toBuffer );
+
+    for ( std::size_t i = iNum; i > 0; i -= 4 )
+    {
+        __m128 f = _mm_loadu_ps( fromPodBuffer + i - 4 );
+        f = _mm_min_ps( hi, _mm_max_ps( lo, f ) );
+        _mm256_storeu_pd( toPodBuffer + i - 4, _mm256_cvtps_pd( f ) );
+    }
+}
+#endif
+
+//-*****************************************************************************
+typedef void ( *ConvertKernel )( const char *, void *, std::size_t );
+
+//-*****************************************************************************
+// Runs iKernel on as many elements as it can handle (a multiple of iWidth)
+// and ConvertData on the rest, in the same order ConvertData would use.
+template < typename FROMPOD, typename TOPOD >
+void ConvertWithKernel( ConvertKernel iKernel, std::size_t iWidth,
+                        char * fromBuffer, void * toBuffer, std::size_t iSize )
+{
+    std::size_t numConvert = iSize / sizeof( FROMPOD );
+    std::size_t numKernel = numConvert - numConvert % iWidth;
+
+    char * fromTail = fromBuffer + numKernel * sizeof( FROMPOD );
+    char * toTail = static_cast< char * >( toBuffer ) +
+        numKernel * sizeof( TOPOD );
+    std::size_t tailSize = ( numConvert - numKernel ) * sizeof( FROMPOD );
+
+    if ( sizeof( FROMPOD ) > sizeof( TOPOD ) )
+    {
+        iKernel( fromBuffer, toBuffer, numKernel );
+        ConvertData< FROMPOD, TOPOD >( fromTail, toTail, tailSize );
+    }
+    else
+    {
+        ConvertData< FROMPOD, TOPOD >( fromTail, toTail, tailSize );
+        iKernel( fromBuffer, toBuffer, numKernel );
+    }
+}
+
+//-*****************************************************************************
+static void ConvertHalfToFloat( char * fromBuffer, void * toBuffer,
+                                std::size_t iSize )
+{
+#ifdef ALEMBIC_CONVERT_X86
+    if ( HasCpuFeatures( kCpuAVX | kCpuF16C ) )
+    {
+        ConvertWithKernel< float16_t, float32_t >( HalfToFloatF16C, 8,
+            fromBuffer, toBuffer, iSize );
+        return;
+    }
+#endif
+    ConvertData< float16_t, float32_t >( fromBuffer, toBuffer, iSize );
+}
+
+//-*****************************************************************************
+static void ConvertFloatToHalf( char * fromBuffer, void * toBuffer,
+                                std::size_t iSize )
+{
+#ifdef ALEMBIC_CONVERT_X86
+    if ( HasCpuFeatures( kCpuAVX | kCpuF16C ) )
+    {
+        ConvertWithKernel< float32_t, float16_t >( FloatToHalfF16C, 8,
+            fromBuffer, toBuffer, iSize );
+        return;
+    }
+#endif
+    ConvertData< float32_t, float16_t >( fromBuffer, toBuffer, iSize );
+}
+
+//-*****************************************************************************
+static void ConvertDoubleToFloat( char * fromBuffer, void * toBuffer,
+                                  std::size_t iSize )
+{
+#ifdef ALEMBIC_CONVERT_X86
+    if ( HasCpuFeatures( kCpuAVX ) )
+    {
+        ConvertWithKernel< float64_t, float32_t >( DoubleToFloatAVX, 4,
+            fromBuffer, toBuffer, iSize );
+        return;
+    }
+#endif
+    ConvertData< float64_t, float32_t >( fromBuffer, toBuffer, iSize );
+}
+
+//-*****************************************************************************
+static void ConvertFloatToDouble( char * fromBuffer, void * toBuffer,
+                                  std::size_t iSize )
+{
+#ifdef ALEMBIC_CONVERT_X86
+    if ( HasCpuFeatures( kCpuAVX ) )
+    {
+        ConvertWithKernel< float32_t, float64_t >( FloatToDoubleAVX, 4,
+            fromBuffer, toBuffer, iSize );
+        return;
+    }
+#endif
+    ConvertData< float32_t, float64_t >( fromBuffer, toBuffer, iSize );
+}
+
+//-*****************************************************************************
+void
+ConvertData( Alembic::Util::PlainOldDataType fromPod,
+             Alembic::Util::PlainOldDataType toPod,
+             char * fromBuffer,
+             void * toBuffer,
+             std::size_t iSize )
+{
+
+    switch (fromPod)
+    {
+        case Util::kBooleanPOD:
+        {
+            switch (toPod)
+            {
+                case Util::kUint8POD:
+                {
+                    ConvertFromBool< Util::uint8_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kInt8POD:
+                {
+                    ConvertFromBool< Util::int8_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kUint16POD:
+                {
+                    ConvertFromBool< Util::uint16_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kInt16POD:
+                {
+                    ConvertFromBool< Util::int16_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kUint32POD:
+                {
+                    ConvertFromBool< Util::uint32_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kInt32POD:
+                {
+                    ConvertFromBool< Util::int32_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kUint64POD:
+                {
+                    ConvertFromBool< Util::uint64_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kInt64POD:
+                {
+                    ConvertFromBool< Util::int64_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kFloat16POD:
+                {
+                    ConvertFromBool< Util::float16_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kFloat32POD:
+                {
+                    ConvertFromBool< Util::float32_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kFloat64POD:
+                {
+                    ConvertFromBool< Util::float64_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                default:
+                break;
+            }
+        }
+        break;
+
+        case Util::kUint8POD:
+        {
+            switch (toPod)
+            {
+                case Util::kBooleanPOD:
+                {
+                    ConvertToBool< Util::uint8_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kInt8POD:
+                {
+                    ConvertData< Util::uint8_t, Util::int8_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kUint16POD:
+                {
+                    ConvertData< Util::uint8_t, Util::uint16_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kInt16POD:
+                {
+                    ConvertData< Util::uint8_t, Util::int16_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kUint32POD:
+                {
+                    ConvertData< Util::uint8_t, Util::uint32_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kInt32POD:
+                {
+                    ConvertData< Util::uint8_t, Util::int32_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kUint64POD:
+                {
+                    ConvertData< Util::uint8_t, Util::uint64_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kInt64POD:
+                {
+                    ConvertData< Util::uint8_t, Util::int64_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kFloat16POD:
+                {
+                    ConvertData< Util::uint8_t, Util::float16_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kFloat32POD:
+                {
+                    ConvertData< Util::uint8_t, Util::float32_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kFloat64POD:
+                {
+                    ConvertData< Util::uint8_t, Util::float64_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                default:
+                break;
+            }
+        }
+        break;
+
+        case Util::kInt8POD:
+        {
+            switch (toPod)
+            {
+                case Util::kBooleanPOD:
+                {
+                    ConvertToBool< Util::int8_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kUint8POD:
+                {
+                    ConvertData< Util::int8_t, Util::uint8_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kUint16POD:
+                {
+                    ConvertData< Util::int8_t, Util::uint16_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kInt16POD:
+                {
+                    ConvertData< Util::int8_t, Util::int16_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kUint32POD:
+                {
+                    ConvertData< Util::int8_t, Util::uint32_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kInt32POD:
+                {
+                    ConvertData< Util::int8_t, Util::int32_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kUint64POD:
+                {
+                    ConvertData< Util::int8_t, Util::uint64_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kInt64POD:
+                {
+                    ConvertData< Util::int8_t, Util::int64_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kFloat16POD:
+                {
+                    ConvertData< Util::int8_t, Util::float16_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kFloat32POD:
+                {
+                    ConvertData< Util::int8_t, Util::float32_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kFloat64POD:
+                {
+                    ConvertData< Util::int8_t, Util::float64_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                default:
+                break;
+            }
+        }
+        break;
+
+        case Util::kUint16POD:
+        {
+            switch (toPod)
+            {
+                case Util::kBooleanPOD:
+                {
+                    ConvertToBool< Util::uint16_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kUint8POD:
+                {
+                    ConvertData< Util::uint16_t, Util::uint8_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kInt8POD:
+                {
+                    ConvertData< Util::uint16_t, Util::int8_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kInt16POD:
+                {
+                    ConvertData< Util::uint16_t, Util::int16_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kUint32POD:
+                {
+                    ConvertData< Util::uint16_t, Util::uint32_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kInt32POD:
+                {
+                    ConvertData< Util::uint16_t, Util::int32_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kUint64POD:
+                {
+                    ConvertData< Util::uint16_t, Util::uint64_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kInt64POD:
+                {
+                    ConvertData< Util::uint16_t, Util::int64_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kFloat16POD:
+                {
+                    ConvertData< Util::uint16_t, Util::float16_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kFloat32POD:
+                {
+                    ConvertData< Util::uint16_t, Util::float32_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kFloat64POD:
+                {
+                    ConvertData< Util::uint16_t, Util::float64_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                default:
+                break;
+            }
+        }
+        break;
+
+        case Util::kInt16POD:
+        {
+            switch (toPod)
+            {
+                case Util::kBooleanPOD:
+                {
+                    ConvertToBool< Util::int16_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kUint8POD:
+                {
+                    ConvertData< Util::int16_t, Util::uint8_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kInt8POD:
+                {
+                    ConvertData< Util::int16_t, Util::int8_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kUint16POD:
+                {
+                    ConvertData< Util::int16_t, Util::uint16_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kUint32POD:
+                {
+                    ConvertData< Util::int16_t, Util::uint32_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kInt32POD:
+                {
+                    ConvertData< Util::int16_t, Util::int32_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kUint64POD:
+                {
+                    ConvertData< Util::int16_t, Util::uint64_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kInt64POD:
+                {
+                    ConvertData< Util::int16_t, Util::int64_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kFloat16POD:
+                {
+                    ConvertData< Util::int16_t, Util::float16_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kFloat32POD:
+                {
+                    ConvertData< Util::int16_t, Util::float32_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kFloat64POD:
+                {
+                    ConvertData< Util::int16_t, Util::float64_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                default:
+                break;
+            }
+        }
+        break;
+
+        case Util::kUint32POD:
+        {
+            switch (toPod)
+            {
+                case Util::kBooleanPOD:
+                {
+                    ConvertToBool< Util::uint32_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kUint8POD:
+                {
+                    ConvertData< Util::uint32_t, Util::uint8_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kInt8POD:
+                {
+                    ConvertData< Util::uint32_t, Util::int8_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kUint16POD:
+                {
+                    ConvertData< Util::uint32_t, Util::uint16_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kInt16POD:
+                {
+                    ConvertData< Util::uint32_t, Util::int16_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kInt32POD:
+                {
+                    ConvertData< Util::uint32_t, Util::int32_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kUint64POD:
+                {
+                    ConvertData< Util::uint32_t, Util::uint64_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kInt64POD:
+                {
+                    ConvertData< Util::uint32_t, Util::int64_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kFloat16POD:
+                {
+                    ConvertData< Util::uint32_t, Util::float16_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kFloat32POD:
+                {
+                    ConvertData< Util::uint32_t, Util::float32_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kFloat64POD:
+                {
+                    ConvertData< Util::uint32_t, Util::float64_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                default:
+                break;
+            }
+        }
+        break;
+
+        case Util::kInt32POD:
+        {
+            switch (toPod)
+            {
+                case Util::kBooleanPOD:
+                {
+                    ConvertToBool< Util::int32_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kUint8POD:
+                {
+                    ConvertData< Util::int32_t, Util::uint8_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kInt8POD:
+                {
+                    ConvertData< Util::int32_t, Util::int8_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kUint16POD:
+                {
+                    ConvertData< Util::int32_t, Util::uint16_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kInt16POD:
+                {
+                    ConvertData< Util::int32_t, Util::int16_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kUint32POD:
+                {
+                    ConvertData< Util::int32_t, Util::uint32_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kUint64POD:
+                {
+                    ConvertData< Util::int32_t, Util::uint64_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kInt64POD:
+                {
+                    ConvertData< Util::int32_t, Util::int64_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kFloat16POD:
+                {
+                    ConvertData< Util::int32_t, Util::float16_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kFloat32POD:
+                {
+                    ConvertData< Util::int32_t, Util::float32_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kFloat64POD:
+                {
+                    ConvertData< Util::int32_t, Util::float64_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                default:
+                break;
+            }
+        }
+        break;
+
+        case Util::kUint64POD:
+        {
+            switch (toPod)
+            {
+                case Util::kBooleanPOD:
+                {
+                    ConvertToBool< Util::uint64_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kUint8POD:
+                {
+                    ConvertData< Util::uint64_t, Util::uint8_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kInt8POD:
+                {
+                    ConvertData< Util::uint64_t, Util::int8_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kUint16POD:
+                {
+                    ConvertData< Util::uint64_t, Util::uint16_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kInt16POD:
+                {
+                    ConvertData< Util::uint64_t, Util::int16_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kUint32POD:
+                {
+                    ConvertData< Util::uint64_t, Util::uint32_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kInt32POD:
+                {
+                    ConvertData< Util::uint64_t, Util::int32_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kInt64POD:
+                {
+                    ConvertData< Util::uint64_t, Util::int64_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kFloat16POD:
+                {
+                    ConvertData< Util::uint64_t, Util::float16_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kFloat32POD:
+                {
+                    ConvertData< Util::uint64_t, Util::float32_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kFloat64POD:
+                {
+                    ConvertData< Util::uint64_t, Util::float64_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                default:
+                break;
+            }
+        }
+        break;
+
+        case Util::kInt64POD:
+        {
+            switch (toPod)
+            {
+                case Util::kBooleanPOD:
+                {
+                    ConvertToBool<  Util::int64_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kUint8POD:
+                {
+                    ConvertData< Util::int64_t, Util::uint8_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kInt8POD:
+                {
+                    ConvertData< Util::int64_t, Util::int8_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kUint16POD:
+                {
+                    ConvertData< Util::int64_t, Util::uint16_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kInt16POD:
+                {
+                    ConvertData< Util::int64_t, Util::int16_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kUint32POD:
+                {
+                    ConvertData< Util::int64_t, Util::uint32_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kInt32POD:
+                {
+                    ConvertData< Util::int64_t, Util::int32_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kUint64POD:
+                {
+                    ConvertData< Util::int64_t, Util::uint64_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kFloat16POD:
+                {
+                    ConvertData< Util::int64_t, Util::float16_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kFloat32POD:
+                {
+                    ConvertData< Util::int64_t, Util::float32_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kFloat64POD:
+                {
+                    ConvertData< Util::int64_t, Util::float64_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                default:
+                break;
+            }
+        }
+        break;
+
+        case Util::kFloat16POD:
+        {
+            switch (toPod)
+            {
+                case Util::kBooleanPOD:
+                {
+                    ConvertToBool< Util::float16_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kUint8POD:
+                {
+                    ConvertData< Util::float16_t, Util::uint8_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kInt8POD:
+                {
+                    ConvertData< Util::float16_t, Util::int8_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kUint16POD:
+                {
+                    ConvertData< Util::float16_t, Util::uint16_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kInt16POD:
+                {
+                    ConvertData< Util::float16_t, Util::int16_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kUint32POD:
+                {
+                    ConvertData< Util::float16_t, Util::uint32_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kInt32POD:
+                {
+                    ConvertData< Util::float16_t, Util::int32_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kUint64POD:
+                {
+                    ConvertData< Util::float16_t, Util::uint64_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kInt64POD:
+                {
+                    ConvertData< Util::float16_t, Util::int64_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kFloat32POD:
+                {
+                    ConvertHalfToFloat( fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kFloat64POD:
+                {
+                    ConvertData< Util::float16_t, Util::float64_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                default:
+                break;
+            }
+        }
+        break;
+
+        case Util::kFloat32POD:
+        {
+            switch (toPod)
+            {
+                case Util::kBooleanPOD:
+                {
+                    ConvertToBool< Util::float32_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kUint8POD:
+                {
+                    ConvertData< Util::float32_t, Util::uint8_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kInt8POD:
+                {
+                    ConvertData< Util::float32_t, Util::int8_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kUint16POD:
+                {
+                    ConvertData< Util::float32_t, Util::uint16_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kInt16POD:
+                {
+                    ConvertData< Util::float32_t, Util::int16_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kUint32POD:
+                {
+                    ConvertData< Util::float32_t, Util::uint32_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kInt32POD:
+                {
+                    ConvertData< Util::float32_t, Util::int32_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kUint64POD:
+                {
+                    ConvertData< Util::float32_t, Util::uint64_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kInt64POD:
+                {
+                    ConvertData< Util::float32_t, Util::int64_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kFloat16POD:
+                {
+                    ConvertFloatToHalf( fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kFloat64POD:
+                {
+                    ConvertFloatToDouble( fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                default:
+                break;
+            }
+        }
+        break;
+
+        case Util::kFloat64POD:
+        {
+            switch (toPod)
+            {
+                case Util::kBooleanPOD:
+                {
+                    ConvertToBool< Util::float64_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kUint8POD:
+                {
+                    ConvertData< Util::float64_t, Util::uint8_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kInt8POD:
+                {
+                    ConvertData< Util::float64_t, Util::int8_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kUint16POD:
+                {
+                    ConvertData< Util::float64_t, Util::uint16_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kInt16POD:
+                {
+                    ConvertData< Util::float64_t, Util::int16_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kUint32POD:
+                {
+                    ConvertData< Util::float64_t, Util::uint32_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kInt32POD:
+                {
+                    ConvertData< Util::float64_t, Util::int32_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kUint64POD:
+                {
+                    ConvertData< Util::float64_t, Util::uint64_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kInt64POD:
+                {
+                    ConvertData< Util::float64_t, Util::int64_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kFloat16POD:
+                {
+                    ConvertData< Util::float64_t, Util::float16_t >(
+                        fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                case Util::kFloat32POD:
+                {
+                    ConvertDoubleToFloat( fromBuffer, toBuffer, iSize );
+                }
+                break;
+
+                default:
+                break;
+            }
+        }
+        break;
+
+        default:
+        break;
+    }
+}
+
+} // End namespace ALEMBIC_VERSION_NS
+} // End namespace Util
+} // End namespace Alembic
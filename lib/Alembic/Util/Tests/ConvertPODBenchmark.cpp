@@ -0,0 +1,108 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2009-2013,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#include <Alembic/Util/ConvertPOD.h>
+#include <Alembic/Util/Foundation.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <vector>
+
+namespace AU = Alembic::Util;
+
+//-*****************************************************************************
+// Times ConvertData for every pair of numeric PODs.
+//
+// usage: AlembicUtilConvertPOD_Benchmark [numElements] [numRuns]
+int main( int argc, char* argv[] )
+{
+    std::size_t numElements = 1 << 22;
+    std::size_t numRuns = 5;
+    if ( argc > 1 )
+    {
+        numElements = strtoul( argv[1], NULL, 10 );
+    }
+    if ( argc > 2 )
+    {
+        numRuns = strtoul( argv[2], NULL, 10 );
+    }
+
+    const AU::PlainOldDataType pods[] = {
+        AU::kUint8POD, AU::kInt8POD, AU::kUint16POD, AU::kInt16POD,
+        AU::kUint32POD, AU::kInt32POD, AU::kUint64POD, AU::kInt64POD,
+        AU::kFloat16POD, AU::kFloat32POD, AU::kFloat64POD };
+    const std::size_t numPods = sizeof( pods ) / sizeof( pods[0] );
+
+    // zeroes are a valid value of every POD
+    std::vector< char > from( numElements * 8, 0 );
+    std::vector< char > to( numElements * 8, 0 );
+
+    for ( std::size_t i = 0; i < numPods; ++i )
+    {
+        for ( std::size_t j = 0; j < numPods; ++j )
+        {
+            std::size_t fromSize = numElements * AU::PODNumBytes( pods[i] );
+            double best = 0.0;
+            for ( std::size_t run = 0; run < numRuns; ++run )
+            {
+                std::chrono::high_resolution_clock::time_point start =
+                    std::chrono::high_resolution_clock::now();
+
+                AU::ConvertData( pods[i], pods[j], &from[0], &to[0],
+                                 fromSize );
+
+                double seconds = std::chrono::duration< double >(
+                    std::chrono::high_resolution_clock::now() - start
+                    ).count();
+                if ( run == 0 || seconds < best )
+                {
+                    best = seconds;
+                }
+            }
+
+            // bytes read plus bytes written
+            double bytes = static_cast< double >( numElements ) *
+                ( AU::PODNumBytes( pods[i] ) + AU::PODNumBytes( pods[j] ) );
+            std::cout << AU::PODName( pods[i] ) << " -> "
+                      << AU::PODName( pods[j] ) << ": "
+                      << best * 1000.0 << " ms, "
+                      << bytes / best / ( 1024.0 * 1024.0 ) << " MB/s"
+                      << std::endl;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,255 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2009-2013,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#include <Alembic/Util/ConvertPOD.h>
+#include <Alembic/Util/Foundation.h>
+
+#include <halfLimits.h>
+
+#include <cstring>
+#include <vector>
+
+namespace AU = Alembic::Util;
+
+//-*****************************************************************************
+// The element by element conversion ConvertData has to match.
+template < typename TOPOD >
+void getMinAndMax( TOPOD & iMin, TOPOD & iMax )
+{
+    iMin = std::numeric_limits< TOPOD >::min();
+    iMax = std::numeric_limits< TOPOD >::max();
+
+    // min() is the smallest positive value for floating point types
+    if ( !std::numeric_limits< TOPOD >::is_integer )
+    {
+        iMin = -iMax;
+    }
+}
+
+template < typename FROMPOD, typename TOPOD >
+void referenceConvert( const FROMPOD * iFrom, TOPOD * oTo, std::size_t iNum )
+{
+    TOPOD toPodMin = 0;
+    TOPOD toPodMax = 0;
+    getMinAndMax< TOPOD >( toPodMin, toPodMax );
+
+    FROMPOD podMin = 0;
+    FROMPOD podMax = 0;
+
+    if ( sizeof( FROMPOD ) > sizeof( TOPOD ) )
+    {
+        podMin = static_cast< FROMPOD >( toPodMin );
+        podMax = static_cast< FROMPOD >( toPodMax );
+        if ( podMin > podMax )
+        {
+            podMin = 0;
+        }
+    }
+    else
+    {
+        getMinAndMax< FROMPOD >( podMin, podMax );
+        if ( podMin != 0 && toPodMin == 0 )
+        {
+            podMin = 0;
+        }
+        else if ( podMin == 0 && toPodMin != 0 &&
+                  sizeof( FROMPOD ) == sizeof( TOPOD ) )
+        {
+            podMax = static_cast< FROMPOD >( toPodMax );
+        }
+    }
+
+    for ( std::size_t i = 0; i < iNum; ++i )
+    {
+        FROMPOD f = iFrom[i];
+        if ( f < podMin )
+        {
+            f = podMin;
+        }
+        else if ( f > podMax )
+        {
+            f = podMax;
+        }
+        oTo[i] = static_cast< TOPOD >( f );
+    }
+}
+
+//-*****************************************************************************
+template < typename POD >
+bool isNaN( const POD & iVal )
+{
+    return iVal != iVal;
+}
+
+//-*****************************************************************************
+template < typename FROMPOD, typename TOPOD >
+bool testPair( AU::PlainOldDataType iFromPod, AU::PlainOldDataType iToPod,
+               std::size_t iNum, bool iInPlace )
+{
+    // ConvertData is only used between different PODs
+    if ( iFromPod == iToPod )
+    {
+        return true;
+    }
+
+    // random bit patterns cover the extremes, infinities and NaNs, the
+    // second half is made of ordinary values for the floating point types
+    std::vector< FROMPOD > from( iNum );
+    unsigned char * bytes = reinterpret_cast< unsigned char * >( &from[0] );
+    for ( std::size_t i = 0; i < iNum * sizeof( FROMPOD ); ++i )
+    {
+        bytes[i] = static_cast< unsigned char >( rand() );
+    }
+
+    if ( !std::numeric_limits< FROMPOD >::is_integer )
+    {
+        // floating point values outside the range of an integral TOPOD
+        // aren't always clamped to it (undefined behavior), so stay within
+        // the range of int8_t for those
+        std::size_t start = iNum / 2;
+        int range = 1000000;
+        if ( std::numeric_limits< TOPOD >::is_integer )
+        {
+            start = 0;
+            range = 127 * 7;
+        }
+
+        for ( std::size_t i = start; i < iNum; ++i )
+        {
+            from[i] = static_cast< FROMPOD >(
+                ( rand() % ( 2 * range + 1 ) - range ) / 7.0f );
+        }
+    }
+
+    std::vector< TOPOD > expected( iNum );
+    referenceConvert< FROMPOD, TOPOD >( &from[0], &expected[0], iNum );
+
+    std::size_t fromSize = iNum * sizeof( FROMPOD );
+    std::vector< char > buffer(
+        std::max( fromSize, iNum * sizeof( TOPOD ) ) + fromSize );
+    char * fromBuffer = &buffer[0];
+    char * toBuffer = iInPlace ? fromBuffer : fromBuffer + fromSize;
+    memcpy( fromBuffer, &from[0], fromSize );
+
+    AU::ConvertData( iFromPod, iToPod, fromBuffer, toBuffer, fromSize );
+
+    for ( std::size_t i = 0; i < iNum; ++i )
+    {
+        TOPOD result;
+        memcpy( &result, toBuffer + i * sizeof( TOPOD ), sizeof( TOPOD ) );
+        if ( isNaN( result ) && isNaN( expected[i] ) )
+        {
+            continue;
+        }
+
+        if ( memcmp( &result, &expected[i], sizeof( TOPOD ) ) != 0 )
+        {
+            std::cerr << "ConvertData " << AU::PODName( iFromPod ) << " -> "
+                      << AU::PODName( iToPod )
+                      << ( iInPlace ? " (in place)" : "" )
+                      << " differs at " << i << " of " << iNum << ": "
+                      << static_cast< double >( from[i] ) << " gave "
+                      << static_cast< double >( result ) << " instead of "
+                      << static_cast< double >( expected[i] ) << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+//-*****************************************************************************
+template < typename FROMPOD >
+bool testFrom( AU::PlainOldDataType iFromPod, std::size_t iNum, bool iInPlace )
+{
+    return
+        testPair< FROMPOD, AU::uint8_t >( iFromPod, AU::kUint8POD,
+                                          iNum, iInPlace ) &&
+        testPair< FROMPOD, AU::int8_t >( iFromPod, AU::kInt8POD,
+                                         iNum, iInPlace ) &&
+        testPair< FROMPOD, AU::uint16_t >( iFromPod, AU::kUint16POD,
+                                           iNum, iInPlace ) &&
+        testPair< FROMPOD, AU::int16_t >( iFromPod, AU::kInt16POD,
+                                          iNum, iInPlace ) &&
+        testPair< FROMPOD, AU::uint32_t >( iFromPod, AU::kUint32POD,
+                                           iNum, iInPlace ) &&
+        testPair< FROMPOD, AU::int32_t >( iFromPod, AU::kInt32POD,
+                                          iNum, iInPlace ) &&
+        testPair< FROMPOD, AU::uint64_t >( iFromPod, AU::kUint64POD,
+                                           iNum, iInPlace ) &&
+        testPair< FROMPOD, AU::int64_t >( iFromPod, AU::kInt64POD,
+                                          iNum, iInPlace ) &&
+        testPair< FROMPOD, AU::float16_t >( iFromPod, AU::kFloat16POD,
+                                            iNum, iInPlace ) &&
+        testPair< FROMPOD, AU::float32_t >( iFromPod, AU::kFloat32POD,
+                                            iNum, iInPlace ) &&
+        testPair< FROMPOD, AU::float64_t >( iFromPod, AU::kFloat64POD,
+                                            iNum, iInPlace );
+}
+
+//-*****************************************************************************
+bool testAll( std::size_t iNum, bool iInPlace )
+{
+    return
+        testFrom< AU::uint8_t >( AU::kUint8POD, iNum, iInPlace ) &&
+        testFrom< AU::int8_t >( AU::kInt8POD, iNum, iInPlace ) &&
+        testFrom< AU::uint16_t >( AU::kUint16POD, iNum, iInPlace ) &&
+        testFrom< AU::int16_t >( AU::kInt16POD, iNum, iInPlace ) &&
+        testFrom< AU::uint32_t >( AU::kUint32POD, iNum, iInPlace ) &&
+        testFrom< AU::int32_t >( AU::kInt32POD, iNum, iInPlace ) &&
+        testFrom< AU::uint64_t >( AU::kUint64POD, iNum, iInPlace ) &&
+        testFrom< AU::int64_t >( AU::kInt64POD, iNum, iInPlace ) &&
+        testFrom< AU::float16_t >( AU::kFloat16POD, iNum, iInPlace ) &&
+        testFrom< AU::float32_t >( AU::kFloat32POD, iNum, iInPlace ) &&
+        testFrom< AU::float64_t >( AU::kFloat64POD, iNum, iInPlace );
+}
+
+//-*****************************************************************************
+int main( int argc, char* argv[] )
+{
+    // sizes around the vector widths and the internal block size
+    const std::size_t sizes[] = { 1, 3, 7, 8, 9, 255, 256, 257, 1037, 4099 };
+
+    for ( std::size_t i = 0; i < sizeof( sizes ) / sizeof( sizes[0] ); ++i )
+    {
+        if ( !testAll( sizes[i], false ) || !testAll( sizes[i], true ) )
+        {
+            return 1;
+        }
+    }
+
+    std::cout << "Success!" << std::endl;
+    return 0;
+}